@@ -0,0 +1,86 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisMorphologyBenchmark.h"
+
+#include <simpletest.h>
+
+#include "kis_pixel_selection.h"
+#include "kis_selection_filters.h"
+
+namespace {
+
+/**
+ * A selection with a lot of edges, so that both the implementations
+ * have some work to do on every row
+ */
+KisPixelSelectionSP createSelection(const QRect &rc)
+{
+    KisPixelSelectionSP selection = new KisPixelSelection();
+
+    for (int y = rc.top(); y <= rc.bottom(); y += 97) {
+        for (int x = rc.left() + (y / 97 % 2) * 48; x <= rc.right(); x += 113) {
+            selection->select(QRect(x, y, 41, 37), 255);
+        }
+    }
+
+    return selection;
+}
+
+void populateData()
+{
+    QTest::addColumn<int>("radius");
+    QTest::addColumn<bool>("useMorphology");
+
+    Q_FOREACH (int radius, QList<int>({8, 16, 32, 64, 128})) {
+        QTest::addRow("legacy-%d", radius) << radius << false;
+        QTest::addRow("morphology-%d", radius) << radius << true;
+    }
+}
+
+template <typename Filter>
+void benchmarkFilter(Filter &filter)
+{
+    QFETCH(bool, useMorphology);
+    filter.setUseMorphology(useMorphology);
+
+    const QRect rect(0, 0, 2000, 1500);
+    KisPixelSelectionSP selection = createSelection(rect);
+
+    QBENCHMARK_ONCE {
+        filter.process(selection, rect);
+    }
+}
+
+}
+
+void KisMorphologyBenchmark::benchmarkGrow_data()
+{
+    populateData();
+}
+
+void KisMorphologyBenchmark::benchmarkGrow()
+{
+    QFETCH(int, radius);
+
+    KisGrowSelectionFilter filter(radius, radius);
+    benchmarkFilter(filter);
+}
+
+void KisMorphologyBenchmark::benchmarkShrink_data()
+{
+    populateData();
+}
+
+void KisMorphologyBenchmark::benchmarkShrink()
+{
+    QFETCH(int, radius);
+
+    KisShrinkSelectionFilter filter(radius, radius, false);
+    benchmarkFilter(filter);
+}
+
+SIMPLE_TEST_MAIN(KisMorphologyBenchmark)
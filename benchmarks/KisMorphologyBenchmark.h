@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISMORPHOLOGYBENCHMARK_H
+#define KISMORPHOLOGYBENCHMARK_H
+
+#include <simpletest.h>
+
+class KisMorphologyBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkGrow_data();
+    void benchmarkGrow();
+    void benchmarkShrink_data();
+    void benchmarkShrink();
+};
+
+#endif // KISMORPHOLOGYBENCHMARK_H
@@ -0,0 +1,225 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeReplayBenchmark.h"
+
+#include <algorithm>
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QtMath>
+
+#include <simpletest.h>
+
+#include "kis_benchmark_values.h"
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColor.h>
+
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <kis_painter.h>
+#include <kis_distance_information.h>
+#include <kis_memory_statistics_server.h>
+
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <brushengine/kis_paintop_settings.h>
+
+#include <KisGlobalResourcesInterface.h>
+
+namespace {
+
+const QString DEFAULT_PRESET_FILE_NAME = "softbrush_30px.kpp";
+
+/**
+ * A few strokes of a typical sketching speed, used when
+ * no real recording is provided
+ */
+KisStrokeRecording::Stroke generateSyntheticStroke(int index)
+{
+    const int numEvents = 300;
+    const qreal eventInterval = 5.0; // ms, a common tablet report rate
+
+    KisStrokeRecording::Stroke stroke;
+
+    for (int i = 0; i < numEvents; i++) {
+        const qreal t = qreal(i) / (numEvents - 1);
+
+        KisStrokeRecording::Event event;
+        event.pos = QPointF(0.1 * TEST_IMAGE_WIDTH + t * 0.8 * TEST_IMAGE_WIDTH,
+                            (0.2 + 0.15 * index) * TEST_IMAGE_HEIGHT +
+                            0.1 * TEST_IMAGE_HEIGHT * qSin(t * 4 * M_PI));
+        event.pressure = qSin(t * M_PI);
+        event.xTilt = -30.0 + 60.0 * t;
+        event.yTilt = 20.0 * qCos(t * 2 * M_PI);
+        event.time = i * eventInterval;
+        event.speed = 0.8 * TEST_IMAGE_WIDTH / (numEvents * eventInterval);
+
+        stroke.append(event);
+    }
+
+    return stroke;
+}
+
+qreal percentile(const QVector<qint64> &sortedValues, qreal portion)
+{
+    if (sortedValues.isEmpty()) return 0.0;
+
+    const int index = qBound(0, qCeil(portion * sortedValues.size()) - 1, sortedValues.size() - 1);
+    return sortedValues[index] / 1e6;
+}
+
+}
+
+void KisStrokeReplayBenchmark::initTestCase()
+{
+    const QString recordingFileName = qEnvironmentVariable("KRITA_REPLAY_RECORDING");
+
+    if (!recordingFileName.isEmpty()) {
+        QVERIFY2(m_recording.load(recordingFileName),
+                 qPrintable(QString("Failed to load the recording: %1").arg(recordingFileName)));
+    } else {
+        KisStrokeRecording synthetic;
+        for (int i = 0; i < 4; i++) {
+            synthetic.addStroke(generateSyntheticStroke(i));
+        }
+
+        // pass the synthetic strokes through the file format to
+        // replay exactly what would be read from a real recording
+        QBuffer buffer;
+        buffer.open(QIODevice::ReadWrite);
+        QVERIFY(synthetic.save(&buffer));
+        buffer.seek(0);
+        QVERIFY(m_recording.load(&buffer));
+    }
+
+    QVERIFY(m_recording.numEvents() > 0);
+
+    m_presetFileName = qEnvironmentVariable("KRITA_REPLAY_PRESET", DEFAULT_PRESET_FILE_NAME);
+    if (QFileInfo(m_presetFileName).isRelative()) {
+        m_presetFileName = QString(FILES_DATA_DIR) + '/' + m_presetFileName;
+    }
+}
+
+void KisStrokeReplayBenchmark::benchmarkReplay_data()
+{
+    QTest::addColumn<QString>("colorModelId");
+    QTest::addColumn<QString>("colorDepthId");
+
+    const QString colorSpace = qEnvironmentVariable("KRITA_REPLAY_COLORSPACE");
+
+    const QStringList ids = colorSpace.split('/');
+
+    if (ids.size() == 2) {
+        QTest::newRow(qPrintable(colorSpace)) << ids[0] << ids[1];
+    } else {
+        if (!colorSpace.isEmpty()) {
+            qWarning() << "KRITA_REPLAY_COLORSPACE should have <model>/<depth> format, got" << colorSpace;
+        }
+
+        QTest::newRow("RGBA/U8") << "RGBA" << "U8";
+        QTest::newRow("RGBA/U16") << "RGBA" << "U16";
+        QTest::newRow("RGBA/F32") << "RGBA" << "F32";
+    }
+}
+
+void KisStrokeReplayBenchmark::benchmarkReplay()
+{
+    QFETCH(QString, colorModelId);
+    QFETCH(QString, colorDepthId);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace(colorModelId, colorDepthId, 0);
+    QVERIFY2(cs, qPrintable(QString("Unknown color space: %1/%2").arg(colorModelId).arg(colorDepthId)));
+
+    KisPaintOpPresetSP preset(new KisPaintOpPreset(m_presetFileName));
+    QVERIFY2(preset->load(KisGlobalResourcesInterface::instance()),
+             qPrintable(QString("Failed to load the preset: %1").arg(m_presetFileName)));
+
+    QRectF strokesBounds;
+    Q_FOREACH (const KisStrokeRecording::Stroke &stroke, m_recording.strokes()) {
+        Q_FOREACH (const KisStrokeRecording::Event &event, stroke) {
+            strokesBounds |= QRectF(event.pos, QSizeF(1, 1));
+        }
+    }
+
+    const int width = qMax(TEST_IMAGE_WIDTH, qCeil(strokesBounds.right()));
+    const int height = qMax(TEST_IMAGE_HEIGHT, qCeil(strokesBounds.bottom()));
+
+    KisImageSP image = new KisImage(0, width, height, cs, "stroke replay image");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "replay layer", OPACITY_OPAQUE_U8, cs);
+    image->addNode(layer);
+
+    QVector<qint64> eventTimes;
+    eventTimes.reserve(m_recording.numEvents());
+
+    qint64 totalTime = 0;
+    qint64 totalDabs = 0;
+    qint64 peakMemory = 0;
+
+    QElapsedTimer timer;
+
+    QBENCHMARK {
+        layer->paintDevice()->clear();
+
+        KisPainter painter(layer->paintDevice());
+        painter.setPaintColor(KoColor(Qt::black, cs));
+        painter.setPaintOpPreset(preset, layer, image);
+
+        Q_FOREACH (const KisStrokeRecording::Stroke &stroke, m_recording.strokes()) {
+            if (stroke.isEmpty()) continue;
+
+            KisDistanceInformation distance;
+            KisPaintInformation previous =
+                KisStrokeRecording::paintInformationFromEvent(stroke.first());
+
+            timer.start();
+            painter.paintAt(previous, &distance);
+            eventTimes.append(timer.nsecsElapsed());
+
+            for (int i = 1; i < stroke.size(); i++) {
+                const KisPaintInformation current =
+                    KisStrokeRecording::paintInformationFromEvent(stroke[i]);
+
+                timer.start();
+                painter.paintLine(previous, current, &distance);
+                eventTimes.append(timer.nsecsElapsed());
+
+                previous = current;
+            }
+
+            totalDabs += distance.currentDabSeqNo();
+
+            peakMemory = qMax(peakMemory,
+                              KisMemoryStatisticsServer::instance()->fetchMemoryStatistics(image).totalMemorySize);
+        }
+    }
+
+    Q_FOREACH (qint64 time, eventTimes) {
+        totalTime += time;
+    }
+
+    std::sort(eventTimes.begin(), eventTimes.end());
+
+    qDebug().noquote() << QString("%1, %2/%3: %4 events, %5 dabs/s")
+                          .arg(QFileInfo(m_presetFileName).fileName())
+                          .arg(colorModelId).arg(colorDepthId)
+                          .arg(m_recording.numEvents())
+                          .arg(totalTime > 0 ? qRound64(totalDabs * 1e9 / totalTime) : 0);
+
+    qDebug().noquote() << QString("    event latency, ms: p50 %1, p90 %2, p99 %3, max %4")
+                          .arg(percentile(eventTimes, 0.5), 0, 'f', 3)
+                          .arg(percentile(eventTimes, 0.9), 0, 'f', 3)
+                          .arg(percentile(eventTimes, 0.99), 0, 'f', 3)
+                          .arg(percentile(eventTimes, 1.0), 0, 'f', 3);
+
+    qDebug().noquote() << QString("    peak tile memory: %1 MiB")
+                          .arg(peakMemory / 1024.0 / 1024.0, 0, 'f', 2);
+}
+
+SIMPLE_TEST_MAIN(KisStrokeReplayBenchmark)
@@ -0,0 +1,45 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKEREPLAYBENCHMARK_H
+#define KISSTROKEREPLAYBENCHMARK_H
+
+#include <simpletest.h>
+
+#include <KisStrokeRecording.h>
+
+/**
+ * Replays the strokes recorded by the freehand tool (see
+ * KisStrokeRecording) with a paintop preset and reports the number
+ * of dabs per second, the percentiles of the time spent on every
+ * tablet event and the peak tile memory usage.
+ *
+ * The benchmark is controlled by the environment variables:
+ *
+ *   KRITA_REPLAY_RECORDING  the recording file; when not set,
+ *                           a synthetic stroke is used
+ *   KRITA_REPLAY_PRESET     the preset file, relative to the
+ *                           benchmarks data dir or absolute
+ *   KRITA_REPLAY_COLORSPACE the color space as "<model>/<depth>",
+ *                           e.g. "RGBA/U16"; when not set, a few
+ *                           common color spaces are tested
+ */
+class KisStrokeReplayBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkReplay_data();
+    void benchmarkReplay();
+
+private:
+    KisStrokeRecording m_recording;
+    QString m_presetFileName;
+};
+
+#endif // KISSTROKEREPLAYBENCHMARK_H
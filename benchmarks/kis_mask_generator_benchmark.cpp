@@ -10,6 +10,9 @@
 
 #include "kis_circle_mask_generator.h"
 #include "kis_rect_mask_generator.h"
+#include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_rect_mask_generator.h"
+#include "kis_cubic_curve.h"
 
 void KisMaskGeneratorBenchmark::benchmarkCircle()
 {
@@ -33,7 +36,7 @@ void KisMaskGeneratorBenchmark::benchmarkCircle()
 #include "krita_utils.h"
 
 
-void benchmarkSIMD(qreal fade) {
+void benchmarkSIMD(KisMaskGenerator &gen) {
     const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
     KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
     dev->setRect(QRect(0, 0, 1000, 1000));
@@ -43,8 +46,6 @@ void benchmarkSIMD(qreal fade) {
                             0.0, 1.0,
                             500, 500, 0);
 
-    KisCircleMaskGenerator gen(1000, 1.0, fade, fade, 2, false);
-
     KisBrushMaskApplicatorBase *applicator = gen.applicator();
     applicator->initializeData(&data);
 
@@ -57,6 +58,11 @@ void benchmarkSIMD(qreal fade) {
     }
 }
 
+void benchmarkSIMD(qreal fade) {
+    KisCircleMaskGenerator gen(1000, 1.0, fade, fade, 2, false);
+    benchmarkSIMD(gen);
+}
+
 void KisMaskGeneratorBenchmark::benchmarkSIMD_SharpBrush()
 {
     benchmarkSIMD(1.0);
@@ -67,6 +73,22 @@ void KisMaskGeneratorBenchmark::benchmarkSIMD_FadedBrush()
     benchmarkSIMD(0.5);
 }
 
+void KisMaskGeneratorBenchmark::benchmarkSIMD_CurveCircle()
+{
+    const KisCubicCurve curve(QString("0,1;0.3,0.9;0.7,0.1;1,0"));
+    KisCurveCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, curve, true);
+    gen.setSoftness(0.8);
+    benchmarkSIMD(gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_CurveRect()
+{
+    const KisCubicCurve curve(QString("0,1;0.3,0.9;0.7,0.1;1,0"));
+    KisCurveRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, curve, true);
+    gen.setSoftness(0.8);
+    benchmarkSIMD(gen);
+}
+
 void KisMaskGeneratorBenchmark::benchmarkSquare()
 {
     KisRectangleMaskGenerator gen(1000, 0.5, 0.5, 0.5, 3, true);
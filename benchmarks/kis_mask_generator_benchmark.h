@@ -16,6 +16,8 @@ private Q_SLOTS:
     void benchmarkCircle();
     void benchmarkSIMD_SharpBrush();
     void benchmarkSIMD_FadedBrush();
+    void benchmarkSIMD_CurveCircle();
+    void benchmarkSIMD_CurveRect();
     void benchmarkSquare();
 
 };
@@ -0,0 +1,337 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAlphaMaskPyramid.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <QGlobalStatic>
+#include <QScopedPointer>
+#include <QTransform>
+
+#include <KoColorSpaceConstants.h>
+#include <KoColorSpaceMaths.h>
+#include <kis_assert.h>
+
+#include "KisAlphaMaskResamplerBase.h"
+#include "KisAlphaMaskResamplerFactoryImpl.h"
+#include "kis_qimage_pyramid.h"
+
+namespace {
+
+struct ResamplerStorage
+{
+    ResamplerStorage()
+        : resampler(createOptimizedClass<KisAlphaMaskResamplerFactoryImpl>())
+    {
+    }
+
+    QScopedPointer<KisAlphaMaskResamplerBase> resampler;
+};
+
+Q_GLOBAL_STATIC(ResamplerStorage, s_resamplerStorage)
+
+/**
+ * The weights of a box filter downscaling a row of \p srcSize pixels
+ * into \p dstSize pixels. Every destination pixel averages the source
+ * pixels it covers, taking the partially covered ones with the weight
+ * proportional to the coverage.
+ */
+struct BoxFilterWeights
+{
+    BoxFilterWeights(int srcSize, int dstSize)
+    {
+        const qreal ratio = qreal(srcSize) / dstSize;
+        taps = int(std::ceil(ratio)) + 1;
+
+        firstIndex.resize(dstSize);
+        weights.resize(dstSize * taps);
+
+        for (int i = 0; i < dstSize; i++) {
+            const qreal start = i * ratio;
+            const qreal end = (i + 1) * ratio;
+            const int first = int(start);
+
+            firstIndex[i] = first;
+
+            for (int k = 0; k < taps; k++) {
+                const int j = first + k;
+                const qreal overlap = j < srcSize ? qMin(end, qreal(j + 1)) - qMax(start, qreal(j)) : 0.0;
+                weights[i * taps + k] = float(qMax(0.0, overlap) / ratio);
+            }
+        }
+    }
+
+    int taps {0};
+    QVector<int> firstIndex;
+    QVector<float> weights;
+};
+
+}
+
+KisAlphaMaskPyramid::Level::Level(const QSize &_size)
+    : size(_size),
+      stride(_size.width() + 2),
+      data(stride * (_size.height() + 2), 0)
+{
+}
+
+KisAlphaMaskPyramid::KisAlphaMaskPyramid(const QImage &baseImage)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!baseImage.isNull());
+
+    m_originalSize = baseImage.size();
+
+    const QImage image = baseImage.convertToFormat(QImage::Format_ARGB32);
+
+    Level baseLevel(m_originalSize);
+
+    for (int y = 0; y < m_originalSize.height(); y++) {
+        const QRgb *srcPtr = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        quint8 *dstPtr = baseLevel.pixel(0, y);
+
+        for (int x = 0; x < m_originalSize.width(); x++) {
+            dstPtr[x] = tipPixelOpacity(srcPtr[x]);
+        }
+    }
+
+    m_levels.append(baseLevel);
+
+    /**
+     * Unlike KisQImagePyramid, we don't keep the enlarged levels: the
+     * bilinear filter enlarges the mask smoothly enough. The sizes of
+     * the downscaled levels are the same as in KisQImagePyramid.
+     */
+    qreal scale = 0.5;
+    while (true) {
+        const QSize scaledSize = m_originalSize * scale;
+        if (scaledSize.isEmpty()) break;
+
+        m_levels.append(downscaleLevel(m_levels.last(), scaledSize));
+
+        scale *= 0.5;
+    }
+}
+
+KisAlphaMaskPyramid::~KisAlphaMaskPyramid()
+{
+}
+
+quint8 KisAlphaMaskPyramid::tipPixelOpacity(QRgb pixel)
+{
+    return KoColorSpaceMaths<quint8>::multiply(OPACITY_OPAQUE_U8 - quint8(qRed(pixel)), quint8(qAlpha(pixel)));
+}
+
+KisAlphaMaskPyramid::Level KisAlphaMaskPyramid::downscaleLevel(const Level &src, const QSize &dstSize)
+{
+    const BoxFilterWeights horizontal(src.size.width(), dstSize.width());
+    const BoxFilterWeights vertical(src.size.height(), dstSize.height());
+
+    // the horizontal pass, the taps beyond the edge of the
+    // level have zero weight and are skipped
+    QVector<float> tmp(dstSize.width() * src.size.height());
+
+    for (int y = 0; y < src.size.height(); y++) {
+        const quint8 *srcRow = src.constPixel(0, y);
+        float *tmpRow = tmp.data() + y * dstSize.width();
+
+        for (int x = 0; x < dstSize.width(); x++) {
+            const quint8 *srcPtr = srcRow + horizontal.firstIndex[x];
+            const float *weights = horizontal.weights.constData() + x * horizontal.taps;
+
+            float value = 0.0f;
+            for (int k = 0; k < horizontal.taps; k++) {
+                if (weights[k] > 0.0f) {
+                    value += weights[k] * srcPtr[k];
+                }
+            }
+            tmpRow[x] = value;
+        }
+    }
+
+    Level dst(dstSize);
+
+    for (int y = 0; y < dstSize.height(); y++) {
+        const float *weights = vertical.weights.constData() + y * vertical.taps;
+        const int firstRow = vertical.firstIndex[y];
+        quint8 *dstRow = dst.pixel(0, y);
+
+        for (int x = 0; x < dstSize.width(); x++) {
+            float value = 0.0f;
+            for (int k = 0; k < vertical.taps; k++) {
+                if (weights[k] > 0.0f) {
+                    value += weights[k] * tmp[(firstRow + k) * dstSize.width() + x];
+                }
+            }
+            dstRow[x] = quint8(qBound(0.0f, value + 0.5f, 255.0f));
+        }
+    }
+
+    return dst;
+}
+
+int KisAlphaMaskPyramid::findNearestLevel(qreal scale, qreal *baseScale) const
+{
+    // the same as KisQImagePyramid::findNearestLevel(), but
+    // the base level always has unit scale
+    const qreal scale_epsilon = 1e-6;
+
+    qreal levelScale = 1.0;
+    int level = 0;
+    int lastLevel = m_levels.size() - 1;
+
+    while ((0.5 * levelScale > scale ||
+            qAbs(0.5 * levelScale - scale) < scale_epsilon) &&
+            level < lastLevel) {
+
+        levelScale *= 0.5;
+        level++;
+    }
+
+    *baseScale = levelScale;
+    return level;
+}
+
+QImage KisAlphaMaskPyramid::createImage(KisDabShape const& shape,
+                                        qreal subPixelX, qreal subPixelY) const
+{
+    if (m_levels.isEmpty()) return QImage();
+
+    qreal baseScale = -1.0;
+    const int level = findNearestLevel(shape.scale(), &baseScale);
+    const Level &srcLevel = m_levels[level];
+
+    QTransform transform;
+    QSize dstSize;
+
+    KisQImagePyramid::calculateParams(shape, subPixelX, subPixelY,
+                                      m_originalSize, baseScale, srcLevel.size,
+                                      &transform, &dstSize);
+
+    QImage dstImage(dstSize, QImage::Format_Alpha8);
+
+    bool isInvertible = false;
+    const QTransform invertedTransform = transform.inverted(&isInvertible);
+
+    if (!isInvertible) {
+        dstImage.fill(0);
+        return dstImage;
+    }
+
+    if (transform.type() <= QTransform::TxScale) {
+        resampleSeparable(srcLevel, invertedTransform, &dstImage);
+    } else {
+        resampleAffine(srcLevel, invertedTransform, &dstImage);
+    }
+
+    return dstImage;
+}
+
+void KisAlphaMaskPyramid::resampleSeparable(const Level &src, const QTransform &invertedTransform, QImage *dstImage) const
+{
+    const KisAlphaMaskResamplerBase *resampler = s_resamplerStorage->resampler.data();
+
+    const int dstWidth = dstImage->width();
+    const int dstHeight = dstImage->height();
+
+    /**
+     * The filter samples the bordered level at the center of the
+     * destination pixel mapped into the level plus the offset of the
+     * border, minus 0.5 for the center of the source pixels.
+     */
+    QVector<qint32> offsets(dstWidth);
+    QVector<quint16> weights(dstWidth);
+
+    for (int x = 0; x < dstWidth; x++) {
+        const qreal srcX = (x + 0.5) * invertedTransform.m11() + invertedTransform.dx() + 0.5;
+        const qreal floorX = std::floor(srcX);
+        const int x0 = int(floorX);
+
+        if (x0 < 0 || x0 > src.size.width()) {
+            // the left border pixel is zero
+            offsets[x] = 0;
+            weights[x] = 0;
+        } else {
+            offsets[x] = x0;
+            weights[x] = quint16(qRound((srcX - floorX) * 256));
+        }
+    }
+
+    // the two rows under the filter; the rows y0 and y0 + 1
+    // always have different parity
+    QVector<quint16> rows[2] = {QVector<quint16>(dstWidth), QVector<quint16>(dstWidth)};
+    int rowIndexes[2] = {-1, -1};
+
+    auto fetchRow = [&] (int row) -> const quint16* {
+        const int slot = row & 1;
+
+        if (rowIndexes[slot] != row) {
+            resampler->resampleHorizontal(src.data.constData() + row * src.stride,
+                                          offsets.constData(), weights.constData(),
+                                          rows[slot].data(), dstWidth);
+            rowIndexes[slot] = row;
+        }
+
+        return rows[slot].constData();
+    };
+
+    for (int y = 0; y < dstHeight; y++) {
+        quint8 *dstRow = dstImage->scanLine(y);
+
+        const qreal srcY = (y + 0.5) * invertedTransform.m22() + invertedTransform.dy() + 0.5;
+        const qreal floorY = std::floor(srcY);
+        const int y0 = int(floorY);
+
+        if (y0 < 0 || y0 > src.size.height()) {
+            memset(dstRow, 0, dstWidth);
+            continue;
+        }
+
+        const quint16 weight = quint16(qRound((srcY - floorY) * 256));
+
+        const quint16 *row0 = fetchRow(y0);
+        const quint16 *row1 = fetchRow(y0 + 1);
+
+        resampler->blendVertical(row0, row1, weight, dstRow, dstWidth);
+    }
+}
+
+void KisAlphaMaskPyramid::resampleAffine(const Level &src, const QTransform &invertedTransform, QImage *dstImage) const
+{
+    const KisAlphaMaskResamplerBase *resampler = s_resamplerStorage->resampler.data();
+
+    const int dstWidth = dstImage->width();
+    const int dstHeight = dstImage->height();
+
+    // the step of the sampling point along the destination row
+    const float dx = float(invertedTransform.m11());
+    const float dy = float(invertedTransform.m12());
+
+    for (int y = 0; y < dstHeight; y++) {
+        const QPointF start = invertedTransform.map(QPointF(0.5, y + 0.5));
+
+        resampler->resampleAffine(src.data.constData(), src.stride,
+                                  src.size.width(), src.size.height(),
+                                  float(start.x()), float(start.y()), dx, dy,
+                                  dstImage->scanLine(y), dstWidth);
+    }
+}
+
+QSize KisAlphaMaskPyramid::originalSize() const
+{
+    return m_originalSize;
+}
+
+void KisAlphaMaskPyramid::setCacheKey(const QByteArray &key)
+{
+    m_cacheKey = key;
+}
+
+QByteArray KisAlphaMaskPyramid::cacheKey() const
+{
+    return m_cacheKey;
+}
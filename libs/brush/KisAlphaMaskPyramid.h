@@ -0,0 +1,96 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISALPHAMASKPYRAMID_H
+#define KISALPHAMASKPYRAMID_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QVector>
+
+#include <kis_dab_shape.h>
+#include <kritabrush_export.h>
+
+/**
+ * A mipmap pyramid of the opacity mask of a brush tip. It is used
+ * instead of KisQImagePyramid for the brushes whose tip is applied
+ * as an alpha mask, which is the most common case for the predefined
+ * brushes.
+ *
+ * The levels are stored as 8-bit masks (a quarter of the size of the
+ * ARGB32 levels of KisQImagePyramid) and are resampled with the
+ * per-arch bilinear kernels of KisAlphaMaskResamplerBase: a separable
+ * filter when the dab is not rotated and an affine one otherwise.
+ *
+ * The size of the generated masks is exactly the same as the size
+ * of the images generated by KisQImagePyramid, that is, the one
+ * returned by KisQImagePyramid::imageSize().
+ */
+class BRUSH_EXPORT KisAlphaMaskPyramid
+{
+public:
+    KisAlphaMaskPyramid(const QImage &baseImage);
+    ~KisAlphaMaskPyramid();
+
+    /**
+     * Converts the pixel of a brush tip into opacity the same way
+     * KoColorSpace::fillGrayBrushWithColor() does
+     */
+    static quint8 tipPixelOpacity(QRgb pixel);
+
+    /**
+     * Generates the opacity mask of the dab in QImage::Format_Alpha8
+     * format.
+     */
+    QImage createImage(KisDabShape const&,
+                       qreal subPixelX, qreal subPixelY) const;
+
+    QSize originalSize() const;
+
+    /**
+     * \see KisQImagePyramid::setCacheKey()
+     */
+    void setCacheKey(const QByteArray &key);
+    QByteArray cacheKey() const;
+
+private:
+    struct Level;
+
+    int findNearestLevel(qreal scale, qreal *baseScale) const;
+    static Level downscaleLevel(const Level &src, const QSize &dstSize);
+
+    void resampleSeparable(const Level &src, const QTransform &invertedTransform, QImage *dstImage) const;
+    void resampleAffine(const Level &src, const QTransform &invertedTransform, QImage *dstImage) const;
+
+private:
+    /**
+     * The pixels of the level are surrounded by a border of one zero
+     * pixel, so the bilinear filter doesn't need to check the bounds
+     * of the mask and fades out the edges of the dab smoothly.
+     */
+    struct Level {
+        Level() {}
+        Level(const QSize &_size);
+
+        quint8* pixel(int x, int y) {
+            return data.data() + (y + 1) * stride + x + 1;
+        }
+
+        const quint8* constPixel(int x, int y) const {
+            return data.constData() + (y + 1) * stride + x + 1;
+        }
+
+        QSize size;
+        int stride {0};
+        QVector<quint8> data;
+    };
+
+    QSize m_originalSize;
+    QByteArray m_cacheKey;
+    QVector<Level> m_levels;
+};
+
+#endif // KISALPHAMASKPYRAMID_H
@@ -0,0 +1,222 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISALPHAMASKRESAMPLER_H
+#define KISALPHAMASKRESAMPLER_H
+
+#include <cstring>
+
+#include <xsimd_extensions/xsimd.hpp>
+
+#include "KisAlphaMaskResamplerBase.h"
+
+template<typename _impl,
+         typename EnableDummyType = void>
+class KisAlphaMaskResampler : public KisAlphaMaskResamplerBase
+{
+public:
+    void resampleHorizontal(const quint8 *srcRow,
+                            const qint32 *offsets, const quint16 *weights,
+                            quint16 *dst, int numPixels) const override
+    {
+        resampleHorizontalScalar(srcRow, offsets, weights, dst, numPixels);
+    }
+
+    void blendVertical(const quint16 *row0, const quint16 *row1, quint16 weight,
+                       quint8 *dst, int numPixels) const override
+    {
+        blendVerticalScalar(row0, row1, weight, dst, numPixels);
+    }
+
+    void resampleAffine(const quint8 *src, int srcStride,
+                        int width, int height,
+                        float x, float y, float dx, float dy,
+                        quint8 *dst, int numPixels) const override
+    {
+        resampleAffineScalar(src, srcStride, width, height, x, y, dx, dy, dst, numPixels);
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+template<typename _impl>
+class KisAlphaMaskResampler<_impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type> : public KisAlphaMaskResamplerBase
+{
+    using int_v = xsimd::batch<int, _impl>;
+    using uint_v = xsimd::batch<unsigned int, _impl>;
+    using float_v = xsimd::batch<float, _impl>;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+    /**
+     * There are no native gathers for 8-bit data, so the pixels
+     * are fetched one by one and all the math is done in vectors.
+     */
+    static void gatherPair(const quint8 *src, const int_v &offsets, int_v &first, int_v &second)
+    {
+        int indices[vectorSize];
+        offsets.store_unaligned(indices);
+
+        int firstValues[vectorSize];
+        int secondValues[vectorSize];
+
+        for (int i = 0; i < vectorSize; i++) {
+            const quint8 *ptr = src + indices[i];
+            firstValues[i] = ptr[0];
+            secondValues[i] = ptr[1];
+        }
+
+        first = int_v::load_unaligned(firstValues);
+        second = int_v::load_unaligned(secondValues);
+    }
+
+    template<typename batch_type, typename dst_type>
+    static void storeNarrowed(const batch_type &value, dst_type *dst)
+    {
+        typename batch_type::value_type values[vectorSize];
+        value.store_unaligned(values);
+
+        for (int i = 0; i < vectorSize; i++) {
+            dst[i] = static_cast<dst_type>(values[i]);
+        }
+    }
+
+public:
+    void resampleHorizontal(const quint8 *srcRow,
+                            const qint32 *offsets, const quint16 *weights,
+                            quint16 *dst, int numPixels) const override
+    {
+        const int block = numPixels / vectorSize;
+        const int block2 = numPixels % vectorSize;
+
+        const int_v vUnit(256);
+
+        for (int i = 0; i < block; i++) {
+            const int_v vOffsets = int_v::load_unaligned(offsets);
+            const int_v vWeights = xsimd::load_and_extend<int_v>(weights);
+
+            int_v vLeft;
+            int_v vRight;
+            gatherPair(srcRow, vOffsets, vLeft, vRight);
+
+            storeNarrowed(vLeft * (vUnit - vWeights) + vRight * vWeights, dst);
+
+            offsets += vectorSize;
+            weights += vectorSize;
+            dst += vectorSize;
+        }
+
+        resampleHorizontalScalar(srcRow, offsets, weights, dst, block2);
+    }
+
+    void blendVertical(const quint16 *row0, const quint16 *row1, quint16 weight,
+                       quint8 *dst, int numPixels) const override
+    {
+        const int block = numPixels / vectorSize;
+        const int block2 = numPixels % vectorSize;
+
+        const uint_v vWeight1(weight);
+        const uint_v vWeight0(256u - weight);
+        const uint_v vRounding(0x8000u);
+
+        for (int i = 0; i < block; i++) {
+            const uint_v vRow0 = xsimd::load_and_extend<uint_v>(row0);
+            const uint_v vRow1 = xsimd::load_and_extend<uint_v>(row1);
+
+            storeNarrowed((vRow0 * vWeight0 + vRow1 * vWeight1 + vRounding) >> 16, dst);
+
+            row0 += vectorSize;
+            row1 += vectorSize;
+            dst += vectorSize;
+        }
+
+        blendVerticalScalar(row0, row1, weight, dst, block2);
+    }
+
+    void resampleAffine(const quint8 *src, int srcStride,
+                        int width, int height,
+                        float x, float y, float dx, float dy,
+                        quint8 *dst, int numPixels) const override
+    {
+        const int block = numPixels / vectorSize;
+        const int block2 = numPixels % vectorSize;
+
+        const float_v vIndices = xsimd::detail::make_sequence_as_batch<float_v>();
+
+        // see a comment in resampleAffineScalar()
+        const float_v vX(x + 0.5f);
+        const float_v vY(y + 0.5f);
+        const float_v vDx(dx);
+        const float_v vDy(dy);
+        const float_v vHalf(0.5f);
+
+        const int_v vZero(0);
+        const int_v vMaxX(width);
+        const int_v vMaxY(height);
+        const int_v vStride(srcStride);
+
+        for (int i = 0; i < block; i++) {
+            const float_v vI = vIndices + float_v(static_cast<float>(i * vectorSize));
+
+            const float_v vSrcX = vX + vI * vDx;
+            const float_v vSrcY = vY + vI * vDy;
+
+            const float_v vFloorX = xsimd::floor(vSrcX);
+            const float_v vFloorY = xsimd::floor(vSrcY);
+
+            int_v vX0 = xsimd::to_int(vFloorX);
+            int_v vY0 = xsimd::to_int(vFloorY);
+
+            const auto outside = (vX0 < vZero) | (vX0 > vMaxX) | (vY0 < vZero) | (vY0 > vMaxY);
+
+            if (xsimd::all(outside)) {
+                std::memset(dst, 0, vectorSize);
+                dst += vectorSize;
+                continue;
+            }
+
+            // keep the excluded lanes inside the mask
+            vX0 = xsimd::select(outside, vZero, vX0);
+            vY0 = xsimd::select(outside, vZero, vY0);
+
+            const int_v vOffsets = vY0 * vStride + vX0;
+
+            int_v vTopLeft;
+            int_v vTopRight;
+            int_v vBottomLeft;
+            int_v vBottomRight;
+
+            gatherPair(src, vOffsets, vTopLeft, vTopRight);
+            gatherPair(src + srcStride, vOffsets, vBottomLeft, vBottomRight);
+
+            const float_v vFx = vSrcX - vFloorX;
+            const float_v vFy = vSrcY - vFloorY;
+
+            const float_v vTop = xsimd::to_float(vTopLeft) +
+                vFx * xsimd::to_float(vTopRight - vTopLeft);
+            const float_v vBottom = xsimd::to_float(vBottomLeft) +
+                vFx * xsimd::to_float(vBottomRight - vBottomLeft);
+
+            int_v vResult = xsimd::to_int(vTop + vFy * (vBottom - vTop) + vHalf);
+            vResult = xsimd::select(outside, vZero, vResult);
+
+            storeNarrowed(vResult, dst);
+
+            dst += vectorSize;
+        }
+
+        const float offset = static_cast<float>(block * vectorSize);
+
+        resampleAffineScalar(src, srcStride, width, height,
+                             x + offset * dx, y + offset * dy, dx, dy,
+                             dst, block2);
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KISALPHAMASKRESAMPLER_H
@@ -0,0 +1,74 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAlphaMaskResamplerBase.h"
+
+#include <cmath>
+
+KisAlphaMaskResamplerBase::~KisAlphaMaskResamplerBase()
+{
+}
+
+void KisAlphaMaskResamplerBase::resampleHorizontalScalar(const quint8 *srcRow,
+                                                         const qint32 *offsets, const quint16 *weights,
+                                                         quint16 *dst, int numPixels)
+{
+    for (int i = 0; i < numPixels; i++) {
+        const quint8 *src = srcRow + offsets[i];
+        const quint32 w = weights[i];
+
+        dst[i] = quint16(src[0] * (256 - w) + src[1] * w);
+    }
+}
+
+void KisAlphaMaskResamplerBase::blendVerticalScalar(const quint16 *row0, const quint16 *row1, quint16 weight,
+                                                    quint8 *dst, int numPixels)
+{
+    const quint32 w1 = weight;
+    const quint32 w0 = 256 - w1;
+
+    for (int i = 0; i < numPixels; i++) {
+        dst[i] = quint8((row0[i] * w0 + row1[i] * w1 + 0x8000) >> 16);
+    }
+}
+
+void KisAlphaMaskResamplerBase::resampleAffineScalar(const quint8 *src, int srcStride,
+                                                     int width, int height,
+                                                     float x, float y, float dx, float dy,
+                                                     quint8 *dst, int numPixels)
+{
+    // the bilinear filter samples the pixels of the bordered
+    // mask around (x + 0.5, y + 0.5)
+    x += 0.5f;
+    y += 0.5f;
+
+    for (int i = 0; i < numPixels; i++) {
+        const float sx = x + i * dx;
+        const float sy = y + i * dy;
+
+        const float floorX = std::floor(sx);
+        const float floorY = std::floor(sy);
+
+        const int x0 = int(floorX);
+        const int y0 = int(floorY);
+
+        if (x0 < 0 || x0 > width || y0 < 0 || y0 > height) {
+            dst[i] = 0;
+            continue;
+        }
+
+        const float fx = sx - floorX;
+        const float fy = sy - floorY;
+
+        const quint8 *p0 = src + y0 * srcStride + x0;
+        const quint8 *p1 = p0 + srcStride;
+
+        const float top = p0[0] + fx * (p0[1] - p0[0]);
+        const float bottom = p1[0] + fx * (p1[1] - p1[0]);
+
+        dst[i] = quint8(top + fy * (bottom - top) + 0.5f);
+    }
+}
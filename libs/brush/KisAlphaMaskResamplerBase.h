@@ -0,0 +1,72 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISALPHAMASKRESAMPLERBASE_H
+#define KISALPHAMASKRESAMPLERBASE_H
+
+#include <QtGlobal>
+
+#include <kritabrush_export.h>
+
+/**
+ * The per-arch kernels of KisAlphaMaskPyramid. All the kernels
+ * sample the source mask with a bilinear filter.
+ *
+ * The source mask is an 8-bit mask surrounded by a border of one
+ * zero pixel, so the samples falling outside the mask fade out
+ * smoothly the same way they do in KisQImagePyramid.
+ */
+class BRUSH_EXPORT KisAlphaMaskResamplerBase
+{
+public:
+    virtual ~KisAlphaMaskResamplerBase();
+
+    /**
+     * The horizontal pass of the separable filter. The i-th output
+     * pixel is interpolated between srcRow[offsets[i]] and
+     * srcRow[offsets[i] + 1] with the weight weights[i] / 256 of the
+     * latter one. The result is stored in 8.8 fixed point format.
+     */
+    virtual void resampleHorizontal(const quint8 *srcRow,
+                                    const qint32 *offsets, const quint16 *weights,
+                                    quint16 *dst, int numPixels) const = 0;
+
+    /**
+     * The vertical pass of the separable filter. Blends two rows
+     * generated by resampleHorizontal() with the weight \p weight / 256
+     * of \p row1.
+     */
+    virtual void blendVertical(const quint16 *row0, const quint16 *row1, quint16 weight,
+                               quint8 *dst, int numPixels) const = 0;
+
+    /**
+     * Samples a row of a mask under arbitrary affine transformation
+     * (e.g. rotation). The i-th output pixel is sampled at
+     * (x + i * dx, y + i * dy) in the coordinates of the source mask
+     * of size \p width x \p height, where the center of its top-left
+     * pixel is (0.5, 0.5). \p src points to the top-left pixel of the
+     * border.
+     */
+    virtual void resampleAffine(const quint8 *src, int srcStride,
+                                int width, int height,
+                                float x, float y, float dx, float dy,
+                                quint8 *dst, int numPixels) const = 0;
+
+protected:
+    static void resampleHorizontalScalar(const quint8 *srcRow,
+                                         const qint32 *offsets, const quint16 *weights,
+                                         quint16 *dst, int numPixels);
+
+    static void blendVerticalScalar(const quint16 *row0, const quint16 *row1, quint16 weight,
+                                    quint8 *dst, int numPixels);
+
+    static void resampleAffineScalar(const quint8 *src, int srcStride,
+                                     int width, int height,
+                                     float x, float y, float dx, float dy,
+                                     quint8 *dst, int numPixels);
+};
+
+#endif // KISALPHAMASKRESAMPLERBASE_H
@@ -0,0 +1,15 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAlphaMaskResamplerFactoryImpl.h"
+
+#include "KisAlphaMaskResampler.h"
+
+template<>
+KisAlphaMaskResamplerBase *KisAlphaMaskResamplerFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KisAlphaMaskResampler<xsimd::current_arch>();
+}
@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISALPHAMASKRESAMPLERFACTORYIMPL_H
+#define KISALPHAMASKRESAMPLERFACTORYIMPL_H
+
+#include <KoMultiArchBuildSupport.h>
+
+class KisAlphaMaskResamplerBase;
+
+struct KisAlphaMaskResamplerFactoryImpl {
+    template<typename _impl>
+    static KisAlphaMaskResamplerBase* create();
+};
+
+#endif // KISALPHAMASKRESAMPLERFACTORYIMPL_H
@@ -0,0 +1,69 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBrushOutlineCache.h"
+
+#include <QCache>
+#include <QGlobalStatic>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace {
+
+/**
+ * The cost of an entry is the number of its points, so
+ * the cache takes about 4 MiB at most
+ */
+struct OutlineCache
+{
+    static const int maxCostPoints = 256 * 1024;
+
+    OutlineCache() : cache(maxCostPoints) {}
+
+    QMutex mutex;
+    QCache<QByteArray, KisOptimizedBrushOutline> cache;
+};
+
+Q_GLOBAL_STATIC(OutlineCache, s_outlineCache)
+
+}
+
+KisOptimizedBrushOutline KisBrushOutlineCache::fetchOutline(const QByteArray &key, TraceFunction traceFunction)
+{
+    if (key.isEmpty()) {
+        return traceFunction();
+    }
+
+    {
+        QMutexLocker l(&s_outlineCache->mutex);
+        KisOptimizedBrushOutline *cachedOutline = s_outlineCache->cache.object(key);
+        if (cachedOutline) {
+            return *cachedOutline;
+        }
+    }
+
+    KisOptimizedBrushOutline outline = traceFunction();
+
+    // the bounding rect is requested on every cursor move, so
+    // precalculate it to let all the copies share the result
+    (void) outline.boundingRect();
+
+    int cost = 0;
+    for (auto it = outline.begin(); it != outline.end(); ++it) {
+        cost += it->size();
+    }
+
+    QMutexLocker l(&s_outlineCache->mutex);
+    s_outlineCache->cache.insert(key, new KisOptimizedBrushOutline(outline), qMax(1, cost));
+
+    return outline;
+}
+
+void KisBrushOutlineCache::clear()
+{
+    QMutexLocker l(&s_outlineCache->mutex);
+    s_outlineCache->cache.clear();
+}
@@ -0,0 +1,48 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBRUSHOUTLINECACHE_H
+#define KISBRUSHOUTLINECACHE_H
+
+#include <functional>
+
+#include <QByteArray>
+
+#include <KisOptimizedBrushOutline.h>
+#include <kritabrush_export.h>
+
+/**
+ * A process-wide LRU cache of the brush outlines traced with
+ * KisBoundary.
+ *
+ * The outline of a brush is traced at the unit scale and rotation of
+ * the brush, the actual scale and rotation of the dab are applied to
+ * the traced outline as a transformation in KisCurrentOutlineFetcher.
+ * Therefore, the traced outline depends only on the shape of the brush
+ * tip and can be shared by all the brushes with the same tip, e.g. by
+ * the brushes recreated from the preset every time its settings change.
+ *
+ * \see KisBrush::outlineCacheKey()
+ */
+class BRUSH_EXPORT KisBrushOutlineCache
+{
+public:
+    using TraceFunction = std::function<KisOptimizedBrushOutline()>;
+
+    /**
+     * Returns the outline cached under \p key or traces it with
+     * \p traceFunction and caches the result. An empty key disables
+     * the caching.
+     */
+    static KisOptimizedBrushOutline fetchOutline(const QByteArray &key, TraceFunction traceFunction);
+
+    /**
+     * Drops all the cached outlines
+     */
+    static void clear();
+};
+
+#endif // KISBRUSHOUTLINECACHE_H
@@ -0,0 +1,230 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTransformedTipCache.h"
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadStorage>
+
+#include <functional>
+
+#include <kis_qimage_pyramid.h>
+#include <KisAlphaMaskPyramid.h>
+
+namespace {
+
+/**
+ * The cost of an entry is its size in kilobytes, so the cache
+ * keeps about a hundred of 400x400 px tips.
+ */
+struct TipCache
+{
+    static const int maxCostKiB = 64 * 1024;
+
+    TipCache() : cache(maxCostKiB) {}
+
+    QMutex mutex;
+    QCache<QByteArray, QImage> cache;
+};
+
+Q_GLOBAL_STATIC(TipCache, s_tipCache)
+
+/**
+ * Set by ExactTipsGuard for the thread that renders the dabs
+ * on the highest precision level
+ */
+Q_GLOBAL_STATIC(QThreadStorage<bool>, s_exactTips)
+
+/**
+ * The number of the quantization steps per pixel of the dab. The edge
+ * of the quantized dab moves by less than 1 / (2 * stepsPerPixel).
+ */
+const int stepsPerPixel = 4;
+
+/**
+ * The type of the cached tip, the pyramids of the same brush
+ * share the content key
+ */
+enum TipType : qint32
+{
+    ImageTip,
+    AlphaMaskTip
+};
+
+struct QuantizedParams
+{
+    qint32 type;
+    qint32 scale;
+    qint32 ratio;
+    qint32 rotation;
+    qint32 subPixelX;
+    qint32 subPixelY;
+};
+
+struct ExactParams
+{
+    qint32 type;
+    qint32 padding;
+    qreal scale;
+    qreal ratio;
+    qreal rotation;
+    qreal subPixelX;
+    qreal subPixelY;
+};
+
+QImage fetchOrCreateImage(const QByteArray &key,
+                          std::function<QImage()> createImage)
+{
+    {
+        QMutexLocker l(&s_tipCache->mutex);
+        QImage *cachedImage = s_tipCache->cache.object(key);
+        if (cachedImage) {
+            return *cachedImage;
+        }
+    }
+
+    const QImage image = createImage();
+
+    const int cost = qMax(1, int(image.sizeInBytes() / 1024));
+
+    QMutexLocker l(&s_tipCache->mutex);
+    s_tipCache->cache.insert(key, new QImage(image), cost);
+
+    return image;
+}
+
+template<class Pyramid>
+QImage createCachedImage(const Pyramid &pyramid, TipType type,
+                         KisDabShape const &shape,
+                         qreal subPixelX, qreal subPixelY)
+{
+    const QByteArray contentKey = pyramid.cacheKey();
+    if (contentKey.isEmpty()) {
+        return pyramid.createImage(shape, subPixelX, subPixelY);
+    }
+
+    if (s_exactTips->localData()) {
+        /**
+         * The exact keys have a different size, so they never
+         * collide with the quantized ones
+         */
+        ExactParams params;
+        params.type = type;
+        params.padding = 0;
+        params.scale = shape.scale();
+        params.ratio = shape.ratio();
+        params.rotation = qIsNaN(shape.rotation()) ? 0.0 : shape.rotation();
+        params.subPixelX = subPixelX;
+        params.subPixelY = subPixelY;
+
+        QByteArray key = contentKey;
+        key.append(reinterpret_cast<const char*>(&params), sizeof(params));
+
+        return fetchOrCreateImage(key,
+            [&] () { return pyramid.createImage(shape, subPixelX, subPixelY); });
+    }
+
+    const QSize originalSize = pyramid.originalSize();
+    const int originalDimension = qMax(1, qMax(originalSize.width(), originalSize.height()));
+
+    QuantizedParams params;
+    params.type = type;
+
+    // the scale step changes the size of the dab by 1 / stepsPerPixel
+    const qreal scaleSteps = stepsPerPixel * originalDimension;
+    params.scale = qMax(1, qRound(shape.scale() * scaleSteps));
+    const qreal scale = params.scale / scaleSteps;
+
+    // the ratio and rotation steps move the edges of the dab
+    // by less than 1 / stepsPerPixel
+    const qreal dabSteps = stepsPerPixel * qMax(1.0, scale * originalDimension);
+
+    params.ratio = qMax(1, qRound(shape.ratio() * dabSteps));
+    const qreal ratio = params.ratio / dabSteps;
+
+    const qreal rotationStep = 1.0 / dabSteps;
+    params.rotation = qIsNaN(shape.rotation()) ? 0 : qRound(shape.rotation() / rotationStep);
+
+    params.subPixelX = qRound(subPixelX * stepsPerPixel);
+    params.subPixelY = qRound(subPixelY * stepsPerPixel);
+
+    const qreal rotation = params.rotation * rotationStep;
+
+    const KisDabShape quantizedShape(scale, ratio, rotation);
+    const qreal quantizedSubPixelX = qreal(params.subPixelX) / stepsPerPixel;
+    const qreal quantizedSubPixelY = qreal(params.subPixelY) / stepsPerPixel;
+
+    /**
+     * The paintops expect the dab to be exactly of the size reported
+     * by KisBrush::maskWidth() and KisBrush::maskHeight(), so the
+     * (rare) dabs whose size is changed by the quantization are
+     * rendered directly.
+     */
+    if (KisQImagePyramid::imageSize(originalSize, quantizedShape, quantizedSubPixelX, quantizedSubPixelY) !=
+        KisQImagePyramid::imageSize(originalSize, shape, subPixelX, subPixelY)) {
+
+        return pyramid.createImage(shape, subPixelX, subPixelY);
+    }
+
+    QByteArray key = contentKey;
+    key.append(reinterpret_cast<const char*>(&params), sizeof(params));
+
+    return fetchOrCreateImage(key,
+        [&] () { return pyramid.createImage(quantizedShape, quantizedSubPixelX, quantizedSubPixelY); });
+}
+
+}
+
+KisTransformedTipCache::ExactTipsGuard::ExactTipsGuard(bool enabled)
+    : m_oldValue(s_exactTips->localData())
+{
+    s_exactTips->setLocalData(m_oldValue || enabled);
+}
+
+KisTransformedTipCache::ExactTipsGuard::~ExactTipsGuard()
+{
+    s_exactTips->setLocalData(m_oldValue);
+}
+
+QByteArray KisTransformedTipCache::contentKey(const QImage &image)
+{
+    if (image.isNull()) return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+
+    const qint32 header[] = {image.width(), image.height(), qint32(image.format())};
+    hash.addData(reinterpret_cast<const char*>(header), sizeof(header));
+
+    const int bytesPerLine = image.bytesPerLine();
+    for (int y = 0; y < image.height(); y++) {
+        hash.addData(reinterpret_cast<const char*>(image.constScanLine(y)), bytesPerLine);
+    }
+
+    return hash.result();
+}
+
+QImage KisTransformedTipCache::createImage(const KisQImagePyramid &pyramid,
+                                           KisDabShape const &shape,
+                                           qreal subPixelX, qreal subPixelY)
+{
+    return createCachedImage(pyramid, ImageTip, shape, subPixelX, subPixelY);
+}
+
+QImage KisTransformedTipCache::createImage(const KisAlphaMaskPyramid &pyramid,
+                                           KisDabShape const &shape,
+                                           qreal subPixelX, qreal subPixelY)
+{
+    return createCachedImage(pyramid, AlphaMaskTip, shape, subPixelX, subPixelY);
+}
+
+void KisTransformedTipCache::clear()
+{
+    QMutexLocker l(&s_tipCache->mutex);
+    s_tipCache->cache.clear();
+}
@@ -0,0 +1,93 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTRANSFORMEDTIPCACHE_H
+#define KISTRANSFORMEDTIPCACHE_H
+
+#include <QByteArray>
+#include <QImage>
+
+#include <kis_dab_shape.h>
+#include <kritabrush_export.h>
+
+class KisQImagePyramid;
+class KisAlphaMaskPyramid;
+
+/**
+ * A process-wide LRU cache of the transformed tips of the image-based
+ * brushes (gbr, png, pipe, svg, text brushes).
+ *
+ * KisDabCache reuses only the last dab generated by the paintop, so
+ * every change of the rotation or the size of the dab makes the brush
+ * transform and resample the tip through QPainter again. This cache keeps
+ * the transformed tips keyed by the content of the tip and the quantized
+ * scale, ratio, rotation and subpixel offset of the dab, so a tip painted
+ * at the same size and angle is reused in the following strokes and by
+ * all the presets sharing the same brush tip.
+ *
+ * The parameters are quantized so that the edge of the dab moves by less
+ * than 1/8 of a pixel, and the tip is always rendered with the quantized
+ * parameters, so the result doesn't depend on whether the tip has been
+ * fetched from the cache or not.
+ *
+ * On the highest precision level the paintops promise the exact dabs, so
+ * they create ExactTipsGuard, which makes the cache render the tips with
+ * the parameters of the dab as they are and key them on the exact values.
+ *
+ * The softness doesn't affect the tips of the image-based brushes, so it
+ * is not a part of the key.
+ *
+ * The opacity masks generated by KisAlphaMaskPyramid are cached as well,
+ * separately from the images of KisQImagePyramid with the same content.
+ */
+class BRUSH_EXPORT KisTransformedTipCache
+{
+public:
+    /**
+     * While the guard exists, the tips requested by the current thread
+     * are not quantized. The guards can be nested.
+     */
+    class BRUSH_EXPORT ExactTipsGuard
+    {
+    public:
+        ExactTipsGuard(bool enabled = true);
+        ~ExactTipsGuard();
+
+    private:
+        Q_DISABLE_COPY(ExactTipsGuard)
+        bool m_oldValue;
+    };
+
+    /**
+     * @return a key identifying the content of \p image, suitable
+     *         for KisQImagePyramid::setCacheKey()
+     */
+    static QByteArray contentKey(const QImage &image);
+
+    /**
+     * Returns the tip of \p pyramid transformed into \p shape. If the
+     * pyramid has no cache key, it is just the same as
+     * KisQImagePyramid::createImage().
+     */
+    static QImage createImage(const KisQImagePyramid &pyramid,
+                              KisDabShape const &shape,
+                              qreal subPixelX, qreal subPixelY);
+
+    /**
+     * The same as above, but for the opacity masks of
+     * KisAlphaMaskPyramid
+     */
+    static QImage createImage(const KisAlphaMaskPyramid &pyramid,
+                              KisDabShape const &shape,
+                              qreal subPixelX, qreal subPixelY);
+
+    /**
+     * Drops all the cached tips
+     */
+    static void clear();
+};
+
+#endif // KISTRANSFORMEDTIPCACHE_H
@@ -13,6 +13,7 @@
 
 #include <QPainterPath>
 #include <QRect>
+#include <QDomDocument>
 #include <QDomElement>
 #include <QtConcurrentMap>
 #include <QByteArray>
@@ -34,6 +35,7 @@
 #include <kis_brush_mask_applicator_base.h>
 #include "kis_algebra_2d.h"
 #include <KisOptimizedBrushOutline.h>
+#include <KisBrushOutlineCache.h>
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <stdlib.h>
@@ -148,6 +150,23 @@ KisFixedPaintDeviceSP KisAutoBrush::outlineSourceImage() const
     return dev;
 }
 
+QByteArray KisAutoBrush::outlineCacheKey() const
+{
+    /**
+     * The outline is traced at the unit scale and with zero
+     * angle (see outlineSourceImage()), so it depends only on
+     * the mask generator and the density/randomness of the mask
+     */
+    QDomDocument doc;
+    QDomElement shapeElt = doc.createElement("MaskGenerator");
+    d->shape->toXML(doc, shapeElt);
+    shapeElt.setAttribute("randomness", QString::number(d->randomness));
+    shapeElt.setAttribute("density", QString::number(d->density));
+    doc.appendChild(shapeElt);
+
+    return QByteArray("auto_brush:") + doc.toByteArray(-1);
+}
+
 qreal KisAutoBrush::userEffectiveSize() const
 {
     return d->shape->diameter();
@@ -431,16 +450,29 @@ KisOptimizedBrushOutline KisAutoBrush::outline(bool forcePreciseOutline) const
 {
     const bool requiresComplexOutline = d->shape->spikes() > 2;
     if (!requiresComplexOutline && !forcePreciseOutline) {
-        QPainterPath path;
-        QRectF brushBoundingbox(0, 0, width(), height());
-        if (maskGenerator()->type() == KisMaskGenerator::CIRCLE) {
-            path.addEllipse(brushBoundingbox);
-        }
-        else { // if (maskGenerator()->type() == KisMaskGenerator::RECTANGLE)
-            path.addRect(brushBoundingbox);
-        }
-
-        return path;
+        const bool isCircle = maskGenerator()->type() == KisMaskGenerator::CIRCLE;
+        const QRectF brushBoundingbox(0, 0, width(), height());
+
+        // flattening of the ellipse is not free either, so
+        // share it between the brushes of the same size
+        const QByteArray key =
+            QString("auto_brush_simple:%1:%2x%3")
+                .arg(isCircle)
+                .arg(brushBoundingbox.width())
+                .arg(brushBoundingbox.height()).toLatin1();
+
+        return KisBrushOutlineCache::fetchOutline(key,
+            [isCircle, brushBoundingbox] () {
+                QPainterPath path;
+                if (isCircle) {
+                    path.addEllipse(brushBoundingbox);
+                }
+                else { // if (maskGenerator()->type() == KisMaskGenerator::RECTANGLE)
+                    path.addRect(brushBoundingbox);
+                }
+
+                return KisOptimizedBrushOutline(path);
+            });
     }
 
     return KisBrush::outline();
@@ -68,6 +68,7 @@ public:
 
     void coldInitBrush() override;
     KisFixedPaintDeviceSP outlineSourceImage() const override;
+    QByteArray outlineCacheKey() const override;
 
 public:
 
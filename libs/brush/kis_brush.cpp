@@ -35,6 +35,8 @@
 #include <brushengine/kis_paint_information.h>
 #include <kis_fixed_paint_device.h>
 #include <kis_qimage_pyramid.h>
+#include <KisAlphaMaskPyramid.h>
+#include <KisTransformedTipCache.h>
 #include <brushengine/kis_paintop_lod_limitations.h>
 #include <resources/KoAbstractGradient.h>
 #include <resources/KoCachedGradient.h>
@@ -42,6 +44,7 @@
 #include <KoResourceServerProvider.h>
 #include <KisLazySharedCacheStorage.h>
 #include <KisOptimizedBrushOutline.h>
+#include <KisBrushOutlineCache.h>
 #include <KisStaticInitializer.h>
 
 
@@ -103,11 +106,15 @@ void KisBrush::PaintDeviceColoringInformation::nextRow()
 
 namespace detail {
 KisOptimizedBrushOutline* outlineFactory(const KisBrush *brush) {
-    KisFixedPaintDeviceSP dev = brush->outlineSourceImage();
+    return new KisOptimizedBrushOutline(
+        KisBrushOutlineCache::fetchOutline(brush->outlineCacheKey(),
+            [brush] () {
+                KisFixedPaintDeviceSP dev = brush->outlineSourceImage();
 
-    KisBoundary boundary(dev);
-    boundary.generateBoundary();
-    return new KisOptimizedBrushOutline(boundary.path());
+                KisBoundary boundary(dev);
+                boundary.generateBoundary();
+                return KisOptimizedBrushOutline(boundary.path());
+            }));
 }
 }
 
@@ -127,8 +134,18 @@ struct KisBrush::Private {
         , threadingAllowed(true)
         , brushPyramid([] (const KisBrush* brush)
                        {
-                           return new KisQImagePyramid(brush->brushTipImage());
+                           const QImage image = brush->brushTipImage();
+                           KisQImagePyramid *pyramid = new KisQImagePyramid(image);
+                           pyramid->setCacheKey(KisTransformedTipCache::contentKey(image));
+                           return pyramid;
                        })
+        , alphaMaskPyramid([] (const KisBrush* brush)
+                           {
+                               const QImage image = brush->brushTipImage();
+                               KisAlphaMaskPyramid *pyramid = new KisAlphaMaskPyramid(image);
+                               pyramid->setCacheKey(KisTransformedTipCache::contentKey(image));
+                               return pyramid;
+                           })
         , brushOutline(&detail::outlineFactory)
 
     {
@@ -160,6 +177,7 @@ struct KisBrush::Private {
            * the objects calls cache.reset().
            */
           brushPyramid(rhs.brushPyramid),
+          alphaMaskPyramid(rhs.alphaMaskPyramid),
           brushOutline(rhs.brushOutline)
     {
         gradient = rhs.gradient;
@@ -171,6 +189,19 @@ struct KisBrush::Private {
     ~Private() {
     }
 
+    /**
+     * The tips applied as a plain alpha mask are resampled by
+     * KisAlphaMaskPyramid, the other modes need the colors
+     * of KisQImagePyramid
+     */
+    void initializePyramid(const KisBrush *brush) {
+        if (brushApplication == ALPHAMASK) {
+            alphaMaskPyramid.initialize(brush);
+        } else {
+            brushPyramid.initialize(brush);
+        }
+    }
+
     enumBrushType brushType;
     enumBrushApplication brushApplication;
 
@@ -191,6 +222,7 @@ struct KisBrush::Private {
 
     QImage brushTipImage;
     mutable KisLazySharedCacheStorageLinked<KisQImagePyramid, const KisBrush*> brushPyramid;
+    mutable KisLazySharedCacheStorageLinked<KisAlphaMaskPyramid, const KisBrush*> alphaMaskPyramid;
     mutable KisLazySharedCacheStorageLinked<KisOptimizedBrushOutline, const KisBrush*> brushOutline;
 };
 
@@ -394,6 +426,12 @@ KisFixedPaintDeviceSP KisBrush::outlineSourceImage() const
     return dev;
 }
 
+QByteArray KisBrush::outlineCacheKey() const
+{
+    const QByteArray contentKey = KisTransformedTipCache::contentKey(brushTipImage());
+    return !contentKey.isEmpty() ? QByteArray("tip:") + contentKey : QByteArray();
+}
+
 bool KisBrush::canPaintFor(const KisPaintInformation& /*info*/)
 {
     return true;
@@ -550,7 +588,7 @@ void KisBrush::notifyBrushIsGoingToBeClonedForStroke()
 {
     /// Default implementation for all image-based brushes:
     /// just recreate the shared pyramid
-    d->brushPyramid.initialize(this);
+    d->initializePyramid(this);
 }
 
 void KisBrush::prepareForSeqNo(const KisPaintInformation &info, int seqNo)
@@ -562,6 +600,7 @@ void KisBrush::prepareForSeqNo(const KisPaintInformation &info, int seqNo)
 void KisBrush::clearBrushPyramid()
 {
     d->brushPyramid.reset();
+    d->alphaMaskPyramid.reset();
 }
 
 void KisBrush::mask(KisFixedPaintDeviceSP dst, const KoColor& color, KisDabShape const& shape, const KisPaintInformation& info, double subPixelX, double subPixelY, qreal softnessFactor, qreal lightnessStrength) const
@@ -595,10 +634,28 @@ void KisBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst,
     Q_UNUSED(info_);
     Q_UNUSED(softnessFactor);
 
-    QImage outputImage = d->brushPyramid.value(this)->createImage(KisDabShape(
-                                                                         shape.scale() * d->scale, shape.ratio(),
-                                                                         -normalizeAngle(shape.rotation() + d->angle)),
-                                                                     subPixelX, subPixelY);
+    const KisDabShape dabShape(shape.scale() * d->scale, shape.ratio(),
+                               -normalizeAngle(shape.rotation() + d->angle));
+
+    /**
+     * When the tip is applied as a plain alpha mask, generate the dab
+     * from the 8-bit mask of KisAlphaMaskPyramid. The colored tips are
+     * converted into the mask a bit differently when colored with a
+     * paint device, so they still go through the generic path.
+     */
+    const bool isPlainColor = dynamic_cast<PlainColoringInformation*>(coloringInformation);
+    const bool isColoredTip = d->brushType == IMAGE || d->brushType == PIPE_IMAGE;
+
+    if (!preserveLightness() &&
+        !(applyingGradient() && d->cachedGradient) &&
+        (isPlainColor || !isColoredTip)) {
+
+        generateDabFromAlphaMask(dst, coloringInformation, dabShape, subPixelX, subPixelY);
+        return;
+    }
+
+    QImage outputImage = KisTransformedTipCache::createImage(*d->brushPyramid.value(this),
+                                                             dabShape, subPixelX, subPixelY);
 
     qint32 maskWidth = outputImage.width();
     qint32 maskHeight = outputImage.height();
@@ -687,6 +744,80 @@ void KisBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst,
 
 }
 
+void KisBrush::generateDabFromAlphaMask(KisFixedPaintDeviceSP dst,
+                                        ColoringInformation* coloringInformation,
+                                        KisDabShape const& dabShape,
+                                        double subPixelX, double subPixelY) const
+{
+    const QImage alphaMask = KisTransformedTipCache::createImage(*d->alphaMaskPyramid.value(this),
+                                                                 dabShape, subPixelX, subPixelY);
+
+    const qint32 maskWidth = alphaMask.width();
+    const qint32 maskHeight = alphaMask.height();
+
+    dst->setRect(QRect(0, 0, maskWidth, maskHeight));
+    dst->lazyGrowBufferWithoutInitialization();
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(coloringInformation);
+
+    const KoColorSpace *cs = dst->colorSpace();
+    const quint32 pixelSize = cs->pixelSize();
+    const quint32 rowSize = maskWidth * pixelSize;
+    quint8 *rowPointer = dst->data();
+
+    quint8* color = 0;
+    if (dynamic_cast<PlainColoringInformation*>(coloringInformation)) {
+        color = const_cast<quint8*>(coloringInformation->color());
+    }
+
+    QScopedPointer<KoColor> fallbackColor;
+
+    if (applyingGradient()) {
+        // the gradient is not set, paint with the same
+        // fallback color as the generic path does
+        fallbackColor.reset(new KoColor(Qt::red, cs));
+        color = fallbackColor->data();
+    }
+
+    /**
+     * fillGrayBrushWithColor() replaces the opacity of the color with
+     * the mask, so prepare a row of opaque pixels and just multiply
+     * it by the mask.
+     */
+    QScopedArrayPointer<quint8> colorRow;
+
+    if (color) {
+        colorRow.reset(new quint8[rowSize]);
+
+        quint8 *pixel = colorRow.data();
+        for (int x = 0; x < maskWidth; x++) {
+            memcpy(pixel, color, pixelSize);
+            pixel += pixelSize;
+        }
+
+        cs->setOpacity(colorRow.data(), OPACITY_OPAQUE_U8, maskWidth);
+    }
+
+    for (int y = 0; y < maskHeight; y++) {
+        if (color) {
+            memcpy(rowPointer, colorRow.data(), rowSize);
+        } else {
+            quint8 *pixel = rowPointer;
+            for (int x = 0; x < maskWidth; x++) {
+                memcpy(pixel, coloringInformation->color(), pixelSize);
+                coloringInformation->nextColumn();
+                pixel += pixelSize;
+            }
+
+            coloringInformation->nextRow();
+        }
+
+        cs->applyAlphaU8Mask(rowPointer, alphaMask.constScanLine(y), maskWidth);
+
+        rowPointer += rowSize;
+    }
+}
+
 KisFixedPaintDeviceSP KisBrush::paintDevice(const KoColorSpace * colorSpace,
                                             KisDabShape const& shape,
                                             const KisPaintInformation& info,
@@ -697,7 +828,7 @@ KisFixedPaintDeviceSP KisBrush::paintDevice(const KoColorSpace * colorSpace,
     double angle = normalizeAngle(shape.rotation() + d->angle);
     double scale = shape.scale() * d->scale;
 
-    QImage outputImage = d->brushPyramid.value(this)->createImage(
+    QImage outputImage = KisTransformedTipCache::createImage(*d->brushPyramid.value(this),
                 KisDabShape(scale, shape.ratio(), -angle), subPixelX, subPixelY);
 
     KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(colorSpace);
@@ -763,6 +894,6 @@ bool KisBrush::supportsCaching() const
 
 void KisBrush::coldInitBrush()
 {
-    d->brushPyramid.initialize(this);
+    d->initializePyramid(this);
     generateOutlineCache();
 }
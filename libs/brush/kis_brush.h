@@ -137,6 +137,14 @@ public:
      */
     virtual KisFixedPaintDeviceSP outlineSourceImage() const;
 
+    /**
+     * A key identifying the content of outlineSourceImage(). The
+     * brushes with the same key share the outline traced by
+     * KisBoundary through KisBrushOutlineCache. An empty key means
+     * the outline is traced for every brush separately.
+     */
+    virtual QByteArray outlineCacheKey() const;
+
 
     /**
      * Change the spacing of the brush.
@@ -383,6 +391,11 @@ protected:
 
 private:
 
+    void generateDabFromAlphaMask(KisFixedPaintDeviceSP dst,
+                                  ColoringInformation* coloringInformation,
+                                  KisDabShape const& dabShape,
+                                  double subPixelX, double subPixelY) const;
+
     struct Private;
     Private* const d;
 
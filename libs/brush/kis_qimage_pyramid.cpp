@@ -334,3 +334,18 @@ QImage KisQImagePyramid::getClosestWithoutWorkaroundBorder(QTransform transform,
                image.width() - 2 * QPAINTER_WORKAROUND_BORDER,
                image.height() - 2 * QPAINTER_WORKAROUND_BORDER);
 }
+
+QSize KisQImagePyramid::originalSize() const
+{
+    return m_originalSize;
+}
+
+void KisQImagePyramid::setCacheKey(const QByteArray &key)
+{
+    m_cacheKey = key;
+}
+
+QByteArray KisQImagePyramid::cacheKey() const
+{
+    return m_cacheKey;
+}
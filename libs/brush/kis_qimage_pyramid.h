@@ -7,6 +7,7 @@
 #ifndef __KIS_QIMAGE_PYRAMID_H
 #define __KIS_QIMAGE_PYRAMID_H
 
+#include <QByteArray>
 #include <QImage>
 #include <QVector>
 #include <kis_dab_shape.h>
@@ -33,8 +34,19 @@ public:
 
     QImage getClosestWithoutWorkaroundBorder(QTransform transform, qreal *scale) const;
 
+    QSize originalSize() const;
+
+    /**
+     * The key identifying the content of the pyramid in
+     * KisTransformedTipCache. The pyramids with an empty key
+     * are never cached.
+     */
+    void setCacheKey(const QByteArray &key);
+    QByteArray cacheKey() const;
+
 private:
     friend class KisGbrBrushTest;
+    friend class KisAlphaMaskPyramid;
     int findNearestLevel(qreal scale, qreal *baseScale) const;
     void appendPyramidLevel(const QImage &image);
 
@@ -52,6 +64,7 @@ private:
 private:
     QSize m_originalSize;
     qreal m_baseScale {0.0};
+    QByteArray m_cacheKey;
 
     struct PyramidLevel {
         PyramidLevel() {}
@@ -0,0 +1,136 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAlphaMaskPyramidTest.h"
+
+#include <KisAlphaMaskPyramid.h>
+#include <kis_qimage_pyramid.h>
+#include <KisTransformedTipCache.h>
+
+#include "KisBrushTipTestingUtils.h"
+
+namespace {
+QImage createTipImage()
+{
+    QRadialGradient gradient(QPointF(40, 30), 35);
+    gradient.setColorAt(0.0, Qt::black);
+    gradient.setColorAt(1.0, Qt::white);
+
+    return KisBrushTipTestingUtils::createTipImage(QSize(97, 61), QRectF(5, 3, 75, 55),
+                                                   gradient, Qt::white);
+}
+
+void addShapes()
+{
+    QTest::addColumn<qreal>("scale");
+    QTest::addColumn<qreal>("ratio");
+    QTest::addColumn<qreal>("rotation");
+    QTest::addColumn<qreal>("subPixel");
+
+    QTest::addRow("identity") << 1.0 << 1.0 << 0.0 << 0.0;
+    QTest::addRow("subpixel") << 1.0 << 1.0 << 0.0 << 0.3;
+    QTest::addRow("downscale") << 0.6 << 1.0 << 0.0 << 0.25;
+    QTest::addRow("downscale-level") << 0.21 << 1.0 << 0.0 << 0.5;
+    QTest::addRow("upscale") << 1.7 << 1.0 << 0.0 << 0.1;
+    QTest::addRow("ratio") << 0.8 << 0.5 << 0.0 << 0.0;
+    QTest::addRow("rotated") << 1.0 << 1.0 << 0.7 << 0.0;
+    QTest::addRow("rotated-downscale") << 0.35 << 1.0 << 2.1 << 0.4;
+    QTest::addRow("rotated-ratio") << 1.3 << 0.6 << 4.0 << 0.75;
+}
+}
+
+void KisAlphaMaskPyramidTest::testMaskSize_data()
+{
+    addShapes();
+}
+
+void KisAlphaMaskPyramidTest::testMaskSize()
+{
+    QFETCH(qreal, scale);
+    QFETCH(qreal, ratio);
+    QFETCH(qreal, rotation);
+    QFETCH(qreal, subPixel);
+
+    const QImage image = createTipImage();
+    KisAlphaMaskPyramid pyramid(image);
+
+    const KisDabShape shape(scale, ratio, rotation);
+    const QImage mask = pyramid.createImage(shape, subPixel, subPixel);
+
+    QCOMPARE(mask.format(), QImage::Format_Alpha8);
+    QCOMPARE(mask.size(), KisQImagePyramid::imageSize(image.size(), shape, subPixel, subPixel));
+}
+
+void KisAlphaMaskPyramidTest::testCompareWithQImagePyramid_data()
+{
+    addShapes();
+}
+
+void KisAlphaMaskPyramidTest::testCompareWithQImagePyramid()
+{
+    QFETCH(qreal, scale);
+    QFETCH(qreal, ratio);
+    QFETCH(qreal, rotation);
+    QFETCH(qreal, subPixel);
+
+    const QImage image = createTipImage();
+    KisAlphaMaskPyramid alphaMaskPyramid(image);
+    KisQImagePyramid imagePyramid(image);
+
+    const KisDabShape shape(scale, ratio, rotation);
+    const QImage mask = alphaMaskPyramid.createImage(shape, subPixel, subPixel);
+    const QImage reference = imagePyramid.createImage(shape, subPixel, subPixel);
+
+    QCOMPARE(mask.size(), reference.size());
+
+    /**
+     * The mipmaps and the filters are not exactly the same as the
+     * ones of QPainter, so compare the average difference only
+     */
+    qint64 totalDifference = 0;
+
+    for (int y = 0; y < mask.height(); y++) {
+        const quint8 *maskPtr = mask.constScanLine(y);
+        const QRgb *referencePtr = reinterpret_cast<const QRgb*>(reference.constScanLine(y));
+
+        for (int x = 0; x < mask.width(); x++) {
+            totalDifference += qAbs(int(maskPtr[x]) - int(KisAlphaMaskPyramid::tipPixelOpacity(referencePtr[x])));
+        }
+    }
+
+    const qreal averageDifference = qreal(totalDifference) / (mask.width() * mask.height());
+    QVERIFY2(averageDifference < 3.0, QString("average difference: %1").arg(averageDifference).toLatin1());
+}
+
+void KisAlphaMaskPyramidTest::testCachedMask()
+{
+    KisTransformedTipCache::clear();
+
+    const QImage image = createTipImage();
+    const QByteArray contentKey = KisTransformedTipCache::contentKey(image);
+
+    KisAlphaMaskPyramid alphaMaskPyramid(image);
+    alphaMaskPyramid.setCacheKey(contentKey);
+
+    KisQImagePyramid imagePyramid(image);
+    imagePyramid.setCacheKey(contentKey);
+
+    // the parameters are on the quantization grid of the cache
+    const KisDabShape shape(0.75, 1.0, 0.0);
+
+    const QImage mask1 = KisTransformedTipCache::createImage(alphaMaskPyramid, shape, 0.25, 0.5);
+    const QImage mask2 = KisTransformedTipCache::createImage(alphaMaskPyramid, shape, 0.25, 0.5);
+    QCOMPARE(mask1.cacheKey(), mask2.cacheKey());
+
+    // the pyramids share the content key, but not the cached tips
+    const QImage tip = KisTransformedTipCache::createImage(imagePyramid, shape, 0.25, 0.5);
+    QCOMPARE(mask1.format(), QImage::Format_Alpha8);
+    QCOMPARE(tip.format(), QImage::Format_ARGB32);
+
+    KisTransformedTipCache::clear();
+}
+
+SIMPLE_TEST_MAIN(KisAlphaMaskPyramidTest)
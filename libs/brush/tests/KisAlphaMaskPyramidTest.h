@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISALPHAMASKPYRAMIDTEST_H
+#define KISALPHAMASKPYRAMIDTEST_H
+
+#include <simpletest.h>
+
+class KisAlphaMaskPyramidTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testMaskSize_data();
+    void testMaskSize();
+
+    void testCompareWithQImagePyramid_data();
+    void testCompareWithQImagePyramid();
+
+    void testCachedMask();
+};
+
+#endif // KISALPHAMASKPYRAMIDTEST_H
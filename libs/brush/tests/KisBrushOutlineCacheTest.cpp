@@ -0,0 +1,119 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBrushOutlineCacheTest.h"
+
+#include <QPainterPath>
+
+#include <simpletest.h>
+
+#include <KisBrushOutlineCache.h>
+#include <KisOptimizedBrushOutline.h>
+#include <kis_auto_brush.h>
+#include <kis_mask_generator.h>
+
+namespace {
+KisBrushSP createSpikedBrush(qreal diameter)
+{
+    return KisBrushSP(new KisAutoBrush(new KisCircleMaskGenerator(diameter, 1.0, 1.0, 1.0, 5, true), 0.0, 0.0));
+}
+
+QVector<QPolygonF> polygons(const KisOptimizedBrushOutline &outline)
+{
+    QVector<QPolygonF> result;
+    for (auto it = outline.begin(); it != outline.end(); ++it) {
+        result.append(*it);
+    }
+    return result;
+}
+}
+
+void KisBrushOutlineCacheTest::testSharedBetweenBrushes()
+{
+    KisBrushOutlineCache::clear();
+
+    KisBrushSP brush1 = createSpikedBrush(30);
+    KisBrushSP brush2 = createSpikedBrush(30);
+    KisBrushSP brush3 = createSpikedBrush(40);
+
+    QCOMPARE(brush1->outlineCacheKey(), brush2->outlineCacheKey());
+    QVERIFY(brush1->outlineCacheKey() != brush3->outlineCacheKey());
+
+    const KisOptimizedBrushOutline outline1 = brush1->outline(true);
+    const KisOptimizedBrushOutline outline2 = brush2->outline(true);
+    const KisOptimizedBrushOutline outline3 = brush3->outline(true);
+
+    QVERIFY(!outline1.isEmpty());
+    QCOMPARE(polygons(outline1), polygons(outline2));
+    QVERIFY(outline1.boundingRect().width() < outline3.boundingRect().width());
+}
+
+void KisBrushOutlineCacheTest::testTraceOnlyOnce()
+{
+    KisBrushOutlineCache::clear();
+
+    int numTraces = 0;
+
+    auto traceFunction = [&numTraces] () {
+        numTraces++;
+
+        QPainterPath path;
+        path.addEllipse(QRectF(0, 0, 20, 10));
+        return KisOptimizedBrushOutline(path);
+    };
+
+    const KisOptimizedBrushOutline outline1 = KisBrushOutlineCache::fetchOutline("test-key", traceFunction);
+    const KisOptimizedBrushOutline outline2 = KisBrushOutlineCache::fetchOutline("test-key", traceFunction);
+
+    QCOMPARE(numTraces, 1);
+    QCOMPARE(polygons(outline1), polygons(outline2));
+
+    // an empty key disables the caching
+    KisBrushOutlineCache::fetchOutline(QByteArray(), traceFunction);
+    KisBrushOutlineCache::fetchOutline(QByteArray(), traceFunction);
+
+    QCOMPARE(numTraces, 3);
+}
+
+void KisBrushOutlineCacheTest::testMappedOutline()
+{
+    QPainterPath path;
+    path.addEllipse(QRectF(0, 0, 30, 10));
+    path.addRect(QRectF(5, 5, 50, 3));
+
+    QTransform transform;
+    transform.translate(100, 50);
+    transform.rotate(33);
+    transform.scale(1.5, 0.7);
+
+    const KisOptimizedBrushOutline outline = KisOptimizedBrushOutline(path).mapped(transform);
+    const QList<QPolygonF> referencePolygons = transform.map(path).toSubpathPolygons();
+
+    const QVector<QPolygonF> mappedPolygons = polygons(outline);
+    QCOMPARE(mappedPolygons.size(), referencePolygons.size());
+
+    QRectF referenceBounds;
+
+    for (int i = 0; i < mappedPolygons.size(); i++) {
+        QCOMPARE(mappedPolygons[i].size(), referencePolygons[i].size());
+
+        for (int j = 0; j < mappedPolygons[i].size(); j++) {
+            QVERIFY(qAbs(mappedPolygons[i][j].x() - referencePolygons[i][j].x()) < 1e-6);
+            QVERIFY(qAbs(mappedPolygons[i][j].y() - referencePolygons[i][j].y()) < 1e-6);
+        }
+
+        referenceBounds |= referencePolygons[i].boundingRect();
+    }
+
+    const QRectF bounds = outline.boundingRect();
+
+    QVERIFY(qAbs(bounds.left() - referenceBounds.left()) < 1e-6);
+    QVERIFY(qAbs(bounds.top() - referenceBounds.top()) < 1e-6);
+    QVERIFY(qAbs(bounds.right() - referenceBounds.right()) < 1e-6);
+    QVERIFY(qAbs(bounds.bottom() - referenceBounds.bottom()) < 1e-6);
+}
+
+SIMPLE_TEST_MAIN(KisBrushOutlineCacheTest)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBRUSHOUTLINECACHETEST_H
+#define KISBRUSHOUTLINECACHETEST_H
+
+#include <simpletest.h>
+
+class KisBrushOutlineCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSharedBetweenBrushes();
+    void testTraceOnlyOnce();
+    void testMappedOutline();
+};
+
+#endif // KISBRUSHOUTLINECACHETEST_H
@@ -0,0 +1,38 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBRUSHTIPTESTINGUTILS_H
+#define KISBRUSHTIPTESTINGUTILS_H
+
+#include <QBrush>
+#include <QImage>
+#include <QPainter>
+
+namespace KisBrushTipTestingUtils {
+
+/**
+ * Creates an ARGB32 brush tip of \p size with an antialiased ellipse
+ * inscribed into \p ellipseRect and filled with \p brush
+ */
+inline QImage createTipImage(const QSize &size, const QRectF &ellipseRect,
+                             const QBrush &brush, const QColor &background = Qt::transparent)
+{
+    QImage image(size, QImage::Format_ARGB32);
+    image.fill(background);
+
+    QPainter gc(&image);
+    gc.setRenderHints(QPainter::Antialiasing);
+    gc.setBrush(brush);
+    gc.setPen(Qt::NoPen);
+    gc.drawEllipse(ellipseRect);
+    gc.end();
+
+    return image;
+}
+
+}
+
+#endif // KISBRUSHTIPTESTINGUTILS_H
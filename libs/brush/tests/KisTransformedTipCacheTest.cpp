@@ -0,0 +1,111 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTransformedTipCacheTest.h"
+
+#include <kis_qimage_pyramid.h>
+#include <KisTransformedTipCache.h>
+
+#include "KisBrushTipTestingUtils.h"
+
+namespace {
+QImage createTipImage(const QColor &color)
+{
+    return KisBrushTipTestingUtils::createTipImage(QSize(64, 48), QRectF(4, 4, 40, 36), color);
+}
+}
+
+void KisTransformedTipCacheTest::testContentKey()
+{
+    const QImage image1 = createTipImage(Qt::black);
+    const QImage image2 = createTipImage(Qt::black);
+    const QImage image3 = createTipImage(Qt::gray);
+
+    QVERIFY(!KisTransformedTipCache::contentKey(image1).isEmpty());
+    QCOMPARE(KisTransformedTipCache::contentKey(image1), KisTransformedTipCache::contentKey(image2));
+    QVERIFY(KisTransformedTipCache::contentKey(image1) != KisTransformedTipCache::contentKey(image3));
+    QVERIFY(KisTransformedTipCache::contentKey(QImage()).isEmpty());
+}
+
+void KisTransformedTipCacheTest::testReuseQuantizedTip()
+{
+    KisTransformedTipCache::clear();
+
+    const QImage image = createTipImage(Qt::black);
+
+    // two separate pyramids, like the ones of two presets sharing the tip
+    KisQImagePyramid pyramid1(image);
+    pyramid1.setCacheKey(KisTransformedTipCache::contentKey(image));
+
+    KisQImagePyramid pyramid2(image);
+    pyramid2.setCacheKey(KisTransformedTipCache::contentKey(image));
+
+    // the parameters are exactly on the quantization grid, so the
+    // tip has exactly the requested size
+    const KisDabShape shape(0.75, 1.0, 0.5);
+
+    const QImage tip1 = KisTransformedTipCache::createImage(pyramid1, shape, 0.25, 0.5);
+    const QImage tip2 = KisTransformedTipCache::createImage(pyramid2, KisDabShape(0.7500001, 1.0, 0.5000001), 0.2500001, 0.5);
+
+    QCOMPARE(tip1.size(), KisQImagePyramid::imageSize(image.size(), shape, 0.25, 0.5));
+
+    // the second tip is fetched from the cache
+    QCOMPARE(tip1.cacheKey(), tip2.cacheKey());
+
+    const QImage tip3 = KisTransformedTipCache::createImage(pyramid1, KisDabShape(0.75, 1.0, 1.5), 0.25, 0.5);
+    QVERIFY(tip1.cacheKey() != tip3.cacheKey());
+
+    KisTransformedTipCache::clear();
+}
+
+void KisTransformedTipCacheTest::testUncachedPyramid()
+{
+    const QImage image = createTipImage(Qt::black);
+    KisQImagePyramid pyramid(image);
+
+    const KisDabShape shape(0.7, 1.0, 0.5);
+
+    const QImage tip1 = KisTransformedTipCache::createImage(pyramid, shape, 0.25, 0.5);
+    const QImage tip2 = KisTransformedTipCache::createImage(pyramid, shape, 0.25, 0.5);
+
+    QCOMPARE(tip1, pyramid.createImage(shape, 0.25, 0.5));
+    QVERIFY(tip1.cacheKey() != tip2.cacheKey());
+}
+
+void KisTransformedTipCacheTest::testExactTips()
+{
+    KisTransformedTipCache::clear();
+
+    const QImage image = createTipImage(Qt::black);
+    KisQImagePyramid pyramid(image);
+    pyramid.setCacheKey(KisTransformedTipCache::contentKey(image));
+
+    const KisDabShape shape(0.7, 1.0, 0.51);
+
+    {
+        KisTransformedTipCache::ExactTipsGuard guard;
+
+        const QImage tip1 = KisTransformedTipCache::createImage(pyramid, shape, 0.3, 0.6);
+        const QImage tip2 = KisTransformedTipCache::createImage(pyramid, shape, 0.3, 0.6);
+
+        QCOMPARE(tip1, pyramid.createImage(shape, 0.3, 0.6));
+
+        // the exact tips are cached as well
+        QCOMPARE(tip1.cacheKey(), tip2.cacheKey());
+
+        const QImage tip3 = KisTransformedTipCache::createImage(pyramid, shape, 0.3000001, 0.6);
+        QVERIFY(tip1.cacheKey() != tip3.cacheKey());
+    }
+
+    // the guard is reset when it goes out of scope, so the tips are quantized again
+    const QImage tip1 = KisTransformedTipCache::createImage(pyramid, KisDabShape(0.75, 1.0, 0.5), 0.25, 0.5);
+    const QImage tip2 = KisTransformedTipCache::createImage(pyramid, KisDabShape(0.7500001, 1.0, 0.5000001), 0.2500001, 0.5);
+    QCOMPARE(tip1.cacheKey(), tip2.cacheKey());
+
+    KisTransformedTipCache::clear();
+}
+
+SIMPLE_TEST_MAIN(KisTransformedTipCacheTest)
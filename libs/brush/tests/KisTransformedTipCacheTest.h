@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTRANSFORMEDTIPCACHETEST_H
+#define KISTRANSFORMEDTIPCACHETEST_H
+
+#include <simpletest.h>
+
+class KisTransformedTipCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testContentKey();
+    void testReuseQuantizedTip();
+    void testUncachedPyramid();
+    void testExactTips();
+};
+
+#endif // KISTRANSFORMEDTIPCACHETEST_H
@@ -0,0 +1,428 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFastGaussianBlur.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <QBitArray>
+#include <QRect>
+#include <QVarLengthArray>
+#include <QtConcurrent>
+
+#include <KoColorSpace.h>
+#include <KoChannelInfo.h>
+#include <KoUpdater.h>
+
+#include "kis_paint_device.h"
+#include "kis_default_bounds.h"
+#include "kis_math_toolbox.h"
+
+
+namespace {
+
+/**
+ * The strips are aligned to the tiles of the device, so that
+ * the parallel jobs never write into the same tile
+ */
+const int STRIP_SIZE = 64;
+
+/**
+ * Converts the blurred channels of a pixel into floats and back,
+ * premultiplying the color channels by alpha the same way
+ * KisConvolutionWorkerSpatial does
+ */
+struct PixelConverter
+{
+    bool init(const KoColorSpace *cs, const QBitArray &channelFlags)
+    {
+        const QBitArray flags =
+            channelFlags.isEmpty() ? QBitArray(cs->channelCount(), true) : channelFlags;
+
+        const QList<KoChannelInfo *> allChannels = cs->channels();
+        for (int i = 0; i < allChannels.size(); i++) {
+            if (flags.testBit(i)) {
+                channels.append(allChannels[i]);
+            }
+        }
+
+        const int numChannels = channels.size();
+
+        toDouble.resize(numChannels);
+        fromDouble.resize(numChannels);
+
+        KisMathToolbox mathToolbox;
+        if (!mathToolbox.getToDoubleChannelPtr(channels, toDouble) ||
+            !mathToolbox.getFromDoubleChannelPtr(channels, fromDouble)) {
+
+            return false;
+        }
+
+        for (int k = 0; k < numChannels; k++) {
+            positions.append(channels[k]->pos());
+            minValues.append(mathToolbox.minChannelValue(channels[k]));
+            maxValues.append(mathToolbox.maxChannelValue(channels[k]));
+
+            if (channels[k]->channelType() == KoChannelInfo::ALPHA) {
+                alphaIndex = k;
+            }
+        }
+
+        return true;
+    }
+
+    int numChannels() const {
+        return channels.size();
+    }
+
+    inline void toFloat(const quint8 *pixel, float *dst) const
+    {
+        const double alpha = alphaIndex >= 0 ? toDouble[alphaIndex](pixel, positions[alphaIndex]) : 1.0;
+
+        for (int k = 0; k < channels.size(); k++) {
+            dst[k] = k == alphaIndex ? alpha : toDouble[k](pixel, positions[k]) * alpha;
+        }
+    }
+
+    inline void fromFloat(const float *src, quint8 *pixel) const
+    {
+        if (alphaIndex >= 0) {
+            const double alpha = store(alphaIndex, src[alphaIndex], pixel);
+            const double alphaInv = alpha > 0.0 ? 1.0 / alpha : 0.0;
+
+            for (int k = 0; k < channels.size(); k++) {
+                if (k == alphaIndex) continue;
+                store(k, src[k] * alphaInv, pixel);
+            }
+        } else {
+            for (int k = 0; k < channels.size(); k++) {
+                store(k, src[k], pixel);
+            }
+        }
+    }
+
+private:
+    inline double store(int k, double value, quint8 *pixel) const
+    {
+        // the running sums may drift a bit out of the range
+        if (minValues[k] < maxValues[k]) {
+            value = qBound(minValues[k], value, maxValues[k]);
+        }
+
+        fromDouble[k](pixel, positions[k], value);
+        return value;
+    }
+
+public:
+    QList<KoChannelInfo *> channels;
+    QVector<int> positions;
+    QVector<PtrToDouble> toDouble;
+    QVector<PtrFromDouble> fromDouble;
+    QVector<double> minValues;
+    QVector<double> maxValues;
+    int alphaIndex = -1;
+};
+
+/**
+ * Applies the box blurs of \p radii to the line \p src of \p length
+ * pixels of \p numChannels floats. Every pass shrinks the line by the
+ * diameter of its box, so the result has the length of \p length minus
+ * the doubled sum of the radii. \p tmp should have the same size as
+ * \p src, both buffers are overwritten.
+ *
+ * \return the pointer to the result, either \p src or \p tmp
+ */
+float* boxBlurLine(float *src, float *tmp, int length, int numChannels, const QVector<int> &radii)
+{
+    float *in = src;
+    float *out = tmp;
+
+    QVarLengthArray<double, 8> sums(numChannels);
+
+    Q_FOREACH (int radius, radii) {
+        if (radius <= 0) continue;
+
+        const int window = 2 * radius + 1;
+        const int outLength = length - 2 * radius;
+        const double norm = 1.0 / window;
+
+        for (int c = 0; c < numChannels; c++) {
+            double sum = 0.0;
+            for (int j = 0; j < window; j++) {
+                sum += in[j * numChannels + c];
+            }
+            sums[c] = sum;
+        }
+
+        for (int i = 0; i < outLength; i++) {
+            float *outPixel = out + i * numChannels;
+
+            for (int c = 0; c < numChannels; c++) {
+                outPixel[c] = sums[c] * norm;
+            }
+
+            if (i + 1 < outLength) {
+                const float *addedPixel = in + (i + window) * numChannels;
+                const float *removedPixel = in + i * numChannels;
+
+                for (int c = 0; c < numChannels; c++) {
+                    sums[c] += addedPixel[c] - removedPixel[c];
+                }
+            }
+        }
+
+        std::swap(in, out);
+        length = outLength;
+    }
+
+    return in;
+}
+
+QVector<QRect> splitIntoStrips(const QRect &rc, Qt::Orientation orientation, int origin)
+{
+    QVector<QRect> strips;
+
+    if (orientation == Qt::Horizontal) {
+        int y = rc.top();
+        while (y <= rc.bottom()) {
+            const int nextY = qMin(rc.bottom() + 1,
+                                   origin + (int(std::floor(qreal(y - origin) / STRIP_SIZE)) + 1) * STRIP_SIZE);
+            strips.append(QRect(rc.left(), y, rc.width(), nextY - y));
+            y = nextY;
+        }
+    } else {
+        int x = rc.left();
+        while (x <= rc.right()) {
+            const int nextX = qMin(rc.right() + 1,
+                                   origin + (int(std::floor(qreal(x - origin) / STRIP_SIZE)) + 1) * STRIP_SIZE);
+            strips.append(QRect(x, rc.top(), nextX - x, rc.height()));
+            x = nextX;
+        }
+    }
+
+    return strips;
+}
+
+/**
+ * Blurs the rows (\p orientation == Qt::Horizontal) or the columns of
+ * \p strip of \p src and writes the result into the same area of \p dst.
+ * The pixels outside \p clampRect are taken from its border.
+ */
+void blurStrip(KisPaintDeviceSP src, KisPaintDeviceSP dst,
+               const QRect &strip, Qt::Orientation orientation,
+               const QRect &clampRect, const QVector<int> &radii,
+               const PixelConverter &converter)
+{
+    const bool horizontal = orientation == Qt::Horizontal;
+
+    int margin = 0;
+    Q_FOREACH (int radius, radii) {
+        margin += radius;
+    }
+
+    const QRect readRect =
+        (horizontal ?
+             strip.adjusted(-margin, 0, margin, 0) :
+             strip.adjusted(0, -margin, 0, margin)) & clampRect;
+
+    const int pixelSize = src->pixelSize();
+    const int numChannels = converter.numChannels();
+
+    QVector<quint8> srcBuffer(readRect.width() * readRect.height() * pixelSize);
+    src->readBytes(srcBuffer.data(), readRect);
+
+    QVector<quint8> dstBuffer(strip.width() * strip.height() * pixelSize);
+
+    const int lineLength = horizontal ? strip.width() : strip.height();
+    const int numLines = horizontal ? strip.height() : strip.width();
+    const int extendedLength = lineLength + 2 * margin;
+
+    QVector<float> line(extendedLength * numChannels);
+    QVector<float> tmp(extendedLength * numChannels);
+
+    auto srcPixel = [&] (int x, int y) {
+        x = qBound(readRect.left(), x, readRect.right());
+        y = qBound(readRect.top(), y, readRect.bottom());
+
+        return srcBuffer.constData() +
+            ((y - readRect.top()) * readRect.width() + x - readRect.left()) * pixelSize;
+    };
+
+    for (int l = 0; l < numLines; l++) {
+        for (int i = 0; i < extendedLength; i++) {
+            const int offset = i - margin;
+
+            const quint8 *pixel = horizontal ?
+                srcPixel(strip.left() + offset, strip.top() + l) :
+                srcPixel(strip.left() + l, strip.top() + offset);
+
+            converter.toFloat(pixel, line.data() + i * numChannels);
+        }
+
+        const float *result = boxBlurLine(line.data(), tmp.data(), extendedLength, numChannels, radii);
+
+        for (int i = 0; i < lineLength; i++) {
+            const int x = horizontal ? i : l;
+            const int y = horizontal ? l : i;
+
+            quint8 *dstPixel = dstBuffer.data() + (y * strip.width() + x) * pixelSize;
+
+            // the channels that are not blurred keep their original values
+            memcpy(dstPixel, srcPixel(strip.left() + x, strip.top() + y), pixelSize);
+            converter.fromFloat(result + i * numChannels, dstPixel);
+        }
+    }
+
+    dst->writeBytes(dstBuffer.constData(), strip);
+}
+
+}
+
+qreal KisFastGaussianBlur::radiusThreshold()
+{
+    /**
+     * The sigma of the Gaussian for this radius is about 10px. For
+     * such sigmas the stacked boxes are virtually indistinguishable
+     * from the real Gaussian, and the convolution is already slower.
+     */
+    return 32.0;
+}
+
+QVector<int> KisFastGaussianBlur::boxRadii(qreal sigma)
+{
+    const int numBoxes = 3;
+
+    QVector<int> radii(numBoxes, 0);
+    if (sigma <= 0.0) return radii;
+
+    /**
+     * Chooses the widths of the boxes from two consecutive odd
+     * numbers, so that the variance of the stack of boxes
+     * (sum of (w^2 - 1) / 12) is the closest to sigma^2
+     */
+    const qreal variance = 12.0 * sigma * sigma;
+    const qreal idealWidth = std::sqrt(variance / numBoxes + 1.0);
+
+    int lowerWidth = int(std::floor(idealWidth));
+    if (lowerWidth % 2 == 0) lowerWidth--;
+    lowerWidth = qMax(1, lowerWidth);
+
+    const int upperWidth = lowerWidth + 2;
+
+    const int numLowerBoxes =
+        qRound((variance - numBoxes * lowerWidth * lowerWidth - 4 * numBoxes * lowerWidth - 3 * numBoxes) /
+               (-4.0 * lowerWidth - 4.0));
+
+    for (int i = 0; i < numBoxes; i++) {
+        radii[i] = ((i < numLowerBoxes ? lowerWidth : upperWidth) - 1) / 2;
+    }
+
+    return radii;
+}
+
+bool KisFastGaussianBlur::apply(KisPaintDeviceSP device,
+                                const QRect &rect,
+                                qreal xSigma, qreal ySigma,
+                                const QBitArray &channelFlags,
+                                KoUpdater *progressUpdater,
+                                KisConvolutionBorderOp borderOp)
+{
+    return applyBoxes(device, rect, boxRadii(xSigma), boxRadii(ySigma),
+                      channelFlags, progressUpdater, borderOp);
+}
+
+bool KisFastGaussianBlur::applyBoxes(KisPaintDeviceSP device,
+                                     const QRect &rect,
+                                     const QVector<int> &xRadii,
+                                     const QVector<int> &yRadii,
+                                     const QBitArray &channelFlags,
+                                     KoUpdater *progressUpdater,
+                                     KisConvolutionBorderOp borderOp)
+{
+    PixelConverter converter;
+    if (!converter.init(device->colorSpace(), channelFlags)) {
+        return false;
+    }
+
+    if (rect.isEmpty() || converter.numChannels() == 0) {
+        return true;
+    }
+
+    int xMargin = 0;
+    Q_FOREACH (int radius, xRadii) {
+        xMargin += radius;
+    }
+
+    int yMargin = 0;
+    Q_FOREACH (int radius, yRadii) {
+        yMargin += radius;
+    }
+
+    /**
+     * The same data rect as KisConvolutionPainter uses for
+     * BORDER_REPEAT, in the wraparound mode the device wraps
+     * the pixels itself.
+     */
+    QRect clampRect = rect.adjusted(-xMargin, -yMargin, xMargin, yMargin);
+
+    if (borderOp == BORDER_REPEAT && !device->defaultBounds()->wrapAroundMode()) {
+        const QRect boundsRect = device->defaultBounds()->bounds();
+        clampRect = rect | boundsRect;
+
+        if (boundsRect == KisDefaultBounds().bounds()) {
+            clampRect = rect | device->exactBounds();
+        }
+    }
+
+    const bool blurRows = xMargin > 0;
+    const bool blurColumns = yMargin > 0;
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(0);
+    }
+
+    KisPaintDeviceSP rowsResult = device;
+
+    if (blurRows) {
+        /**
+         * When the columns are blurred as well, the blurred rows are
+         * needed for the whole vertical extent of the column boxes
+         */
+        QRect rowsRect = rect;
+        if (blurColumns) {
+            rowsResult = new KisPaintDevice(device->colorSpace());
+            rowsResult->prepareClone(device);
+            rowsRect = rect.adjusted(0, -yMargin, 0, yMargin) & clampRect;
+        }
+
+        QVector<QRect> strips = splitIntoStrips(rowsRect, Qt::Horizontal, device->y());
+
+        QtConcurrent::blockingMap(strips,
+            [&] (const QRect &strip) {
+                blurStrip(device, rowsResult, strip, Qt::Horizontal, clampRect, xRadii, converter);
+            });
+    }
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(50);
+    }
+
+    if (blurColumns) {
+        QVector<QRect> strips = splitIntoStrips(rect, Qt::Vertical, device->x());
+
+        QtConcurrent::blockingMap(strips,
+            [&] (const QRect &strip) {
+                blurStrip(rowsResult, device, strip, Qt::Vertical, clampRect, yRadii, converter);
+            });
+    }
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(100);
+    }
+
+    return true;
+}
@@ -0,0 +1,78 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFASTGAUSSIANBLUR_H
+#define KISFASTGAUSSIANBLUR_H
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+#include "kis_convolution_painter.h"
+
+#include <QVector>
+
+class QBitArray;
+class QRect;
+class KoUpdater;
+
+/**
+ * Approximates the Gaussian blur with three stacked box blurs. Every
+ * box blur is calculated with a running sum, so the cost per pixel
+ * doesn't depend on the radius, which makes it much faster than the
+ * convolution for the radii of hundreds of pixels, common for glows
+ * and drop shadows. For small radii the approximation is too coarse,
+ * so KisGaussianKernel::applyGaussian() switches to it only starting
+ * from radiusThreshold().
+ *
+ * The rows and the columns are blurred in tile-aligned strips, which
+ * are processed in parallel.
+ */
+class KRITAIMAGE_EXPORT KisFastGaussianBlur
+{
+public:
+    /**
+     * The minimal radius (as passed to KisGaussianKernel) the
+     * approximation is used for
+     */
+    static qreal radiusThreshold();
+
+    /**
+     * The radii of the three box blurs, whose stack has the variance
+     * closest to \p sigma squared
+     */
+    static QVector<int> boxRadii(qreal sigma);
+
+    /**
+     * Blurs \p rect of \p device with the Gaussian with the standard
+     * deviations of \p xSigma and \p ySigma. Zero sigma means no blur
+     * along the corresponding axis. The alpha channel and \p borderOp
+     * are handled the same way as in KisConvolutionPainter.
+     *
+     * \return false if the color space of the device has a channel
+     *         type that is not supported; the device is not changed
+     *         in this case
+     */
+    static bool apply(KisPaintDeviceSP device,
+                      const QRect &rect,
+                      qreal xSigma, qreal ySigma,
+                      const QBitArray &channelFlags,
+                      KoUpdater *progressUpdater,
+                      KisConvolutionBorderOp borderOp = BORDER_REPEAT);
+
+    /**
+     * The same as apply(), but blurs with the stacks of the box blurs
+     * of the explicitly given radii. The blur reaches as far as the
+     * sum of the radii along every axis.
+     */
+    static bool applyBoxes(KisPaintDeviceSP device,
+                           const QRect &rect,
+                           const QVector<int> &xRadii,
+                           const QVector<int> &yRadii,
+                           const QBitArray &channelFlags,
+                           KoUpdater *progressUpdater,
+                           KisConvolutionBorderOp borderOp = BORDER_REPEAT);
+};
+
+#endif // KISFASTGAUSSIANBLUR_H
@@ -0,0 +1,189 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAARWAVELETKERNEL_H
+#define KISHAARWAVELETKERNEL_H
+
+#include <type_traits>
+
+#include <KoMultiArchBuildSupport.h>
+
+#include "KisHaarWaveletKernelBase.h"
+
+template<typename _impl, typename EnableDummyType = void>
+struct KisWaveletVectorOps
+{
+    static void sumDifference(const float *a, const float *b,
+                              float *sum, float *diff,
+                              int numValues, float scale)
+    {
+        for (int i = 0; i < numValues; i++) {
+            const float x = a[i];
+            const float y = b[i];
+            sum[i] = (x + y) * scale;
+            diff[i] = (x - y) * scale;
+        }
+    }
+
+    static void softThreshold(float *values, int numValues, float threshold)
+    {
+        for (int i = 0; i < numValues; i++) {
+            const float x = values[i];
+            values[i] =
+                x > threshold ? x - threshold :
+                x < -threshold ? x + threshold : 0.0f;
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+template<typename _impl>
+struct KisWaveletVectorOps<_impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+{
+    using float_v = xsimd::batch<float, _impl>;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+    static void sumDifference(const float *a, const float *b,
+                              float *sum, float *diff,
+                              int numValues, float scale)
+    {
+        const float_v vScale(scale);
+        int i = 0;
+
+        for (; i + vectorSize <= numValues; i += vectorSize) {
+            const float_v x = float_v::load_unaligned(a + i);
+            const float_v y = float_v::load_unaligned(b + i);
+            ((x + y) * vScale).store_unaligned(sum + i);
+            ((x - y) * vScale).store_unaligned(diff + i);
+        }
+
+        KisWaveletVectorOps<xsimd::generic>::sumDifference(a + i, b + i, sum + i, diff + i,
+                                                           numValues - i, scale);
+    }
+
+    static void softThreshold(float *values, int numValues, float threshold)
+    {
+        const float_v t(threshold);
+        const float_v zero(0.0f);
+        int i = 0;
+
+        for (; i + vectorSize <= numValues; i += vectorSize) {
+            const float_v x = float_v::load_unaligned(values + i);
+            xsimd::select(x > t, x - t,
+                          xsimd::select(x < -t, x + t, zero)).store_unaligned(values + i);
+        }
+
+        KisWaveletVectorOps<xsimd::generic>::softThreshold(values + i, numValues - i, threshold);
+    }
+};
+
+#endif // HAVE_XSIMD
+
+/**
+ * The pixels of the row are interleaved, so the horizontal step
+ * is specialized for the common channel counts to let the compiler
+ * unroll the inner loop and vectorize it where possible. The
+ * depth of 0 means that the channel count is known at runtime only.
+ */
+template<int staticDepth>
+struct KisWaveletPairOps
+{
+    static void splitPairs(const float *src, float *sum, float *diff,
+                           int numPairs, int runtimeDepth, float scale)
+    {
+        const int depth = staticDepth > 0 ? staticDepth : runtimeDepth;
+
+        for (int j = 0; j < numPairs; j++) {
+            for (int k = 0; k < depth; k++) {
+                const float x = src[k];
+                const float y = src[depth + k];
+                sum[k] = (x + y) * scale;
+                diff[k] = (x - y) * scale;
+            }
+            src += 2 * depth;
+            sum += depth;
+            diff += depth;
+        }
+    }
+
+    static void mergePairs(const float *sum, const float *diff, float *dst,
+                           int numPairs, int runtimeDepth, float scale)
+    {
+        const int depth = staticDepth > 0 ? staticDepth : runtimeDepth;
+
+        for (int j = 0; j < numPairs; j++) {
+            for (int k = 0; k < depth; k++) {
+                const float s = sum[k];
+                const float d = diff[k];
+                dst[k] = (s + d) * scale;
+                dst[depth + k] = (s - d) * scale;
+            }
+            dst += 2 * depth;
+            sum += depth;
+            diff += depth;
+        }
+    }
+};
+
+template<typename _impl>
+class KisHaarWaveletKernel : public KisHaarWaveletKernelBase
+{
+public:
+    void sumDifference(const float *a, const float *b,
+                       float *sum, float *diff,
+                       int numValues, float scale) const override
+    {
+        KisWaveletVectorOps<_impl>::sumDifference(a, b, sum, diff, numValues, scale);
+    }
+
+    void splitPairs(const float *src, float *sum, float *diff,
+                    int numPairs, int depth, float scale) const override
+    {
+        switch (depth) {
+        case 1:
+            KisWaveletPairOps<1>::splitPairs(src, sum, diff, numPairs, depth, scale);
+            break;
+        case 3:
+            KisWaveletPairOps<3>::splitPairs(src, sum, diff, numPairs, depth, scale);
+            break;
+        case 4:
+            KisWaveletPairOps<4>::splitPairs(src, sum, diff, numPairs, depth, scale);
+            break;
+        default:
+            KisWaveletPairOps<0>::splitPairs(src, sum, diff, numPairs, depth, scale);
+            break;
+        }
+    }
+
+    void mergePairs(const float *sum, const float *diff, float *dst,
+                    int numPairs, int depth, float scale) const override
+    {
+        switch (depth) {
+        case 1:
+            KisWaveletPairOps<1>::mergePairs(sum, diff, dst, numPairs, depth, scale);
+            break;
+        case 3:
+            KisWaveletPairOps<3>::mergePairs(sum, diff, dst, numPairs, depth, scale);
+            break;
+        case 4:
+            KisWaveletPairOps<4>::mergePairs(sum, diff, dst, numPairs, depth, scale);
+            break;
+        default:
+            KisWaveletPairOps<0>::mergePairs(sum, diff, dst, numPairs, depth, scale);
+            break;
+        }
+    }
+
+    void softThreshold(float *values, int numValues, float threshold) const override
+    {
+        KisWaveletVectorOps<_impl>::softThreshold(values, numValues, threshold);
+    }
+};
+
+#endif // KISHAARWAVELETKERNEL_H
@@ -0,0 +1,61 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAARWAVELETKERNELBASE_H
+#define KISHAARWAVELETKERNELBASE_H
+
+#include "kritaimage_export.h"
+
+/**
+ * The inner loops of the Haar wavelet transform of KisMathToolbox.
+ *
+ * Every level of the transform is split into a horizontal and a
+ * vertical step. Each step replaces a pair of samples (a, b) with
+ * their sum and difference, multiplied by a scale, i.e. it is the
+ * predict/update pair of the lifting scheme of the Haar wavelet.
+ *
+ * The samples are the interleaved color channels of the pixels, so
+ * the vertical step works on two contiguous rows and is vectorized
+ * over the whole row, while the horizontal step combines the
+ * neighbouring pixels of the same row.
+ */
+class KRITAIMAGE_EXPORT KisHaarWaveletKernelBase
+{
+public:
+    virtual ~KisHaarWaveletKernelBase();
+
+    /**
+     * sum[i] = (a[i] + b[i]) * scale, diff[i] = (a[i] - b[i]) * scale
+     * for \p numValues values. \p a and \p b may alias \p sum and \p diff.
+     */
+    virtual void sumDifference(const float *a, const float *b,
+                               float *sum, float *diff,
+                               int numValues, float scale) const = 0;
+
+    /**
+     * Splits a row of 2 * \p numPairs pixels of \p depth channels
+     * into the scaled sums and differences of the pixel pairs.
+     * The buffers must not alias each other.
+     */
+    virtual void splitPairs(const float *src, float *sum, float *diff,
+                            int numPairs, int depth, float scale) const = 0;
+
+    /**
+     * The inverse of splitPairs(): merges the sums and the differences
+     * of \p numPairs pixels back into a row of 2 * \p numPairs pixels.
+     * The buffers must not alias each other.
+     */
+    virtual void mergePairs(const float *sum, const float *diff, float *dst,
+                            int numPairs, int depth, float scale) const = 0;
+
+    /**
+     * Shrinks \p numValues values towards zero by \p threshold, the
+     * values with the magnitude below the threshold become zero.
+     */
+    virtual void softThreshold(float *values, int numValues, float threshold) const = 0;
+};
+
+#endif // KISHAARWAVELETKERNELBASE_H
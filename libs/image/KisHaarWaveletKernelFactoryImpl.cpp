@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHaarWaveletKernelFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisHaarWaveletKernel.h"
+
+template<typename _impl>
+KisHaarWaveletKernelBase *KisHaarWaveletKernelFactoryImpl::create()
+{
+    return new KisHaarWaveletKernel<_impl>();
+}
+
+template KisHaarWaveletKernelBase *KisHaarWaveletKernelFactoryImpl::create<xsimd::current_arch>();
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAARWAVELETKERNELFACTORYIMPL_H
+#define KISHAARWAVELETKERNELFACTORYIMPL_H
+
+#include <KoMultiArchBuildSupport.h>
+#include "kritaimage_export.h"
+
+class KisHaarWaveletKernelBase;
+
+class KRITAIMAGE_EXPORT KisHaarWaveletKernelFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisHaarWaveletKernelBase *create();
+};
+
+#endif // KISHAARWAVELETKERNELFACTORYIMPL_H
@@ -0,0 +1,624 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisMorphology.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <QBitArray>
+#include <QRect>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+#include <KoColorSpace.h>
+#include <KoChannelInfo.h>
+#include <KoUpdater.h>
+
+#include "kis_paint_device.h"
+#include "kis_default_bounds.h"
+
+
+namespace {
+
+/**
+ * The strips are aligned to the tiles of the device, so that
+ * the parallel jobs never write into the same tile
+ */
+const int STRIP_SIZE = 64;
+
+/**
+ * A line structuring element of 2 * radius + 1 pixels,
+ * horizontal or vertical
+ */
+struct Pass
+{
+    Qt::Orientation orientation;
+    int radius;
+
+    int xMargin() const {
+        return orientation == Qt::Horizontal ? radius : 0;
+    }
+
+    int yMargin() const {
+        return orientation == Qt::Vertical ? radius : 0;
+    }
+};
+
+/**
+ * A rectangle of the half-sides xRadius and yRadius, the
+ * ellipses are unions of such rectangles
+ */
+struct Span
+{
+    int xRadius;
+    int yRadius;
+};
+
+typedef void (*LineFunc)(const quint8 *line, quint8 *result,
+                         int length, int radius,
+                         int pixelSize, int channelPos,
+                         quint8 *forward, quint8 *backward);
+
+typedef void (*CombineFunc)(const quint8 *src, quint8 *dst,
+                            int length,
+                            int pixelSize, int channelPos);
+
+/**
+ * Van Herk/Gil-Werman algorithm: the line is split into blocks of
+ * the window size, \p forward keeps the running extremum from the
+ * start of every block, \p backward from its end. Every window
+ * covers the end of one block and the start of the next one, so
+ * its extremum is combined from the two values.
+ *
+ * \p line has \p length + 2 * \p radius pixels, the result is
+ * written into \p length pixels of \p result.
+ */
+template <typename T, bool isMax>
+void processLine(const quint8 *line, quint8 *result,
+                 int length, int radius,
+                 int pixelSize, int channelPos,
+                 quint8 *forward, quint8 *backward)
+{
+    const int window = 2 * radius + 1;
+    const int extendedLength = length + 2 * radius;
+
+    T *g = reinterpret_cast<T*>(forward);
+    T *h = reinterpret_cast<T*>(backward);
+
+    auto value = [=] (int i) {
+        return *reinterpret_cast<const T*>(line + i * pixelSize + channelPos);
+    };
+
+    auto op = [] (T a, T b) {
+        return isMax ? (a < b ? b : a) : (b < a ? b : a);
+    };
+
+    for (int i = 0; i < extendedLength; i++) {
+        g[i] = i % window == 0 ? value(i) : op(g[i - 1], value(i));
+    }
+
+    for (int i = extendedLength - 1; i >= 0; i--) {
+        h[i] = i == extendedLength - 1 || (i + 1) % window == 0 ? value(i) : op(h[i + 1], value(i));
+    }
+
+    for (int i = 0; i < length; i++) {
+        *reinterpret_cast<T*>(result + i * pixelSize + channelPos) = op(h[i], g[i + 2 * radius]);
+    }
+}
+
+/**
+ * Merges the extrema of \p src into \p dst
+ */
+template <typename T, bool isMax>
+void combineLine(const quint8 *src, quint8 *dst,
+                 int length,
+                 int pixelSize, int channelPos)
+{
+    for (int i = 0; i < length; i++) {
+        const T a = *reinterpret_cast<const T*>(src + i * pixelSize + channelPos);
+        T &b = *reinterpret_cast<T*>(dst + i * pixelSize + channelPos);
+        b = isMax ? (b < a ? a : b) : (a < b ? a : b);
+    }
+}
+
+struct ChannelProcessor
+{
+    LineFunc func;
+    CombineFunc combine;
+    int pos;
+};
+
+template <bool isMax>
+ChannelProcessor channelProcessor(KoChannelInfo::enumChannelValueType type, int pos)
+{
+    switch (type) {
+    case KoChannelInfo::UINT8:
+        return {processLine<quint8, isMax>, combineLine<quint8, isMax>, pos};
+    case KoChannelInfo::INT8:
+        return {processLine<qint8, isMax>, combineLine<qint8, isMax>, pos};
+    case KoChannelInfo::UINT16:
+        return {processLine<quint16, isMax>, combineLine<quint16, isMax>, pos};
+    case KoChannelInfo::INT16:
+        return {processLine<qint16, isMax>, combineLine<qint16, isMax>, pos};
+    case KoChannelInfo::UINT32:
+        return {processLine<quint32, isMax>, combineLine<quint32, isMax>, pos};
+#ifdef HAVE_OPENEXR
+    case KoChannelInfo::FLOAT16:
+        return {processLine<half, isMax>, combineLine<half, isMax>, pos};
+#endif
+    case KoChannelInfo::FLOAT32:
+        return {processLine<float, isMax>, combineLine<float, isMax>, pos};
+    case KoChannelInfo::FLOAT64:
+        return {processLine<double, isMax>, combineLine<double, isMax>, pos};
+    default:
+        return {nullptr, nullptr, pos};
+    }
+}
+
+QVector<QRect> splitIntoStrips(const QRect &rc, Qt::Orientation orientation, int origin, int stripSize)
+{
+    QVector<QRect> strips;
+
+    if (orientation == Qt::Horizontal) {
+        int y = rc.top();
+        while (y <= rc.bottom()) {
+            const int nextY = qMin(rc.bottom() + 1,
+                                   origin + (int(std::floor(qreal(y - origin) / stripSize)) + 1) * stripSize);
+            strips.append(QRect(rc.left(), y, rc.width(), nextY - y));
+            y = nextY;
+        }
+    } else {
+        int x = rc.left();
+        while (x <= rc.right()) {
+            const int nextX = qMin(rc.right() + 1,
+                                   origin + (int(std::floor(qreal(x - origin) / stripSize)) + 1) * stripSize);
+            strips.append(QRect(x, rc.top(), nextX - x, rc.height()));
+            x = nextX;
+        }
+    }
+
+    return strips;
+}
+
+/**
+ * The scratch buffers of a strip and the line operations on them
+ */
+struct LineProcessor
+{
+    LineProcessor(int pixelSize, int maxLength, int maxRadius,
+                  const QVector<ChannelProcessor> &processors)
+        : pixelSize(pixelSize),
+          processors(processors),
+          line((maxLength + 2 * maxRadius) * pixelSize),
+          result(maxLength * pixelSize),
+          // the scratch buffers for the largest channel type
+          forward((maxLength + 2 * maxRadius) * sizeof(double)),
+          backward((maxLength + 2 * maxRadius) * sizeof(double))
+    {
+    }
+
+    /**
+     * Fills the line with \p length + 2 * \p radius pixels returned by
+     * \p pixel and writes \p length processed pixels into result
+     */
+    template <typename PixelFunc>
+    void process(int length, int radius, PixelFunc pixel) {
+        const int extendedLength = length + 2 * radius;
+
+        for (int i = 0; i < extendedLength; i++) {
+            memcpy(line.data() + i * pixelSize, pixel(i - radius), pixelSize);
+        }
+
+        // the channels that are not processed keep their original values
+        memcpy(result.data(), line.constData() + radius * pixelSize, length * pixelSize);
+
+        Q_FOREACH (const ChannelProcessor &processor, processors) {
+            processor.func(line.constData(), result.data(),
+                           length, radius,
+                           pixelSize, processor.pos,
+                           forward.data(), backward.data());
+        }
+    }
+
+    const int pixelSize;
+    const QVector<ChannelProcessor> &processors;
+    QVector<quint8> line;
+    QVector<quint8> result;
+    QVector<quint8> forward;
+    QVector<quint8> backward;
+};
+
+/**
+ * Processes all the lines of \p pass crossing \p strip of \p src and
+ * writes the result into the same area of \p dst. The pixels outside
+ * \p clampRect are taken from its border.
+ */
+void processStrip(KisPaintDeviceSP src, KisPaintDeviceSP dst,
+                  const QRect &strip, const Pass &pass,
+                  const QRect &clampRect,
+                  const QVector<ChannelProcessor> &processors)
+{
+    const QRect readRect =
+        strip.adjusted(-pass.xMargin(), -pass.yMargin(), pass.xMargin(), pass.yMargin()) & clampRect;
+
+    const int pixelSize = src->pixelSize();
+
+    QVector<quint8> srcBuffer(readRect.width() * readRect.height() * pixelSize);
+    src->readBytes(srcBuffer.data(), readRect);
+
+    QVector<quint8> dstBuffer(strip.width() * strip.height() * pixelSize);
+
+    LineProcessor processor(pixelSize, qMax(strip.width(), strip.height()), pass.radius, processors);
+
+    auto srcPixel = [&] (int x, int y) {
+        x = qBound(readRect.left(), x, readRect.right());
+        y = qBound(readRect.top(), y, readRect.bottom());
+
+        return srcBuffer.constData() +
+            ((y - readRect.top()) * readRect.width() + x - readRect.left()) * pixelSize;
+    };
+
+    if (pass.orientation == Qt::Horizontal) {
+        for (int y = strip.top(); y <= strip.bottom(); y++) {
+            processor.process(strip.width(), pass.radius,
+                              [&] (int i) { return srcPixel(strip.left() + i, y); });
+
+            memcpy(dstBuffer.data() + (y - strip.top()) * strip.width() * pixelSize,
+                   processor.result.constData(),
+                   strip.width() * pixelSize);
+        }
+    } else {
+        for (int x = strip.left(); x <= strip.right(); x++) {
+            processor.process(strip.height(), pass.radius,
+                              [&] (int i) { return srcPixel(x, strip.top() + i); });
+
+            for (int i = 0; i < strip.height(); i++) {
+                memcpy(dstBuffer.data() + (i * strip.width() + x - strip.left()) * pixelSize,
+                       processor.result.constData() + i * pixelSize,
+                       pixelSize);
+            }
+        }
+    }
+
+    dst->writeBytes(dstBuffer.constData(), strip);
+}
+
+/**
+ * Processes \p strip of \p src with the union of \p spans and writes the
+ * result into the same area of \p dst. The pixels outside \p clampRect
+ * are taken from its border.
+ *
+ * Every span is a vertical line followed by a horizontal one. The spans
+ * come in the order of growing heights, so the vertical extrema of every
+ * column are computed once and updated from one height to the next: the
+ * window of 2 * h + 1 pixels is covered by the two windows of the
+ * previous height h' shifted by h - h', if h - h' <= h'. Only when the
+ * height jumps further, the column is processed with a full line. The
+ * horizontal lines read the extrema of their span, their results are
+ * merged.
+ */
+void processEllipseStrip(KisPaintDeviceSP src, KisPaintDeviceSP dst,
+                         const QRect &strip, const QVector<Span> &spans,
+                         int xRadius, int yRadius,
+                         const QRect &clampRect,
+                         const QVector<ChannelProcessor> &processors)
+{
+    const QRect readRect = strip.adjusted(-xRadius, -yRadius, xRadius, yRadius) & clampRect;
+
+    const int pixelSize = src->pixelSize();
+
+    QVector<quint8> srcBuffer(readRect.width() * readRect.height() * pixelSize);
+    src->readBytes(srcBuffer.data(), readRect);
+
+    // the columns, which the horizontal lines may read
+    const int left = qMax(strip.left() - xRadius, readRect.left());
+    const int right = qMin(strip.right() + xRadius, readRect.right());
+    const int columns = right - left + 1;
+
+    /**
+     * The vertical extrema of every column for the rows from
+     * strip.top() - yRadius to strip.bottom() + yRadius. For the
+     * height h only the rows from strip.top() - (yRadius - h) to
+     * strip.bottom() + (yRadius - h) are valid, which is enough
+     * to get all the following heights.
+     */
+    const int columnLength = strip.height() + 2 * yRadius;
+    QVector<quint8> columnBuffer(columns * columnLength * pixelSize);
+    QVector<quint8> dstBuffer(strip.width() * strip.height() * pixelSize);
+
+    LineProcessor processor(pixelSize, qMax(strip.width(), columnLength), qMax(xRadius, yRadius), processors);
+
+    auto srcPixel = [&] (int x, int y) {
+        x = qBound(readRect.left(), x, readRect.right());
+        y = qBound(readRect.top(), y, readRect.bottom());
+
+        return srcBuffer.constData() +
+            ((y - readRect.top()) * readRect.width() + x - readRect.left()) * pixelSize;
+    };
+
+    auto column = [&] (int x) {
+        return columnBuffer.data() + (x - left) * columnLength * pixelSize;
+    };
+
+    auto columnPixel = [&] (int x, int y) {
+        x = qBound(left, x, right);
+
+        return column(x) + (y - strip.top() + yRadius) * pixelSize;
+    };
+
+    int prevHeight = -1;
+
+    for (int k = 0; k < spans.size(); k++) {
+        const Span &span = spans[k];
+
+        const int height = span.yRadius;
+        const int shift = height - prevHeight;
+        const int length = columnLength - 2 * height;
+
+        for (int x = left; x <= right; x++) {
+            quint8 *extrema = column(x);
+
+            if (prevHeight < 0 || shift > prevHeight) {
+                processor.process(length, height,
+                                  [&] (int i) { return srcPixel(x, strip.top() - yRadius + height + i); });
+            } else {
+                // the center keeps the original values of the channels that are not processed
+                memcpy(processor.result.data(), extrema + height * pixelSize, length * pixelSize);
+
+                Q_FOREACH (const ChannelProcessor &channel, processors) {
+                    channel.combine(extrema + prevHeight * pixelSize, processor.result.data(),
+                                    length, pixelSize, channel.pos);
+                    channel.combine(extrema + (prevHeight + 2 * shift) * pixelSize, processor.result.data(),
+                                    length, pixelSize, channel.pos);
+                }
+            }
+
+            memcpy(extrema + height * pixelSize, processor.result.constData(), length * pixelSize);
+        }
+
+        prevHeight = height;
+
+        for (int y = strip.top(); y <= strip.bottom(); y++) {
+            processor.process(strip.width(), span.xRadius,
+                              [&] (int i) { return columnPixel(strip.left() + i, y); });
+
+            quint8 *dstRow = dstBuffer.data() + (y - strip.top()) * strip.width() * pixelSize;
+
+            if (k == 0) {
+                memcpy(dstRow, processor.result.constData(), strip.width() * pixelSize);
+            } else {
+                Q_FOREACH (const ChannelProcessor &channel, processors) {
+                    channel.combine(processor.result.constData(), dstRow,
+                                    strip.width(), pixelSize, channel.pos);
+                }
+            }
+        }
+    }
+
+    dst->writeBytes(dstBuffer.constData(), strip);
+}
+
+/**
+ * Every column dx of the ellipse is a vertical line with the half-height
+ * of heights[|dx|]. The ellipse is the union of the rectangles, one per
+ * every distinct height, as wide as the columns that reach that height.
+ * The spans are returned in the order of growing heights.
+ */
+QVector<Span> decomposeEllipse(int xRadius, int yRadius)
+{
+    const QVector<int> heights = KisMorphology::ellipseHalfHeights(xRadius, yRadius);
+
+    QVector<Span> spans;
+
+    for (int dx = xRadius; dx >= 0; dx--) {
+        if (dx == xRadius || heights[dx] > heights[dx + 1]) {
+            spans.append({dx, heights[dx]});
+        }
+    }
+
+    return spans;
+}
+
+/**
+ * Runs \p processStrip for all the \p strips in parallel. The strips
+ * are run in batches to be able to report the progress.
+ */
+template <typename Func>
+void processStrips(const QVector<QRect> &strips, Func processStrip,
+                   KoUpdater *progressUpdater, int progressStart, int progressEnd)
+{
+    const int batchSize = qMax(1, QThread::idealThreadCount());
+
+    for (int i = 0; i < strips.size(); i += batchSize) {
+        if (progressUpdater) {
+            progressUpdater->setProgress(progressStart + (progressEnd - progressStart) * i / strips.size());
+        }
+
+        QVector<QRect> batch = strips.mid(i, batchSize);
+        QtConcurrent::blockingMap(batch, processStrip);
+    }
+}
+
+}
+
+int KisMorphology::radiusThreshold()
+{
+    /**
+     * The brute force is cheaper for the smaller radii
+     */
+    return 8;
+}
+
+QVector<int> KisMorphology::ellipseHalfHeights(int xRadius, int yRadius)
+{
+    QVector<int> heights(xRadius + 1);
+
+    heights[0] = yRadius;
+
+    for (int dx = 1; dx <= xRadius; dx++) {
+        const qreal x = dx - 0.5;
+        heights[dx] = int(std::floor(yRadius * std::sqrt(qreal(xRadius * xRadius) - x * x) / xRadius + 0.5));
+    }
+
+    return heights;
+}
+
+bool KisMorphology::apply(KisPaintDeviceSP device,
+                          const QRect &rect,
+                          Operation operation,
+                          Shape shape,
+                          int xRadius, int yRadius,
+                          const QBitArray &channelFlags,
+                          KoUpdater *progressUpdater,
+                          KisConvolutionBorderOp borderOp)
+{
+    const KoColorSpace *cs = device->colorSpace();
+
+    const QBitArray flags =
+        channelFlags.isEmpty() ? QBitArray(cs->channelCount(), true) : channelFlags;
+
+    QVector<ChannelProcessor> processors;
+
+    const QList<KoChannelInfo *> channels = cs->channels();
+    for (int i = 0; i < channels.size(); i++) {
+        if (!flags.testBit(i)) continue;
+
+        const KoChannelInfo::enumChannelValueType type = channels[i]->channelValueType();
+
+        const ChannelProcessor processor =
+            operation == Dilate ?
+                channelProcessor<true>(type, channels[i]->pos()) :
+                channelProcessor<false>(type, channels[i]->pos());
+
+        if (!processor.func) return false;
+
+        processors.append(processor);
+    }
+
+    xRadius = qMax(0, xRadius);
+    yRadius = qMax(0, yRadius);
+
+    if (rect.isEmpty() || processors.isEmpty() || (xRadius == 0 && yRadius == 0)) {
+        return true;
+    }
+
+    /**
+     * The same data rect as KisConvolutionPainter uses for
+     * BORDER_REPEAT, in the wraparound mode the device wraps
+     * the pixels itself.
+     */
+    QRect clampRect = rect.adjusted(-xRadius, -yRadius, xRadius, yRadius);
+
+    if (borderOp == BORDER_REPEAT && !device->defaultBounds()->wrapAroundMode()) {
+        const QRect boundsRect = device->defaultBounds()->bounds();
+        clampRect = rect | boundsRect;
+
+        if (boundsRect == KisDefaultBounds().bounds()) {
+            clampRect = rect | device->exactBounds();
+        }
+    }
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(0);
+    }
+
+    /**
+     * An ellipse with one of the radii equal to zero is a line,
+     * which is processed as a rectangle
+     */
+    if (shape == Ellipse && xRadius > 0 && yRadius > 0) {
+        const QVector<Span> spans = decomposeEllipse(xRadius, yRadius);
+
+        /**
+         * Every strip reads the rows of its neighbours, so they are
+         * read from a copy-on-write snapshot of the device
+         */
+        KisPaintDeviceSP src = new KisPaintDevice(*device);
+
+        const QVector<QRect> strips = splitIntoStrips(rect, Qt::Horizontal, device->y(), STRIP_SIZE);
+
+        processStrips(strips,
+            [&] (const QRect &strip) {
+                processEllipseStrip(src, device, strip, spans, xRadius, yRadius, clampRect, processors);
+            },
+            progressUpdater, 0, 100);
+
+        if (progressUpdater) {
+            progressUpdater->setProgress(100);
+        }
+
+        return true;
+    }
+
+    QVector<Pass> passes;
+
+    if (xRadius > 0) {
+        passes.append({Qt::Horizontal, xRadius});
+    }
+
+    if (yRadius > 0) {
+        passes.append({Qt::Vertical, yRadius});
+    }
+
+    /**
+     * Every pass should produce the area needed by the following ones
+     */
+    QVector<QRect> passRects(passes.size());
+    passRects.last() = rect;
+
+    for (int i = passes.size() - 2; i >= 0; i--) {
+        const Pass &next = passes[i + 1];
+        passRects[i] = passRects[i + 1].adjusted(-next.xMargin(), -next.yMargin(),
+                                                 next.xMargin(), next.yMargin()) & clampRect;
+    }
+
+    /**
+     * The horizontal and vertical lines read only the pixels of their
+     * own strips, so the last pass can work in place. The intermediate
+     * result goes into a separate device, so that the pixels of the
+     * device outside the rect are never touched.
+     */
+    KisPaintDeviceSP src = device;
+
+    for (int i = 0; i < passes.size(); i++) {
+        const Pass &pass = passes[i];
+        const bool isLast = i == passes.size() - 1;
+
+        KisPaintDeviceSP dst = device;
+
+        if (!isLast) {
+            dst = new KisPaintDevice(cs);
+            dst->prepareClone(device);
+        }
+
+        const QVector<QRect> strips =
+            splitIntoStrips(passRects[i],
+                            pass.orientation,
+                            pass.orientation == Qt::Vertical ? device->x() : device->y(),
+                            STRIP_SIZE);
+
+        processStrips(strips,
+            [&] (const QRect &strip) {
+                processStrip(src, dst, strip, pass, clampRect, processors);
+            },
+            progressUpdater, 100 * i / passes.size(), 100 * (i + 1) / passes.size());
+
+        src = dst;
+    }
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(100);
+    }
+
+    return true;
+}
@@ -0,0 +1,90 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISMORPHOLOGY_H
+#define KISMORPHOLOGY_H
+
+#include <QVector>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+#include "kis_convolution_painter.h"
+
+class QBitArray;
+class QRect;
+class KoUpdater;
+
+/**
+ * Grayscale dilation and erosion with the cost per pixel that doesn't
+ * depend on the area of the structuring element.
+ *
+ * Rectangles (and lines, as rectangles with one of the radii equal to
+ * zero) are decomposed into a horizontal and a vertical line, every
+ * line is processed with the van Herk/Gil-Werman algorithm, which
+ * needs three comparisons per pixel for any length of the line.
+ *
+ * Ellipses are processed exactly: an ellipse is the union of the
+ * rectangles, one per every distinct half-height of its columns, see
+ * ellipseHalfHeights(). The vertical extrema of the columns are
+ * computed once and updated from one height to the next, so every
+ * rectangle costs a couple of comparisons per pixel and one horizontal
+ * line. The cost per pixel grows linearly with the number of distinct
+ * heights instead of the area of the ellipse. The edge of the ellipse
+ * is hard, there is no antialiasing.
+ *
+ * Every channel is processed independently in its native type, all the
+ * channel depths are supported. The lines are processed in tile-aligned
+ * strips in parallel.
+ */
+class KRITAIMAGE_EXPORT KisMorphology
+{
+public:
+    enum Operation {
+        Dilate, ///< every pixel takes the maximum of its neighbourhood
+        Erode ///< every pixel takes the minimum of its neighbourhood
+    };
+
+    enum Shape {
+        Rectangle,
+        Ellipse
+    };
+
+    /**
+     * The minimal radius, starting from which the engine is faster
+     * than the brute force implementations
+     */
+    static int radiusThreshold();
+
+    /**
+     * The half-heights of the columns of the ellipse with the radii of
+     * \p xRadius and \p yRadius, for dx from 0 to \p xRadius. The shape
+     * is the same as the one of KisSelectionFilter::computeBorder(),
+     * which Grow and Shrink Selection use for the small radii.
+     */
+    static QVector<int> ellipseHalfHeights(int xRadius, int yRadius);
+
+    /**
+     * Dilates or erodes \p rect of \p device with the structuring
+     * element of \p shape with the radii of \p xRadius and \p yRadius.
+     * With \p borderOp == BORDER_REPEAT the pixels outside the bounds
+     * of the device are taken from the border, the same way as in
+     * KisConvolutionPainter; otherwise they are read from the device.
+     *
+     * \return false if the color space of the device has a channel
+     *         type that is not supported; the device is not changed
+     *         in this case
+     */
+    static bool apply(KisPaintDeviceSP device,
+                      const QRect &rect,
+                      Operation operation,
+                      Shape shape,
+                      int xRadius, int yRadius,
+                      const QBitArray &channelFlags,
+                      KoUpdater *progressUpdater,
+                      KisConvolutionBorderOp borderOp = BORDER_REPEAT);
+};
+
+#endif // KISMORPHOLOGY_H
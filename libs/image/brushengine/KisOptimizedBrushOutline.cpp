@@ -10,6 +10,112 @@
 #include <QTransform>
 #include <kis_algebra_2d.h>
 
+namespace {
+
+/**
+ * QTransform::map() checks the type of the transformation for every
+ * point of the polygon. The outline is usually mapped with an affine
+ * transformation, which we can apply in a tight loop the compiler can
+ * vectorize.
+ */
+QPolygonF mapPolygon(const QTransform &t, const QPolygonF &polygon)
+{
+    const QTransform::TransformationType type = t.type();
+
+    if (type == QTransform::TxNone) {
+        return polygon;
+    } else if (type > QTransform::TxShear) {
+        return t.map(polygon);
+    }
+
+    const qreal m11 = t.m11();
+    const qreal m12 = t.m12();
+    const qreal m21 = t.m21();
+    const qreal m22 = t.m22();
+    const qreal dx = t.dx();
+    const qreal dy = t.dy();
+
+    const int numPoints = polygon.size();
+    QPolygonF result(numPoints);
+
+    const QPointF *src = polygon.constData();
+    QPointF *dst = result.data();
+
+    for (int i = 0; i < numPoints; i++) {
+        const qreal x = src[i].x();
+        const qreal y = src[i].y();
+
+        dst[i] = QPointF(m11 * x + m21 * y + dx,
+                         m12 * x + m22 * y + dy);
+    }
+
+    return result;
+}
+
+/**
+ * Accumulates the bounds of the transformed polygon without
+ * transforming it. For an affine transformation the bounds of
+ * the x and y components can be calculated in a single pass.
+ */
+void accumulateMappedBounds(const QTransform &t, const QPolygonF &polygon,
+                            QRectF *result, bool *resultInitialized)
+{
+    if (polygon.isEmpty()) return;
+
+    if (t.type() > QTransform::TxShear) {
+        auto it = polygon.cbegin();
+
+        if (!*resultInitialized) {
+            KisAlgebra2D::Private::resetEmptyRectangle(t.map(*it), result);
+            *resultInitialized = true;
+            ++it;
+        }
+
+        for (; it != polygon.cend(); ++it) {
+            KisAlgebra2D::accumulateBoundsNonEmpty(t.map(*it), result);
+        }
+
+        return;
+    }
+
+    const qreal m11 = t.m11();
+    const qreal m12 = t.m12();
+    const qreal m21 = t.m21();
+    const qreal m22 = t.m22();
+
+    const QPointF *src = polygon.constData();
+    const int numPoints = polygon.size();
+
+    qreal minX = m11 * src[0].x() + m21 * src[0].y();
+    qreal maxX = minX;
+    qreal minY = m12 * src[0].x() + m22 * src[0].y();
+    qreal maxY = minY;
+
+    for (int i = 1; i < numPoints; i++) {
+        const qreal x = m11 * src[i].x() + m21 * src[i].y();
+        const qreal y = m12 * src[i].x() + m22 * src[i].y();
+
+        minX = qMin(minX, x);
+        maxX = qMax(maxX, x);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+    }
+
+    const QPointF topLeft(minX + t.dx(), minY + t.dy());
+    const QPointF bottomRight(maxX + t.dx(), maxY + t.dy());
+
+    if (!*resultInitialized) {
+        KisAlgebra2D::Private::resetEmptyRectangle(topLeft, result);
+        *resultInitialized = true;
+    } else {
+        KisAlgebra2D::accumulateBoundsNonEmpty(topLeft, result);
+    }
+
+    KisAlgebra2D::accumulateBoundsNonEmpty(bottomRight, result);
+}
+
+}
+
 KisOptimizedBrushOutline::KisOptimizedBrushOutline()
 {
 }
@@ -64,40 +170,11 @@ QRectF KisOptimizedBrushOutline::boundingRect() const
     bool resultInitialized = false;
 
     for (auto polyIt = m_subpaths.cbegin(); polyIt != m_subpaths.cend(); ++polyIt) {
-        /**
-         * This is a highly optimized way to accumulate a rect from a
-         * set of points:
-         *
-         * 1) `QRectF::isEmpty()` is expensive, so use `resultInitialized` instead
-         * 2) Use `KisAlgebra2D::accumulateBoundsNonEmpty` to avoid calling `isEmpty()`
-         */
-
-
-        auto it = polyIt->cbegin();
-
-        if (!resultInitialized && it != polyIt->cend()) {
-            KisAlgebra2D::Private::resetEmptyRectangle(m_transform.map(*it), &result);
-            resultInitialized = true;
-            ++it;
-        }
-
-        for (; it != polyIt->cend(); ++it) {
-            KisAlgebra2D::accumulateBoundsNonEmpty(m_transform.map(*it), &result);
-        }
+        accumulateMappedBounds(m_transform, *polyIt, &result, &resultInitialized);
     }
 
     for (auto polyIt = m_additionalDecorations.cbegin(); polyIt != m_additionalDecorations.cend(); ++polyIt) {
-        auto it = polyIt->cbegin();
-
-        if (!resultInitialized && it != polyIt->cend()) {
-            KisAlgebra2D::Private::resetEmptyRectangle(m_transform.map(*it), &result);
-            resultInitialized = true;
-            ++it;
-        }
-
-        for (; it != polyIt->cend(); ++it) {
-            KisAlgebra2D::accumulateBoundsNonEmpty(m_transform.map(*it), &result);
-        }
+        accumulateMappedBounds(m_transform, *polyIt, &result, &resultInitialized);
     }
 
     m_cachedBoundingRect = result;
@@ -163,12 +240,12 @@ QPolygonF KisOptimizedBrushOutline::const_iterator::dereference() const
     int index = m_index;
 
     if (index < m_outline->m_subpaths.size()) {
-        return m_outline->m_transform.map(m_outline->m_subpaths.at(index));
+        return mapPolygon(m_outline->m_transform, m_outline->m_subpaths.at(index));
     }
 
     index -= m_outline->m_subpaths.size();
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(index >= 0, QPolygonF());
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(index < m_outline->m_additionalDecorations.size(), QPolygonF());
 
-    return m_outline->m_transform.map(m_outline->m_additionalDecorations.at(index));
+    return mapPolygon(m_outline->m_transform, m_outline->m_additionalDecorations.at(index));
 }
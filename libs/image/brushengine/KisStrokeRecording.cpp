@@ -0,0 +1,222 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeRecording.h"
+
+#include <cstring>
+
+#include <QDataStream>
+#include <QFile>
+
+#include "kis_debug.h"
+#include "kis_paint_information.h"
+
+namespace {
+const char MAGIC[4] = {'K', 'S', 'R', 'C'};
+const quint16 VERSION = 1;
+
+// the position and the eight sensors, all stored as floats
+const qint64 EVENT_SIZE = 10 * sizeof(float);
+
+void prepareStream(QDataStream &stream)
+{
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+}
+}
+
+KisStrokeRecording::Event KisStrokeRecording::eventFromPaintInformation(const KisPaintInformation &pi)
+{
+    Event event;
+
+    event.pos = pi.pos();
+    event.pressure = pi.pressure();
+    event.xTilt = pi.xTilt();
+    event.yTilt = pi.yTilt();
+    event.rotation = pi.rotation();
+    event.tangentialPressure = pi.tangentialPressure();
+    event.perspective = pi.perspective();
+    event.time = pi.currentTime();
+    event.speed = pi.drawingSpeed();
+
+    return event;
+}
+
+KisPaintInformation KisStrokeRecording::paintInformationFromEvent(const Event &event)
+{
+    return KisPaintInformation(event.pos,
+                               event.pressure,
+                               event.xTilt, event.yTilt,
+                               event.rotation,
+                               event.tangentialPressure,
+                               event.perspective,
+                               event.time,
+                               event.speed);
+}
+
+void KisStrokeRecording::addStroke(const Stroke &stroke)
+{
+    m_strokes.append(stroke);
+}
+
+const QVector<KisStrokeRecording::Stroke>& KisStrokeRecording::strokes() const
+{
+    return m_strokes;
+}
+
+int KisStrokeRecording::numEvents() const
+{
+    int result = 0;
+
+    Q_FOREACH (const Stroke &stroke, m_strokes) {
+        result += stroke.size();
+    }
+
+    return result;
+}
+
+bool KisStrokeRecording::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        warnKrita << "KisStrokeRecording: failed to open" << fileName;
+        return false;
+    }
+
+    return load(&file);
+}
+
+bool KisStrokeRecording::load(QIODevice *device)
+{
+    m_strokes.clear();
+
+    char magic[4];
+    if (device->read(magic, 4) != 4 || memcmp(magic, MAGIC, 4) != 0) {
+        warnKrita << "KisStrokeRecording: not a stroke recording";
+        return false;
+    }
+
+    QDataStream stream(device);
+    prepareStream(stream);
+
+    quint16 version = 0;
+    stream >> version;
+
+    if (version != VERSION) {
+        warnKrita << "KisStrokeRecording: unsupported version" << version;
+        return false;
+    }
+
+    while (!stream.atEnd()) {
+        quint32 numEvents = 0;
+        stream >> numEvents;
+
+        /**
+         * The count comes from the file, so don't trust it more than
+         * the data left in the device. The truncation itself is
+         * reported by the stream status below.
+         */
+        const qint64 maxEvents = device->bytesAvailable() / EVENT_SIZE;
+
+        Stroke stroke;
+        stroke.reserve(int(qMin(qint64(numEvents), maxEvents)));
+
+        for (quint32 i = 0; i < numEvents && stream.status() == QDataStream::Ok; i++) {
+            float x, y;
+            Event event;
+
+            stream >> x >> y
+                   >> event.pressure
+                   >> event.xTilt >> event.yTilt
+                   >> event.rotation
+                   >> event.tangentialPressure
+                   >> event.perspective
+                   >> event.time
+                   >> event.speed;
+
+            event.pos = QPointF(x, y);
+            stroke.append(event);
+        }
+
+        if (stream.status() != QDataStream::Ok) {
+            warnKrita << "KisStrokeRecording: the recording is truncated";
+            return false;
+        }
+
+        m_strokes.append(stroke);
+    }
+
+    return true;
+}
+
+bool KisStrokeRecording::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        warnKrita << "KisStrokeRecording: failed to open" << fileName;
+        return false;
+    }
+
+    return save(&file);
+}
+
+bool KisStrokeRecording::save(QIODevice *device) const
+{
+    if (!writeHeader(device)) return false;
+
+    Q_FOREACH (const Stroke &stroke, m_strokes) {
+        if (!writeStroke(device, stroke)) return false;
+    }
+
+    return true;
+}
+
+bool KisStrokeRecording::appendStroke(const QString &fileName, const Stroke &stroke)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        warnKrita << "KisStrokeRecording: failed to open" << fileName;
+        return false;
+    }
+
+    if (file.size() == 0 && !writeHeader(&file)) {
+        return false;
+    }
+
+    return writeStroke(&file, stroke);
+}
+
+bool KisStrokeRecording::writeHeader(QIODevice *device)
+{
+    if (device->write(MAGIC, 4) != 4) return false;
+
+    QDataStream stream(device);
+    prepareStream(stream);
+    stream << VERSION;
+
+    return stream.status() == QDataStream::Ok;
+}
+
+bool KisStrokeRecording::writeStroke(QIODevice *device, const Stroke &stroke)
+{
+    QDataStream stream(device);
+    prepareStream(stream);
+
+    stream << quint32(stroke.size());
+
+    Q_FOREACH (const Event &event, stroke) {
+        stream << float(event.pos.x()) << float(event.pos.y())
+               << event.pressure
+               << event.xTilt << event.yTilt
+               << event.rotation
+               << event.tangentialPressure
+               << event.perspective
+               << event.time
+               << event.speed;
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
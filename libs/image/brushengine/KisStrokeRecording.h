@@ -0,0 +1,83 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKERECORDING_H
+#define KISSTROKERECORDING_H
+
+#include "kritaimage_export.h"
+
+#include <QPointF>
+#include <QVector>
+
+class QIODevice;
+class QString;
+class KisPaintInformation;
+
+/**
+ * A sequence of the tablet events of one or more freehand strokes,
+ * as they come from KisPaintingInformationBuilder, that is, before
+ * any smoothing or stabilization.
+ *
+ * The recording is stored in a compact binary format: a short header
+ * followed by a list of stroke chunks. Every chunk can be appended to
+ * an existing file without rewriting it, so the freehand tool just
+ * appends every finished stroke to the file. The format is:
+ *
+ *   header:  "KSRC" magic, quint16 version
+ *   chunk:   quint32 number of events, then the events
+ *   event:   pos.x, pos.y, pressure, xTilt, yTilt, rotation,
+ *            tangentialPressure, perspective, time, speed
+ *            (all single precision floats, little endian)
+ *
+ * \see KisImageConfig::strokeRecordingFile()
+ */
+class KRITAIMAGE_EXPORT KisStrokeRecording
+{
+public:
+    struct Event {
+        QPointF pos;
+        float pressure {1.0f};
+        float xTilt {0.0f};
+        float yTilt {0.0f};
+        float rotation {0.0f};
+        float tangentialPressure {0.0f};
+        float perspective {1.0f};
+        float time {0.0f};
+        float speed {0.0f};
+    };
+
+    using Stroke = QVector<Event>;
+
+public:
+    static Event eventFromPaintInformation(const KisPaintInformation &pi);
+    static KisPaintInformation paintInformationFromEvent(const Event &event);
+
+    void addStroke(const Stroke &stroke);
+    const QVector<Stroke>& strokes() const;
+
+    int numEvents() const;
+
+    bool load(const QString &fileName);
+    bool load(QIODevice *device);
+
+    bool save(const QString &fileName) const;
+    bool save(QIODevice *device) const;
+
+    /**
+     * Appends \p stroke to the recording file \p fileName, creating
+     * the file if it doesn't exist yet
+     */
+    static bool appendStroke(const QString &fileName, const Stroke &stroke);
+
+private:
+    static bool writeHeader(QIODevice *device);
+    static bool writeStroke(QIODevice *device, const Stroke &stroke);
+
+private:
+    QVector<Stroke> m_strokes;
+};
+
+#endif // KISSTROKERECORDING_H
@@ -0,0 +1,99 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFilterResultCache.h"
+
+#include <QMutex>
+#include <QRegion>
+
+#include <KoColorSpace.h>
+
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "kis_default_bounds_base.h"
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_color_transformation_filter.h"
+
+
+struct KisFilterResultCache::Private
+{
+    QMutex lock;
+    KisPaintDeviceSP device;
+    QRegion validRegion;
+};
+
+KisFilterResultCache::KisFilterResultCache()
+    : m_d(new Private)
+{
+}
+
+KisFilterResultCache::~KisFilterResultCache()
+{
+}
+
+void KisFilterResultCache::invalidate()
+{
+    QMutexLocker l(&m_d->lock);
+    m_d->validRegion = QRegion();
+    m_d->device = 0;
+}
+
+void KisFilterResultCache::process(KisFilterSP filter,
+                                   KisFilterConfigurationSP config,
+                                   KisPaintDeviceSP src,
+                                   KisPaintDeviceSP dst,
+                                   const QRect &rect,
+                                   bool reuseCached)
+{
+    if (dynamic_cast<const KisColorTransformationFilter*>(filter.data()) ||
+        src->defaultBounds()->currentLevelOfDetail() > 0) {
+
+        filter->process(src, dst, 0, rect, config, 0);
+        return;
+    }
+
+    KisPaintDeviceSP cacheDevice;
+    QRegion missingRegion(rect);
+
+    {
+        QMutexLocker l(&m_d->lock);
+
+        if (!m_d->device || !(*m_d->device->colorSpace() == *dst->colorSpace())) {
+            m_d->device = new KisPaintDevice(dst->colorSpace());
+            m_d->device->setDefaultBounds(dst->defaultBounds());
+            m_d->validRegion = QRegion();
+        }
+
+        cacheDevice = m_d->device;
+
+        if (reuseCached) {
+            missingRegion -= m_d->validRegion;
+        } else {
+            m_d->validRegion -= rect;
+        }
+    }
+
+    const QRegion cachedRegion = QRegion(rect) - missingRegion;
+
+    for (auto it = cachedRegion.begin(); it != cachedRegion.end(); ++it) {
+        KisPainter::copyAreaOptimized(it->topLeft(), cacheDevice, dst, *it);
+    }
+
+    for (auto it = missingRegion.begin(); it != missingRegion.end(); ++it) {
+        filter->process(src, dst, 0, *it, config, 0);
+        KisPainter::copyAreaOptimized(it->topLeft(), dst, cacheDevice, *it);
+    }
+
+    if (!missingRegion.isEmpty()) {
+        QMutexLocker l(&m_d->lock);
+
+        // the cache might have been reset while we were filtering
+        if (m_d->device == cacheDevice) {
+            m_d->validRegion += missingRegion;
+        }
+    }
+}
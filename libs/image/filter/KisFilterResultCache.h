@@ -0,0 +1,67 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFILTERRESULTCACHE_H
+#define KISFILTERRESULTCACHE_H
+
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+class QRect;
+
+/**
+ * Keeps the unmasked result of the filter of a filter mask or
+ * an adjustment layer, so that the updates that don't change the
+ * input of the filter (e.g. painting on the mask's selection or on
+ * a mask above it) could copy the filtered pixels instead of
+ * running the filter once again.
+ *
+ * The cache doesn't know anything about the input of the filter,
+ * so the owner should tell it when the cached pixels can be reused
+ * and call invalidate() whenever the filter or its input changes
+ * in an untracked way. Every rect processed without reusing the
+ * cached pixels refreshes that area of the cache.
+ *
+ * Color transformation filters are cheaper than copying the cached
+ * pixels, and level of detail planes change too often, so both of
+ * them bypass the cache.
+ *
+ * The object is thread-safe as long as the concurrent calls to
+ * process() don't overlap, which is guaranteed by the update
+ * scheduler.
+ */
+class KRITAIMAGE_EXPORT KisFilterResultCache
+{
+public:
+    KisFilterResultCache();
+    ~KisFilterResultCache();
+
+    /**
+     * Drops all the cached pixels
+     */
+    void invalidate();
+
+    /**
+     * Writes the result of \p filter applied to \p src into \p rect of
+     * \p dst. If \p reuseCached is true, the part of the rect covered
+     * by the cache is copied from it and only the rest is filtered.
+     * The filtered pixels are stored in the cache.
+     */
+    void process(KisFilterSP filter,
+                 KisFilterConfigurationSP config,
+                 KisPaintDeviceSP src,
+                 KisPaintDeviceSP dst,
+                 const QRect &rect,
+                 bool reuseCached);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISFILTERRESULTCACHE_H
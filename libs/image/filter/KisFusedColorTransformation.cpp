@@ -0,0 +1,213 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFusedColorTransformation.h"
+
+#include <cstring>
+
+#include <KoColorSpace.h>
+#include <KoChannelInfo.h>
+
+
+KisFusedColorTransformation::KisFusedColorTransformation(const KoColorSpace *cs)
+    : m_colorSpace(cs)
+{
+    /**
+     * In 8-bit color spaces every byte of a pixel is a separate
+     * channel, so the lookup table can be indexed by the byte
+     * position directly
+     */
+    m_canUseLookupTable = true;
+    Q_FOREACH (const KoChannelInfo *channel, cs->channels()) {
+        if (channel->channelValueType() != KoChannelInfo::UINT8) {
+            m_canUseLookupTable = false;
+            break;
+        }
+    }
+}
+
+KisFusedColorTransformation::~KisFusedColorTransformation()
+{
+    qDeleteAll(m_ownedTransformations);
+}
+
+void KisFusedColorTransformation::appendTransformation(KoColorTransformation *transformation,
+                                                       bool takeOwnership,
+                                                       bool isPerChannel)
+{
+    m_transformations.append(transformation);
+
+    if (transformation) {
+        if (takeOwnership) {
+            m_ownedTransformations.append(transformation);
+        }
+
+        m_isPerChannel &= isPerChannel;
+    }
+
+    m_lookupTables.clear();
+}
+
+bool KisFusedColorTransformation::usesLookupTable() const
+{
+    return m_canUseLookupTable && m_isPerChannel && !m_transformations.isEmpty();
+}
+
+int KisFusedColorTransformation::numStages() const
+{
+    return m_transformations.size();
+}
+
+namespace {
+inline void applyLookupTable(const quint8 *lut, const quint8 *src, quint8 *dst,
+                             qint32 nPixels, int pixelSize)
+{
+    for (qint32 i = 0; i < nPixels; i++) {
+        for (int c = 0; c < pixelSize; c++) {
+            dst[c] = lut[(c << 8) + src[c]];
+        }
+
+        src += pixelSize;
+        dst += pixelSize;
+    }
+}
+}
+
+void KisFusedColorTransformation::transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    const int pixelSize = m_colorSpace->pixelSize();
+    const int numBytes = nPixels * pixelSize;
+
+    if (m_transformations.isEmpty()) {
+        if (src != dst) {
+            memcpy(dst, src, numBytes);
+        }
+        return;
+    }
+
+    if (usesLookupTable()) {
+        if (m_lookupTables.isEmpty()) {
+            prepareLookupTables();
+        }
+
+        applyLookupTable(m_lookupTables.last().constData(), src, dst, nPixels, pixelSize);
+        return;
+    }
+
+    /**
+     * The intermediate stages alternate between two scratch
+     * buffers, so that no transformation reads and writes the
+     * same memory. The last one writes directly into \p dst if
+     * it doesn't alias its source.
+     */
+    const quint8 *stageSrc = src;
+
+    for (int i = 0; i < m_transformations.size(); i++) {
+        const bool isLastStage = i == m_transformations.size() - 1;
+
+        quint8 *stageDst = dst;
+        if (!isLastStage || stageSrc == dst) {
+            QVector<quint8> &buffer = m_stageBuffers[i & 1];
+            if (buffer.size() < numBytes) {
+                buffer.resize(numBytes);
+            }
+            stageDst = buffer.data();
+        }
+
+        /**
+         * Some transformations write the color channels only, so the
+         * source pixels are copied first, the same way the filters
+         * prepare the destination device
+         */
+        memcpy(stageDst, stageSrc, numBytes);
+
+        if (m_transformations[i]) {
+            m_transformations[i]->transform(stageSrc, stageDst, nPixels);
+        }
+
+        stageSrc = stageDst;
+    }
+
+    if (stageSrc != dst) {
+        memcpy(dst, stageSrc, numBytes);
+    }
+}
+
+void KisFusedColorTransformation::transformStages(const quint8 *src, quint8 *const *dst, qint32 nPixels) const
+{
+    if (!usesLookupTable()) {
+        transformChain(src, dst, nPixels);
+        return;
+    }
+
+    if (m_lookupTables.isEmpty()) {
+        prepareLookupTables();
+    }
+
+    const int pixelSize = m_colorSpace->pixelSize();
+
+    for (int i = 0; i < m_lookupTables.size(); i++) {
+        applyLookupTable(m_lookupTables[i].constData(), src, dst[i], nPixels, pixelSize);
+    }
+}
+
+void KisFusedColorTransformation::transformChain(const quint8 *src, quint8 *const *dst, qint32 nPixels) const
+{
+    const int numBytes = nPixels * m_colorSpace->pixelSize();
+    const quint8 *stageSrc = src;
+
+    for (int i = 0; i < m_transformations.size(); i++) {
+        /**
+         * Some transformations write the color channels only, so the
+         * source pixels are copied first, the same way the filters
+         * prepare the destination device
+         */
+        memcpy(dst[i], stageSrc, numBytes);
+
+        if (m_transformations[i]) {
+            m_transformations[i]->transform(stageSrc, dst[i], nPixels);
+        }
+
+        stageSrc = dst[i];
+    }
+}
+
+void KisFusedColorTransformation::prepareLookupTables() const
+{
+    const int pixelSize = m_colorSpace->pixelSize();
+    const int numStages = m_transformations.size();
+
+    /**
+     * The chain is evaluated on 256 pixels, every channel of the pixel
+     * i is equal to i. Since every channel of the result depends on the
+     * same channel of the source only, the channel c of the resulting
+     * pixel i of a stage is the value of the stage's table for c at i.
+     */
+    QVector<quint8> ramp(256 * pixelSize);
+    for (int i = 0; i < 256; i++) {
+        memset(ramp.data() + i * pixelSize, i, pixelSize);
+    }
+
+    QVector<QVector<quint8>> results(numStages, QVector<quint8>(256 * pixelSize));
+    QVector<quint8*> resultPointers(numStages);
+    for (int i = 0; i < numStages; i++) {
+        resultPointers[i] = results[i].data();
+    }
+
+    transformChain(ramp.constData(), resultPointers.constData(), 256);
+
+    m_lookupTables.resize(numStages);
+    for (int i = 0; i < numStages; i++) {
+        QVector<quint8> &lut = m_lookupTables[i];
+        lut.resize(256 * pixelSize);
+
+        for (int c = 0; c < pixelSize; c++) {
+            for (int j = 0; j < 256; j++) {
+                lut[(c << 8) + j] = results[i][j * pixelSize + c];
+            }
+        }
+    }
+}
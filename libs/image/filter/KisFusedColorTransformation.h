@@ -0,0 +1,88 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFUSEDCOLORTRANSFORMATION_H
+#define KISFUSEDCOLORTRANSFORMATION_H
+
+#include <QVector>
+
+#include <KoColorTransformation.h>
+
+#include "kritaimage_export.h"
+
+class KoColorSpace;
+
+/**
+ * Applies a chain of color transformations in a single pass over the
+ * pixels: every chunk of pixels is passed through all of them while it
+ * is still in the cache. No transformation of the chain is ever called
+ * with the same source and destination buffer.
+ *
+ * When every transformation in the chain is per-channel (see
+ * KisColorTransformationFilter::isPerChannelTransformation()) and all
+ * the channels of the color space are 8-bit, every stage of the chain
+ * is collapsed into a lookup table per channel, which are built on the
+ * first call to transform() or transformStages().
+ *
+ * Like any other color transformation, the object should be used by
+ * one thread only.
+ */
+class KRITAIMAGE_EXPORT KisFusedColorTransformation : public KoColorTransformation
+{
+public:
+    KisFusedColorTransformation(const KoColorSpace *cs);
+    ~KisFusedColorTransformation() override;
+
+    /**
+     * Appends \p transformation to the end of the chain. Null
+     * transformations are considered to be identity, but still
+     * form a stage of the chain.
+     *
+     * \param takeOwnership the transformation is deleted
+     *        together with the fused one
+     * \param isPerChannel every channel of the result depends
+     *        on the same channel of the source only
+     */
+    void appendTransformation(KoColorTransformation *transformation,
+                              bool takeOwnership,
+                              bool isPerChannel);
+
+    /**
+     * \return true if the chain is collapsed into the lookup tables
+     */
+    bool usesLookupTable() const;
+
+    /**
+     * \return the number of transformations in the chain
+     */
+    int numStages() const;
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override;
+
+    /**
+     * Writes the result of every stage of the chain into a separate
+     * buffer: \p dst[i] receives the pixels of \p src passed through
+     * the first i + 1 transformations. The buffers should not overlap
+     * with each other or with \p src.
+     */
+    void transformStages(const quint8 *src, quint8 *const *dst, qint32 nPixels) const;
+
+private:
+    void transformChain(const quint8 *src, quint8 *const *dst, qint32 nPixels) const;
+    void prepareLookupTables() const;
+
+private:
+    const KoColorSpace *m_colorSpace;
+    QVector<KoColorTransformation*> m_transformations;
+    QVector<KoColorTransformation*> m_ownedTransformations;
+    bool m_isPerChannel {true};
+    bool m_canUseLookupTable {false};
+
+    mutable QVector<QVector<quint8>> m_lookupTables;
+    mutable QVector<quint8> m_stageBuffers[2];
+};
+
+#endif // KISFUSEDCOLORTRANSFORMATION_H
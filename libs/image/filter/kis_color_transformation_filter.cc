@@ -62,6 +62,13 @@ void KisColorTransformationFilter::processImpl(KisPaintDeviceSP device,
 
 }
 
+bool KisColorTransformationFilter::isPerChannelTransformation(const KoColorSpace *cs, const KisFilterConfigurationSP config) const
+{
+    Q_UNUSED(cs);
+    Q_UNUSED(config);
+    return false;
+}
+
 KisFilterConfigurationSP  KisColorTransformationFilter::factoryConfiguration(KisResourcesInterfaceSP resourcesInterface) const
 {
     return new KisColorTransformationConfiguration(id(), 0, resourcesInterface);
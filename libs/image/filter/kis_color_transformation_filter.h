@@ -29,6 +29,16 @@ public:
      */
     virtual KoColorTransformation* createTransformation(const KoColorSpace* cs, const KisFilterConfigurationSP config) const = 0;
 
+    /**
+     * @return true if every channel of the result of the transformation,
+     * created for \p config, depends on the same channel of the source
+     * only. A chain of such transformations can be collapsed into
+     * per-channel lookup tables, see KisFusedColorTransformation.
+     *
+     * The default implementation returns false.
+     */
+    virtual bool isPerChannelTransformation(const KoColorSpace* cs, const KisFilterConfigurationSP config) const;
+
     KisFilterConfigurationSP factoryConfiguration(KisResourcesInterfaceSP resourcesInterface) const override;
 };
 
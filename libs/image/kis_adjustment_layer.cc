@@ -19,15 +19,21 @@
 #include "filter/kis_filter_configuration.h"
 #include "filter/kis_filter_registry.h"
 #include "filter/kis_filter.h"
+#include "filter/KisFilterResultCache.h"
 #include "kis_node_visitor.h"
 #include "kis_processing_visitor.h"
 
+struct KisAdjustmentLayer::Private
+{
+    KisFilterResultCache filterResultCache;
+};
 
 KisAdjustmentLayer::KisAdjustmentLayer(KisImageWSP image,
                                        const QString &name,
                                        KisFilterConfigurationSP kfc,
                                        KisSelectionSP selection)
-    : KisSelectionBasedLayer(image.data(), name, selection, kfc)
+    : KisSelectionBasedLayer(image.data(), name, selection, kfc),
+      m_d(new Private())
 {
     // by default Adjustment Layers have a copy composition,
     // which is more natural for users
@@ -42,7 +48,8 @@ KisAdjustmentLayer::KisAdjustmentLayer(KisImageWSP image,
 }
 
 KisAdjustmentLayer::KisAdjustmentLayer(const KisAdjustmentLayer& rhs)
-        : KisSelectionBasedLayer(rhs)
+        : KisSelectionBasedLayer(rhs),
+          m_d(new Private())
 {
 }
 
@@ -55,6 +62,12 @@ void KisAdjustmentLayer::setFilter(KisFilterConfigurationSP filterConfig, bool c
 {
     filterConfig->setChannelFlags(channelFlags());
     KisSelectionBasedLayer::setFilter(filterConfig, checkCompareConfig);
+    m_d->filterResultCache.invalidate();
+}
+
+KisFilterResultCache* KisAdjustmentLayer::filterResultCache() const
+{
+    return &m_d->filterResultCache;
 }
 
 QRect KisAdjustmentLayer::incomingChangeRect(const QRect &rect) const
@@ -134,5 +147,6 @@ void KisAdjustmentLayer::setChannelFlags(const QBitArray & channelFlags)
         filterConfig->setChannelFlags(channelFlags);
     }
     KisLayer::setChannelFlags(channelFlags);
+    m_d->filterResultCache.invalidate();
 }
 
@@ -17,10 +17,12 @@
 #define KIS_ADJUSTMENT_LAYER_H_
 
 #include <QObject>
+#include <QScopedPointer>
 #include <kritaimage_export.h>
 #include "kis_selection_based_layer.h"
 
 class KisFilterConfiguration;
+class KisFilterResultCache;
 
 class KRITAIMAGE_EXPORT KisAdjustmentLayer : public KisSelectionBasedLayer
 {
@@ -78,6 +80,13 @@ public:
 
     void setChannelFlags(const QBitArray & channelFlags) override;
 
+    /**
+     * The result of the filter before it is masked by the selection
+     * of the layer. It lets the updates caused by painting on the
+     * selection skip running the filter.
+     */
+    KisFilterResultCache* filterResultCache() const;
+
 protected:
     // override from KisLayer
     QRect incomingChangeRect(const QRect &rect) const override;
@@ -93,6 +102,10 @@ public Q_SLOTS:
     KisLayer* layer() {
         return this;
     }
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
 };
 
 #endif // KIS_ADJUSTMENT_LAYER_H_
@@ -10,6 +10,8 @@
 #include <QBitArray>
 
 #include <KoChannelInfo.h>
+#include <KoColor.h>
+#include <KoColorSpace.h>
 #include <KoCompositeOpRegistry.h>
 
 #include "kis_node_visitor.h"
@@ -23,7 +25,12 @@
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_configuration.h"
 #include "filter/kis_filter_registry.h"
+#include "filter/kis_color_transformation_filter.h"
+#include "filter/kis_color_transformation_configuration.h"
+#include "filter/KisFusedColorTransformation.h"
+#include "filter/KisFilterResultCache.h"
 #include "kis_selection.h"
+#include "kis_pixel_selection.h"
 #include "kis_clone_layer.h"
 #include "kis_processing_information.h"
 #include "kis_busy_progress_indicator.h"
@@ -48,10 +55,11 @@
 class KisUpdateOriginalVisitor : public KisNodeVisitor
 {
 public:
-    KisUpdateOriginalVisitor(const QRect &updateRect, KisPaintDeviceSP projection, const QRect &cropRect)
+    KisUpdateOriginalVisitor(const QRect &updateRect, KisPaintDeviceSP projection, const QRect &cropRect, bool isFilthy = false)
         : m_updateRect(updateRect),
           m_cropRect(cropRect),
-          m_projection(projection)
+          m_projection(projection),
+          m_isFilthy(isFilthy)
         {
         }
 
@@ -110,8 +118,24 @@ public:
             KIS_ASSERT_RECOVER_NOOP(layer->busyProgressIndicator());
             layer->busyProgressIndicator()->update();
 
-            // We do not create a transaction here, as srcDevice != dstDevice
-            filter->process(m_projection, dstDevice, 0, filterRect, filterConfig.data(), 0);
+            if (selection) {
+                /**
+                 * Painting on the selection of the layer doesn't change
+                 * the result of the filter, but any other change of the
+                 * layer itself (e.g. moving it) does.
+                 */
+                KisFilterResultCache *filterCache = layer->filterResultCache();
+                const bool reuseCached = m_isFilthy && layer->hasTemporaryTarget();
+
+                if (m_isFilthy && !reuseCached) {
+                    filterCache->invalidate();
+                }
+
+                filterCache->process(filter, filterConfig, m_projection, dstDevice, filterRect, reuseCached);
+            } else {
+                // We do not create a transaction here, as srcDevice != dstDevice
+                filter->process(m_projection, dstDevice, 0, filterRect, filterConfig.data(), 0);
+            }
         }
 
         if (selection) {
@@ -196,6 +220,7 @@ private:
     QRect m_updateRect;
     QRect m_cropRect;
     KisPaintDeviceSP m_projection;
+    bool m_isFilthy;
 };
 
 
@@ -203,6 +228,78 @@ private:
 /*                     KisAsyncMerger                                */
 /*********************************************************************/
 
+namespace {
+
+struct FusableLayer {
+    KisProjectionLeafSP leaf;
+    qint32 position;
+    KisAdjustmentLayer *layer;
+    const KisColorTransformationFilter *filter;
+    KisFilterConfigurationSP config;
+};
+
+/**
+ * An adjustment layer can be merged together with its neighbours
+ * when its original is just a color transformation of the
+ * projection below and its own projection fully replaces the
+ * lower layers, i.e. it has the "Copy" blending mode, full opacity,
+ * no masks and no selection within the rect.
+ */
+bool fetchFusableLayer(KisProjectionLeafSP leaf, qint32 position,
+                       const QRect &rect, const KoColorSpace *projectionColorSpace,
+                       FusableLayer *result)
+{
+    if (position & (KisMergeWalker::N_EXTRA | KisMergeWalker::N_FILTHY_PROJECTION)) return false;
+    if (!leaf->visible() || leaf->hasClones()) return false;
+    if (leaf->opacity() != OPACITY_OPAQUE_U8) return false;
+
+    KisAdjustmentLayer *layer = qobject_cast<KisAdjustmentLayer*>(leaf->node().data());
+    if (!layer) return false;
+
+    if (layer->compositeOpId() != COMPOSITE_COPY ||
+        layer->hasEffectMasks() ||
+        layer->layerStyle() ||
+        layer->hasTemporaryTarget()) {
+
+        return false;
+    }
+
+    const QBitArray channelFlags = leaf->channelFlags();
+    if (!channelFlags.isEmpty() && channelFlags.count(true) != channelFlags.size()) return false;
+
+    if (!(*layer->original()->colorSpace() == *projectionColorSpace)) return false;
+
+    KisSelectionSP selection = layer->internalSelection();
+    if (selection) {
+        if (selection->hasShapeSelection()) return false;
+
+        KisPixelSelectionSP pixelSelection = selection->pixelSelection();
+        if (*pixelSelection->defaultPixel().data() != MAX_SELECTED ||
+            pixelSelection->extent().intersects(rect)) {
+
+            return false;
+        }
+    }
+
+    KisFilterConfigurationSP config = layer->filter();
+    if (!config) return false;
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value(config->name());
+    const KisColorTransformationFilter *colorFilter =
+        dynamic_cast<const KisColorTransformationFilter*>(filter.data());
+    if (!colorFilter) return false;
+
+    result->leaf = leaf;
+    result->position = position;
+    result->layer = layer;
+    result->filter = colorFilter;
+    result->config = config;
+
+    return true;
+}
+
+}
+
 void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
     KisMergeWalker::LeafStack &leafStack = walker.leafStack();
 
@@ -248,9 +345,17 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
             setupProjection(currentLeaf, applyRect, useTempProjections);
         }
 
+        if (m_currentProjection &&
+            walker.levelOfDetail() == 0 &&
+            mergeAdjustmentLayersRun(walker, currentLeaf, item.m_position,
+                                     applyRect, useTempProjections)) {
+            continue;
+        }
+
         KisUpdateOriginalVisitor originalVisitor(applyRect,
                                                  m_currentProjection,
-                                                 walker.cropRect());
+                                                 walker.cropRect(),
+                                                 item.m_position & KisMergeWalker::N_FILTHY);
 
         if(item.m_position & KisMergeWalker::N_FILTHY) {
             DEBUG_NODE_ACTION("Updating", "N_FILTHY", currentLeaf, applyRect);
@@ -305,6 +410,155 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
     }
 }
 
+bool KisAsyncMerger::mergeAdjustmentLayersRun(KisBaseRectsWalker &walker,
+                                              KisProjectionLeafSP firstLeaf,
+                                              qint32 firstPosition,
+                                              const QRect &rect,
+                                              bool useTempProjection)
+{
+    KisMergeWalker::LeafStack &leafStack = walker.leafStack();
+    if (leafStack.isEmpty() || (firstPosition & KisMergeWalker::N_TOPMOST)) return false;
+
+    const KoColorSpace *cs = m_currentProjection->colorSpace();
+
+    QVector<FusableLayer> run;
+
+    {
+        FusableLayer layer;
+        if (!fetchFusableLayer(firstLeaf, firstPosition, rect, cs, &layer)) return false;
+        run.append(layer);
+    }
+
+    /**
+     * The layers below the filthy one have their projections cached,
+     * so we don't mix them with the ones that should be regenerated
+     */
+    const bool belowFilthy = firstPosition & KisMergeWalker::N_BELOW_FILTHY;
+
+    while (!leafStack.isEmpty() &&
+           !(run.last().position & KisMergeWalker::N_TOPMOST)) {
+
+        const KisMergeWalker::JobItem &nextItem = leafStack.top();
+
+        if (nextItem.m_applyRect != rect ||
+            bool(nextItem.m_position & KisMergeWalker::N_BELOW_FILTHY) != belowFilthy ||
+            !nextItem.m_leaf ||
+            nextItem.m_leaf->parent() != firstLeaf->parent()) {
+
+            break;
+        }
+
+        FusableLayer layer;
+        if (!fetchFusableLayer(nextItem.m_leaf, nextItem.m_position, rect, cs, &layer)) break;
+
+        run.append(layer);
+        leafStack.pop();
+    }
+
+    if (run.size() < 2) return false;
+
+    const FusableLayer &last = run.last();
+
+    if (belowFilthy) {
+        DEBUG_NODE_ACTION("Skipping run", "N_BELOW_FILTHY", last.leaf, rect);
+
+        /**
+         * The "Copy" blending with full opacity overwrites the
+         * projection, so the lower layers of the run don't matter
+         */
+        compositeWithProjection(last.leaf, rect);
+    } else {
+        DEBUG_NODE_ACTION("Updating run", run.size(), last.leaf, rect);
+
+        KisFusedColorTransformation transformation(cs);
+
+        /**
+         * None of the layers of the run has masks, so all their
+         * originals need the same rect
+         */
+        const QRect originalUpdateRect =
+            last.leaf->projectionPlane()->needRectForOriginal(rect);
+
+        QVector<KisPaintDeviceSP> originals;
+
+        for (int i = 0; i < run.size(); i++) {
+            const FusableLayer &layer = run[i];
+
+            KisColorTransformationConfiguration *colorTransformationConfiguration =
+                dynamic_cast<KisColorTransformationConfiguration*>(layer.config.data());
+
+            KoColorTransformation *colorTransformation =
+                colorTransformationConfiguration ?
+                    colorTransformationConfiguration->colorTransformation(cs, layer.filter) :
+                    layer.filter->createTransformation(cs, layer.config);
+
+            transformation.appendTransformation(colorTransformation,
+                                                !colorTransformationConfiguration,
+                                                layer.filter->isPerChannelTransformation(cs, layer.config));
+
+            KIS_ASSERT_RECOVER_NOOP(layer.layer->busyProgressIndicator());
+            layer.layer->busyProgressIndicator()->update();
+
+            KisPaintDeviceSP originalDevice = layer.layer->original();
+            originalDevice->clear(originalUpdateRect);
+            originals.append(originalDevice);
+        }
+
+        const QRect applyRect = originalUpdateRect & m_currentProjection->extent();
+
+        if (!applyRect.isEmpty()) {
+            /**
+             * The originals of all the layers of the run are written,
+             * since they are read outside the merger as well (thumbnails,
+             * color sampler, merging the layers down). The stages of the
+             * chain are written into separate buffers, so no transformation
+             * works in place.
+             */
+            const int pixelSize = cs->pixelSize();
+            const int stripHeight = qMin(applyRect.height(), 64);
+            const int bufferSize = applyRect.width() * stripHeight * pixelSize;
+
+            QVector<quint8> srcBuffer(bufferSize);
+            QVector<QVector<quint8>> stageBuffers(run.size(), QVector<quint8>(bufferSize));
+            QVector<quint8*> stagePointers(run.size());
+            for (int i = 0; i < run.size(); i++) {
+                stagePointers[i] = stageBuffers[i].data();
+            }
+
+            for (int y = applyRect.top(); y <= applyRect.bottom(); y += stripHeight) {
+                const QRect stripRect(applyRect.left(), y,
+                                      applyRect.width(),
+                                      qMin(stripHeight, applyRect.bottom() - y + 1));
+
+                m_currentProjection->readBytes(srcBuffer.data(), stripRect);
+                transformation.transformStages(srcBuffer.constData(),
+                                               stagePointers.constData(),
+                                               stripRect.width() * stripRect.height());
+
+                for (int i = 0; i < run.size(); i++) {
+                    originals[i]->writeBytes(stageBuffers[i].constData(), stripRect);
+                }
+            }
+        }
+
+        Q_FOREACH (const FusableLayer &layer, run) {
+            layer.leaf->projectionPlane()->recalculate(rect,
+                                                       layer.position & KisMergeWalker::N_FILTHY ?
+                                                           walker.startNode() :
+                                                           layer.leaf->node());
+        }
+
+        compositeWithProjection(last.leaf, rect);
+    }
+
+    if (last.position & KisMergeWalker::N_TOPMOST) {
+        writeProjection(last.leaf, useTempProjection, rect);
+        resetProjection();
+    }
+
+    return true;
+}
+
 void KisAsyncMerger::resetProjection() {
     m_currentProjection = 0;
     m_finalProjection = 0;
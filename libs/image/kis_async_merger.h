@@ -24,6 +24,20 @@ private:
     inline bool compositeWithProjection(KisProjectionLeafSP leaf, const QRect &rect);
     inline void doNotifyClones(KisBaseRectsWalker &walker);
 
+    /**
+     * Merges the run of adjustment layers starting from \p firstLeaf
+     * with a single color transformation pass, taking the rest of the
+     * run from the leaf stack of \p walker.
+     *
+     * \return false if the run has less than two layers; nothing
+     *         is merged then
+     */
+    bool mergeAdjustmentLayersRun(KisBaseRectsWalker &walker,
+                                  KisProjectionLeafSP firstLeaf,
+                                  qint32 firstPosition,
+                                  const QRect &rect,
+                                  bool useTempProjection);
+
 private:
     /**
      * The place where intermediate results of layer's merge
@@ -209,7 +209,7 @@ void FastRowProcessor<KisCurveCircleMaskGenerator>::process<xsimd::current_arch>
 
     float *bufferPointer = buffer;
 
-    const qreal *curveDataPointer = d->curveData.data();
+    const float *curveDataPointer = d->vectorCurveData.constData();
 
     float_v currentIndices = xsimd::detail::make_sequence_as_batch<float_v>();
 
@@ -225,6 +225,10 @@ void FastRowProcessor<KisCurveCircleMaskGenerator>::process<xsimd::current_arch>
     const float_v vXCoeff(static_cast<float>(d->xcoef));
     const float_v vCurveResolution(static_cast<float>(d->curveResolution));
 
+    // the excluded lanes are gathered as well, so keep their
+    // indices inside the table
+    const int_v vMaxAlphaValue(d->vectorCurveData.size() - 2);
+
     float_v vCurvedData(0);
     float_v vCurvedData1(0);
 
@@ -252,6 +256,7 @@ void FastRowProcessor<KisCurveCircleMaskGenerator>::process<xsimd::current_arch>
 
             const auto alphaMask = vAlphaValue < int_v(0);
             vAlphaValue = xsimd::set_zero(vAlphaValue, alphaMask);
+            vAlphaValue = xsimd::min(vAlphaValue, vMaxAlphaValue);
 
             vCurvedData = float_v::gather(curveDataPointer, vAlphaValue);
             vCurvedData1 = float_v::gather(curveDataPointer, vAlphaValue + 1);
@@ -457,6 +462,7 @@ void FastRowProcessor<KisCurveRectangleMaskGenerator>::process<xsimd::current_ar
                                                                                     float centerX,
                                                                                     float centerY)
 {
+    using int_v = xsimd::batch<int, xsimd::current_arch>;
     using float_v = xsimd::batch<float, xsimd::current_arch>;
     using float_m = float_v::batch_bool_type;
 
@@ -466,7 +472,7 @@ void FastRowProcessor<KisCurveRectangleMaskGenerator>::process<xsimd::current_ar
 
     float *bufferPointer = buffer;
 
-    const qreal *curveDataPointer = d->curveData.data();
+    const float *curveDataPointer = d->vectorCurveData.constData();
 
     float_v currentIndices = xsimd::detail::make_sequence_as_batch<float_v>();
 
@@ -481,6 +487,7 @@ void FastRowProcessor<KisCurveRectangleMaskGenerator>::process<xsimd::current_ar
     const float_v vYCoeff(static_cast<float>(d->ycoeff));
     const float_v vXCoeff(static_cast<float>(d->xcoeff));
     const float_v vCurveResolution(static_cast<float>(d->curveResolution));
+    const int_v vCurveResolutionInt(static_cast<int>(d->curveResolution));
 
     const float_v vOne(1);
     const float_v vZero(0);
@@ -508,8 +515,8 @@ void FastRowProcessor<KisCurveRectangleMaskGenerator>::process<xsimd::current_ar
             const auto sIndex = xsimd::nearbyint_as_int(preSIndex * vCurveResolution);
             const auto tIndex = xsimd::nearbyint_as_int(preTIndex * vCurveResolution);
 
-            const auto sIndexInverted = xsimd::to_int(vCurveResolution - xsimd::to_float(sIndex));
-            const auto tIndexInverted = xsimd::to_int(vCurveResolution - xsimd::to_float(tIndex));
+            const int_v sIndexInverted = vCurveResolutionInt - sIndex;
+            const int_v tIndexInverted = vCurveResolutionInt - tIndex;
 
             const auto vCurvedDataSIndex = float_v::gather(curveDataPointer, sIndex);
             const auto vCurvedDataTIndex = float_v::gather(curveDataPointer, tIndex);
@@ -97,6 +97,29 @@ bool KisConvolutionPainter::supportsFFTW()
 #endif
 }
 
+KisConvolutionPainter::KernelSpectrumCacheScope::KernelSpectrumCacheScope()
+{
+#ifdef HAVE_FFTW3
+    KisConvolutionKernelSpectrumCache::acquire();
+#endif
+}
+
+KisConvolutionPainter::KernelSpectrumCacheScope::~KernelSpectrumCacheScope()
+{
+#ifdef HAVE_FFTW3
+    KisConvolutionKernelSpectrumCache::release();
+#endif
+}
+
+int KisConvolutionPainter::numCachedKernelSpectra()
+{
+#ifdef HAVE_FFTW3
+    return KisConvolutionKernelSpectrumCache::numSpectra();
+#else
+    return 0;
+#endif
+}
+
 
 KisConvolutionPainter::KisConvolutionPainter()
     : KisPainter(),
@@ -80,9 +80,27 @@ public:
 
     static bool supportsFFTW();
 
+    /**
+     * The FFTW engine caches the spectra of the kernels only while
+     * an object of this class exists, e.g. during a filter stroke,
+     * which applies the same kernel to many patches of the image.
+     * When the last of them is destroyed, the cache is freed.
+     */
+    class KRITAIMAGE_EXPORT KernelSpectrumCacheScope
+    {
+    public:
+        KernelSpectrumCacheScope();
+        ~KernelSpectrumCacheScope();
+
+    private:
+        Q_DISABLE_COPY(KernelSpectrumCacheScope)
+    };
+
 protected:
     friend class KisConvolutionPainterTest;
 
+    static int numCachedKernelSpectra();
+
 
 
 private:
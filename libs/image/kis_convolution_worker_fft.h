@@ -13,13 +13,19 @@
 #include <KoChannelInfo.h>
 
 #include "kis_convolution_worker.h"
+#include "kis_convolution_kernel.h"
 #include "kis_math_toolbox.h"
 
+#include <QAtomicInt>
+#include <QCache>
+#include <QCryptographicHash>
 #include <QMutex>
+#include <QSharedPointer>
 #include <QVector>
 #include <QTextStream>
 #include <QFile>
 #include <QDir>
+#include <QtConcurrent>
 
 #include <fftw3.h>
 
@@ -33,6 +39,117 @@ private:
 
 QMutex KisConvolutionWorkerFFTLock::fftwMutex;
 
+/**
+ * Keeps the spectra of the recently used kernels, so that applying
+ * the same kernel again (e.g. to the next patch of a filter stroke)
+ * doesn't need to transform the kernel again. The spectra are keyed by
+ * the hash of the kernel and the size of the FFT block.
+ *
+ * The spectra are stored only while the cache is acquired by someone
+ * (see KisConvolutionPainter::KernelSpectrumCacheScope), the release
+ * of the last user frees all of them.
+ */
+class KisConvolutionKernelSpectrumCache
+{
+public:
+    struct Spectrum {
+        Spectrum(quint32 length)
+            : data((fftw_complex *)fftw_malloc(sizeof(fftw_complex) * length)),
+              size(sizeof(fftw_complex) * length)
+        {
+            memset(data, 0, size);
+        }
+
+        ~Spectrum() {
+            fftw_free(data);
+        }
+
+        fftw_complex *data;
+        size_t size;
+
+    private:
+        Q_DISABLE_COPY(Spectrum)
+    };
+
+    typedef QSharedPointer<Spectrum> SpectrumSP;
+
+    static QByteArray key(const KisConvolutionKernelSP kernel, quint32 fftWidth, quint32 fftHeight)
+    {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+
+        const quint32 sizes[] = {kernel->width(), kernel->height(), fftWidth, fftHeight};
+        hash.addData(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+
+        for (quint32 y = 0; y < kernel->height(); y++) {
+            for (quint32 x = 0; x < kernel->width(); x++) {
+                const qreal value = kernel->data()->coeff(y, x);
+                hash.addData(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+        }
+
+        return hash.result();
+    }
+
+    static SpectrumSP fetch(const QByteArray &key)
+    {
+        Storage *s = storage();
+        QMutexLocker l(&s->mutex);
+
+        SpectrumSP *spectrum = s->cache.object(key);
+        return spectrum ? *spectrum : SpectrumSP();
+    }
+
+    static void insert(const QByteArray &key, SpectrumSP spectrum)
+    {
+        Storage *s = storage();
+        QMutexLocker l(&s->mutex);
+
+        if (!s->numUsers) return;
+
+        s->cache.insert(key, new SpectrumSP(spectrum), qMax(1, int(spectrum->size / 1024)));
+    }
+
+    static void acquire()
+    {
+        Storage *s = storage();
+        QMutexLocker l(&s->mutex);
+
+        s->numUsers++;
+    }
+
+    static void release()
+    {
+        Storage *s = storage();
+        QMutexLocker l(&s->mutex);
+
+        KIS_SAFE_ASSERT_RECOVER_RETURN(s->numUsers > 0);
+
+        if (!--s->numUsers) {
+            s->cache.clear();
+        }
+    }
+
+    static int numSpectra()
+    {
+        Storage *s = storage();
+        QMutexLocker l(&s->mutex);
+
+        return s->cache.count();
+    }
+
+private:
+    struct Storage {
+        QMutex mutex;
+        QCache<QByteArray, SpectrumSP> cache {128 * 1024}; // KiB
+        int numUsers {0};
+    };
+
+    static Storage* storage() {
+        static Storage s;
+        return &s;
+    }
+};
+
 
 template<class _IteratorFactory_>
 class KisConvolutionWorkerFFT : public KisConvolutionWorker<_IteratorFactory_>
@@ -72,89 +189,109 @@ public:
         const quint32 halfKernelWidth = (kernel->width() - 1) / 2;
         const quint32 halfKernelHeight = (kernel->height() - 1) / 2;
 
-        m_fftWidth = areaSize.width() + 4 * halfKernelWidth;
-        m_fftHeight = areaSize.height() + 2 * halfKernelHeight;
-
         /**
-         * FIXME: check whether this "optimization" is needed to
-         * be uncommented. My tests showed about 30% better performance
-         * when the line is commented out (DK).
+         * The area is convolved in tiles with the overlap-save method:
+         * every tile reads its area grown by the half of the kernel and
+         * keeps only the pixels, which are not affected by the circular
+         * wrapping of the FFT. The tiles are aligned to the tiles of the
+         * destination device, so the parallel jobs never write into the
+         * same device tile, and all of them share the same FFT size,
+         * so the kernel is transformed only once.
          */
-        //optimumDimensions(m_fftWidth, m_fftHeight);
+        const QRect dstRect(dstPos, areaSize);
+        const QPoint srcOffset = srcPos - dstPos;
+        const QPoint tileOrigin(this->m_painter->device()->x(), this->m_painter->device()->y());
+
+        const int tileWidth = tileSize(halfKernelWidth, dstRect.left() - tileOrigin.x(), dstRect.width());
+        const int tileHeight = tileSize(halfKernelHeight, dstRect.top() - tileOrigin.y(), dstRect.height());
+
+        m_fftWidth = optimumFFTSize(tileWidth + 2 * halfKernelWidth);
+        m_fftHeight = optimumFFTSize(tileHeight + 2 * halfKernelHeight);
 
         m_fftLength = m_fftHeight * (m_fftWidth / 2 + 1);
         m_extraMem = (m_fftWidth % 2) ? 1 : 2;
 
-        // create and fill kernel
-        m_kernelFFT = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * m_fftLength);
-        memset(m_kernelFFT, 0, sizeof(fftw_complex) * m_fftLength);
-        fftFillKernelMatrix(kernel, m_kernelFFT);
-
         // find out which channels need convolving
         QList<KoChannelInfo*> convChannelList = this->convolvableChannelList(src);
 
-        m_channelFFT.resize(convChannelList.count());
-        for (auto i = m_channelFFT.begin(); i != m_channelFFT.end(); ++i) {
-            *i = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * m_fftLength);
-        }
-
         const double kernelFactor = kernel->factor() ? kernel->factor() : 1;
         const double fftScale = 1.0 / (m_fftHeight * m_fftWidth) / kernelFactor;
 
         FFTInfo info (fftScale, convChannelList, kernel, this->m_painter->device()->colorSpace());
-        int cacheRowStride = m_fftWidth + m_extraMem;
+        const int cacheRowStride = m_fftWidth + m_extraMem;
 
-        fillCacheFromDevice(src,
-                            QRect(srcPos.x() - halfKernelWidth,
-                                  srcPos.y() - halfKernelHeight,
-                                  m_fftWidth,
-                                  m_fftHeight),
-                            cacheRowStride,
-                            info, dataRect);
-
-        addToProgress(10);
-        if (isInterrupted()) return;
+        // the plans are created on a scratch buffer and then executed on
+        // the buffers of the tiles, which have the same size and alignment
+        KisConvolutionKernelSpectrumCache::Spectrum scratch(m_fftLength);
 
-        // calculate number off fft operations required for progress reporting
-        const float progressPerFFT = (100 - 30) / (double)(convChannelList.count() * 2 + 1);
-
-        // perform FFT
         fftw_plan fftwPlanForward, fftwPlanBackward;
 
         KisConvolutionWorkerFFTLock::fftwMutex.lock();
-        fftwPlanForward = fftw_plan_dft_r2c_2d(m_fftHeight, m_fftWidth, (double*)m_kernelFFT, m_kernelFFT, FFTW_ESTIMATE);
-        fftwPlanBackward = fftw_plan_dft_c2r_2d(m_fftHeight, m_fftWidth, m_kernelFFT, (double*)m_kernelFFT, FFTW_ESTIMATE);
+        fftwPlanForward = fftw_plan_dft_r2c_2d(m_fftHeight, m_fftWidth, (double*)scratch.data, scratch.data, FFTW_ESTIMATE);
+        fftwPlanBackward = fftw_plan_dft_c2r_2d(m_fftHeight, m_fftWidth, scratch.data, (double*)scratch.data, FFTW_ESTIMATE);
         KisConvolutionWorkerFFTLock::fftwMutex.unlock();
 
-        fftw_execute(fftwPlanForward);
-        addToProgress(progressPerFFT);
-        if (isInterrupted()) return;
+        const QByteArray spectrumKey = KisConvolutionKernelSpectrumCache::key(kernel, m_fftWidth, m_fftHeight);
+        m_kernelSpectrum = KisConvolutionKernelSpectrumCache::fetch(spectrumKey);
 
-        for (auto k = m_channelFFT.begin(); k != m_channelFFT.end(); ++k)
-        {
-            fftw_execute_dft_r2c(fftwPlanForward, (double*)(*k), *k);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
+        if (!m_kernelSpectrum) {
+            m_kernelSpectrum.reset(new KisConvolutionKernelSpectrumCache::Spectrum(m_fftLength));
+            fftFillKernelMatrix(kernel, m_kernelSpectrum->data);
+            fftw_execute_dft_r2c(fftwPlanForward, (double*)m_kernelSpectrum->data, m_kernelSpectrum->data);
+
+            KisConvolutionKernelSpectrumCache::insert(spectrumKey, m_kernelSpectrum);
+        }
+
+        addToProgress(10);
+
+        /**
+         * When the source and the destination is the same device, the
+         * tiles would read the pixels already written by their neighbours,
+         * so they read from a (copy-on-write) snapshot of the source.
+         */
+        KisPaintDeviceSP source = src;
+        if (src == this->m_painter->device()) {
+            source = new KisPaintDevice(*src);
+        }
+
+        QVector<QRect> tiles;
+        for (int y = alignDown(dstRect.top() - tileOrigin.y(), tileHeight) + tileOrigin.y();
+             y <= dstRect.bottom(); y += tileHeight) {
 
-            fftMultiply(*k, m_kernelFFT);
+            for (int x = alignDown(dstRect.left() - tileOrigin.x(), tileWidth) + tileOrigin.x();
+                 x <= dstRect.right(); x += tileWidth) {
 
-            fftw_execute_dft_c2r(fftwPlanBackward, *k, (double*)*k);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
+                tiles.append(QRect(x, y, tileWidth, tileHeight) & dstRect);
+            }
         }
 
+        const float progressPerTile = 90.0 / tiles.size();
+        QAtomicInt isCancelled(0);
+        QMutex progressMutex;
+
+        QtConcurrent::blockingMap(tiles,
+            [&] (const QRect &tile) {
+                if (isCancelled.loadAcquire()) return;
+
+                convolveTile(source, tile, srcOffset,
+                             halfKernelWidth, halfKernelHeight,
+                             cacheRowStride, info, dataRect,
+                             fftwPlanForward, fftwPlanBackward);
+
+                QMutexLocker l(&progressMutex);
+                addToProgress(progressPerTile);
+
+                if (isInterrupted()) {
+                    isCancelled.storeRelease(1);
+                }
+            });
+
         KisConvolutionWorkerFFTLock::fftwMutex.lock();
         fftw_destroy_plan(fftwPlanForward);
         fftw_destroy_plan(fftwPlanBackward);
         KisConvolutionWorkerFFTLock::fftwMutex.unlock();
 
-
-        writeResultToDevice(QRect(dstPos.x(), dstPos.y(), areaSize.width(), areaSize.height()),
-                            cacheRowStride, halfKernelWidth, halfKernelHeight,
-                            info, dataRect);
-
-        addToProgress(20);
-        cleanUp();
+        m_kernelSpectrum.clear();
     }
 
     struct FFTInfo {
@@ -209,11 +346,53 @@ public:
         int alphaRealPos {-1};
     };
 
+    void convolveTile(KisPaintDeviceSP src,
+                      const QRect &tile,
+                      const QPoint &srcOffset,
+                      const quint32 halfKernelWidth,
+                      const quint32 halfKernelHeight,
+                      const int cacheRowStride,
+                      const FFTInfo &info,
+                      const QRect &dataRect,
+                      fftw_plan fftwPlanForward,
+                      fftw_plan fftwPlanBackward)
+    {
+        // the buffers are zero-filled, so the incomplete tiles
+        // are just padded with zeros
+        QVector<QSharedPointer<KisConvolutionKernelSpectrumCache::Spectrum> > channelBuffers;
+        QVector<fftw_complex*> channelFFT;
+
+        for (int i = 0; i < info.numChannels(); i++) {
+            channelBuffers.append(QSharedPointer<KisConvolutionKernelSpectrumCache::Spectrum>(
+                new KisConvolutionKernelSpectrumCache::Spectrum(m_fftLength)));
+            channelFFT.append(channelBuffers.last()->data);
+        }
+
+        fillCacheFromDevice(src,
+                            QRect(tile.x() + srcOffset.x() - halfKernelWidth,
+                                  tile.y() + srcOffset.y() - halfKernelHeight,
+                                  tile.width() + 2 * halfKernelWidth,
+                                  tile.height() + 2 * halfKernelHeight),
+                            cacheRowStride,
+                            info, dataRect, channelFFT);
+
+        Q_FOREACH (fftw_complex *channel, channelFFT) {
+            fftw_execute_dft_r2c(fftwPlanForward, (double*)channel, channel);
+            fftMultiply(channel, m_kernelSpectrum->data);
+            fftw_execute_dft_c2r(fftwPlanBackward, channel, (double*)channel);
+        }
+
+        writeResultToDevice(tile,
+                            cacheRowStride, halfKernelWidth, halfKernelHeight,
+                            info, dataRect, channelFFT);
+    }
+
     void fillCacheFromDevice(KisPaintDeviceSP src,
                              const QRect &rect,
                              const int cacheRowStride,
                              const FFTInfo &info,
-                             const QRect &dataRect) {
+                             const QRect &dataRect,
+                             const QVector<fftw_complex*> &channelFFT) {
 
         typename _IteratorFactory_::HLineConstIterator hitSrc =
             _IteratorFactory_::createHLineConstIterator(src,
@@ -225,7 +404,7 @@ public:
         const auto channelPtrBegin = channelPtr.begin();
         const auto channelPtrEnd = channelPtr.end();
 
-        auto iFFt = m_channelFFT.constBegin();
+        auto iFFt = channelFFT.constBegin();
         for (auto i = channelPtrBegin; i != channelPtrEnd; ++i, ++iFFt) {
             *i = (double*)*iFFt;
         }
@@ -318,7 +497,8 @@ public:
                              const int halfKernelWidth,
                              const int halfKernelHeight,
                              const FFTInfo &info,
-                             const QRect &dataRect) {
+                             const QRect &dataRect,
+                             const QVector<fftw_complex*> &channelFFT) {
 
         typename _IteratorFactory_::HLineIterator hitDst =
             _IteratorFactory_::createHLineIterator(this->m_painter->device(),
@@ -332,7 +512,7 @@ public:
         const auto channelPtrBegin = channelPtr.begin();
         const auto channelPtrEnd = channelPtr.end();
 
-        auto iFFt = m_channelFFT.constBegin();
+        auto iFFt = channelFFT.constBegin();
         for (auto i = channelPtrBegin; i != channelPtrEnd; ++i, ++iFFt) {
             *i = (double*)*iFFt + initialOffset;
         }
@@ -410,7 +590,7 @@ public:
     }
 
 private:
-    void fftFillKernelMatrix(const KisConvolutionKernelSP kernel, fftw_complex *m_kernelFFT)
+    void fftFillKernelMatrix(const KisConvolutionKernelSP kernel, fftw_complex *kernelFFT)
     {
         // find central item
         QPoint offset((kernel->width() - 1) / 2, (kernel->height() - 1) / 2);
@@ -432,7 +612,7 @@ private:
                 if (absXpos >= m_fftWidth)
                     absXpos -= m_fftWidth;
 
-                ((double*)m_kernelFFT)[(m_fftWidth + m_extraMem) * absYpos + absXpos] = kernel->data()->coeff(y, x);
+                ((double*)kernelFFT)[(m_fftWidth + m_extraMem) * absYpos + absXpos] = kernel->data()->coeff(y, x);
             }
         }
     }
@@ -458,26 +638,51 @@ private:
         }
     }
 
-    void optimumDimensions(quint32& w, quint32& h)
+    static quint32 optimumFFTSize(quint32 size)
+    {
+        // FFTW is most efficient when the array size has
+        // no prime factors other than 2, 3, 5 and 7
+        auto isOptimum = [] (quint32 value) {
+            for (quint32 factor : {2, 3, 5, 7}) {
+                while (value % factor == 0) {
+                    value /= factor;
+                }
+            }
+            return value == 1;
+        };
+
+        while (!isOptimum(size)) {
+            ++size;
+        }
+
+        return size;
+    }
+
+    static int alignDown(int value, int step)
     {
-        // FFTW is most efficient when array size is a factor of 2, 3, 5 or 7
-        quint32 optW = w, optH = h;
+        return value >= 0 ? value / step * step : -((-value + step - 1) / step * step);
+    }
 
-        while ((optW % 2 != 0) || (optW % 3 != 0) || (optW % 5 != 0) || (optW % 7 != 0))
-            ++optW;
+    /**
+     * The size of the tiles along one axis. The FFT block of a tile is
+     * about four times bigger than the kernel, which keeps the overhead
+     * of the overlapping borders low, but is not bigger than 2048
+     * pixels, unless the kernel itself is huge. The size is a multiple
+     * of the device tile size, but is never bigger than the area,
+     * aligned to the device tiles.
+     */
+    static int tileSize(quint32 halfKernelSize, int areaOffset, int areaSize)
+    {
+        const int deviceTileSize = 64;
+        const int kernelSize = 2 * halfKernelSize + 1;
 
-        while ((optH % 2 != 0) || (optH % 3 != 0) || (optH % 5 != 0) || (optH % 7 != 0))
-            ++optH;
+        const int preferredSize = qMin(4 * kernelSize, 2048) - 2 * int(halfKernelSize);
+        const int size = qMax(deviceTileSize, alignDown(preferredSize, deviceTileSize));
 
-        quint32 optAreaW = optW * h;
-        quint32 optAreaH = optH * w;
+        const int alignedStart = alignDown(areaOffset, deviceTileSize);
+        const int alignedEnd = alignDown(areaOffset + areaSize - 1, deviceTileSize) + deviceTileSize;
 
-        if (optAreaW < optAreaH) {
-            w = optW;
-        }
-        else {
-            h = optH;
-        }
+        return qMin(size, alignedEnd - alignedStart);
     }
 
     void fftLogMatrix(double* channel, const QString &f)
@@ -521,26 +726,9 @@ private:
 
     bool isInterrupted()
     {
-        if (this->m_progress && this->m_progress->interrupted()) {
-            cleanUp();
-            return true;
-        }
-
-        return false;
+        return this->m_progress && this->m_progress->interrupted();
     }
 
-    void cleanUp()
-    {
-        // free kernel fft data
-        if (m_kernelFFT) {
-            fftw_free(m_kernelFFT);
-        }
-
-        Q_FOREACH (fftw_complex *channel, m_channelFFT) {
-            fftw_free(channel);
-        }
-        m_channelFFT.clear();
-    }
 private:
     quint32 m_fftWidth {0};
     quint32 m_fftHeight {0};
@@ -548,8 +736,7 @@ private:
     quint32 m_extraMem {0};
     float m_currentProgress {0.0};
 
-    fftw_complex* m_kernelFFT {0};
-    QVector<fftw_complex*> m_channelFFT;
+    KisConvolutionKernelSpectrumCache::SpectrumSP m_kernelSpectrum;
 };
 
 #endif
@@ -4,6 +4,7 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include <QDomDocument>
@@ -26,6 +27,7 @@ KisCurveCircleMaskGenerator::KisCurveCircleMaskGenerator(qreal diameter, qreal r
     // here we set resolution for the maximum size of the brush!
     d->curveResolution = qRound(qMax(width(), height()) * OVERSAMPLING);
     d->curveData = curve.floatTransfer(d->curveResolution + 2);
+    transformCurveForVectorization(d->curveData, d->vectorCurveData);
     d->curvePoints = curve.points();
     setCurveString(curve.toString());
     d->dirty = false;
@@ -119,6 +121,7 @@ void KisCurveCircleMaskGenerator::setSoftness(qreal softness)
     d->dirty = true;
     KisMaskGenerator::setSoftness(softness);
     KisCurveCircleMaskGenerator::transformCurveForSoftness(softness,d->curvePoints, d->curveResolution+2, d->curveData);
+    transformCurveForVectorization(d->curveData, d->vectorCurveData);
     d->dirty = false;
 }
 
@@ -146,6 +149,12 @@ void KisCurveCircleMaskGenerator::transformCurveForSoftness(qreal softness,const
     result = curve.floatTransfer( curveResolution );
 }
 
+void KisCurveCircleMaskGenerator::transformCurveForVectorization(const QVector<qreal> &curveData, QVector<float> &result)
+{
+    result.resize(curveData.size());
+    std::copy(curveData.constBegin(), curveData.constEnd(), result.begin());
+}
+
 void KisCurveCircleMaskGenerator::setMaskScalarApplicator()
 {
     d->applicator.reset(
@@ -51,6 +51,15 @@ public:
 
     static void transformCurveForSoftness(qreal softness,const QList<QPointF> &points, int curveResolution, QVector<qreal> &result);
 
+    /**
+     * Converts \p curveData into a single precision copy used by the
+     * vectorized processors of the curve masks. Gathering floats by
+     * 32-bit indices is a native instruction on AVX2, while gathering
+     * doubles into a float batch falls back to per-lane loads and
+     * conversions.
+     */
+    static void transformCurveForVectorization(const QVector<qreal> &curveData, QVector<float> &result);
+
 private:
 
     qreal norme(qreal a, qreal b) const {
@@ -22,6 +22,7 @@ struct Q_DECL_HIDDEN KisCurveCircleMaskGenerator::Private
         ycoef(rhs.ycoef),
         curveResolution(rhs.curveResolution),
         curveData(rhs.curveData),
+        vectorCurveData(rhs.vectorCurveData),
         curvePoints(rhs.curvePoints),
         dirty(true),
         fadeMaker(rhs.fadeMaker,*this)
@@ -32,6 +33,9 @@ struct Q_DECL_HIDDEN KisCurveCircleMaskGenerator::Private
     qreal ycoef {0.0};
     qreal curveResolution {0.0};
     QVector<qreal> curveData;
+
+    // see KisCurveCircleMaskGenerator::transformCurveForVectorization()
+    QVector<float> vectorCurveData;
     QList<QPointF> curvePoints;
     bool dirty {false};
 
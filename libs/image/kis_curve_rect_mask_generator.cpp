@@ -26,6 +26,7 @@ KisCurveRectangleMaskGenerator::KisCurveRectangleMaskGenerator(qreal diameter, q
 {
     d->curveResolution = qRound( qMax(width(),height()) * OVERSAMPLING);
     d->curveData = curve.floatTransfer( d->curveResolution + 1);
+    KisCurveCircleMaskGenerator::transformCurveForVectorization(d->curveData, d->vectorCurveData);
     d->curvePoints = curve.points();
     setCurveString(curve.toString());
     d->dirty = false;
@@ -109,6 +110,7 @@ void KisCurveRectangleMaskGenerator::setSoftness(qreal softness)
     d->dirty = true;
     KisMaskGenerator::setSoftness(softness);
     KisCurveCircleMaskGenerator::transformCurveForSoftness(softness,d->curvePoints, d->curveResolution + 1, d->curveData);
+    KisCurveCircleMaskGenerator::transformCurveForVectorization(d->curveData, d->vectorCurveData);
     d->dirty = false;
 }
 
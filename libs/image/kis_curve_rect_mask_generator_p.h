@@ -24,6 +24,7 @@ struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
         ycoeff(rhs.ycoeff),
         curveResolution(rhs.curveResolution),
         curveData(rhs.curveData),
+        vectorCurveData(rhs.vectorCurveData),
         curvePoints(rhs.curvePoints),
         dirty(rhs.dirty),
         fadeMaker(rhs.fadeMaker, *this)
@@ -34,6 +35,9 @@ struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
     qreal ycoeff {0.0};
     qreal curveResolution {0.0};
     QVector<qreal> curveData;
+
+    // see KisCurveCircleMaskGenerator::transformCurveForVectorization()
+    QVector<float> vectorCurveData;
     QList<QPointF> curvePoints;
     bool dirty {false};
 
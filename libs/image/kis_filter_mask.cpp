@@ -13,6 +13,7 @@
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_configuration.h"
 #include "filter/kis_filter_registry.h"
+#include "filter/KisFilterResultCache.h"
 #include "kis_selection.h"
 #include "kis_processing_information.h"
 #include "kis_node.h"
@@ -22,9 +23,15 @@
 #include "kis_transaction.h"
 #include "kis_painter.h"
 
+struct KisFilterMask::Private
+{
+    KisFilterResultCache filterCache;
+};
+
 KisFilterMask::KisFilterMask(KisImageWSP image, const QString &name)
     : KisEffectMask(image, name),
-      KisNodeFilterInterface(0)
+      KisNodeFilterInterface(0),
+      m_d(new Private)
 {
     setCompositeOpId(COMPOSITE_COPY);
 }
@@ -36,6 +43,7 @@ KisFilterMask::~KisFilterMask()
 KisFilterMask::KisFilterMask(const KisFilterMask& rhs)
         : KisEffectMask(rhs)
         , KisNodeFilterInterface(rhs)
+        , m_d(new Private)
 {
 }
 
@@ -47,6 +55,7 @@ QIcon KisFilterMask::icon() const
 void KisFilterMask::setFilter(KisFilterConfigurationSP  filterConfig, bool checkCompareConfig)
 {
     KisNodeFilterInterface::setFilter(filterConfig, checkCompareConfig);
+    m_d->filterCache.invalidate();
 }
 
 QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
@@ -54,8 +63,6 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
                                   const QRect & rc,
                                   PositionToFilthy maskPos) const
 {
-    Q_UNUSED(maskPos);
-
     KisFilterConfigurationSP filterConfig = filter();
 
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(nodeProgressProxy(), rc);
@@ -81,7 +88,24 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
     KIS_ASSERT_RECOVER_NOOP(this->busyProgressIndicator());
     this->busyProgressIndicator()->update();
 
-    filter->process(src, dst, 0, rc, filterConfig.data(), 0);
+    /**
+     * The input of the filter stays the same when a mask above this
+     * one is changed or when the user paints on our own selection.
+     * Any other change of the mask itself (moving, toggling the
+     * visibility) might have happened while the mask was not
+     * rendered, so the cached result cannot be trusted anymore.
+     */
+    bool reuseCached = maskPos == N_BELOW_FILTHY;
+
+    if (maskPos == N_FILTHY) {
+        if (hasTemporaryTarget()) {
+            reuseCached = true;
+        } else {
+            m_d->filterCache.invalidate();
+        }
+    }
+
+    m_d->filterCache.process(filter, filterConfig, src, dst, rc, reuseCached);
 
     QRect r = filter->changedRect(rc, filterConfig.data(), dst->defaultBounds()->currentLevelOfDetail());
     return r;
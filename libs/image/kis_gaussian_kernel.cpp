@@ -10,6 +10,8 @@
 #include "kis_convolution_kernel.h"
 #include <kis_convolution_painter.h>
 #include <kis_transaction.h>
+#include "KisFastGaussianBlur.h"
+#include "KisMorphology.h"
 #include <QRect>
 
 
@@ -109,6 +111,29 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
 {
     QPoint srcTopLeft = rect.topLeft();
 
+    /**
+     * The size of the convolution kernel grows with the radius, so
+     * the large radii are blurred with the constant-time stacked box
+     * blurs instead. The radii of zero mean "no blur along this axis"
+     */
+    const qreal threshold = KisFastGaussianBlur::radiusThreshold();
+
+    if ((xRadius > 0.0 || yRadius > 0.0) &&
+        (xRadius <= 0.0 || xRadius >= threshold) &&
+        (yRadius <= 0.0 || yRadius >= threshold)) {
+
+        QScopedPointer<KisTransaction> transaction;
+        if (createTransaction) {
+            transaction.reset(new KisTransaction(device));
+        }
+
+        if (KisFastGaussianBlur::apply(device, rect,
+                                       xRadius > 0.0 ? sigmaFromRadius(xRadius) : 0.0,
+                                       yRadius > 0.0 ? sigmaFromRadius(yRadius) : 0.0,
+                                       channelFlags, progressUpdater, borderOp)) {
+            return;
+        }
+    }
 
     if (KisConvolutionPainter::supportsFFTW()) {
         KisConvolutionPainter painter(device, KisConvolutionPainter::FFTW);
@@ -345,6 +370,22 @@ void KisGaussianKernel::applyDilate(KisPaintDeviceSP device, const QRect &rect,
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN(device->colorSpace()->pixelSize() == 1);
 
+    /**
+     * The cost of the convolution grows with the area of the disk,
+     * the large radii are processed by the morphology engine instead
+     */
+    if (radius >= KisMorphology::radiusThreshold()) {
+        QScopedPointer<KisTransaction> transaction;
+        if (createTransaction) {
+            transaction.reset(new KisTransaction(device));
+        }
+
+        KisMorphology::apply(device, rect, KisMorphology::Dilate, KisMorphology::Ellipse,
+                             qRound(radius), qRound(radius),
+                             channelFlags, progressUpdater, BORDER_REPEAT);
+        return;
+    }
+
     QPoint srcTopLeft = rect.topLeft();
 
     KisConvolutionPainter painter(device);
@@ -371,6 +412,18 @@ void KisGaussianKernel::applyErodeU8(KisPaintDeviceSP device, const QRect &rect,
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN(device->colorSpace()->pixelSize() == 1);
 
+    if (radius >= KisMorphology::radiusThreshold()) {
+        QScopedPointer<KisTransaction> transaction;
+        if (createTransaction) {
+            transaction.reset(new KisTransaction(device));
+        }
+
+        KisMorphology::apply(device, rect, KisMorphology::Erode, KisMorphology::Ellipse,
+                             qRound(radius), qRound(radius),
+                             channelFlags, progressUpdater, BORDER_REPEAT);
+        return;
+    }
+
     {
         KisSequentialIterator dstIt(device, rect);
         while (dstIt.nextPixel()) {
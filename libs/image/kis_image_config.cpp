@@ -80,6 +80,17 @@ void KisImageConfig::setEnablePerfLog(bool value)
     m_config.writeEntry("enablePerfLog", value);
 }
 
+QString KisImageConfig::strokeRecordingFile(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("strokeRecordingFile", QString()) : QString();
+}
+
+void KisImageConfig::setStrokeRecordingFile(const QString &value)
+{
+    m_config.writeEntry("strokeRecordingFile", value);
+}
+
 qreal KisImageConfig::transformMaskOffBoundsReadArea() const
 {
     return m_config.readEntry("transformMaskOffBoundsReadArea", 0.5);
@@ -24,6 +24,15 @@ public:
     bool enablePerfLog(bool requestDefault = false) const;
     void setEnablePerfLog(bool value);
 
+    /**
+     * When not empty, the freehand tool appends the tablet events of
+     * every stroke to this file.
+     *
+     * \see KisStrokeRecording
+     */
+    QString strokeRecordingFile(bool requestDefault = false) const;
+    void setStrokeRecordingFile(const QString &value);
+
     qreal transformMaskOffBoundsReadArea() const;
 
     int updatePatchHeight() const;
@@ -16,11 +16,15 @@
 
 #include <QVector>
 #include <QGlobalStatic>
+#include <QtConcurrent>
 
 #include <KoColorSpaceMaths.h>
+#include <KoMultiArchBuildSupport.h>
 
 #include <kis_debug.h>
 #include "kis_iterator_ng.h"
+#include "KisHaarWaveletKernelBase.h"
+#include "KisHaarWaveletKernelFactoryImpl.h"
 
 #include "math.h"
 
@@ -59,6 +63,65 @@ void fromDoubleCheckNullF(quint8* data, int channelpos, double v, bool *isNull)
 }
 
 
+namespace {
+
+const KisHaarWaveletKernelBase *waveletKernel()
+{
+    static const QScopedPointer<KisHaarWaveletKernelBase> kernel(
+        createOptimizedClass<KisHaarWaveletKernelFactoryImpl>());
+    return kernel.data();
+}
+
+/**
+ * Calls \p func for consecutive ranges of \p numRows rows in parallel.
+ * The small levels of the transform are not worth the threading
+ * overhead, so they are processed in the calling thread.
+ */
+template<typename Func>
+void processRowRanges(int numRows, int rowLength, Func func)
+{
+    const int minValuesPerJob = 1 << 16;
+    const int rowsPerJob = qMax(1, minValuesPerJob / qMax(1, rowLength));
+
+    if (numRows <= rowsPerJob) {
+        func(0, numRows);
+        return;
+    }
+
+    QVector<QPair<int, int>> jobs;
+    for (int row = 0; row < numRows; row += rowsPerJob) {
+        jobs.append(qMakePair(row, qMin(row + rowsPerJob, numRows)));
+    }
+
+    QtConcurrent::blockingMap(jobs,
+        [&] (const QPair<int, int> &job) {
+            func(job.first, job.second);
+        });
+}
+
+/**
+ * Splits \p rect into horizontal strips aligned to the tiles of \p device,
+ * so that the strips could be read or written in parallel
+ */
+QVector<QRect> splitIntoTileRows(KisPaintDeviceSP device, const QRect &rect)
+{
+    const int tileSize = 64;
+    QVector<QRect> strips;
+
+    int top = rect.top();
+    while (top <= rect.bottom()) {
+        const int offset = (top - device->y()) % tileSize;
+        const int height = qMin(tileSize - (offset < 0 ? offset + tileSize : offset),
+                                rect.bottom() - top + 1);
+        strips.append(QRect(rect.x(), top, rect.width(), height));
+        top += height;
+    }
+
+    return strips;
+}
+
+}
+
 void KisMathToolbox::transformToFR(KisPaintDeviceSP src, KisFloatRepresentation* fr, const QRect& rect)
 {
     qint32 depth = src->colorSpace()->colorChannelCount();
@@ -72,19 +135,24 @@ void KisMathToolbox::transformToFR(KisPaintDeviceSP src, KisFloatRepresentation*
     if (!getToDoubleChannelPtr(cis, f))
         return;
 
-    KisHLineConstIteratorSP srcIt = src->createHLineIteratorNG(rect.x(), rect.y(), rect.width());
-
-    for (int i = rect.y(); i < rect.height(); i++) {
-        float *dstIt = fr->coeffs + (i - rect.y()) * fr->size * fr->depth;
-        do {
-            const quint8* v1 = srcIt->oldRawData();
-            for (int k = 0; k < depth; k++) {
-                *dstIt = f[k](v1, cis[k]->pos());
-                ++dstIt;
+    QVector<QRect> strips = splitIntoTileRows(src, rect);
+
+    QtConcurrent::blockingMap(strips,
+        [&] (const QRect &strip) {
+            KisHLineConstIteratorSP srcIt = src->createHLineConstIteratorNG(strip.x(), strip.y(), strip.width());
+
+            for (int i = strip.top(); i <= strip.bottom(); i++) {
+                float *dstIt = fr->coeffs + (i - rect.y()) * fr->size * fr->depth;
+                do {
+                    const quint8* v1 = srcIt->oldRawData();
+                    for (int k = 0; k < depth; k++) {
+                        *dstIt = f[k](v1, cis[k]->pos());
+                        ++dstIt;
+                    }
+                } while (srcIt->nextPixel());
+                srcIt->nextRow();
             }
-        } while (srcIt->nextPixel());
-        srcIt->nextRow();
-    }
+        });
 }
 
 bool KisMathToolbox::getToDoubleChannelPtr(QList<KoChannelInfo *> cis, QVector<PtrToDouble>& f)
@@ -136,18 +204,24 @@ void KisMathToolbox::transformFromFR(KisPaintDeviceSP dst, KisFloatRepresentatio
     if (!getFromDoubleChannelPtr(cis, f))
         return;
 
-    KisHLineIteratorSP dstIt = dst->createHLineIteratorNG(rect.x(), rect.y(), rect.width());
-    for (int i = rect.y(); i < rect.height(); i++) {
-        float *srcIt = fr->coeffs + (i - rect.y()) * fr->size * fr->depth;
-        do {
-            quint8* v1 = dstIt->rawData();
-            for (int k = 0; k < depth; k++) {
-                f[k](v1, cis[k]->pos(), *srcIt);
-                ++srcIt;
+    QVector<QRect> strips = splitIntoTileRows(dst, rect);
+
+    QtConcurrent::blockingMap(strips,
+        [&] (const QRect &strip) {
+            KisHLineIteratorSP dstIt = dst->createHLineIteratorNG(strip.x(), strip.y(), strip.width());
+
+            for (int i = strip.top(); i <= strip.bottom(); i++) {
+                float *srcIt = fr->coeffs + (i - rect.y()) * fr->size * fr->depth;
+                do {
+                    quint8* v1 = dstIt->rawData();
+                    for (int k = 0; k < depth; k++) {
+                        f[k](v1, cis[k]->pos(), *srcIt);
+                        ++srcIt;
+                    }
+                } while(dstIt->nextPixel());
+                dstIt->nextRow();
             }
-        } while(dstIt->nextPixel());
-        dstIt->nextRow();
-    }
+        });
 }
 
 bool KisMathToolbox::getFromDoubleChannelPtr(QList<KoChannelInfo *> cis, QVector<PtrFromDouble>& f)
@@ -258,71 +332,87 @@ double KisMathToolbox::maxChannelValue(KoChannelInfo *c)
 
 void KisMathToolbox::wavetrans(KisMathToolbox::KisWavelet* wav, KisMathToolbox::KisWavelet* buff, uint halfsize)
 {
-    uint l = (2 * halfsize) * wav->depth * sizeof(float);
-    for (uint i = 0; i < halfsize; i++) {
-        float * itLL = buff->coeffs + i * buff->size * buff->depth;
-        float * itHL = buff->coeffs + (i * buff->size + halfsize) * buff->depth;
-        float * itLH = buff->coeffs + (halfsize + i) * buff->size * buff->depth;
-        float * itHH = buff->coeffs + ((halfsize + i) * buff->size + halfsize) * buff->depth;
-        float * itS11 = wav->coeffs + 2 * i * wav->size * wav->depth;
-        float * itS12 = wav->coeffs + (2 * i * wav->size + 1) * wav->depth;
-        float * itS21 = wav->coeffs + (2 * i + 1) * wav->size * wav->depth;
-        float * itS22 = wav->coeffs + ((2 * i + 1) * wav->size + 1) * wav->depth;
-        for (uint j = 0; j < halfsize; j++) {
-            for (uint k = 0; k < wav->depth; k++) {
-                *(itLL++) = (*itS11 + *itS12 + *itS21 + *itS22) * M_SQRT1_2;
-                *(itHL++) = (*itS11 - *itS12 + *itS21 - *itS22) * M_SQRT1_2;
-                *(itLH++) = (*itS11 + *itS12 - *itS21 - *itS22) * M_SQRT1_2;
-                *(itHH++) = (*(itS11++) - *(itS12++) - *(itS21++) + *(itS22++)) * M_SQRT1_2;
-            }
-            itS11 += wav->depth; itS12 += wav->depth;
-            itS21 += wav->depth; itS22 += wav->depth;
-        }
-    }
-    for (uint i = 0; i < halfsize; i++) {
-        uint p = i * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-        p = (i + halfsize) * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-    }
-    if (halfsize != 1) {
-        wavetrans(wav, buff, halfsize / 2);
+    const KisHaarWaveletKernelBase *kernel = waveletKernel();
+    const int depth = wav->depth;
+    const int stride = wav->size * depth;
+
+    for (int h = halfsize; h >= 1; h /= 2) {
+        const int rowLength = 2 * h * depth;
+
+        // horizontal step: the rows of wav are split into the low-pass
+        // and high-pass halves of the rows of buff
+        processRowRanges(2 * h, rowLength,
+            [&] (int begin, int end) {
+                for (int r = begin; r < end; r++) {
+                    kernel->splitPairs(wav->coeffs + r * stride,
+                                       buff->coeffs + r * stride,
+                                       buff->coeffs + r * stride + h * depth,
+                                       h, depth, 1.0f);
+                }
+            });
+
+        // vertical step: the pairs of rows of buff are merged back into
+        // the top (LL, HL) and the bottom (LH, HH) halves of wav
+        processRowRanges(h, 2 * rowLength,
+            [&] (int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    kernel->sumDifference(buff->coeffs + 2 * i * stride,
+                                          buff->coeffs + (2 * i + 1) * stride,
+                                          wav->coeffs + i * stride,
+                                          wav->coeffs + (h + i) * stride,
+                                          rowLength, float(M_SQRT1_2));
+                }
+            });
     }
 }
 
 void KisMathToolbox::waveuntrans(KisMathToolbox::KisWavelet* wav, KisMathToolbox::KisWavelet* buff, uint halfsize)
 {
-    uint l = (2 * halfsize) * wav->depth * sizeof(float);
-    for (uint i = 0; i < halfsize; i++) {
-        float * itLL = wav->coeffs + i * buff->size * buff->depth;
-        float * itHL = wav->coeffs + (i * buff->size + halfsize) * buff->depth;
-        float * itLH = wav->coeffs + (halfsize + i) * buff->size * buff->depth;
-        float * itHH = wav->coeffs + ((halfsize + i) * buff->size + halfsize) * buff->depth;
-        float * itS11 = buff->coeffs + 2 * i * wav->size * wav->depth;
-        float * itS12 = buff->coeffs + (2 * i * wav->size + 1) * wav->depth;
-        float * itS21 = buff->coeffs + (2 * i + 1) * wav->size * wav->depth;
-        float * itS22 = buff->coeffs + ((2 * i + 1) * wav->size + 1) * wav->depth;
-        for (uint j = 0; j < halfsize; j++) {
-            for (uint k = 0; k < wav->depth; k++) {
-                *(itS11++) = (*itLL + *itHL + *itLH + *itHH) * 0.25 * M_SQRT2;
-                *(itS12++) = (*itLL - *itHL + *itLH - *itHH) * 0.25 * M_SQRT2;
-                *(itS21++) = (*itLL + *itHL - *itLH - *itHH) * 0.25 * M_SQRT2;
-                *(itS22++) = (*(itLL++) - *(itHL++) - *(itLH++) + *(itHH++)) * 0.25 * M_SQRT2;
-            }
-            itS11 += wav->depth; itS12 += wav->depth;
-            itS21 += wav->depth; itS22 += wav->depth;
-        }
-    }
-    for (uint i = 0; i < halfsize; i++) {
-        uint p = i * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-        p = (i + halfsize) * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
+    const KisHaarWaveletKernelBase *kernel = waveletKernel();
+    const int depth = wav->depth;
+    const int stride = wav->size * depth;
+
+    for (int h = halfsize; h <= int(wav->size / 2); h *= 2) {
+        const int rowLength = 2 * h * depth;
+
+        processRowRanges(h, 2 * rowLength,
+            [&] (int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    kernel->sumDifference(wav->coeffs + i * stride,
+                                          wav->coeffs + (h + i) * stride,
+                                          buff->coeffs + 2 * i * stride,
+                                          buff->coeffs + (2 * i + 1) * stride,
+                                          rowLength, float(0.25 * M_SQRT2));
+                }
+            });
+
+        processRowRanges(2 * h, rowLength,
+            [&] (int begin, int end) {
+                for (int r = begin; r < end; r++) {
+                    kernel->mergePairs(buff->coeffs + r * stride,
+                                       buff->coeffs + r * stride + h * depth,
+                                       wav->coeffs + r * stride,
+                                       h, depth, 1.0f);
+                }
+            });
     }
+}
 
-    if (halfsize != wav->size / 2) {
-        waveuntrans(wav, buff, halfsize*2);
-    }
+void KisMathToolbox::waveletSoftThreshold(KisWavelet* wav, float threshold)
+{
+    const KisHaarWaveletKernelBase *kernel = waveletKernel();
+
+    // the very first pixel keeps the average of the whole image
+    float * const begin = wav->coeffs + wav->depth;
+    const int numValues = wav->size * wav->size * wav->depth - wav->depth;
+    const int chunkSize = 1 << 16;
+
+    processRowRanges((numValues + chunkSize - 1) / chunkSize, chunkSize,
+        [&] (int first, int last) {
+            const int from = first * chunkSize;
+            const int to = qMin(last * chunkSize, numValues);
+            kernel->softThreshold(begin + from, to - from, threshold);
+        });
 }
 
 KisMathToolbox::KisWavelet* KisMathToolbox::fastWaveletTransformation(KisPaintDeviceSP src, const QRect& rect,  KisWavelet* buff)
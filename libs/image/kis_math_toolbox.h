@@ -91,6 +91,13 @@ public:
      */
     void fastWaveletUntransformation(KisPaintDeviceSP dst, const QRect&, KisWavelet* wav, KisWavelet* buff = 0);
 
+    /**
+     * Shrinks all the coefficients of the wavelet, except the average of the
+     * image, towards zero by \p threshold. The coefficients with the magnitude
+     * below the threshold become zero.
+     */
+    void waveletSoftThreshold(KisWavelet* wav, float threshold);
+
     bool getToDoubleChannelPtr(QList<KoChannelInfo *> cis, QVector<PtrToDouble>& f);
     bool getFromDoubleChannelPtr(QList<KoChannelInfo *> cis, QVector<PtrFromDouble>& f);
     bool getFromDoubleCheckNullChannelPtr(QList<KoChannelInfo *> cis, QVector<PtrFromDoubleCheckNull>& f);
@@ -100,6 +107,12 @@ public:
 
 private:
 
+    /**
+     * The levels of the transform are computed in place in \p wav, starting
+     * with \p halfsize. Every level is split into the horizontal and the
+     * vertical step, each of them reads one of the buffers and writes the
+     * other one, so no copying is needed.
+     */
     void wavetrans(KisWavelet* wav, KisWavelet* buff, uint halfsize);
     void waveuntrans(KisWavelet* wav, KisWavelet* buff, uint halfsize);
 
@@ -9,11 +9,15 @@
 
 #include <algorithm>
 
+#include <QBitArray>
+
 #include <klocalizedstring.h>
 
 #include <KoColorSpace.h>
 #include "kis_convolution_painter.h"
 #include "kis_convolution_kernel.h"
+#include "KisFastGaussianBlur.h"
+#include "KisMorphology.h"
 #include "kis_pixel_selection.h"
 #include <kis_sequential_iterator.h>
 
@@ -509,6 +513,23 @@ QRect KisFeatherSelectionFilter::changeRect(const QRect& rect, KisDefaultBoundsB
 
 void KisFeatherSelectionFilter::process(KisPixelSelectionSP pixelSelection, const QRect& rect)
 {
+    /**
+     * The kernel below is a Gaussian truncated at one sigma, which is
+     * close to a box. Large radii are blurred with a stack of one wide
+     * and two narrow boxes instead, which has nearly the same variance
+     * and reaches exactly as far as the kernel.
+     */
+    if (m_radius >= KisFastGaussianBlur::radiusThreshold()) {
+        const int narrowRadius = m_radius / 16;
+        const QVector<int> radii = {m_radius - 2 * narrowRadius, narrowRadius, narrowRadius};
+
+        if (KisFastGaussianBlur::applyBoxes(pixelSelection, rect, radii, radii,
+                                            pixelSelection->colorSpace()->channelFlags(false, true),
+                                            0, BORDER_REPEAT)) {
+            return;
+        }
+    }
+
     // compute horizontal kernel
     const uint kernelSize = m_radius * 2 + 1;
     Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> gaussianMatrix(1, kernelSize);
@@ -557,10 +578,28 @@ QRect KisGrowSelectionFilter::changeRect(const QRect& rect, KisDefaultBoundsBase
     return rect.adjusted(-m_xRadius, -m_yRadius, m_xRadius, m_yRadius);
 }
 
+void KisGrowSelectionFilter::setUseMorphology(bool value)
+{
+    m_useMorphology = value;
+}
+
 void KisGrowSelectionFilter::process(KisPixelSelectionSP pixelSelection, const QRect& rect)
 {
     if (m_xRadius <= 0 || m_yRadius <= 0) return;
 
+    /**
+     * The cost of the code below grows with the radius, so the large
+     * radii are processed by the morphology engine, which produces
+     * exactly the same ellipse
+     */
+    if (m_useMorphology && qMin(m_xRadius, m_yRadius) >= KisMorphology::radiusThreshold()) {
+        KisMorphology::apply(pixelSelection, rect,
+                             KisMorphology::Dilate, KisMorphology::Ellipse,
+                             m_xRadius, m_yRadius,
+                             QBitArray(), 0, BORDER_IGNORE);
+        return;
+    }
+
     /**
         * Much code resembles Shrink filter, so please fix bugs
         * in both filters
@@ -684,10 +723,29 @@ QRect KisShrinkSelectionFilter::changeRect(const QRect& rect, KisDefaultBoundsBa
     return m_edgeLock ? defaultBounds->imageBorderRect() : rect;
 }
 
+void KisShrinkSelectionFilter::setUseMorphology(bool value)
+{
+    m_useMorphology = value;
+}
+
 void KisShrinkSelectionFilter::process(KisPixelSelectionSP pixelSelection, const QRect& rect)
 {
     if (m_xRadius <= 0 || m_yRadius <= 0) return;
 
+    /**
+     * Large radii are processed by the morphology engine, which produces
+     * exactly the same ellipse. With the edge lock the pixels outside the
+     * image are considered to be equal to the ones on its border.
+     */
+    if (m_useMorphology && qMin(m_xRadius, m_yRadius) >= KisMorphology::radiusThreshold()) {
+        KisMorphology::apply(pixelSelection, rect,
+                             KisMorphology::Erode, KisMorphology::Ellipse,
+                             m_xRadius, m_yRadius,
+                             QBitArray(), 0,
+                             m_edgeLock ? BORDER_REPEAT : BORDER_IGNORE);
+        return;
+    }
+
     /*
         pretty much the same as fatten_region only different
         blame all bugs in this function on jaycox@gimp.org
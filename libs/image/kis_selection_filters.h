@@ -100,9 +100,15 @@ public:
 
     void process(KisPixelSelectionSP pixelSelection, const QRect &rect) override;
 
+    /**
+     * Large radii are processed by KisMorphology by default, disabling
+     * it lets the benchmarks compare the two implementations
+     */
+    void setUseMorphology(bool value);
+
 private:
     qint32 m_xRadius;
-    qint32 m_yRadius;
+    qint32 m_yRadius;    bool m_useMorphology {true};
 };
 
 class KRITAIMAGE_EXPORT KisShrinkSelectionFilter : public KisSelectionFilter
@@ -116,10 +122,16 @@ public:
 
     void process(KisPixelSelectionSP pixelSelection, const QRect &rect) override;
 
+    /**
+     * Large radii are processed by KisMorphology by default, disabling
+     * it lets the benchmarks compare the two implementations
+     */
+    void setUseMorphology(bool value);
+
 private:
     qint32 m_xRadius;
     qint32 m_yRadius;
-    qint32 m_edgeLock;
+    qint32 m_edgeLock;    bool m_useMorphology {true};
 };
 
 class KRITAIMAGE_EXPORT KisSmoothSelectionFilter : public KisSelectionFilter
@@ -0,0 +1,120 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFastGaussianBlurTest.h"
+
+#include <cmath>
+
+#include <QBitArray>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
+#include "kis_convolution_painter.h"
+#include "kis_convolution_kernel.h"
+#include "kis_gaussian_kernel.h"
+#include "KisFastGaussianBlur.h"
+#include "testutil.h"
+#include "testing_timed_default_bounds.h"
+
+#include <simpletest.h>
+
+void KisFastGaussianBlurTest::testBoxRadii()
+{
+    const QVector<qreal> sigmas = {3.0, 10.0, 30.3, 120.0, 300.3};
+
+    Q_FOREACH (qreal sigma, sigmas) {
+        const QVector<int> radii = KisFastGaussianBlur::boxRadii(sigma);
+        QCOMPARE(radii.size(), 3);
+
+        qreal variance = 0.0;
+        Q_FOREACH (int radius, radii) {
+            const int width = 2 * radius + 1;
+            variance += (width * width - 1) / 12.0;
+        }
+
+        // the widths are consecutive odd numbers, so the variance
+        // can differ from the ideal one by a fraction of a box step
+        QVERIFY2(qAbs(std::sqrt(variance) - sigma) < 0.5,
+                 qPrintable(QString("sigma: %1, stacked: %2").arg(sigma).arg(std::sqrt(variance))));
+    }
+}
+
+void KisFastGaussianBlurTest::testUniformArea()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, 400, 300);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(imageRect));
+
+    const KoColor color(QColor(200, 100, 50, 180), cs);
+    dev->fill(imageRect, color);
+
+    QVERIFY(KisFastGaussianBlur::apply(dev, imageRect.adjusted(50, 50, -50, -50),
+                                       60.0, 30.0, QBitArray(), 0));
+
+    KisSequentialConstIterator it(dev, imageRect);
+    while (it.nextPixel()) {
+        QVERIFY(memcmp(it.rawDataConst(), color.data(), cs->pixelSize()) == 0);
+    }
+}
+
+void KisFastGaussianBlurTest::testCompareWithConvolution()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->alpha8();
+    const QRect imageRect(0, 0, 300, 300);
+    const QRect applyRect = imageRect.adjusted(20, 20, -20, -20);
+    const qreal radius = 40.0;
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(imageRect));
+    dev->fill(QRect(100, 80, 100, 140), KoColor(Qt::white, cs));
+    dev->fill(QRect(20, 20, 30, 30), KoColor(Qt::white, cs));
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(*dev);
+
+    // the convolution, the same way KisGaussianKernel did it
+    // before switching to the box blurs
+    {
+        KisPaintDeviceSP interm = new KisPaintDevice(cs);
+        interm->setDefaultBounds(refDev->defaultBounds());
+
+        KisConvolutionKernelSP kernelHoriz = KisGaussianKernel::createHorizontalKernel(radius);
+        KisConvolutionKernelSP kernelVertical = KisGaussianKernel::createVerticalKernel(radius);
+        const int verticalCenter = kernelVertical->height() / 2;
+
+        KisConvolutionPainter horizPainter(interm, KisConvolutionPainter::SPATIAL);
+        horizPainter.applyMatrix(kernelHoriz, refDev,
+                                 applyRect.topLeft() - QPoint(0, verticalCenter),
+                                 applyRect.topLeft() - QPoint(0, verticalCenter),
+                                 applyRect.size() + QSize(0, 2 * verticalCenter),
+                                 BORDER_REPEAT);
+
+        KisConvolutionPainter verticalPainter(refDev, KisConvolutionPainter::SPATIAL);
+        verticalPainter.applyMatrix(kernelVertical, interm,
+                                    applyRect.topLeft(), applyRect.topLeft(),
+                                    applyRect.size(), BORDER_REPEAT);
+    }
+
+    KisGaussianKernel::applyGaussian(dev, applyRect, radius, radius, QBitArray(), 0);
+
+    int maxDifference = 0;
+
+    KisSequentialConstIterator it(dev, imageRect);
+    KisSequentialConstIterator refIt(refDev, imageRect);
+
+    while (it.nextPixel() && refIt.nextPixel()) {
+        maxDifference = qMax(maxDifference, qAbs(int(*it.rawDataConst()) - int(*refIt.rawDataConst())));
+    }
+
+    QVERIFY2(maxDifference <= 6, qPrintable(QString("max difference: %1").arg(maxDifference)));
+}
+
+SIMPLE_TEST_MAIN(KisFastGaussianBlurTest)
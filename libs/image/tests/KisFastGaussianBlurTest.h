@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFASTGAUSSIANBLURTEST_H
+#define KISFASTGAUSSIANBLURTEST_H
+
+#include <simpletest.h>
+
+class KisFastGaussianBlurTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testBoxRadii();
+    void testUniformArea();
+    void testCompareWithConvolution();
+};
+
+#endif // KISFASTGAUSSIANBLURTEST_H
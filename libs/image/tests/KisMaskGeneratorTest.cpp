@@ -183,4 +183,52 @@ void KisMaskGeneratorTest::testRectangularSoftVectorMask()
     }
 }
 
+void KisMaskGeneratorTest::testCircularCurveScalarMask()
+{
+    QRect bounds(0,0,1000,1000);
+    const KisCubicCurve pointsCurve(QString("0,1;0.3,0.9;0.7,0.1;1,0"));
+    {
+    KisCurveCircleMaskGenerator circScalar(1000, 0.7, 0.8, 0.8, 2, pointsCurve, true);
+    circScalar.setSoftness(0.8);
+    circScalar.setMaskScalarApplicator(); // Force usage of scalar backend
+
+    KisMaskGeneratorTestTester(circScalar.applicator(), bounds);
+    }
+}
+
+void KisMaskGeneratorTest::testCircularCurveVectorMask()
+{
+    QRect bounds(0,0,1000,1000);
+    const KisCubicCurve pointsCurve(QString("0,1;0.3,0.9;0.7,0.1;1,0"));
+    {
+    KisCurveCircleMaskGenerator circVectr(1000, 0.7, 0.8, 0.8, 2, pointsCurve, true);
+    circVectr.setSoftness(0.8);
+    KisMaskGeneratorTestTester(circVectr.applicator(), bounds);
+    }
+}
+
+void KisMaskGeneratorTest::testRectangularCurveScalarMask()
+{
+    QRect bounds(0,0,1000,1000);
+    const KisCubicCurve pointsCurve(QString("0,1;0.3,0.9;0.7,0.1;1,0"));
+    {
+    KisCurveRectangleMaskGenerator circScalar(1000, 0.7, 0.8, 0.8, 2, pointsCurve, true);
+    circScalar.setSoftness(0.8);
+    circScalar.setMaskScalarApplicator(); // Force usage of scalar backend
+
+    KisMaskGeneratorTestTester(circScalar.applicator(), bounds);
+    }
+}
+
+void KisMaskGeneratorTest::testRectangularCurveVectorMask()
+{
+    QRect bounds(0,0,1000,1000);
+    const KisCubicCurve pointsCurve(QString("0,1;0.3,0.9;0.7,0.1;1,0"));
+    {
+    KisCurveRectangleMaskGenerator circVectr(1000, 0.7, 0.8, 0.8, 2, pointsCurve, true);
+    circVectr.setSoftness(0.8);
+    KisMaskGeneratorTestTester(circVectr.applicator(), bounds);
+    }
+}
+
 SIMPLE_TEST_MAIN(KisMaskGeneratorTest)
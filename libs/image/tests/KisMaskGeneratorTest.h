@@ -31,6 +31,12 @@ private Q_SLOTS:
     void testRectangularSoftScalarMask();
     void testRectangularSoftVectorMask();
 
+    void testCircularCurveScalarMask();
+    void testCircularCurveVectorMask();
+
+    void testRectangularCurveScalarMask();
+    void testRectangularCurveVectorMask();
+
 };
 
 #endif // KISMASKGENERATORBENCHMARK_H
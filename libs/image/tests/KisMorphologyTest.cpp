@@ -0,0 +1,180 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisMorphologyTest.h"
+
+#include <QBitArray>
+#include <QtMath>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_global.h"
+#include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
+#include "KisMorphology.h"
+#include "testutil.h"
+#include "testing_timed_default_bounds.h"
+
+#include <simpletest.h>
+
+void KisMorphologyTest::testMatchesBruteForce_data()
+{
+    QTest::addColumn<int>("operation");
+    QTest::addColumn<int>("shape");
+    QTest::addColumn<int>("xRadius");
+    QTest::addColumn<int>("yRadius");
+
+    QTest::newRow("dilate-5-9") << int(KisMorphology::Dilate) << int(KisMorphology::Rectangle) << 5 << 9;
+    QTest::newRow("erode-5-9") << int(KisMorphology::Erode) << int(KisMorphology::Rectangle) << 5 << 9;
+    QTest::newRow("dilate-line") << int(KisMorphology::Dilate) << int(KisMorphology::Rectangle) << 0 << 70;
+    QTest::newRow("erode-large") << int(KisMorphology::Erode) << int(KisMorphology::Rectangle) << 25 << 21;
+    QTest::newRow("ellipse-dilate-12") << int(KisMorphology::Dilate) << int(KisMorphology::Ellipse) << 12 << 12;
+    QTest::newRow("ellipse-erode-9-17") << int(KisMorphology::Erode) << int(KisMorphology::Ellipse) << 9 << 17;
+    QTest::newRow("ellipse-dilate-large") << int(KisMorphology::Dilate) << int(KisMorphology::Ellipse) << 37 << 23;
+    QTest::newRow("ellipse-flat") << int(KisMorphology::Erode) << int(KisMorphology::Ellipse) << 45 << 6;
+    QTest::newRow("ellipse-line") << int(KisMorphology::Erode) << int(KisMorphology::Ellipse) << 15 << 0;
+}
+
+void KisMorphologyTest::testMatchesBruteForce()
+{
+    QFETCH(int, operation);
+    QFETCH(int, shape);
+    QFETCH(int, xRadius);
+    QFETCH(int, yRadius);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    const QRect imageRect(0, 0, 200, 150);
+    const QRect applyRect(17, 23, 120, 80);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(imageRect));
+
+    for (int y = 0; y < imageRect.height(); y += 13) {
+        for (int x = 0; x < imageRect.width(); x += 19) {
+            dev->fill(QRect(x, y, 7, 5),
+                      KoColor(QColor((x * 7) % 256, (y * 11) % 256, (x * y) % 256, 128 + (x + y) % 128), cs));
+        }
+    }
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(*dev);
+
+    QVERIFY(KisMorphology::apply(dev, applyRect,
+                                 KisMorphology::Operation(operation), KisMorphology::Shape(shape),
+                                 xRadius, yRadius, QBitArray(), 0, BORDER_IGNORE));
+
+    // the half-heights of the columns of the structuring element
+    QVector<int> heights(xRadius + 1, yRadius);
+    if (shape == KisMorphology::Ellipse && yRadius > 0) {
+        heights = KisMorphology::ellipseHalfHeights(xRadius, yRadius);
+    }
+
+    const int numChannels = cs->channelCount();
+    const QRect readRect = applyRect.adjusted(-xRadius, -yRadius, xRadius, yRadius);
+
+    QVector<quint16> source(readRect.width() * readRect.height() * numChannels);
+    refDev->readBytes(reinterpret_cast<quint8*>(source.data()), readRect);
+
+    QVector<quint16> result(applyRect.width() * applyRect.height() * numChannels);
+    dev->readBytes(reinterpret_cast<quint8*>(result.data()), applyRect);
+
+    for (int y = 0; y < applyRect.height(); y++) {
+        for (int x = 0; x < applyRect.width(); x++) {
+            for (int c = 0; c < numChannels; c++) {
+                quint16 expected = operation == KisMorphology::Dilate ? 0 : 0xffff;
+
+                for (int i = -xRadius; i <= xRadius; i++) {
+                    const int height = heights[qAbs(i)];
+
+                    for (int j = -height; j <= height; j++) {
+                        const quint16 value =
+                            source[((y + yRadius + j) * readRect.width() + x + xRadius + i) * numChannels + c];
+                        expected = operation == KisMorphology::Dilate ?
+                            qMax(expected, value) : qMin(expected, value);
+                    }
+                }
+
+                const quint16 actual = result[(y * applyRect.width() + x) * numChannels + c];
+
+                if (actual != expected) {
+                    QFAIL(qPrintable(QString("pixel (%1, %2), channel %3: expected %4, got %5")
+                                     .arg(x).arg(y).arg(c).arg(expected).arg(actual)));
+                }
+            }
+        }
+    }
+
+    // the pixels outside the rect are not touched
+    QCOMPARE(dev->exactBounds(), refDev->exactBounds());
+}
+
+void KisMorphologyTest::testEllipseShape()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->alpha8();
+    const QRect imageRect(0, 0, 200, 200);
+    const QPoint center(100, 100);
+    const int radius = 40;
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(imageRect));
+    dev->fill(QRect(center, QSize(1, 1)), KoColor(Qt::white, cs));
+
+    QVERIFY(KisMorphology::apply(dev, imageRect,
+                                 KisMorphology::Dilate, KisMorphology::Ellipse,
+                                 radius, radius, QBitArray(), 0));
+
+    auto isSet = [&] (int dx, int dy) {
+        quint8 value = 0;
+        dev->readBytes(&value, center.x() + dx, center.y() + dy, 1, 1);
+        return value == 255;
+    };
+
+    QCOMPARE(dev->exactBounds(), QRect(center - QPoint(radius, radius), QSize(2 * radius + 1, 2 * radius + 1)));
+
+    // every pixel of the disk is set, and nothing else
+    for (int dy = -radius; dy <= radius; dy++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            const qreal x = qMax(0.0, qAbs(dx) - 0.5);
+            const qreal y = qAbs(dy) - 0.5;
+            const bool inside = pow2(x) + pow2(y) <= pow2(radius);
+            const bool outside = pow2(x) + pow2(qAbs(dy) + 0.5) > pow2(radius + 1);
+
+            if ((inside && !isSet(dx, dy)) || (outside && isSet(dx, dy))) {
+                QFAIL(qPrintable(QString("pixel (%1, %2) is wrong").arg(dx).arg(dy)));
+            }
+        }
+    }
+
+    // the corners of the circumscribed octagon are not there
+    QVERIFY(!isSet(radius, radius / 2));
+    QVERIFY(!isSet(radius / 2, -radius));
+}
+
+void KisMorphologyTest::testErodeKeepsUniformArea()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", 0);
+    const QRect imageRect(0, 0, 400, 300);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(imageRect));
+
+    const KoColor color(QColor(200, 100, 50, 180), cs);
+    dev->fill(imageRect, color);
+
+    // with BORDER_REPEAT the transparent pixels outside
+    // the image should not erode the image border
+    QVERIFY(KisMorphology::apply(dev, imageRect,
+                                 KisMorphology::Erode, KisMorphology::Ellipse,
+                                 60, 30, QBitArray(), 0));
+
+    KisSequentialConstIterator it(dev, imageRect);
+    while (it.nextPixel()) {
+        QVERIFY(memcmp(it.rawDataConst(), color.data(), cs->pixelSize()) == 0);
+    }
+}
+
+SIMPLE_TEST_MAIN(KisMorphologyTest)
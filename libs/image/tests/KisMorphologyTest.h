@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISMORPHOLOGYTEST_H
+#define KISMORPHOLOGYTEST_H
+
+#include <simpletest.h>
+
+class KisMorphologyTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testMatchesBruteForce_data();
+    void testMatchesBruteForce();
+    void testEllipseShape();
+    void testErodeKeepsUniformArea();
+};
+
+#endif // KISMORPHOLOGYTEST_H
@@ -0,0 +1,133 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeRecordingTest.h"
+
+#include <QBuffer>
+#include <QTemporaryDir>
+
+#include "brushengine/KisStrokeRecording.h"
+#include "brushengine/kis_paint_information.h"
+
+#include <simpletest.h>
+
+namespace {
+KisStrokeRecording::Stroke createStroke(int numEvents, qreal offset)
+{
+    KisStrokeRecording::Stroke stroke;
+
+    for (int i = 0; i < numEvents; i++) {
+        KisPaintInformation pi(QPointF(offset + i, 2 * i), 0.5 + 0.01 * i,
+                               10.0, -20.0, 30.0, 0.25, 0.75, 5.0 * i, 1.5);
+
+        stroke.append(KisStrokeRecording::eventFromPaintInformation(pi));
+    }
+
+    return stroke;
+}
+
+void compareStrokes(const KisStrokeRecording::Stroke &lhs, const KisStrokeRecording::Stroke &rhs)
+{
+    QCOMPARE(lhs.size(), rhs.size());
+
+    for (int i = 0; i < lhs.size(); i++) {
+        QCOMPARE(lhs[i].pos, rhs[i].pos);
+        QCOMPARE(lhs[i].pressure, rhs[i].pressure);
+        QCOMPARE(lhs[i].xTilt, rhs[i].xTilt);
+        QCOMPARE(lhs[i].yTilt, rhs[i].yTilt);
+        QCOMPARE(lhs[i].rotation, rhs[i].rotation);
+        QCOMPARE(lhs[i].tangentialPressure, rhs[i].tangentialPressure);
+        QCOMPARE(lhs[i].perspective, rhs[i].perspective);
+        QCOMPARE(lhs[i].time, rhs[i].time);
+        QCOMPARE(lhs[i].speed, rhs[i].speed);
+    }
+}
+}
+
+void KisStrokeRecordingTest::testSaveLoad()
+{
+    KisStrokeRecording recording;
+    recording.addStroke(createStroke(10, 0.0));
+    recording.addStroke(createStroke(3, 100.0));
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    QVERIFY(recording.save(&buffer));
+
+    buffer.seek(0);
+
+    KisStrokeRecording loaded;
+    QVERIFY(loaded.load(&buffer));
+
+    QCOMPARE(loaded.strokes().size(), 2);
+    QCOMPARE(loaded.numEvents(), 13);
+    compareStrokes(loaded.strokes()[0], recording.strokes()[0]);
+    compareStrokes(loaded.strokes()[1], recording.strokes()[1]);
+
+    const KisPaintInformation pi =
+        KisStrokeRecording::paintInformationFromEvent(loaded.strokes()[0][4]);
+
+    QCOMPARE(pi.pos(), QPointF(4.0, 8.0));
+    QCOMPARE(pi.pressure(), qreal(0.54f));
+    QCOMPARE(pi.currentTime(), 20.0);
+    QCOMPARE(pi.drawingSpeed(), 1.5);
+}
+
+void KisStrokeRecordingTest::testAppendStroke()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath("strokes.ksrc");
+
+    QVERIFY(KisStrokeRecording::appendStroke(fileName, createStroke(5, 0.0)));
+    QVERIFY(KisStrokeRecording::appendStroke(fileName, createStroke(7, 50.0)));
+
+    KisStrokeRecording loaded;
+    QVERIFY(loaded.load(fileName));
+
+    QCOMPARE(loaded.strokes().size(), 2);
+    compareStrokes(loaded.strokes()[0], createStroke(5, 0.0));
+    compareStrokes(loaded.strokes()[1], createStroke(7, 50.0));
+}
+
+void KisStrokeRecordingTest::testTruncated()
+{
+    KisStrokeRecording recording;
+    recording.addStroke(createStroke(10, 0.0));
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    QVERIFY(recording.save(&buffer));
+
+    buffer.buffer().chop(5);
+    buffer.seek(0);
+
+    KisStrokeRecording loaded;
+    QVERIFY(!loaded.load(&buffer));
+
+    QBuffer garbage;
+    garbage.setData("not a recording");
+    garbage.open(QIODevice::ReadOnly);
+    QVERIFY(!loaded.load(&garbage));
+}
+
+void KisStrokeRecordingTest::testCorruptedEventCount()
+{
+    KisStrokeRecording recording;
+    recording.addStroke(createStroke(2, 0.0));
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    QVERIFY(recording.save(&buffer));
+
+    // the event count follows the magic and the version
+    buffer.buffer().replace(6, 4, QByteArray(4, '\xff'));
+    buffer.seek(0);
+
+    KisStrokeRecording loaded;
+    QVERIFY(!loaded.load(&buffer));
+}
+
+SIMPLE_TEST_MAIN(KisStrokeRecordingTest)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKERECORDINGTEST_H
+#define KISSTROKERECORDINGTEST_H
+
+#include <simpletest.h>
+
+class KisStrokeRecordingTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSaveLoad();
+    void testAppendStroke();
+    void testTruncated();
+    void testCorruptedEventCount();
+};
+
+#endif // KISSTROKERECORDINGTEST_H
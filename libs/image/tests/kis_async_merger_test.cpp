@@ -496,6 +496,101 @@ void KisAsyncMergerTest::testFilterMaskOnFilterLayer()
                                   "async_merger_test", "mask_on_adj", "initial", 3));
 }
 
+void KisAsyncMergerTest::testFusedAdjustmentLayers_data()
+{
+    QTest::addColumn<QStringList>("filterIds");
+
+    QTest::newRow("per-channel") << (QStringList() << "invert" << "invert" << "invert");
+    QTest::newRow("mixed") << (QStringList() << "invert" << "desaturate" << "invert");
+}
+
+    /*
+      +-----------+
+      |root       |
+      | paint 2   |
+      | adj 3     |
+      | adj 2     |
+      | adj 1     |
+      | paint 1   |
+      +-----------+
+     */
+
+void KisAsyncMergerTest::testFusedAdjustmentLayers()
+{
+    QFETCH(QStringList, filterIds);
+
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 640, 441, colorSpace, "fused adjustments test");
+
+    QImage sourceImage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+
+    KisPaintDeviceSP device1 = new KisPaintDevice(colorSpace);
+    device1->convertFromQImage(sourceImage, 0, 0, 0);
+
+    KisLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8, device1);
+    image->addNode(paintLayer1, image->rootLayer());
+
+    QList<KisAdjustmentLayerSP> adjustmentLayers;
+    QList<KisPaintDeviceSP> references;
+
+    KisPaintDeviceSP reference = new KisPaintDevice(*device1);
+
+    Q_FOREACH (const QString &filterId, filterIds) {
+        KisFilterSP filter = KisFilterRegistry::instance()->value(filterId);
+        QVERIFY(filter);
+        KisFilterConfigurationSP configuration = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+        QVERIFY(configuration);
+
+        KisAdjustmentLayerSP layer =
+            new KisAdjustmentLayer(image, filterId, configuration->cloneWithResourcesSnapshot(), 0);
+        image->addNode(layer, image->rootLayer());
+        adjustmentLayers.append(layer);
+
+        filter->process(reference, image->bounds(), configuration);
+        references.append(new KisPaintDevice(*reference));
+    }
+
+    KisLayerSP paintLayer2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8, colorSpace);
+    image->addNode(paintLayer2, image->rootLayer());
+
+    const QRect rect = image->bounds();
+
+    KisMergeWalker walker(rect);
+    KisAsyncMerger merger;
+    QPoint pt;
+
+    walker.collectRects(paintLayer1, rect);
+    merger.startMerge(walker);
+
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     references.last()->convertToQImage(0),
+                                     image->rootLayer()->projection()->convertToQImage(0), 1));
+
+    // the originals of the inner layers of the run are rendered as well
+    for (int i = 0; i < adjustmentLayers.size(); i++) {
+        QVERIFY(TestUtil::compareQImages(pt,
+                                         references[i]->convertToQImage(0, rect),
+                                         adjustmentLayers[i]->original()->convertToQImage(0, rect), 1));
+    }
+
+    // the layers of the run are below the filthy one, so the cached result is used
+    walker.collectRects(paintLayer2, rect);
+    merger.startMerge(walker);
+
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     references.last()->convertToQImage(0),
+                                     image->rootLayer()->projection()->convertToQImage(0), 1));
+
+    // the run becomes shorter, its new topmost layer is taken from the cache
+    adjustmentLayers[2]->setVisible(false, true);
+
+    walker.collectRects(paintLayer2, rect);
+    merger.startMerge(walker);
+
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     references[1]->convertToQImage(0),
+                                     image->rootLayer()->projection()->convertToQImage(0), 1));
+}
 
 SIMPLE_TEST_MAIN(KisAsyncMergerTest)
 
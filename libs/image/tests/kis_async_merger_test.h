@@ -29,6 +29,9 @@ private Q_SLOTS:
 
     void testFilterMaskOnFilterLayer();
 
+    void testFusedAdjustmentLayers_data();
+    void testFusedAdjustmentLayers();
+
 };
 
 #endif /* KIS_ASYNC_MERGER_TEST_H */
@@ -450,6 +450,89 @@ void KisConvolutionPainterTest::testGaussianDetailsFFTW()
     testGaussianDetails(true);
 }
 
+void KisConvolutionPainterTest::testTiledFFTWInPlace()
+{
+    /**
+     * The area is big enough to be split into several FFT tiles,
+     * so the result must not depend on whether the tiles read
+     * the pixels already written by their neighbours
+     */
+    const QRect rc(13, 7, 700, 500);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+
+    for (int y = rc.top(); y <= rc.bottom(); y += 17) {
+        for (int x = rc.left(); x <= rc.right(); x += 23) {
+            KoColor c(QColor((x * 7) % 256, (y * 13) % 256, (x + y) % 256, 255), dev->colorSpace());
+            dev->fill(QRect(x, y, 11, 9), c);
+        }
+    }
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(rc);
+    dev->setDefaultBounds(bounds);
+
+    KisPaintDeviceSP ref = new KisPaintDevice(*dev);
+    KisPaintDeviceSP src = new KisPaintDevice(*dev);
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createHorizontalKernel(60);
+
+    KisConvolutionPainter refPainter(ref, KisConvolutionPainter::FFTW);
+    refPainter.applyMatrix(kernel, src, rc.topLeft(), rc.topLeft(), rc.size(), BORDER_REPEAT);
+
+    KisConvolutionPainter painter(dev, KisConvolutionPainter::FFTW);
+    painter.applyMatrix(kernel, dev, rc.topLeft(), rc.topLeft(), rc.size(), BORDER_REPEAT);
+
+    QImage refImage = ref->convertToQImage(0, rc.x(), rc.y(), rc.width(), rc.height());
+    QImage result = dev->convertToQImage(0, rc.x(), rc.y(), rc.width(), rc.height());
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::compareQImages(errorPoint, refImage, result));
+}
+
+void KisConvolutionPainterTest::testKernelSpectrumCacheScope()
+{
+    if (!KisConvolutionPainter::supportsFFTW()) {
+        QSKIP("FFTW is not available");
+    }
+
+    const QRect rc(0, 0, 200, 200);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->fill(QRect(50, 50, 100, 100), KoColor(Qt::red, dev->colorSpace()));
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createHorizontalKernel(20);
+
+    auto applyKernel = [&] () {
+        KisConvolutionPainter painter(dev, KisConvolutionPainter::FFTW);
+        painter.applyMatrix(kernel, dev, rc.topLeft(), rc.topLeft(), rc.size(), BORDER_REPEAT);
+    };
+
+    QCOMPARE(KisConvolutionPainter::numCachedKernelSpectra(), 0);
+
+    // nobody has acquired the cache, so nothing is stored
+    applyKernel();
+    QCOMPARE(KisConvolutionPainter::numCachedKernelSpectra(), 0);
+
+    {
+        KisConvolutionPainter::KernelSpectrumCacheScope scope1;
+
+        applyKernel();
+        QCOMPARE(KisConvolutionPainter::numCachedKernelSpectra(), 1);
+
+        {
+            KisConvolutionPainter::KernelSpectrumCacheScope scope2;
+
+            applyKernel();
+            QCOMPARE(KisConvolutionPainter::numCachedKernelSpectra(), 1);
+        }
+
+        // the cache is still used by the first scope
+        QCOMPARE(KisConvolutionPainter::numCachedKernelSpectra(), 1);
+    }
+
+    QCOMPARE(KisConvolutionPainter::numCachedKernelSpectra(), 0);
+}
+
 #include "kis_transaction.h"
 
 void KisConvolutionPainterTest::testDilate()
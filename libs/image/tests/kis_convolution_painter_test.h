@@ -47,6 +47,9 @@ private Q_SLOTS:
     void testGaussianDetailsSpatial();
     void testGaussianDetailsFFTW();
 
+    void testTiledFFTWInPlace();
+    void testKernelSpectrumCacheScope();
+
     void testDilate();
     void testErode();
 
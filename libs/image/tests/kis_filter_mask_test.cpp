@@ -8,6 +8,7 @@
 #include <simpletest.h>
 
 #include <KoColorSpaceRegistry.h>
+#include <KoColor.h>
 
 #include "kis_selection.h"
 #include "filter/kis_filter.h"
@@ -97,5 +98,70 @@ void KisFilterMaskTest::testProjectionSelected()
     }
 
 }
+void KisFilterMaskTest::testCachedFilterResult()
+{
+    TestUtil::MaskParent p(QRect(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT));
+    KisImageSP image = p.image;
+    KisPaintLayerSP layer = p.layer;
+    KisPaintDeviceSP original = layer->paintDevice();
+
+    QImage qimage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    original->convertFromQImage(qimage, 0, 0, 0);
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("blur");
+    Q_ASSERT(f);
+    KisFilterConfigurationSP kfc = f->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    Q_ASSERT(kfc);
+
+    KisFilterMaskSP mask = new KisFilterMask(image, "mask");
+    image->addNode(mask, layer);
+
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    mask->createNodeProgressProxy();
+
+    mask->initSelection(layer);
+    mask->select(qimage.rect(), MAX_SELECTED);
+
+    const QRect rect = qimage.rect();
+
+    KisPaintDeviceSP filtered = new KisPaintDevice(*original);
+    mask->apply(filtered, rect, rect, KisNode::N_ABOVE_FILTHY);
+
+    KisPaintDeviceSP cached = new KisPaintDevice(*original);
+    mask->apply(cached, rect, rect, KisNode::N_BELOW_FILTHY);
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     filtered->convertToQImage(0, rect),
+                                     cached->convertToQImage(0, rect)));
+
+    // the cached pixels are reused only when the input is known to be unchanged
+    original->fill(QRect(100, 100, 200, 200), KoColor(Qt::red, original->colorSpace()));
+
+    cached = new KisPaintDevice(*original);
+    mask->apply(cached, rect, rect, KisNode::N_BELOW_FILTHY);
+
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     filtered->convertToQImage(0, rect),
+                                     cached->convertToQImage(0, rect)));
+
+    KisPaintDeviceSP refiltered = new KisPaintDevice(*original);
+    mask->apply(refiltered, rect, rect, KisNode::N_ABOVE_FILTHY);
+
+    QVERIFY(!TestUtil::compareQImages(errpoint,
+                                      filtered->convertToQImage(0, rect),
+                                      refiltered->convertToQImage(0, rect),
+                                      0, 0, 0, false));
+
+    // changing the filter drops the cache
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+
+    cached = new KisPaintDevice(*original);
+    mask->apply(cached, rect, rect, KisNode::N_BELOW_FILTHY);
+
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refiltered->convertToQImage(0, rect),
+                                     cached->convertToQImage(0, rect)));
+}
 
 SIMPLE_TEST_MAIN(KisFilterMaskTest)
@@ -249,4 +249,20 @@ void KisMaskSimilarityTest::testSoftRectMask()
     KisMaskSimilarityTester::runMaskGenTest(generator,RECT_SOFT);
 }
 
+void KisMaskSimilarityTest::testCurveCircleMask()
+{
+    const KisCubicCurve pointsCurve(QString("0,1;0.3,0.9;0.7,0.1;1,0"));
+    KisCurveCircleMaskGenerator generator(499.5, 0.7, 0.8, 0.8, 2, pointsCurve, true);
+    generator.setSoftness(0.8);
+    KisMaskSimilarityTester::runMaskGenTest(generator,CIRC_SOFT);
+}
+
+void KisMaskSimilarityTest::testCurveRectMask()
+{
+    const KisCubicCurve pointsCurve(QString("0,1;0.3,0.9;0.7,0.1;1,0"));
+    KisCurveRectangleMaskGenerator generator(499.5, 0.7, 0.8, 0.8, 2, pointsCurve, true);
+    generator.setSoftness(0.8);
+    KisMaskSimilarityTester::runMaskGenTest(generator,RECT_SOFT);
+}
+
 SIMPLE_TEST_MAIN(KisMaskSimilarityTest)
@@ -7,7 +7,76 @@
 #include "kis_math_toolbox_test.h"
 
 #include <simpletest.h>
+
+#include <cmath>
+
+#include <QImage>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
 #include "kis_math_toolbox.h"
+#include "kis_paint_device.h"
+
+namespace {
+
+QImage createTestImage(const QSize &size)
+{
+    QImage image(size, QImage::Format_ARGB32);
+
+    for (int y = 0; y < size.height(); y++) {
+        for (int x = 0; x < size.width(); x++) {
+            image.setPixel(x, y, qRgba((x * 7 + y * 3) % 256,
+                                       (x * y) % 256,
+                                       (x * x + 5 * y) % 256,
+                                       255));
+        }
+    }
+
+    return image;
+}
+
+/**
+ * The straightforward 2x2 Haar transform the toolbox used to do
+ */
+void referenceWavelet(KisMathToolbox::KisWavelet *wav)
+{
+    const int size = wav->size;
+    const int depth = wav->depth;
+    QVector<float> buff(size * size * depth);
+
+    auto at = [&] (float *data, int x, int y, int k) -> float& {
+        return data[(y * size + x) * depth + k];
+    };
+
+    for (int h = size / 2; h >= 1; h /= 2) {
+        for (int i = 0; i < h; i++) {
+            for (int j = 0; j < h; j++) {
+                for (int k = 0; k < depth; k++) {
+                    const float s11 = at(wav->coeffs, 2 * j, 2 * i, k);
+                    const float s12 = at(wav->coeffs, 2 * j + 1, 2 * i, k);
+                    const float s21 = at(wav->coeffs, 2 * j, 2 * i + 1, k);
+                    const float s22 = at(wav->coeffs, 2 * j + 1, 2 * i + 1, k);
+
+                    at(buff.data(), j, i, k) = (s11 + s12 + s21 + s22) * M_SQRT1_2;
+                    at(buff.data(), h + j, i, k) = (s11 - s12 + s21 - s22) * M_SQRT1_2;
+                    at(buff.data(), j, h + i, k) = (s11 + s12 - s21 - s22) * M_SQRT1_2;
+                    at(buff.data(), h + j, h + i, k) = (s11 - s12 - s21 + s22) * M_SQRT1_2;
+                }
+            }
+        }
+
+        for (int y = 0; y < 2 * h; y++) {
+            for (int x = 0; x < 2 * h; x++) {
+                for (int k = 0; k < depth; k++) {
+                    at(wav->coeffs, x, y, k) = at(buff.data(), x, y, k);
+                }
+            }
+        }
+    }
+}
+
+}
 
 void KisMathToolboxTest::testCreation()
 {
@@ -15,5 +84,66 @@ void KisMathToolboxTest::testCreation()
     Q_UNUSED(tb);
 }
 
+void KisMathToolboxTest::testWaveletMatchesReference()
+{
+    const QRect rect(10, 70, 300, 200);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->convertFromQImage(createTestImage(QSize(400, 300)), 0, 0, 0);
+
+    KisMathToolbox tb;
+
+    QScopedPointer<KisMathToolbox::KisWavelet> expected(tb.initWavelet(dev, rect));
+
+    const KoColorSpace *cs = dev->colorSpace();
+    for (int y = 0; y < rect.height(); y++) {
+        for (int x = 0; x < rect.width(); x++) {
+            const KoColor c = dev->pixel(rect.topLeft() + QPoint(x, y));
+            float *pixel = expected->coeffs + (y * expected->size + x) * expected->depth;
+
+            int k = 0;
+            Q_FOREACH (KoChannelInfo *channel, cs->channels()) {
+                if (channel->channelType() != KoChannelInfo::COLOR) continue;
+
+                pixel[k++] = c.data()[channel->pos()];
+            }
+        }
+    }
+
+    referenceWavelet(expected.data());
+
+    QScopedPointer<KisMathToolbox::KisWavelet> wav(tb.fastWaveletTransformation(dev, rect));
+
+    QCOMPARE(wav->size, expected->size);
+    QCOMPARE(wav->depth, expected->depth);
+
+    const int numCoeffs = wav->size * wav->size * wav->depth;
+    for (int i = 0; i < numCoeffs; i++) {
+        if (std::abs(wav->coeffs[i] - expected->coeffs[i]) >
+            1e-3f * qMax(1.0f, std::abs(expected->coeffs[i]))) {
+
+            qDebug() << "Coefficient mismatch at" << i << wav->coeffs[i] << expected->coeffs[i];
+            QFAIL("The wavelet differs from the reference");
+        }
+    }
+}
+
+void KisMathToolboxTest::testWaveletRoundTrip()
+{
+    const QRect rect(10, 70, 300, 200);
+    const QImage image = createTestImage(QSize(400, 300));
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->convertFromQImage(image, 0, 0, 0);
+
+    KisMathToolbox tb;
+    QScopedPointer<KisMathToolbox::KisWavelet> buff(tb.initWavelet(dev, rect));
+    QScopedPointer<KisMathToolbox::KisWavelet> wav(tb.fastWaveletTransformation(dev, rect, buff.data()));
+
+    dev->fill(rect, KoColor(Qt::black, dev->colorSpace()));
+    tb.fastWaveletUntransformation(dev, rect, wav.data(), buff.data());
+
+    QCOMPARE(dev->convertToQImage(0, 0, 0, 400, 300), image);
+}
 
 SIMPLE_TEST_MAIN(KisMathToolboxTest)
@@ -15,6 +15,8 @@ class KisMathToolboxTest : public QObject
 private Q_SLOTS:
 
     void testCreation();
+    void testWaveletMatchesReference();
+    void testWaveletRoundTrip();
 
 };
 
@@ -6,6 +6,8 @@
 
 #include "KisSupportedArchitectures.h"
 
+#include <atomic>
+
 #include <KConfigGroup>
 #include <KSharedConfig>
 #include <kis_debug.h>
@@ -142,6 +144,91 @@ unsigned int KisSupportedArchitectures::bestArch()
     return 0;
 }
 
+namespace {
+std::atomic<unsigned int> s_calibratedArchs[KisSupportedArchitectures::NumKernelFamilies] = {};
+}
+
+unsigned int KisSupportedArchitectures::bestArch(KernelFamily family)
+{
+    const unsigned int best_arch = bestArch();
+    const unsigned int calibrated_arch = s_calibratedArchs[family].load();
+
+    return calibrated_arch && calibrated_arch <= best_arch ? calibrated_arch : best_arch;
+}
+
+void KisSupportedArchitectures::setCalibratedArch(KernelFamily family, unsigned int arch)
+{
+    s_calibratedArchs[family].store(qMin(arch, bestArch()));
+}
+
+bool KisSupportedArchitectures::calibrationEnabled()
+{
+    KConfigGroup cfg = KSharedConfig::openConfig()->group("");
+    return cfg.readEntry("enableVectorCalibration", false);
+}
+
+QVector<unsigned int> KisSupportedArchitectures::availableArchs()
+{
+    QVector<unsigned int> archs;
+
+#ifdef HAVE_XSIMD
+    const unsigned int best_arch = bestArch();
+
+    QVector<unsigned int> candidates;
+
+#ifdef Q_PROCESSOR_X86
+    candidates << xsimd::fma3<xsimd::avx2>::version()
+               << xsimd::avx::version()
+               << xsimd::sse4_1::version()
+               << xsimd::ssse3::version()
+               << xsimd::sse2::version();
+#elif XSIMD_WITH_NEON64
+    candidates << xsimd::neon64::version();
+#elif XSIMD_WITH_NEON
+    candidates << xsimd::neon::version();
+#endif // XSIMD_WITH_SSE2
+
+    Q_FOREACH (unsigned int arch, candidates) {
+        if (arch <= best_arch) {
+            archs << arch;
+        }
+    }
+#endif // HAVE_XSIMD
+
+    return archs;
+}
+
+QString KisSupportedArchitectures::archName(unsigned int arch)
+{
+#ifdef HAVE_XSIMD
+#ifdef Q_PROCESSOR_X86
+    if (arch == xsimd::fma3<xsimd::avx2>::version()) {
+        return xsimd::fma3<xsimd::avx2>::name();
+    } else if (arch == xsimd::avx::version()) {
+        return xsimd::avx::name();
+    } else if (arch == xsimd::sse4_1::version()) {
+        return xsimd::sse4_1::name();
+    } else if (arch == xsimd::ssse3::version()) {
+        return xsimd::ssse3::name();
+    } else if (arch == xsimd::sse2::version()) {
+        return xsimd::sse2::name();
+    }
+#elif XSIMD_WITH_NEON64
+    if (arch == xsimd::neon64::version()) {
+        return xsimd::neon64::name();
+    }
+#elif XSIMD_WITH_NEON
+    if (arch == xsimd::neon::version()) {
+        return xsimd::neon::name();
+    }
+#endif // XSIMD_WITH_SSE2
+#else
+    Q_UNUSED(arch);
+#endif // HAVE_XSIMD
+
+    return "Scalar";
+}
+
 template<typename S>
 struct is_supported_arch {
     is_supported_arch(S &log)
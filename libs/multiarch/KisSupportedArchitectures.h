@@ -10,9 +10,23 @@
 #include "kritamultiarch_export.h"
 
 #include <QString>
+#include <QVector>
 
 class KRITAMULTIARCH_EXPORT KisSupportedArchitectures
 {
+public:
+    /**
+     * Groups of the vectorized kernels that can be dispatched to
+     * different instruction sets by the calibration (see
+     * KoMultiArchCalibration)
+     */
+    enum KernelFamily {
+        CompositeKernels = 0,
+        MixingKernels,
+        ConversionKernels,
+        NumKernelFamilies
+    };
+
 public:
     static QString baseArchName();
 
@@ -20,6 +34,36 @@ public:
 
     static unsigned int bestArch();
 
+    /**
+     * @return the instruction set the kernels of \p family should be
+     *         created for. If the calibration has selected an instruction
+     *         set for the family, it is returned, otherwise the result is
+     *         the same as bestArch()
+     */
+    static unsigned int bestArch(KernelFamily family);
+
+    /**
+     * Overrides the instruction set used for \p family. It affects only
+     * the kernels created after the call. Passing 0 resets the override.
+     * The instruction set cannot be newer than bestArch().
+     */
+    static void setCalibratedArch(KernelFamily family, unsigned int arch);
+
+    /**
+     * @return true if the user has enabled the calibration of the
+     *         dispatch of the vectorized kernels
+     */
+    static bool calibrationEnabled();
+
+    /**
+     * @return all the instruction sets the optimized code is built for
+     *         and which are allowed to be used on this CPU, the newest
+     *         one first
+     */
+    static QVector<unsigned int> availableArchs();
+
+    static QString archName(unsigned int arch);
+
     static QString supportedInstructionSets();
 };
 
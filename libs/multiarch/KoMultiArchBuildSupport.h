@@ -13,12 +13,15 @@
 
 #include "KisSupportedArchitectures.h"
 
+/**
+ * Creates the class for the best instruction set that is not newer
+ * than \p best_arch. Used by the calibration code to create the kernels
+ * for every available instruction set.
+ */
 template<class FactoryType, class... Args>
-auto createOptimizedClass(Args &&...param)
+auto createOptimizedClassForArch(unsigned int best_arch, Args &&...param)
 {
 #ifdef HAVE_XSIMD
-    const unsigned int best_arch = KisSupportedArchitectures::bestArch();
-
 #ifdef Q_PROCESSOR_X86
     if (xsimd::fma3<xsimd::avx2>::version() <= best_arch) {
         return FactoryType::template create<xsimd::fma3<xsimd::avx2>>(
@@ -47,12 +50,34 @@ auto createOptimizedClass(Args &&...param)
             std::forward<Args>(param)...);
     }
 #endif // XSIMD_WITH_SSE2
+#else
+    Q_UNUSED(best_arch);
 #endif // HAVE_XSIMD
 
     return FactoryType::template create<xsimd::generic>(
         std::forward<Args>(param)...);
 }
 
+template<class FactoryType, class... Args>
+auto createOptimizedClass(Args &&...param)
+{
+    return createOptimizedClassForArch<FactoryType>(
+        KisSupportedArchitectures::bestArch(),
+        std::forward<Args>(param)...);
+}
+
+/**
+ * Same as createOptimizedClass(), but respects the instruction set
+ * selected for \p family by the calibration (if it is enabled).
+ */
+template<class FactoryType, class... Args>
+auto createCalibratedClass(KisSupportedArchitectures::KernelFamily family, Args &&...param)
+{
+    return createOptimizedClassForArch<FactoryType>(
+        KisSupportedArchitectures::bestArch(family),
+        std::forward<Args>(param)...);
+}
+
 template<class FactoryType, class... Args>
 auto createScalarClass(Args &&...params)
 {
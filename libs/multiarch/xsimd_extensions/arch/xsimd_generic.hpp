@@ -63,6 +63,19 @@ inline T load_and_extend(const T2 *src) noexcept
         T{});
 }
 
+// Load `T::size` values from the array of `T2` elements, picking every
+// `stride`-th element of the source array. Used for deinterleaving
+// channels of the pixels with arbitrary layout.
+template<typename T, typename T2>
+inline T load_and_extend_strided(const T2 *src, size_t stride) noexcept
+{
+    return kernel::detail::apply_with_index_and_value(
+        [&](size_t i, typename T::value_type) {
+            return static_cast<typename T::value_type>(src[i * stride]);
+        },
+        T{});
+}
+
 /*************************************************
  * Type-inferred, auto-aligned memory allocation *
  *************************************************/
@@ -39,6 +39,10 @@ inline auto set_one(const batch<T, A> &src, const batch_bool<T, A> &mask) noexce
 template<typename T, typename T2>
 inline T load_and_extend(const T2 *src) noexcept;
 
+// Load `T::size` values from the array of `T2` elements with a stride.
+template<typename T, typename T2>
+inline T load_and_extend_strided(const T2 *src, size_t stride) noexcept;
+
 /*************************************************
  * Type-inferred, auto-aligned memory allocation *
  *************************************************/
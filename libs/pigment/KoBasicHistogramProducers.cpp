@@ -6,6 +6,8 @@
 
 #include "KoBasicHistogramProducers.h"
 
+#include <algorithm>
+
 #include <QString>
 #include <klocalizedstring.h>
 
@@ -17,6 +19,10 @@
 // #include "Ko_global.h"
 #include "KoIntegerMaths.h"
 #include "KoChannelInfo.h"
+#include "KoHistogramBinnerFactory.h"
+#include "KoColorModelStandardIds.h"
+
+#include <kis_assert.h>
 
 static const KoColorSpace* m_labCs = 0;
 
@@ -55,6 +61,9 @@ KoBasicHistogramProducer::KoBasicHistogramProducer(const KoID& id, int nrOfBins,
     m_width = 1.0;
 }
 
+KoBasicHistogramProducer::~KoBasicHistogramProducer()
+{
+}
 
 void KoBasicHistogramProducer::clear()
 {
@@ -88,6 +97,96 @@ void KoBasicHistogramProducer::makeExternalToInternal()
     }
 }
 
+void KoBasicHistogramProducer::addRegionToBinImpl(const quint8 *pixels, const quint8 *selectionMask, quint32 nPixels,
+                                                  const KoColorSpace *cs, const KoHistogramBinRange &range,
+                                                  bool countOutOfRange, bool normalised)
+{
+    if (!nPixels) return;
+
+    /**
+     * For most of the color spaces normalisedChannelsValue() just scales
+     * the stored values by their type, but Lab centers a* and b* on its
+     * own half value and the floating point CMYK and Lab keep the values
+     * in their own units. Nothing in KoChannelInfo tells these cases
+     * apart, so the normalised values are always taken from the color
+     * space itself.
+     */
+    const bool binNormalisedValues = normalised;
+
+    if (binNormalisedValues) {
+        if (!m_normalisedBinner) {
+            m_normalisedBinner.reset(KoHistogramBinnerFactory::create(Float32BitsColorDepthID));
+        }
+        KIS_SAFE_ASSERT_RECOVER_RETURN(m_normalisedBinner);
+    } else {
+        if (!m_binner) {
+            m_binner.reset(KoHistogramBinnerFactory::create(m_colorSpace->colorDepthId()));
+        }
+        KIS_SAFE_ASSERT_RECOVER_RETURN(m_binner);
+    }
+
+    const quint32 dstPixelSize = m_colorSpace->pixelSize();
+    m_conversionBuffer.resize(nPixels * dstPixelSize);
+    cs->convertPixelsTo(pixels, m_conversionBuffer.data(), m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
+
+    const quint8 *binnedPixels = m_conversionBuffer.constData();
+    int binnedPixelSize = dstPixelSize;
+    KoHistogramBinnerBase *binner = m_binner.data();
+
+    if (binNormalisedValues) {
+        m_normalisedBuffer.resize(nPixels * m_channels);
+
+        QVector<float> channels(m_channels);
+
+        for (quint32 i = 0; i < nPixels; i++) {
+            m_colorSpace->normalisedChannelsValue(m_conversionBuffer.constData() + i * dstPixelSize, channels);
+            std::copy(channels.constBegin(), channels.constEnd(), m_normalisedBuffer.begin() + i * m_channels);
+        }
+
+        binnedPixels = reinterpret_cast<const quint8*>(m_normalisedBuffer.constData());
+        binnedPixelSize = m_channels * sizeof(float);
+        binner = m_normalisedBinner.data();
+    }
+
+    const quint8 *skipMask = 0;
+
+    if (m_skipTransparent || (selectionMask && m_skipUnselected)) {
+        m_skipMask.resize(nPixels);
+
+        if (m_skipTransparent) {
+            // transparent pixels have zero opacity, so the opacity itself is the mask
+            cs->copyOpacityU8(const_cast<quint8*>(pixels), m_skipMask.data(), nPixels);
+        } else {
+            m_skipMask.fill(OPACITY_OPAQUE_U8);
+        }
+
+        if (selectionMask && m_skipUnselected) {
+            for (quint32 i = 0; i < nPixels; i++) {
+                if (!selectionMask[i]) {
+                    m_skipMask[i] = 0;
+                }
+            }
+        }
+
+        skipMask = m_skipMask.constData();
+    }
+
+    const int channelSize = binnedPixelSize / m_channels;
+    quint32 count = 0;
+
+    // the bins of every channel are stored in a separate vector, so the
+    // channels are binned one by one, the converted data is still in cache
+    for (int i = 0; i < m_channels; i++) {
+        count = binner->addPixels(binnedPixels + i * channelSize, binnedPixelSize,
+                                  skipMask, nPixels, 1, range,
+                                  m_bins[i].data(),
+                                  countOutOfRange ? &m_outLeft[i] : 0,
+                                  countOutOfRange ? &m_outRight[i] : 0);
+    }
+
+    m_count += count;
+}
+
 // ------------ U8 ---------------------
 
 KoBasicU8HistogramProducer::KoBasicU8HistogramProducer(const KoID& id, const KoColorSpace *cs)
@@ -102,38 +201,12 @@ QString KoBasicU8HistogramProducer::positionToString(qreal pos) const
 
 void KoBasicU8HistogramProducer::addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *cs)
 {
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
+    // the producer doesn't support zooming, the values are rounded
+    // in the same way as in KoColorSpace::scaleToU8()
+    KoHistogramBinRange range;
+    range.bias = 0.5f;
 
-    if (selectionMask) {
-        quint8 *dst = dstPixels;
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    m_bins[i][m_colorSpace->scaleToU8(dst,i)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
-        }
-    } else {
-        quint8 *dst = dstPixels;
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    m_bins[i][m_colorSpace->scaleToU8(dst,i)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
-        }
-    }
+    addRegionToBinImpl(pixels, selectionMask, nPixels, cs, range, false, false);
 }
 
 // ------------ U16 ---------------------
@@ -156,56 +229,12 @@ qreal KoBasicU16HistogramProducer::maximalZoom() const
 void KoBasicU16HistogramProducer::addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *cs)
 {
     // The view
-    quint16 from = static_cast<quint16>(m_from * UINT16_MAX);
-    quint16 width = static_cast<quint16>(m_width * UINT16_MAX + 0.5); // We include the end
-    quint16 to = from + width;
-    qreal factor = 255.0 / width;
+    KoHistogramBinRange range;
+    range.from = static_cast<float>(m_from);
+    range.to = static_cast<float>(m_from + m_width);
+    range.factor = static_cast<float>(255.0 / m_width);
 
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-    quint8 *dst = dstPixels;
-    QVector<float> channels(m_colorSpace->channelCount());
-
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    quint16 value = channels[i]*UINT16_MAX;
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
-        }
-    } else {
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    quint16 value = channels[i]*UINT16_MAX;
-
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
-        }
-    }
+    addRegionToBinImpl(pixels, selectionMask, nPixels, cs, range, true, true);
 }
 
 // ------------ Float32 ---------------------
@@ -228,57 +257,12 @@ qreal KoBasicF32HistogramProducer::maximalZoom() const
 void KoBasicF32HistogramProducer::addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *cs)
 {
     // The view
-    float from = static_cast<float>(m_from);
-    float width = static_cast<float>(m_width);
-    float to = from + width;
-    float factor = 255.0 / width;
-
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-    quint8 *dst = dstPixels;
-    QVector<float> channels(m_colorSpace->channelCount());
-
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
+    KoHistogramBinRange range;
+    range.from = static_cast<float>(m_from);
+    range.to = static_cast<float>(m_from + m_width);
+    range.factor = static_cast<float>(255.0 / m_width);
 
-        }
-    } else {
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
-
-        }
-    }
+    addRegionToBinImpl(pixels, selectionMask, nPixels, cs, range, true, true);
 }
 
 #ifdef HAVE_OPENEXR
@@ -352,6 +336,7 @@ void KoBasicF16HalfHistogramProducer::addRegionToBin(const quint8 * pixels, cons
             nPixels--;
         }
     }
+    delete[] dstPixels;
 }
 #endif
 
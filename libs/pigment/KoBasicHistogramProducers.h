@@ -9,6 +9,7 @@
 
 #include "KoHistogramProducer.h"
 
+#include <QScopedPointer>
 #include <QVector>
 
 #include <KoConfig.h>
@@ -17,13 +18,14 @@
 #include "KoID.h"
 #include "kritapigment_export.h"
 #include "KoColorSpaceRegistry.h"
+#include "KoHistogramBinnerBase.h"
 
 class KRITAPIGMENT_EXPORT KoBasicHistogramProducer : public KoHistogramProducer
 {
 public:
     explicit KoBasicHistogramProducer(const KoID& id, int channelCount, int nrOfBins);
     explicit KoBasicHistogramProducer(const KoID& id, int nrOfBins, const KoColorSpace *colorSpace);
-    ~KoBasicHistogramProducer() override {}
+    ~KoBasicHistogramProducer() override;
 
     void clear() override;
 
@@ -78,6 +80,24 @@ protected:
     }
     // not virtual since that is useless: we call it from constructor
     void makeExternalToInternal();
+
+    /**
+     * Converts the pixels into m_colorSpace and adds them to the bins
+     * with a vectorized KoHistogramBinnerBase. All the channels of
+     * m_colorSpace should have the same size and the depth should be
+     * supported by KoHistogramBinnerFactory.
+     *
+     * If \p countOutOfRange is false, the values outside of the range
+     * are clamped into the edge bins.
+     *
+     * If \p normalised is true, the bins are the ones of the values of
+     * KoColorSpace::normalisedChannelsValue(), otherwise of the stored
+     * values scaled into [0, 1] by their type.
+     */
+    void addRegionToBinImpl(const quint8 *pixels, const quint8 *selectionMask, quint32 nPixels,
+                            const KoColorSpace *colorSpace, const KoHistogramBinRange &range,
+                            bool countOutOfRange, bool normalised);
+
     typedef QVector<quint32> vBins;
     QVector<vBins> m_bins;
     vBins m_outLeft, m_outRight;
@@ -87,6 +107,13 @@ protected:
     const KoColorSpace *m_colorSpace;
     KoID m_id;
     QVector<qint32> m_external;
+
+private:
+    QScopedPointer<KoHistogramBinnerBase> m_binner;
+    QScopedPointer<KoHistogramBinnerBase> m_normalisedBinner;
+    QVector<quint8> m_conversionBuffer;
+    QVector<float> m_normalisedBuffer;
+    QVector<quint8> m_skipMask;
 };
 
 class KRITAPIGMENT_EXPORT KoBasicU8HistogramProducer : public KoBasicHistogramProducer
@@ -22,6 +22,7 @@
 #include "KoColorProfile.h"
 #include "KoColorConversionCache.h"
 #include "KoColorConversionSystem.h"
+#include "KoMultiArchCalibration.h"
 
 #include "colorspaces/KoAlphaColorSpace.h"
 #include "colorspaces/KoLabColorSpace.h"
@@ -146,6 +147,10 @@ KoColorSpaceRegistry* KoColorSpaceRegistry::instance()
 
 void KoColorSpaceRegistry::init()
 {
+    // the calibration must select the instruction sets before
+    // the color spaces create their vectorized ops
+    KoMultiArchCalibration::initialize();
+
     d->rgbU8sRGB = 0;
     d->lab16sLAB = 0;
     d->alphaCs = 0;
@@ -0,0 +1,262 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOHISTOGRAMBINNER_H
+#define KOHISTOGRAMBINNER_H
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+#include <KoColorSpaceMaths.h>
+#include <KoMultiArchBuildSupport.h>
+
+#include "KoHistogramBinnerBase.h"
+
+/**
+ * The counters of the histograms. For long runs of pixels the counting
+ * is split into several partial histograms, the pixels are distributed
+ * among them in a round-robin way. It breaks the dependency chain of
+ * the increments of the same counter, which is very common for images
+ * with flat areas. The partial histograms are summed up in merge().
+ *
+ * For short runs the cost of clearing and merging the partial
+ * histograms is higher than the gain, so the final bins are
+ * incremented directly.
+ */
+class KoHistogramCounters
+{
+public:
+    static const int numPartials = 4;
+    static const int minPixelsForPartials = 1024;
+
+    KoHistogramCounters(quint32 *bins, int size, int nPixels)
+        : m_bins(bins)
+        , m_size(size)
+    {
+        if (nPixels >= minPixelsForPartials) {
+            m_partials.resize(numPartials * size, 0);
+            m_counters = m_partials.data();
+            m_partialStride = size;
+        } else {
+            m_counters = bins;
+            m_partialStride = 0;
+        }
+    }
+
+    ALWAYS_INLINE void add(int lane, int index)
+    {
+        m_counters[(lane & (numPartials - 1)) * m_partialStride + index]++;
+    }
+
+    void merge()
+    {
+        if (!m_partialStride) return;
+
+        for (int i = 0; i < m_size; i++) {
+            quint32 sum = 0;
+            for (int p = 0; p < numPartials; p++) {
+                sum += m_partials[p * m_size + i];
+            }
+            m_bins[i] += sum;
+        }
+    }
+
+private:
+    quint32 *m_bins;
+    int m_size;
+    std::vector<quint32> m_partials;
+    quint32 *m_counters;
+    int m_partialStride;
+};
+
+template<typename channels_type>
+struct KoHistogramBinnerScalarKernel
+{
+    static ALWAYS_INLINE int binIndex(float value, const KoHistogramBinRange &range)
+    {
+        const float x = (value - range.from) * range.factor + range.bias;
+        return int(qBound(0.0f, x, float(range.numBins - 1)));
+    }
+
+    static quint32 addPixels(const quint8 *pixels, int pixelStride,
+                             const quint8 *skipMask, int nPixels, int channelsNb,
+                             const KoHistogramBinRange &range,
+                             KoHistogramCounters &counters,
+                             quint32 *outLeft, quint32 *outRight)
+    {
+        const bool countOutOfRange = outLeft && outRight;
+        quint32 count = 0;
+
+        for (int i = 0; i < nPixels; i++, pixels += pixelStride) {
+            if (skipMask && !skipMask[i]) continue;
+
+            const channels_type *src = reinterpret_cast<const channels_type*>(pixels);
+
+            for (int ch = 0; ch < channelsNb; ch++) {
+                const float value = KoColorSpaceMaths<channels_type, float>::scaleToA(src[ch]);
+
+                if (countOutOfRange && value < range.from) {
+                    outLeft[ch]++;
+                } else if (countOutOfRange && value > range.to) {
+                    outRight[ch]++;
+                } else {
+                    counters.add(i, ch * range.numBins + binIndex(value, range));
+                }
+            }
+
+            count++;
+        }
+
+        return count;
+    }
+};
+
+template<typename channels_type, typename _impl, typename EnableDummyType = void>
+struct KoHistogramBinnerKernel
+{
+    static quint32 addPixels(const quint8 *pixels, int pixelStride,
+                             const quint8 *skipMask, int nPixels, int channelsNb,
+                             const KoHistogramBinRange &range,
+                             KoHistogramCounters &counters,
+                             quint32 *outLeft, quint32 *outRight)
+    {
+        return KoHistogramBinnerScalarKernel<channels_type>::addPixels(
+            pixels, pixelStride, skipMask, nPixels, channelsNb, range, counters, outLeft, outRight);
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+/**
+ * Vectorized version of the binning. The channel values are
+ * deinterleaved, normalized and converted into the indices of the
+ * counters in vector registers, the counters themselves are
+ * incremented with scalar instructions (there is no conflict-free
+ * scatter on most of the supported architectures).
+ *
+ * The indices are calculated in floating point. They are integral and
+ * much smaller than 2^24, so the calculation is exact. The values
+ * lying outside of the range are marked with negative indices.
+ */
+template<typename channels_type, typename _impl>
+struct KoHistogramBinnerKernel<channels_type, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+    static ALWAYS_INLINE float_v loadNormalized(const channels_type *src, int stride)
+    {
+        if constexpr (std::is_same<channels_type, float>::value) {
+            return xsimd::load_and_extend_strided<float_v>(src, stride);
+        } else {
+            // exactly the same division as in KoIntegerToFloat,
+            // so the result matches the scalar version bit-to-bit
+            return xsimd::batch_cast<float>(xsimd::load_and_extend_strided<int_v>(src, stride)) /
+                float_v(float(KoColorSpaceMathsTraits<channels_type>::max));
+        }
+    }
+
+    static quint32 addPixels(const quint8 *pixels, int pixelStride,
+                             const quint8 *skipMask, int nPixels, int channelsNb,
+                             const KoHistogramBinRange &range,
+                             KoHistogramCounters &counters,
+                             quint32 *outLeft, quint32 *outRight)
+    {
+        const bool countOutOfRange = outLeft && outRight;
+        const int stride = pixelStride / static_cast<int>(sizeof(channels_type));
+
+        const float_v from(range.from);
+        const float_v to(range.to);
+        const float_v factor(range.factor);
+        const float_v bias(range.bias);
+        const float_v maxBin(float(range.numBins - 1));
+        const float_v zero(0.0f);
+        const float_v leftMark(-1.0f);
+        const float_v rightMark(-2.0f);
+
+        alignas(_impl::alignment()) std::array<int, int_v::size> indices;
+
+        quint32 count = 0;
+        int i = 0;
+
+        for (; i + vectorSize <= nPixels; i += vectorSize) {
+            const channels_type *src = reinterpret_cast<const channels_type*>(pixels);
+
+            for (int ch = 0; ch < channelsNb; ch++) {
+                const float_v value = loadNormalized(src + ch, stride);
+
+                // NaN values go into the first bin, the same as in the scalar version
+                const float_v x = (value - from) * factor + bias;
+                float_v index = xsimd::min(xsimd::select(x > zero, x, zero), maxBin) +
+                    float_v(float(ch * range.numBins));
+
+                if (countOutOfRange) {
+                    index = xsimd::select(value < from, leftMark,
+                                          xsimd::select(value > to, rightMark, index));
+                }
+
+                xsimd::batch_cast<int>(index).store_aligned(indices.data());
+
+                for (int lane = 0; lane < vectorSize; lane++) {
+                    if (skipMask && !skipMask[i + lane]) continue;
+
+                    const int idx = indices[lane];
+
+                    if (idx >= 0) {
+                        counters.add(lane, idx);
+                    } else if (idx == -1) {
+                        outLeft[ch]++;
+                    } else {
+                        outRight[ch]++;
+                    }
+                }
+            }
+
+            if (skipMask) {
+                for (int lane = 0; lane < vectorSize; lane++) {
+                    count += skipMask[i + lane] != 0;
+                }
+            } else {
+                count += vectorSize;
+            }
+
+            pixels += vectorSize * pixelStride;
+        }
+
+        count += KoHistogramBinnerScalarKernel<channels_type>::addPixels(
+            pixels, pixelStride, skipMask ? skipMask + i : nullptr, nPixels - i,
+            channelsNb, range, counters, outLeft, outRight);
+
+        return count;
+    }
+};
+
+#endif /* defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) */
+
+template<typename channels_type, typename _impl>
+class KoHistogramBinner : public KoHistogramBinnerBase
+{
+public:
+    quint32 addPixels(const quint8 *pixels, int pixelStride,
+                      const quint8 *skipMask, int nPixels, int channelsNb,
+                      const KoHistogramBinRange &range,
+                      quint32 *bins, quint32 *outLeft, quint32 *outRight) const override
+    {
+        KoHistogramCounters counters(bins, channelsNb * range.numBins, nPixels);
+
+        const quint32 count = KoHistogramBinnerKernel<channels_type, _impl>::addPixels(
+            pixels, pixelStride, skipMask, nPixels, channelsNb, range, counters, outLeft, outRight);
+
+        counters.merge();
+        return count;
+    }
+};
+
+#endif // KOHISTOGRAMBINNER_H
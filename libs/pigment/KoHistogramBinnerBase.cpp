@@ -0,0 +1,12 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoHistogramBinnerBase.h"
+
+KoHistogramBinnerBase::~KoHistogramBinnerBase()
+{
+
+}
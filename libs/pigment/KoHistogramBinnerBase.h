@@ -0,0 +1,74 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOHISTOGRAMBINNERBASE_H
+#define KOHISTOGRAMBINNERBASE_H
+
+#include "kritapigment_export.h"
+
+#include <QtGlobal>
+
+/**
+ * Describes how the normalized channel values are mapped into the bins
+ * of a histogram. A value \c v falls into the bin
+ * <tt>int((v - from) * factor + bias)</tt> clamped into [0, numBins - 1].
+ */
+struct KoHistogramBinRange
+{
+    float from = 0.0f;
+    float to = 1.0f;
+    float factor = 255.0f;
+
+    /**
+     * 0.0 means the bin is found by truncation (the view of the
+     * histogram producers), 0.5 means rounding to the nearest bin (the
+     * same as KoColorSpace::scaleToU8())
+     */
+    float bias = 0.0f;
+
+    int numBins = 256;
+};
+
+/**
+ * Accumulates the values of all the channels of the pixels into the
+ * histograms. All the channels of the pixel should have the same type,
+ * which is defined by the factory the binner is created with.
+ *
+ * The histograms are counted in several partial histograms which are
+ * merged in the end of every call. Consecutive pixels often have the
+ * same value, so incrementing a single counter would serialize the
+ * loop on the store-to-load forwarding of the counter.
+ */
+class KRITAPIGMENT_EXPORT KoHistogramBinnerBase
+{
+public:
+    virtual ~KoHistogramBinnerBase();
+
+    /**
+     * Adds \p nPixels pixels to the histograms.
+     *
+     * \param pixels the first pixel
+     * \param pixelStride the distance between the pixels in bytes, it
+     *        may be a multiple of the pixel size to subsample the data
+     * \param skipMask optional mask with one byte per pixel, pixels
+     *        with zero value in the mask are skipped
+     * \param channelsNb the number of channels in the pixel
+     * \param bins channelsNb * range.numBins counters, the histograms
+     *        of the channels follow each other in memory order of the
+     *        channels
+     * \param outLeft, outRight channelsNb counters of the values lying
+     *        outside of [range.from, range.to]. If they are null, such
+     *        values are clamped into the first or the last bin.
+     *
+     * \return the number of pixels actually added
+     */
+    virtual quint32 addPixels(const quint8 *pixels, int pixelStride,
+                              const quint8 *skipMask, int nPixels, int channelsNb,
+                              const KoHistogramBinRange &range,
+                              quint32 *bins, quint32 *outLeft, quint32 *outRight) const = 0;
+};
+
+#endif // KOHISTOGRAMBINNERBASE_H
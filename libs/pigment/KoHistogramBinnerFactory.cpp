@@ -0,0 +1,34 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoHistogramBinnerFactory.h"
+
+#include <KoColorModelStandardIds.h>
+
+#include "KoHistogramBinnerFactoryImpl.h"
+
+KoHistogramBinnerBase *KoHistogramBinnerFactory::create(const KoID &depthId)
+{
+    if (depthId == Integer8BitsColorDepthID) {
+        return createCalibratedClass<
+            KoHistogramBinnerFactoryImpl<quint8>>(KisSupportedArchitectures::ConversionKernels);
+    } else if (depthId == Integer16BitsColorDepthID) {
+        return createCalibratedClass<
+            KoHistogramBinnerFactoryImpl<quint16>>(KisSupportedArchitectures::ConversionKernels);
+    } else if (depthId == Float32BitsColorDepthID) {
+        return createCalibratedClass<
+            KoHistogramBinnerFactoryImpl<float>>(KisSupportedArchitectures::ConversionKernels);
+    }
+
+    return nullptr;
+}
+
+bool KoHistogramBinnerFactory::isSupported(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ||
+        depthId == Integer16BitsColorDepthID ||
+        depthId == Float32BitsColorDepthID;
+}
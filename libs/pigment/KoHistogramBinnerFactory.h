@@ -0,0 +1,30 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOHISTOGRAMBINNERFACTORY_H
+#define KOHISTOGRAMBINNERFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+
+class KoHistogramBinnerBase;
+
+/**
+ * Creates a per-arch histogram binner for the channels of depth
+ * \p depthId. Supported depths are 8-bit and 16-bit integers and
+ * 32-bit float.
+ *
+ * \return the binner or nullptr if the depth is not supported
+ */
+class KRITAPIGMENT_EXPORT KoHistogramBinnerFactory
+{
+public:
+    static KoHistogramBinnerBase* create(const KoID &depthId);
+    static bool isSupported(const KoID &depthId);
+};
+
+#endif // KOHISTOGRAMBINNERFACTORY_H
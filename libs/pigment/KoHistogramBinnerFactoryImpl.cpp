@@ -0,0 +1,24 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoHistogramBinnerFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoHistogramBinner.h"
+
+template<typename _channels_type_>
+template<typename _impl>
+KoHistogramBinnerBase *
+KoHistogramBinnerFactoryImpl<_channels_type_>::create()
+{
+    return new KoHistogramBinner<_channels_type_, _impl>();
+}
+
+template KoHistogramBinnerBase* KoHistogramBinnerFactoryImpl<quint8>::create<xsimd::current_arch>();
+template KoHistogramBinnerBase* KoHistogramBinnerFactoryImpl<quint16>::create<xsimd::current_arch>();
+template KoHistogramBinnerBase* KoHistogramBinnerFactoryImpl<float>::create<xsimd::current_arch>();
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
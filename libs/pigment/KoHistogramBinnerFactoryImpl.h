@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOHISTOGRAMBINNERFACTORYIMPL_H
+#define KOHISTOGRAMBINNERFACTORYIMPL_H
+
+#include <KoMultiArchBuildSupport.h>
+#include "kritapigment_export.h"
+
+class KoHistogramBinnerBase;
+
+template<typename _channels_type_>
+class KRITAPIGMENT_EXPORT KoHistogramBinnerFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoHistogramBinnerBase *create();
+};
+
+#endif // KOHISTOGRAMBINNERFACTORYIMPL_H
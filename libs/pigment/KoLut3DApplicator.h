@@ -0,0 +1,251 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOLUT3DAPPLICATOR_H
+#define KOLUT3DAPPLICATOR_H
+
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+#include <KoColorSpaceMaths.h>
+#include <KoMultiArchBuildSupport.h>
+
+#include "KoLut3DApplicatorBase.h"
+
+/**
+ * Scalar version of the tetrahedral interpolation of a KoLut3D.
+ *
+ * The cube of the grid containing the sample is split into six
+ * tetrahedra along its main diagonal. The tetrahedron is selected by
+ * sorting the fractional coordinates of the sample, so only four nodes
+ * are fetched per pixel instead of eight needed by trilinear
+ * interpolation.
+ */
+template<typename src_channels_type, typename dst_channels_type>
+struct KoLut3DScalarKernel
+{
+    static void apply(const src_channels_type *src, dst_channels_type *dst,
+                      int nPixels, const KoLut3D &lut)
+    {
+        const int n = lut.gridSize;
+        const float scale = float(n - 1);
+        const float maxIndex = float(n - 2);
+
+        const int sx = 3;
+        const int sy = 3 * n;
+        const int sz = 3 * n * n;
+
+        const float *table = lut.table.constData();
+
+        for (int i = 0; i < nPixels; i++) {
+            const float x = KoColorSpaceMaths<src_channels_type, float>::scaleToA(src[0]) * scale;
+            const float y = KoColorSpaceMaths<src_channels_type, float>::scaleToA(src[1]) * scale;
+            const float z = KoColorSpaceMaths<src_channels_type, float>::scaleToA(src[2]) * scale;
+
+            const float ix = qMin(std::floor(x), maxIndex);
+            const float iy = qMin(std::floor(y), maxIndex);
+            const float iz = qMin(std::floor(z), maxIndex);
+
+            const float fx = x - ix;
+            const float fy = y - iy;
+            const float fz = z - iz;
+
+            // the ties are resolved in the same way as in the vectorized version
+            const int strideMax = fx >= fy && fx >= fz ? sx : fy >= fz ? sy : sz;
+            const int strideMin = fz <= fy && fz <= fx ? sz : fy <= fx ? sy : sx;
+
+            const float fMax = qMax(fx, qMax(fy, fz));
+            const float fMin = qMin(fx, qMin(fy, fz));
+            const float fMid = qMax(qMin(fx, fy), qMin(qMax(fx, fy), fz));
+
+            const float w0 = 1.0f - fMax;
+            const float w1 = fMax - fMid;
+            const float w2 = fMid - fMin;
+            const float w3 = fMin;
+
+            const float *c0 = table + int(ix) * sx + int(iy) * sy + int(iz) * sz;
+            const float *c1 = c0 + strideMax;
+            const float *c2 = c0 + sx + sy + sz - strideMin;
+            const float *c3 = c0 + sx + sy + sz;
+
+            for (int ch = 0; ch < 3; ch++) {
+                const float value = w0 * c0[ch] + w1 * c1[ch] + w2 * c2[ch] + w3 * c3[ch];
+                dst[ch] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(value);
+            }
+            dst[3] = KoColorSpaceMaths<src_channels_type, dst_channels_type>::scaleToA(src[3]);
+
+            src += 4;
+            dst += 4;
+        }
+    }
+};
+
+template<typename src_channels_type, typename dst_channels_type, typename _impl, typename EnableDummyType = void>
+struct KoLut3DKernel
+{
+    static void apply(const src_channels_type *src, dst_channels_type *dst,
+                      int nPixels, const KoLut3D &lut)
+    {
+        KoLut3DScalarKernel<src_channels_type, dst_channels_type>::apply(src, dst, nPixels, lut);
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+/**
+ * Vectorized version of the tetrahedral interpolation. The coordinates,
+ * the weights and the offsets of the nodes are calculated in vector
+ * registers, the nodes are fetched with scalar loads (there is no fast
+ * gather on most of the supported architectures).
+ *
+ * The offsets are calculated in floating point. They are integral and
+ * much smaller than 2^24, so the calculation is exact.
+ */
+template<typename src_channels_type, typename dst_channels_type, typename _impl>
+struct KoLut3DKernel<src_channels_type, dst_channels_type, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+    static ALWAYS_INLINE float_v loadNormalized(const src_channels_type *src)
+    {
+        // exactly the same division as in KoIntegerToFloat,
+        // so the result matches KoLuts bit-to-bit
+        return xsimd::batch_cast<float>(xsimd::load_and_extend_strided<int_v>(src, 4)) /
+            float_v(float(KoColorSpaceMathsTraits<src_channels_type>::max));
+    }
+
+    static ALWAYS_INLINE void storeDenormalized(const float_v &value, dst_channels_type *dst)
+    {
+        if constexpr (std::is_same<dst_channels_type, float>::value) {
+            alignas(_impl::alignment()) std::array<float, float_v::size> buf;
+            value.store_aligned(buf.data());
+
+            for (size_t i = 0; i < float_v::size; i++) {
+                dst[i * 4] = buf[i];
+            }
+        } else {
+            const float unit = float(KoColorSpaceMathsTraits<dst_channels_type>::max);
+
+            // the same rounding as in float2int(): the value is clamped,
+            // so the truncation of (v + 0.5) is correct
+            const float_v v = xsimd::clip(value * float_v(unit), float_v(0.0f), float_v(unit));
+            const int_v result = xsimd::batch_cast<int>(v + float_v(0.5f));
+
+            alignas(_impl::alignment()) std::array<int, int_v::size> buf;
+            result.store_aligned(buf.data());
+
+            for (size_t i = 0; i < int_v::size; i++) {
+                dst[i * 4] = static_cast<dst_channels_type>(buf[i]);
+            }
+        }
+    }
+
+    static void apply(const src_channels_type *src, dst_channels_type *dst,
+                      int nPixels, const KoLut3D &lut)
+    {
+        const int n = lut.gridSize;
+        const float_v scale(float(n - 1));
+        const float_v maxIndex(float(n - 2));
+
+        const float_v sx(3.0f);
+        const float_v sy(3.0f * n);
+        const float_v sz(3.0f * n * n);
+        const float_v sxyz = sx + sy + sz;
+
+        const float *table = lut.table.constData();
+
+        alignas(_impl::alignment()) std::array<int, int_v::size> offsets[4];
+        alignas(_impl::alignment()) std::array<float, float_v::size> nodes[4][3];
+
+        int i = 0;
+
+        for (; i + vectorSize <= nPixels; i += vectorSize) {
+            const float_v x = loadNormalized(src) * scale;
+            const float_v y = loadNormalized(src + 1) * scale;
+            const float_v z = loadNormalized(src + 2) * scale;
+
+            const float_v ix = xsimd::min(xsimd::floor(x), maxIndex);
+            const float_v iy = xsimd::min(xsimd::floor(y), maxIndex);
+            const float_v iz = xsimd::min(xsimd::floor(z), maxIndex);
+
+            const float_v fx = x - ix;
+            const float_v fy = y - iy;
+            const float_v fz = z - iz;
+
+            const float_v strideMax =
+                xsimd::select((fx >= fy) & (fx >= fz), sx, xsimd::select(fy >= fz, sy, sz));
+            const float_v strideMin =
+                xsimd::select((fz <= fy) & (fz <= fx), sz, xsimd::select(fy <= fx, sy, sx));
+
+            const float_v fMax = xsimd::max(fx, xsimd::max(fy, fz));
+            const float_v fMin = xsimd::min(fx, xsimd::min(fy, fz));
+            const float_v fMid = xsimd::max(xsimd::min(fx, fy), xsimd::min(xsimd::max(fx, fy), fz));
+
+            const float_v w0 = float_v(1.0f) - fMax;
+            const float_v w1 = fMax - fMid;
+            const float_v w2 = fMid - fMin;
+            const float_v w3 = fMin;
+
+            const float_v base = ix * sx + iy * sy + iz * sz;
+
+            xsimd::batch_cast<int>(base).store_aligned(offsets[0].data());
+            xsimd::batch_cast<int>(base + strideMax).store_aligned(offsets[1].data());
+            xsimd::batch_cast<int>(base + sxyz - strideMin).store_aligned(offsets[2].data());
+            xsimd::batch_cast<int>(base + sxyz).store_aligned(offsets[3].data());
+
+            for (int v = 0; v < 4; v++) {
+                for (int lane = 0; lane < vectorSize; lane++) {
+                    const float *node = table + offsets[v][lane];
+                    nodes[v][0][lane] = node[0];
+                    nodes[v][1][lane] = node[1];
+                    nodes[v][2][lane] = node[2];
+                }
+            }
+
+            for (int ch = 0; ch < 3; ch++) {
+                const float_v value =
+                    w0 * float_v::load_aligned(nodes[0][ch].data()) +
+                    w1 * float_v::load_aligned(nodes[1][ch].data()) +
+                    w2 * float_v::load_aligned(nodes[2][ch].data()) +
+                    w3 * float_v::load_aligned(nodes[3][ch].data());
+
+                storeDenormalized(value, dst + ch);
+            }
+
+            for (int lane = 0; lane < vectorSize; lane++) {
+                dst[lane * 4 + 3] =
+                    KoColorSpaceMaths<src_channels_type, dst_channels_type>::scaleToA(src[lane * 4 + 3]);
+            }
+
+            src += 4 * vectorSize;
+            dst += 4 * vectorSize;
+        }
+
+        KoLut3DScalarKernel<src_channels_type, dst_channels_type>::apply(src, dst, nPixels - i, lut);
+    }
+};
+
+#endif /* defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) */
+
+template<typename src_channels_type, typename dst_channels_type, typename _impl>
+class KoLut3DApplicator : public KoLut3DApplicatorBase
+{
+public:
+    void apply(const quint8 *src, quint8 *dst, qint32 nPixels, const KoLut3D &lut) const override
+    {
+        KoLut3DKernel<src_channels_type, dst_channels_type, _impl>::apply(
+            reinterpret_cast<const src_channels_type *>(src),
+            reinterpret_cast<dst_channels_type *>(dst),
+            nPixels, lut);
+    }
+};
+
+#endif // KOLUT3DAPPLICATOR_H
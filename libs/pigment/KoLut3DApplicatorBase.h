@@ -0,0 +1,42 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOLUT3DAPPLICATORBASE_H
+#define KOLUT3DAPPLICATORBASE_H
+
+#include "kritapigment_export.h"
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * A baked 3D lookup table of a color transformation.
+ *
+ * The table has gridSize^3 nodes, every node stores three normalized
+ * float values of the color channels of the destination pixel. The
+ * axes of the table are the first three channels of the source pixel
+ * in memory order, the first channel is the fastest-changing axis.
+ */
+struct KoLut3D
+{
+    int gridSize = 0;
+    QVector<float> table;
+};
+
+/**
+ * Applies a baked KoLut3D to the pixels of a color space with three
+ * color channels and alpha in the last position. The color channels
+ * are evaluated with tetrahedral interpolation, alpha channel is copied
+ * from the source pixel.
+ */
+class KRITAPIGMENT_EXPORT KoLut3DApplicatorBase
+{
+public:
+    virtual ~KoLut3DApplicatorBase();
+    virtual void apply(const quint8 *src, quint8 *dst, qint32 nPixels, const KoLut3D &lut) const = 0;
+};
+
+#endif // KOLUT3DAPPLICATORBASE_H
@@ -0,0 +1,52 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoLut3DApplicatorFactory.h"
+
+#include <KoColorModelStandardIds.h>
+
+#include "KoLut3DApplicatorFactoryImpl.h"
+
+namespace {
+
+template<typename src_channels_type>
+KoLut3DApplicatorBase *createForSource(const KoID &dstDepthId)
+{
+    if (dstDepthId == Integer8BitsColorDepthID) {
+        return createCalibratedClass<
+            KoLut3DApplicatorFactoryImpl<src_channels_type, quint8>>(KisSupportedArchitectures::ConversionKernels);
+    } else if (dstDepthId == Integer16BitsColorDepthID) {
+        return createCalibratedClass<
+            KoLut3DApplicatorFactoryImpl<src_channels_type, quint16>>(KisSupportedArchitectures::ConversionKernels);
+    } else if (dstDepthId == Float32BitsColorDepthID) {
+        return createCalibratedClass<
+            KoLut3DApplicatorFactoryImpl<src_channels_type, float>>(KisSupportedArchitectures::ConversionKernels);
+    }
+
+    return nullptr;
+}
+
+}
+
+KoLut3DApplicatorBase *KoLut3DApplicatorFactory::create(const KoID &srcDepthId, const KoID &dstDepthId)
+{
+    if (srcDepthId == Integer8BitsColorDepthID) {
+        return createForSource<quint8>(dstDepthId);
+    } else if (srcDepthId == Integer16BitsColorDepthID) {
+        return createForSource<quint16>(dstDepthId);
+    }
+
+    return nullptr;
+}
+
+bool KoLut3DApplicatorFactory::isSupported(const KoID &srcDepthId, const KoID &dstDepthId)
+{
+    return (srcDepthId == Integer8BitsColorDepthID ||
+            srcDepthId == Integer16BitsColorDepthID) &&
+        (dstDepthId == Integer8BitsColorDepthID ||
+         dstDepthId == Integer16BitsColorDepthID ||
+         dstDepthId == Float32BitsColorDepthID);
+}
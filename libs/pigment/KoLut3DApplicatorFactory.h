@@ -0,0 +1,31 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOLUT3DAPPLICATORFACTORY_H
+#define KOLUT3DAPPLICATORFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+
+class KoLut3DApplicatorBase;
+
+/**
+ * Creates a per-arch applicator of a 3D LUT. Supported source depths
+ * are 8-bit and 16-bit integers, supported destination depths are
+ * 8-bit and 16-bit integers and 32-bit float. Both pixels are expected
+ * to have three color channels with alpha in the last position.
+ *
+ * \return the applicator or nullptr if the depths are not supported
+ */
+class KRITAPIGMENT_EXPORT KoLut3DApplicatorFactory
+{
+public:
+    static KoLut3DApplicatorBase* create(const KoID &srcDepthId, const KoID &dstDepthId);
+    static bool isSupported(const KoID &srcDepthId, const KoID &dstDepthId);
+};
+
+#endif // KOLUT3DAPPLICATORFACTORY_H
@@ -0,0 +1,30 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoLut3DApplicatorFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoLut3DApplicator.h"
+
+template<typename _src_channels_type_, typename _dst_channels_type_>
+template<typename _impl>
+KoLut3DApplicatorBase *
+KoLut3DApplicatorFactoryImpl<_src_channels_type_, _dst_channels_type_>::create()
+{
+    return new KoLut3DApplicator<_src_channels_type_,
+                                 _dst_channels_type_,
+                                 _impl>();
+}
+
+template KoLut3DApplicatorBase* KoLut3DApplicatorFactoryImpl<quint8,  quint8>::create<xsimd::current_arch>();
+template KoLut3DApplicatorBase* KoLut3DApplicatorFactoryImpl<quint8,  quint16>::create<xsimd::current_arch>();
+template KoLut3DApplicatorBase* KoLut3DApplicatorFactoryImpl<quint8,  float>::create<xsimd::current_arch>();
+
+template KoLut3DApplicatorBase* KoLut3DApplicatorFactoryImpl<quint16, quint8>::create<xsimd::current_arch>();
+template KoLut3DApplicatorBase* KoLut3DApplicatorFactoryImpl<quint16, quint16>::create<xsimd::current_arch>();
+template KoLut3DApplicatorBase* KoLut3DApplicatorFactoryImpl<quint16, float>::create<xsimd::current_arch>();
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
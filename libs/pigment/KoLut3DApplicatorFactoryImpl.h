@@ -0,0 +1,24 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOLUT3DAPPLICATORFACTORYIMPL_H
+#define KOLUT3DAPPLICATORFACTORYIMPL_H
+
+#include <KoMultiArchBuildSupport.h>
+#include "kritapigment_export.h"
+
+class KoLut3DApplicatorBase;
+
+template<typename _src_channels_type_,
+         typename _dst_channels_type_>
+class KRITAPIGMENT_EXPORT KoLut3DApplicatorFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoLut3DApplicatorBase *create();
+};
+
+#endif // KOLUT3DAPPLICATORFACTORYIMPL_H
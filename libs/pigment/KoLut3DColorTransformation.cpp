@@ -0,0 +1,235 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoLut3DColorTransformation.h"
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorProfile.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceMaths.h>
+
+#include "KoLut3DApplicatorBase.h"
+#include "KoLut3DApplicatorFactory.h"
+
+namespace {
+
+/**
+ * The cache keeps the LUTs of the last used conversions. The cost of
+ * an entry is its size in kilobytes, so the default LUT takes about
+ * 1.6 MiB and the cache can hold about a dozen of them.
+ */
+struct LutCache
+{
+    static const int maxCostKiB = 24 * 1024;
+
+    LutCache() : cache(maxCostKiB) {}
+
+    QMutex mutex;
+    QCache<QByteArray, KoLut3DSP> cache;
+};
+
+Q_GLOBAL_STATIC(LutCache, s_lutCache)
+
+template<typename channels_type>
+void fillGrid(quint8 *pixels, int gridSize)
+{
+    channels_type *dst = reinterpret_cast<channels_type*>(pixels);
+
+    const qint64 unit = KoColorSpaceMathsTraits<channels_type>::unitValue;
+    const qint64 divisor = gridSize - 1;
+
+    for (int z = 0; z < gridSize; z++) {
+        for (int y = 0; y < gridSize; y++) {
+            for (int x = 0; x < gridSize; x++) {
+                dst[0] = channels_type((x * unit + divisor / 2) / divisor);
+                dst[1] = channels_type((y * unit + divisor / 2) / divisor);
+                dst[2] = channels_type((z * unit + divisor / 2) / divisor);
+                dst[3] = channels_type(unit);
+                dst += 4;
+            }
+        }
+    }
+}
+
+template<typename channels_type>
+void readGrid(const quint8 *pixels, int numNodes, float *table)
+{
+    const channels_type *src = reinterpret_cast<const channels_type*>(pixels);
+
+    for (int i = 0; i < numNodes; i++) {
+        table[0] = KoColorSpaceMaths<channels_type, float>::scaleToA(src[0]);
+        table[1] = KoColorSpaceMaths<channels_type, float>::scaleToA(src[1]);
+        table[2] = KoColorSpaceMaths<channels_type, float>::scaleToA(src[2]);
+        table += 3;
+        src += 4;
+    }
+}
+
+int pixelSizeForDepth(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ? 4 :
+        depthId == Integer16BitsColorDepthID ? 8 : 16;
+}
+
+bool hasSupportedLayout(const KoColorSpace *cs)
+{
+    return cs->channelCount() == 4 &&
+        cs->colorChannelCount() == 3 &&
+        cs->alphaPos() == 3;
+}
+
+}
+
+struct KoLut3DColorTransformation::Private
+{
+    KoLut3DSP lut;
+    QScopedPointer<KoLut3DApplicatorBase> applicator;
+};
+
+KoLut3DColorTransformation::KoLut3DColorTransformation(const KoColorSpace *srcCs,
+                                                       const KoColorSpace *dstCs,
+                                                       Intent renderingIntent,
+                                                       ConversionFlags conversionFlags,
+                                                       KoLut3DSP lut)
+    : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags)
+    , m_d(new Private)
+{
+    m_d->lut = lut;
+    m_d->applicator.reset(KoLut3DApplicatorFactory::create(srcCs->colorDepthId(), dstCs->colorDepthId()));
+}
+
+KoLut3DColorTransformation::~KoLut3DColorTransformation()
+{
+}
+
+void KoLut3DColorTransformation::transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    m_d->applicator->apply(src, dst, nPixels, *m_d->lut);
+}
+
+bool KoLut3DColorTransformation::isValid() const
+{
+    return m_d->lut && m_d->lut->gridSize >= 2 && m_d->applicator;
+}
+
+bool KoLut3DColorTransformation::canBake(const KoColorSpace *srcCs, const KoColorSpace *dstCs)
+{
+    /**
+     * The grid is uniform in the encoded values of the source. In a
+     * linear color space most of the perceptually distinct shadows
+     * fall into the first cell of the grid, so the interpolation
+     * would band there (the error of the sRGB-like encoding reaches
+     * 12 steps of an 8-bit channel)
+     */
+    if (srcCs->profile() && srcCs->profile()->isLinear()) return false;
+
+    return hasSupportedLayout(srcCs) && hasSupportedLayout(dstCs) &&
+        KoLut3DApplicatorFactory::isSupported(srcCs->colorDepthId(), dstCs->colorDepthId());
+}
+
+KoLut3DSP KoLut3DColorTransformation::bakeLut(const KoColorTransformation *transformation,
+                                              const KoID &srcDepthId,
+                                              const KoID &dstDepthId,
+                                              int gridSize)
+{
+    if (!KoLut3DApplicatorFactory::isSupported(srcDepthId, dstDepthId) || gridSize < 2) {
+        return KoLut3DSP();
+    }
+
+    const int numNodes = gridSize * gridSize * gridSize;
+
+    QVector<quint8> srcPixels(numNodes * pixelSizeForDepth(srcDepthId));
+    QVector<quint8> dstPixels(numNodes * pixelSizeForDepth(dstDepthId));
+
+    if (srcDepthId == Integer8BitsColorDepthID) {
+        fillGrid<quint8>(srcPixels.data(), gridSize);
+    } else {
+        fillGrid<quint16>(srcPixels.data(), gridSize);
+    }
+
+    transformation->transform(srcPixels.constData(), dstPixels.data(), numNodes);
+
+    QSharedPointer<KoLut3D> lut(new KoLut3D());
+    lut->gridSize = gridSize;
+    lut->table.resize(numNodes * 3);
+
+    if (dstDepthId == Integer8BitsColorDepthID) {
+        readGrid<quint8>(dstPixels.constData(), numNodes, lut->table.data());
+    } else if (dstDepthId == Integer16BitsColorDepthID) {
+        readGrid<quint16>(dstPixels.constData(), numNodes, lut->table.data());
+    } else {
+        readGrid<float>(dstPixels.constData(), numNodes, lut->table.data());
+    }
+
+    return lut;
+}
+
+KoColorConversionTransformation *KoLut3DColorTransformation::createProofingTransform(const KoColorSpace *srcCs,
+                                                                                    const KoColorSpace *dstCs,
+                                                                                    const KoColorSpace *proofingSpace,
+                                                                                    Intent renderingIntent,
+                                                                                    Intent proofingIntent,
+                                                                                    ConversionFlags conversionFlags,
+                                                                                    quint8 *gamutWarning,
+                                                                                    double adaptationState)
+{
+    /**
+     * The gamut warning replaces the out-of-gamut colors with a solid
+     * color, which would be smeared by the interpolation
+     */
+    if (conversionFlags.testFlag(GamutCheck) || !canBake(srcCs, dstCs)) return nullptr;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    Q_FOREACH (const KoColorSpace *cs, QVector<const KoColorSpace*>({srcCs, proofingSpace, dstCs})) {
+        hash.addData(cs->id().toLatin1());
+        if (cs->profile()) {
+            hash.addData(cs->profile()->uniqueId());
+        }
+        hash.addData("|", 1);
+    }
+
+    hash.addData(QByteArray::number(int(renderingIntent)) + ' ');
+    hash.addData(QByteArray::number(int(proofingIntent)) + ' ');
+    hash.addData(QByteArray::number(int(conversionFlags)) + ' ');
+    hash.addData(QByteArray::number(adaptationState));
+
+    const QByteArray key = hash.result();
+
+    KoLut3DSP lut;
+
+    {
+        QMutexLocker l(&s_lutCache->mutex);
+        KoLut3DSP *cachedLut = s_lutCache->cache.object(key);
+        if (cachedLut) {
+            lut = *cachedLut;
+        }
+    }
+
+    if (!lut) {
+        QScopedPointer<KoColorConversionTransformation> transformation(
+            srcCs->createProofingTransform(dstCs, proofingSpace,
+                                           renderingIntent, proofingIntent,
+                                           conversionFlags, gamutWarning, adaptationState));
+
+        if (!transformation || !transformation->isValid()) return nullptr;
+
+        lut = bakeLut(transformation.data(), srcCs->colorDepthId(), dstCs->colorDepthId());
+        if (!lut) return nullptr;
+
+        const int cost = qMax(1, int(lut->table.size() * sizeof(float) / 1024));
+
+        QMutexLocker l(&s_lutCache->mutex);
+        s_lutCache->cache.insert(key, new KoLut3DSP(lut), cost);
+    }
+
+    return new KoLut3DColorTransformation(srcCs, dstCs, renderingIntent, conversionFlags, lut);
+}
@@ -0,0 +1,112 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOLUT3DCOLORTRANSFORMATION_H
+#define KOLUT3DCOLORTRANSFORMATION_H
+
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <KoColorConversionTransformation.h>
+#include <KoID.h>
+
+#include "kritapigment_export.h"
+
+struct KoLut3D;
+typedef QSharedPointer<const KoLut3D> KoLut3DSP;
+
+/**
+ * A color conversion transformation that evaluates a baked 3D LUT
+ * instead of the original transformation.
+ *
+ * Any transformation, including chains built with
+ * KoMultipleColorConversionTransformation or
+ * KoCompositeColorTransformation (e.g. proofing followed by the display
+ * conversion), can be baked with bakeLut(). The LUT is sampled on a
+ * regular grid of the color channels of the source color space and is
+ * evaluated with tetrahedral interpolation by a per-arch applicator.
+ * Alpha channel is copied from the source pixel, so the baked
+ * transformation should not mix alpha into the color channels.
+ *
+ * At the moment the only user of the cached LUTs is the soft-proofing
+ * of the canvas, see createProofingTransform(). It chains two ICC
+ * transformations per pixel, while the plain display conversion is a
+ * single ICC transformation, which LCMS optimizes on its own.
+ */
+class KRITAPIGMENT_EXPORT KoLut3DColorTransformation : public KoColorConversionTransformation
+{
+public:
+    /**
+     * The default size of the grid. (gridSize - 1) divides both 255
+     * and 65535, so the nodes of the grid fall exactly on the values
+     * representable in the integer color spaces.
+     */
+    static const int DefaultGridSize = 52;
+
+    KoLut3DColorTransformation(const KoColorSpace *srcCs,
+                               const KoColorSpace *dstCs,
+                               Intent renderingIntent,
+                               ConversionFlags conversionFlags,
+                               KoLut3DSP lut);
+    ~KoLut3DColorTransformation() override;
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override;
+
+    bool isValid() const override;
+
+    /**
+     * @return true if a transformation from \p srcCs to \p dstCs can be
+     *         baked into a 3D LUT, that is both color spaces have three
+     *         color channels with alpha channel in the end, their
+     *         depths are supported by KoLut3DApplicatorFactory and the
+     *         profile of \p srcCs is not linear (the uniform grid is
+     *         too coarse for the shadows of linear data)
+     */
+    static bool canBake(const KoColorSpace *srcCs, const KoColorSpace *dstCs);
+
+    /**
+     * Bakes \p transformation into a 3D LUT by evaluating it on a
+     * regular grid of gridSize^3 source pixels.
+     *
+     * \p transformation should convert pixels of depth \p srcDepthId
+     * into pixels of depth \p dstDepthId, both with three color
+     * channels and alpha.
+     */
+    static KoLut3DSP bakeLut(const KoColorTransformation *transformation,
+                             const KoID &srcDepthId,
+                             const KoID &dstDepthId,
+                             int gridSize = DefaultGridSize);
+
+    /**
+     * Creates a soft-proofing transformation from \p srcCs to \p dstCs
+     * through \p proofingSpace, the same as
+     * KoColorSpace::createProofingTransform(), but evaluated with a
+     * baked 3D LUT.
+     *
+     * The LUTs are stored in a global cache keyed by the color spaces,
+     * their profiles and the parameters of the conversion, so the same
+     * LUT is reused by all the views proofing into the same space.
+     *
+     * \return a new transformation or nullptr if the conversion cannot
+     *         be baked, e.g. because of the gamut warning, which cannot
+     *         be interpolated
+     */
+    static KoColorConversionTransformation* createProofingTransform(const KoColorSpace *srcCs,
+                                                                    const KoColorSpace *dstCs,
+                                                                    const KoColorSpace *proofingSpace,
+                                                                    Intent renderingIntent,
+                                                                    Intent proofingIntent,
+                                                                    ConversionFlags conversionFlags,
+                                                                    quint8 *gamutWarning,
+                                                                    double adaptationState);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KOLUT3DCOLORTRANSFORMATION_H
@@ -95,7 +95,7 @@ public:
         }
     }
 
-private:
+protected:
     class MixerImpl;
 
     struct ArrayOfPointers {
@@ -290,6 +290,29 @@ private:
             normalizeFactor += weightsWrapper.normalizeFactor();
         }
 
+        /**
+         * Add the sums that were precomputed by an external (usually,
+         * vectorized) accumulation routine. \p channelTotals should
+         * contain the sums for all the channels, except alpha; the
+         * value for the alpha channel position is ignored.
+         */
+        void accumulateTotals(const mix_type *channelTotals, mix_type alphaTotal, qint64 weightsNormalizeFactor, int nColors) {
+#ifdef SANITY_CHECKS
+            m_numPixels += nColors;
+#else
+            Q_UNUSED(nColors);
+#endif
+
+            for (int i = 0; i < (int)_CSTrait::channels_nb; i++) {
+                if (i != _CSTrait::alpha_pos) {
+                    totals[i] += channelTotals[i];
+                }
+            }
+
+            totalAlpha += alphaTotal;
+            normalizeFactor += weightsNormalizeFactor;
+        }
+
         qint64 currentWeightsSum() const
         {
             return normalizeFactor;
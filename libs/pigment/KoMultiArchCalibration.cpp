@@ -0,0 +1,291 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoMultiArchCalibration.h"
+
+#include <limits>
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QSysInfo>
+#include <QThread>
+#include <QVector>
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <KoColorModelStandardIds.h>
+#include <KoCompositeOp.h>
+#include <KoMixColorsOp.h>
+#include <KoMultiArchBuildSupport.h>
+
+#include "DebugPigment.h"
+#include "KoOptimizedMixColorsOpFactoryImpl.h"
+#include "KoOptimizedPixelDataScalerU8ToU16FactoryImpl.h"
+#include "colorspaces/KoRgbU8ColorSpace.h"
+#include "compositeops/KoOptimizedCompositeOpFactoryPerArch.h"
+#include "dithering/KisOptimizedDitherOpFactoryImpl.h"
+
+namespace {
+
+const char *const configGroupName = "VectorCalibration";
+
+const char *const familyKeys[KisSupportedArchitectures::NumKernelFamilies] = {
+    "compositeKernels",
+    "mixingKernels",
+    "conversionKernels"
+};
+
+/**
+ * The size of the benchmarked patch is the size of a tile of the paint
+ * device, so the data fits into L1/L2 caches the same way as while
+ * painting.
+ */
+const int patchSize = 64;
+const int numPixels = patchSize * patchSize;
+
+const int numIterations = 16;
+const int numRuns = 5;
+
+/**
+ * A newer instruction set is replaced with an older one only if the
+ * older one is faster by this ratio. It filters out the noise of the
+ * measurements.
+ */
+const qreal switchThreshold = 0.95;
+
+template<typename Func>
+qint64 measure(Func func)
+{
+    // the first run warms up the caches and lets the CPU switch
+    // into the power state it uses for the instruction set
+    func();
+
+    qint64 best = std::numeric_limits<qint64>::max();
+
+    for (int i = 0; i < numRuns; i++) {
+        QElapsedTimer timer;
+        timer.start();
+
+        func();
+
+        best = qMin(best, timer.nsecsElapsed());
+    }
+
+    return best;
+}
+
+struct Buffers
+{
+    Buffers()
+        : src(numPixels * 4 * sizeof(quint16))
+        , dst(numPixels * 4 * sizeof(quint16))
+        , mask(numPixels)
+        , weights(numPixels, 1)
+    {
+        // a deterministic pattern with all the alpha values present,
+        // the branches of the kernels depend on the alpha
+        for (int i = 0; i < src.size(); i++) {
+            src[i] = quint8((i * 7 + i / 5) & 0xff);
+            dst[i] = quint8((i * 13 + i / 3) & 0xff);
+        }
+
+        for (int i = 0; i < mask.size(); i++) {
+            mask[i] = quint8((i * 3) & 0xff);
+        }
+    }
+
+    QVector<quint8> src;
+    QVector<quint8> dst;
+    QVector<quint8> mask;
+    QVector<qint16> weights;
+};
+
+qint64 benchmarkCompositeKernels(unsigned int arch, const KoColorSpace *cs, Buffers &buffers)
+{
+    QScopedPointer<KoCompositeOp> alphaDarkenOp(
+        createOptimizedClassForArch<
+            KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamy32>>(arch, cs));
+    QScopedPointer<KoCompositeOp> overOp(
+        createOptimizedClassForArch<
+            KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32>>(arch, cs));
+
+    KoCompositeOp::ParameterInfo params;
+    params.dstRowStart = buffers.dst.data();
+    params.dstRowStride = patchSize * 4;
+    params.srcRowStart = buffers.src.constData();
+    params.srcRowStride = patchSize * 4;
+    params.maskRowStart = buffers.mask.constData();
+    params.maskRowStride = patchSize;
+    params.rows = patchSize;
+    params.cols = patchSize;
+    params.setOpacityAndAverage(0.8f, 0.8f);
+    params.flow = 0.9f;
+
+    return measure([&] () {
+        for (int i = 0; i < numIterations; i++) {
+            alphaDarkenOp->composite(params);
+            overOp->composite(params);
+        }
+    });
+}
+
+qint64 benchmarkMixingKernels(unsigned int arch, Buffers &buffers)
+{
+    QScopedPointer<KoMixColorsOp> mixOp(
+        createOptimizedClassForArch<KoOptimizedMixColorsOpFactoryImpl<quint8, 4, 3>>(arch));
+
+    quint8 result[4];
+
+    return measure([&] () {
+        for (int i = 0; i < numIterations; i++) {
+            mixOp->mixColors(buffers.src.constData(), buffers.weights.constData(),
+                             numPixels, result, numPixels);
+        }
+    });
+}
+
+qint64 benchmarkConversionKernels(unsigned int arch, Buffers &buffers)
+{
+    QScopedPointer<KoOptimizedPixelDataScalerU8ToU16Base> scaler(
+        createOptimizedClassForArch<KoOptimizedPixelDataScalerU8ToU16FactoryImpl>(arch, 4));
+
+    QScopedPointer<KisDitherOp> ditherOp(
+        createOptimizedClassForArch<KisOptimizedDitherOpFactoryImpl<quint16, quint8, DITHER_BAYER>>(
+            arch, Integer16BitsColorDepthID, Integer8BitsColorDepthID, 4));
+
+    return measure([&] () {
+        for (int i = 0; i < numIterations; i++) {
+            scaler->convertU8ToU16(buffers.src.constData(), patchSize * 4,
+                                   buffers.dst.data(), patchSize * 8,
+                                   patchSize, patchSize);
+            ditherOp->dither(buffers.dst.constData(), patchSize * 8,
+                             buffers.src.data(), patchSize * 4,
+                             0, 0, patchSize, patchSize);
+        }
+    });
+}
+
+/**
+ * Identifies the configuration the cached results are valid for. If
+ * the set of the instruction sets changes (e.g. the user disables AVX
+ * or moves the config to another machine), the calibration is rerun.
+ */
+QString cpuSignature()
+{
+    QStringList archNames;
+    Q_FOREACH (unsigned int arch, KisSupportedArchitectures::availableArchs()) {
+        archNames << KisSupportedArchitectures::archName(arch);
+    }
+
+    return QString("%1;%2;%3;%4")
+        .arg(QSysInfo::currentCpuArchitecture())
+        .arg(QThread::idealThreadCount())
+        .arg(KisSupportedArchitectures::supportedInstructionSets().trimmed())
+        .arg(archNames.join(' '));
+}
+
+unsigned int archForName(const QString &name)
+{
+    Q_FOREACH (unsigned int arch, KisSupportedArchitectures::availableArchs()) {
+        if (KisSupportedArchitectures::archName(arch) == name) {
+            return arch;
+        }
+    }
+
+    return 0;
+}
+
+}
+
+void KoMultiArchCalibration::initialize()
+{
+    if (!KisSupportedArchitectures::calibrationEnabled()) return;
+    if (KisSupportedArchitectures::availableArchs().size() < 2) return;
+
+    KConfigGroup cfg = KSharedConfig::openConfig()->group(configGroupName);
+
+    const QString signature = cpuSignature();
+    Results results;
+
+    if (cfg.readEntry("signature", QString()) == signature) {
+        for (int i = 0; i < KisSupportedArchitectures::NumKernelFamilies; i++) {
+            const unsigned int arch = archForName(cfg.readEntry(familyKeys[i], QString()));
+            if (arch) {
+                results.insert(KisSupportedArchitectures::KernelFamily(i), arch);
+            }
+        }
+    }
+
+    if (results.size() != KisSupportedArchitectures::NumKernelFamilies) {
+        results = calibrate();
+
+        cfg.writeEntry("signature", signature);
+        for (auto it = results.constBegin(); it != results.constEnd(); ++it) {
+            cfg.writeEntry(familyKeys[it.key()], KisSupportedArchitectures::archName(it.value()));
+        }
+        cfg.sync();
+    }
+
+    apply(results);
+}
+
+KoMultiArchCalibration::Results KoMultiArchCalibration::calibrate()
+{
+    Results results;
+
+    const QVector<unsigned int> archs = KisSupportedArchitectures::availableArchs();
+    if (archs.isEmpty()) return results;
+
+    // the color space is needed only as the owner of the composite ops,
+    // so use the unmanaged one which doesn't need the registry
+    QScopedPointer<KoRgbU8ColorSpace> cs(new KoRgbU8ColorSpace());
+    Buffers buffers;
+
+    for (int family = 0; family < KisSupportedArchitectures::NumKernelFamilies; family++) {
+        unsigned int bestArch = archs.first();
+        qint64 bestTime = std::numeric_limits<qint64>::max();
+
+        // the archs are sorted from the newest to the oldest one
+        Q_FOREACH (unsigned int arch, archs) {
+            qint64 time = 0;
+
+            switch (family) {
+            case KisSupportedArchitectures::CompositeKernels:
+                time = benchmarkCompositeKernels(arch, cs.data(), buffers);
+                break;
+            case KisSupportedArchitectures::MixingKernels:
+                time = benchmarkMixingKernels(arch, buffers);
+                break;
+            case KisSupportedArchitectures::ConversionKernels:
+                time = benchmarkConversionKernels(arch, buffers);
+                break;
+            }
+
+            dbgPigment << "Calibration:" << familyKeys[family]
+                       << KisSupportedArchitectures::archName(arch) << time << "ns";
+
+            if (time < bestTime * switchThreshold) {
+                bestTime = time;
+                bestArch = arch;
+            }
+        }
+
+        results.insert(KisSupportedArchitectures::KernelFamily(family), bestArch);
+    }
+
+    return results;
+}
+
+void KoMultiArchCalibration::apply(const Results &results)
+{
+    for (auto it = results.constBegin(); it != results.constEnd(); ++it) {
+        KisSupportedArchitectures::setCalibratedArch(it.key(), it.value());
+
+        dbgPigment << "Using" << KisSupportedArchitectures::archName(it.value())
+                   << "for" << familyKeys[it.key()];
+    }
+}
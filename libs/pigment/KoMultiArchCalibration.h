@@ -0,0 +1,60 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOMULTIARCHCALIBRATION_H
+#define KOMULTIARCHCALIBRATION_H
+
+#include "kritapigment_export.h"
+
+#include <QMap>
+
+#include <KisSupportedArchitectures.h>
+
+/**
+ * Optional calibration of the dispatch of the vectorized kernels.
+ *
+ * By default the kernels are created for the newest instruction set
+ * supported by the CPU. On some CPUs the kernels built for an older
+ * instruction set run faster (e.g. because of the frequency throttling
+ * on wide vector instructions or double-pumped AVX units). The
+ * calibration runs a short microbenchmark of the composite, mixing and
+ * conversion kernels for every available instruction set and makes
+ * every family of the kernels use the fastest one.
+ *
+ * The results are stored in the config file together with the
+ * signature of the CPU, so the benchmark runs only once.
+ *
+ * The calibration is disabled by default and is enabled by the
+ * "enableVectorCalibration" config option.
+ */
+class KRITAPIGMENT_EXPORT KoMultiArchCalibration
+{
+public:
+    typedef QMap<KisSupportedArchitectures::KernelFamily, unsigned int> Results;
+
+    /**
+     * Loads the cached results of the calibration, or runs the
+     * calibration if there are no results for this CPU yet, and applies
+     * them to the dispatch. Does nothing if the calibration is disabled.
+     *
+     * Must be called before any kernel is created, that is before
+     * the color spaces are initialized.
+     */
+    static void initialize();
+
+    /**
+     * Runs the microbenchmark and returns the fastest instruction set
+     * for every family of the kernels
+     */
+    static Results calibrate();
+
+    /**
+     * Makes the dispatch use the instruction sets from \p results
+     */
+    static void apply(const Results &results);
+};
+
+#endif // KOMULTIARCHCALIBRATION_H
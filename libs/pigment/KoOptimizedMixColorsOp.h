@@ -0,0 +1,373 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOP_H
+#define KOOPTIMIZEDMIXCOLORSOP_H
+
+#include "KoMixColorsOpImpl.h"
+#include "KoColorSpaceTraits.h"
+#include "KoMultiArchBuildSupport.h"
+
+/**
+ * A mix colors op that uses vectorized accumulation for the
+ * contiguous-array methods (mixColors() with a plain array of
+ * pixels and the Mixer interface). The methods that accept an
+ * array of pointers are not vectorized and fall back to the
+ * scalar implementation of KoMixColorsOpImpl.
+ *
+ * The generic (scalar) version is just a plain KoMixColorsOpImpl.
+ */
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_,
+         typename _impl,
+         typename EnableDummyType = void>
+class KoOptimizedMixColorsOp
+    : public KoMixColorsOpImpl<KoColorSpaceTrait<_channels_type_, _channels_nb_, _alpha_pos_>>
+{
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+#include <array>
+#include "KoStreamedMath.h"
+
+/**
+ * Vectorized accumulation of the weighted sums of the pixels.
+ *
+ * For integer color spaces the result is bit-exact with the scalar
+ * version of KoMixColorsOpImpl. The products of the channel values and
+ * alpha * weight do not fit into 32-bit vector lanes, so both factors
+ * are split into 8-bit (color) and 16-bit (alpha * weight) parts, the
+ * partial products are summed in 32-bit lanes and flushed into 64-bit
+ * totals every flushInterval iterations.
+ *
+ * For floating point color spaces the sums are accumulated in float
+ * lanes and flushed into double totals with the same interval.
+ */
+template<typename _channels_type_, int _channels_nb_, int _alpha_pos_, typename _impl>
+struct KoStreamedMixColors
+{
+    using channels_type = _channels_type_;
+    using MathsTraits = KoColorSpaceMathsTraits<channels_type>;
+    using mix_type = typename MathsTraits::mixtype;
+
+    using int_v = typename KoStreamedMath<_impl>::int_v;
+    using uint_v = typename KoStreamedMath<_impl>::uint_v;
+    using float_v = typename KoStreamedMath<_impl>::float_v;
+
+    static constexpr int channels_nb = _channels_nb_;
+    static constexpr int alpha_pos = _alpha_pos_;
+    static constexpr int pixelSize = channels_nb * sizeof(channels_type);
+    static constexpr int vectorSize = static_cast<int>(int_v::size);
+
+    static constexpr bool isIntegerType = std::is_integral<channels_type>::value;
+    static constexpr int numChannelBytes = isIntegerType ? sizeof(channels_type) : 1;
+
+    /**
+     * Every partial product is not bigger than 255 * 65535, so
+     * 64 of them still fit into a signed 32-bit integer lane
+     */
+    static constexpr int flushInterval = 64;
+
+    static_assert(alpha_pos >= 0, "KoStreamedMixColors supports only color spaces with alpha channel");
+    static_assert(sizeof(channels_type) <= 2 || std::is_same<channels_type, float>::value,
+                  "KoStreamedMixColors supports only 8-bit, 16-bit integer and 32-bit float channels");
+
+    template<bool useWeights>
+    static void accumulate(const quint8 *data, const qint16 *weights, int nPixels,
+                           mix_type *totals, mix_type &totalAlpha)
+    {
+        if constexpr (isIntegerType) {
+            accumulateInteger<useWeights>(data, weights, nPixels, totals, totalAlpha);
+        } else {
+            accumulateFloat<useWeights>(data, weights, nPixels, totals, totalAlpha);
+        }
+    }
+
+private:
+    template<bool useWeights>
+    static void accumulateScalar(const quint8 *data, const qint16 *weights, int nPixels,
+                                 mix_type *totals, mix_type &totalAlpha)
+    {
+        for (int p = 0; p < nPixels; p++) {
+            const channels_type *color = reinterpret_cast<const channels_type*>(data);
+
+            mix_type alphaTimesWeight = color[alpha_pos];
+            if (useWeights) {
+                alphaTimesWeight *= weights[p];
+            }
+
+            for (int i = 0; i < channels_nb; i++) {
+                if (i != alpha_pos) {
+                    totals[i] += color[i] * alphaTimesWeight;
+                }
+            }
+
+            totalAlpha += alphaTimesWeight;
+            data += pixelSize;
+        }
+    }
+
+    template<typename Result, typename V>
+    static ALWAYS_INLINE Result horizontalSum(const V &value)
+    {
+        alignas(_impl::alignment()) std::array<typename V::value_type, V::size> buf;
+        value.store_aligned(buf.data());
+
+        Result sum = 0;
+        for (size_t i = 0; i < V::size; i++) {
+            sum += buf[i];
+        }
+        return sum;
+    }
+
+    static ALWAYS_INLINE void loadPixels(const quint8 *data, int_v (&channels)[channels_nb])
+    {
+        if constexpr (std::is_same<channels_type, quint8>::value && channels_nb == 4) {
+            const uint_v data_i = uint_v::load_unaligned(reinterpret_cast<const quint32 *>(data));
+            const uint_v mask(0xFF);
+
+            channels[0] = xsimd::bitwise_cast_compat<int>(data_i & mask);
+            channels[1] = xsimd::bitwise_cast_compat<int>((data_i >> 8) & mask);
+            channels[2] = xsimd::bitwise_cast_compat<int>((data_i >> 16) & mask);
+            channels[3] = xsimd::bitwise_cast_compat<int>(data_i >> 24);
+        } else {
+            const channels_type *src = reinterpret_cast<const channels_type *>(data);
+
+            for (int i = 0; i < channels_nb; i++) {
+                channels[i] = xsimd::load_and_extend_strided<int_v>(src + i, channels_nb);
+            }
+        }
+    }
+
+    static void flushPartialSums(int_v (&partialSums)[channels_nb][numChannelBytes][2],
+                                 int_v (&alphaSums)[2],
+                                 mix_type *totals, mix_type &totalAlpha)
+    {
+        for (int i = 0; i < channels_nb; i++) {
+            if (i == alpha_pos) continue;
+
+            for (int byte = 0; byte < numChannelBytes; byte++) {
+                const qint64 lowFactor = qint64(1) << (8 * byte);
+                const qint64 highFactor = qint64(1) << (8 * byte + 16);
+
+                totals[i] += horizontalSum<qint64>(partialSums[i][byte][0]) * lowFactor +
+                             horizontalSum<qint64>(partialSums[i][byte][1]) * highFactor;
+
+                partialSums[i][byte][0] = int_v(0);
+                partialSums[i][byte][1] = int_v(0);
+            }
+        }
+
+        totalAlpha += horizontalSum<qint64>(alphaSums[0]) +
+                      horizontalSum<qint64>(alphaSums[1]) * (qint64(1) << 16);
+
+        alphaSums[0] = int_v(0);
+        alphaSums[1] = int_v(0);
+    }
+
+    template<bool useWeights>
+    static void accumulateInteger(const quint8 *data, const qint16 *weights, int nPixels,
+                                  mix_type *totals, mix_type &totalAlpha)
+    {
+        const int numBlocks = nPixels / vectorSize;
+
+        /**
+         * Partial sums are indexed as [channel][byte of the channel value]
+         * [low/high 16-bit half of alpha * weight]
+         */
+        int_v partialSums[channels_nb][numChannelBytes][2];
+        int_v alphaSums[2] = {int_v(0), int_v(0)};
+
+        for (int i = 0; i < channels_nb; i++) {
+            for (int byte = 0; byte < numChannelBytes; byte++) {
+                partialSums[i][byte][0] = int_v(0);
+                partialSums[i][byte][1] = int_v(0);
+            }
+        }
+
+        const int_v lowHalfMask(0xFFFF);
+        const int_v byteMask(0xFF);
+
+        int iterationsSinceFlush = 0;
+
+        for (int block = 0; block < numBlocks; block++) {
+            int_v channels[channels_nb];
+            loadPixels(data, channels);
+
+            int_v alphaTimesWeight = channels[alpha_pos];
+            if (useWeights) {
+                alphaTimesWeight *= xsimd::load_and_extend<int_v>(weights);
+                weights += vectorSize;
+            }
+
+            const int_v awLow = alphaTimesWeight & lowHalfMask;
+            const int_v awHigh = alphaTimesWeight >> 16;
+
+            alphaSums[0] += awLow;
+            alphaSums[1] += awHigh;
+
+            for (int i = 0; i < channels_nb; i++) {
+                if (i == alpha_pos) continue;
+
+                for (int byte = 0; byte < numChannelBytes; byte++) {
+                    const int_v c = numChannelBytes > 1 ? (channels[i] >> (8 * byte)) & byteMask : channels[i];
+                    partialSums[i][byte][0] += c * awLow;
+                    partialSums[i][byte][1] += c * awHigh;
+                }
+            }
+
+            data += vectorSize * pixelSize;
+
+            if (++iterationsSinceFlush >= flushInterval) {
+                flushPartialSums(partialSums, alphaSums, totals, totalAlpha);
+                iterationsSinceFlush = 0;
+            }
+        }
+
+        if (iterationsSinceFlush) {
+            flushPartialSums(partialSums, alphaSums, totals, totalAlpha);
+        }
+
+        accumulateScalar<useWeights>(data, weights, nPixels - numBlocks * vectorSize, totals, totalAlpha);
+    }
+
+    template<bool useWeights>
+    static void accumulateFloat(const quint8 *data, const qint16 *weights, int nPixels,
+                                mix_type *totals, mix_type &totalAlpha)
+    {
+        const int numBlocks = nPixels / vectorSize;
+
+        /**
+         * The slot of the alpha channel is used for accumulating
+         * the sum of alpha * weight
+         */
+        float_v partialSums[channels_nb];
+        for (int i = 0; i < channels_nb; i++) {
+            partialSums[i] = float_v(0.0f);
+        }
+
+        auto flush = [&] () {
+            for (int i = 0; i < channels_nb; i++) {
+                if (i == alpha_pos) {
+                    totalAlpha += horizontalSum<mix_type>(partialSums[i]);
+                } else {
+                    totals[i] += horizontalSum<mix_type>(partialSums[i]);
+                }
+                partialSums[i] = float_v(0.0f);
+            }
+        };
+
+        int iterationsSinceFlush = 0;
+
+        for (int block = 0; block < numBlocks; block++) {
+            const float *src = reinterpret_cast<const float *>(data);
+
+            float_v alphaTimesWeight = xsimd::load_and_extend_strided<float_v>(src + alpha_pos, channels_nb);
+            if (useWeights) {
+                alphaTimesWeight *= xsimd::batch_cast<float>(xsimd::load_and_extend<int_v>(weights));
+                weights += vectorSize;
+            }
+
+            for (int i = 0; i < channels_nb; i++) {
+                if (i == alpha_pos) {
+                    partialSums[i] += alphaTimesWeight;
+                } else {
+                    const float_v c = xsimd::load_and_extend_strided<float_v>(src + i, channels_nb);
+                    partialSums[i] = xsimd::fma(c, alphaTimesWeight, partialSums[i]);
+                }
+            }
+
+            data += vectorSize * pixelSize;
+
+            if (++iterationsSinceFlush >= flushInterval) {
+                flush();
+                iterationsSinceFlush = 0;
+            }
+        }
+
+        if (iterationsSinceFlush) {
+            flush();
+        }
+
+        accumulateScalar<useWeights>(data, weights, nPixels - numBlocks * vectorSize, totals, totalAlpha);
+    }
+};
+
+template<typename _channels_type_, int _channels_nb_, int _alpha_pos_, typename _impl>
+class KoOptimizedMixColorsOp<
+        _channels_type_, _channels_nb_, _alpha_pos_, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KoMixColorsOpImpl<KoColorSpaceTrait<_channels_type_, _channels_nb_, _alpha_pos_>>
+{
+    using Trait = KoColorSpaceTrait<_channels_type_, _channels_nb_, _alpha_pos_>;
+    using base_class = KoMixColorsOpImpl<Trait>;
+    using MixDataResult = typename base_class::MixDataResult;
+    using mix_type = typename KoColorSpaceMathsTraits<_channels_type_>::mixtype;
+    using Accumulator = KoStreamedMixColors<_channels_type_, _channels_nb_, _alpha_pos_, _impl>;
+
+public:
+    using base_class::mixColors;
+
+    KoMixColorsOp::Mixer* createMixer() const override {
+        return new OptimizedMixerImpl();
+    }
+
+    void mixColors(const quint8 *colors, const qint16 *weights, int nColors, quint8 *dst, int weightSum = 255) const override {
+        MixDataResult result;
+        accumulateImpl<true>(result, colors, weights, weightSum, nColors);
+        result.computeMixedColor(dst);
+    }
+
+    void mixColors(const quint8 *colors, int nColors, quint8 *dst) const override {
+        MixDataResult result;
+        accumulateImpl<false>(result, colors, nullptr, nColors, nColors);
+        result.computeMixedColor(dst);
+    }
+
+private:
+    template<bool useWeights>
+    static void accumulateImpl(MixDataResult &result, const quint8 *data, const qint16 *weights, int normalizeFactor, int nPixels)
+    {
+        mix_type totals[Trait::channels_nb] = {};
+        mix_type totalAlpha = 0;
+
+        Accumulator::template accumulate<useWeights>(data, weights, nPixels, totals, totalAlpha);
+        result.accumulateTotals(totals, totalAlpha, normalizeFactor, nPixels);
+    }
+
+    class OptimizedMixerImpl : public KoMixColorsOp::Mixer
+    {
+    public:
+        void accumulate(const quint8 *data, const qint16 *weights, int weightSum, int nPixels) override
+        {
+            accumulateImpl<true>(result, data, weights, weightSum, nPixels);
+        }
+
+        void accumulateAverage(const quint8 *data, int nPixels) override
+        {
+            accumulateImpl<false>(result, data, nullptr, nPixels, nPixels);
+        }
+
+        void computeMixedColor(quint8 *data) override
+        {
+            result.computeMixedColor(data);
+        }
+
+        qint64 currentWeightsSum() const override
+        {
+            return result.currentWeightsSum();
+        }
+
+    private:
+        MixDataResult result;
+    };
+};
+
+#endif /* defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) */
+
+#endif // KOOPTIMIZEDMIXCOLORSOP_H
@@ -0,0 +1,49 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedMixColorsOpFactory.h"
+
+#include <KoColorModelStandardIdsUtils.h>
+
+#include "KoOptimizedMixColorsOpFactoryImpl.h"
+
+template <typename channels_type>
+struct CreateMixColorsOp
+{
+    KoMixColorsOp *operator() (int numChannels, int alphaPos) {
+        if (numChannels == 4 && alphaPos == 3) {
+            return createCalibratedClass<
+                KoOptimizedMixColorsOpFactoryImpl<channels_type, 4, 3>>(KisSupportedArchitectures::MixingKernels);
+        } else if (numChannels == 2 && alphaPos == 1) {
+            return createCalibratedClass<
+                KoOptimizedMixColorsOpFactoryImpl<channels_type, 2, 1>>(KisSupportedArchitectures::MixingKernels);
+        }
+
+        return nullptr;
+    }
+};
+
+#ifdef HAVE_OPENEXR
+template <>
+struct CreateMixColorsOp<half>
+{
+    KoMixColorsOp *operator() (int, int) {
+        return nullptr;
+    }
+};
+#endif
+
+KoMixColorsOp *KoOptimizedMixColorsOpFactory::create(KoID depthId, int numChannels, int alphaPos)
+{
+    if (depthId != Integer8BitsColorDepthID &&
+        depthId != Integer16BitsColorDepthID &&
+        depthId != Float32BitsColorDepthID) {
+
+        return nullptr;
+    }
+
+    return channelTypeForColorDepthId<CreateMixColorsOp>(depthId, numChannels, alphaPos);
+}
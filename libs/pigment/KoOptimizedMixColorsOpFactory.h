@@ -0,0 +1,31 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOPFACTORY_H
+#define KOOPTIMIZEDMIXCOLORSOPFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+
+class KoMixColorsOp;
+
+/**
+ * Creates a mix colors op with vectorized accumulation for the pixel
+ * layouts used by the most common color spaces: 8-bit, 16-bit integer
+ * and 32-bit float RGBA and GrayA.
+ *
+ * \return the optimized op or nullptr if the requested layout has no
+ *         optimized implementation. In the latter case the caller should
+ *         fall back to KoMixColorsOpImpl.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedMixColorsOpFactory
+{
+public:
+    static KoMixColorsOp* create(KoID depthId, int numChannels, int alphaPos);
+};
+
+#endif // KOOPTIMIZEDMIXCOLORSOPFACTORY_H
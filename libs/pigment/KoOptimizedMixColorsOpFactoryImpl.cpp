@@ -0,0 +1,32 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedMixColorsOpFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedMixColorsOp.h"
+
+template<typename _channels_type_, int _channels_nb_, int _alpha_pos_>
+template<typename _impl>
+KoMixColorsOp *
+KoOptimizedMixColorsOpFactoryImpl<_channels_type_, _channels_nb_, _alpha_pos_>::
+    create()
+{
+    return new KoOptimizedMixColorsOp<_channels_type_,
+                                      _channels_nb_,
+                                      _alpha_pos_,
+                                      _impl>();
+}
+
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint8,  4, 3>::create<xsimd::current_arch>();
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint16, 4, 3>::create<xsimd::current_arch>();
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<float,   4, 3>::create<xsimd::current_arch>();
+
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint8,  2, 1>::create<xsimd::current_arch>();
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint16, 2, 1>::create<xsimd::current_arch>();
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<float,   2, 1>::create<xsimd::current_arch>();
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
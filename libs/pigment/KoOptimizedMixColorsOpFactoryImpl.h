@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOPFACTORYIMPL_H
+#define KOOPTIMIZEDMIXCOLORSOPFACTORYIMPL_H
+
+#include <KoMultiArchBuildSupport.h>
+#include "kritapigment_export.h"
+
+class KoMixColorsOp;
+
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_>
+class KRITAPIGMENT_EXPORT KoOptimizedMixColorsOpFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoMixColorsOp *create();
+};
+
+#endif // KOOPTIMIZEDMIXCOLORSOPFACTORYIMPL_H
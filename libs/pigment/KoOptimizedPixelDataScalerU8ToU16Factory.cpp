@@ -11,12 +11,12 @@
 
 KoOptimizedPixelDataScalerU8ToU16Base *KoOptimizedPixelDataScalerU8ToU16Factory::createRgbaScaler()
 {
-    return createOptimizedClass<
-            KoOptimizedPixelDataScalerU8ToU16FactoryImpl>(4);
+    return createCalibratedClass<
+            KoOptimizedPixelDataScalerU8ToU16FactoryImpl>(KisSupportedArchitectures::ConversionKernels, 4);
 }
 
 KoOptimizedPixelDataScalerU8ToU16Base *KoOptimizedPixelDataScalerU8ToU16Factory::createCmykaScaler()
 {
-    return createOptimizedClass<
-            KoOptimizedPixelDataScalerU8ToU16FactoryImpl>(5);
+    return createCalibratedClass<
+            KoOptimizedPixelDataScalerU8ToU16FactoryImpl>(KisSupportedArchitectures::ConversionKernels, 5);
 }
@@ -0,0 +1,253 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoPaletteMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <QCache>
+#include <QGlobalStatic>
+#include <QMutex>
+
+#include <KoMultiArchBuildSupport.h>
+
+#include "KoPaletteMapKernelBase.h"
+#include "KoPaletteMapKernelFactoryImpl.h"
+
+namespace {
+
+const int gridBits = 5;
+const int gridSize = 1 << gridBits;
+const int cellShift = 16 - gridBits;
+const int numCells = gridSize * gridSize * gridSize;
+
+// the distances are calculated in chunks to keep the buffer on the stack
+const int chunkSize = 64;
+
+const KoPaletteMapKernelBase *paletteMapKernel()
+{
+    static const QScopedPointer<KoPaletteMapKernelBase> kernel(
+        createOptimizedClass<KoPaletteMapKernelFactoryImpl>());
+    return kernel.data();
+}
+
+struct PaletteMapCache
+{
+    QMutex lock;
+    QCache<QByteArray, QSharedPointer<const KoPaletteMap>> maps {16};
+};
+
+Q_GLOBAL_STATIC(PaletteMapCache, s_mapCache)
+
+inline int cellIndex(const quint16 *color)
+{
+    return ((color[0] >> cellShift) * gridSize + (color[1] >> cellShift)) * gridSize +
+        (color[2] >> cellShift);
+}
+
+}
+
+struct KoPaletteMap::Private
+{
+    int numColors = 0;
+    int numNearest = 1;
+    Weights weights;
+
+    /**
+     * The candidates of cell i are stored in the range
+     * [cellOffsets[i], cellOffsets[i + 1]) of the arrays below,
+     * sorted by their index in the palette
+     */
+    QVector<int> cellOffsets;
+    QVector<float> c0;
+    QVector<float> c1;
+    QVector<float> c2;
+    QVector<int> indices;
+
+    int findNearest(const quint16 *color, Match *matches, int numMatches) const;
+};
+
+KoPaletteMap::KoPaletteMap(const QVector<Color> &colors, const Weights &weights, int numNearest)
+    : m_d(new Private)
+{
+    m_d->numColors = colors.size();
+    m_d->numNearest = qBound(1, numNearest, 2);
+    m_d->weights = weights;
+    m_d->cellOffsets.resize(numCells + 1);
+
+    const int numPicked = qMin(m_d->numNearest, m_d->numColors);
+    QVector<double> minDistances(m_d->numColors);
+    QVector<double> maxDistances(m_d->numColors);
+    QVector<double> sortedDistances;
+
+    int cell = 0;
+
+    for (int g0 = 0; g0 < gridSize; g0++) {
+        for (int g1 = 0; g1 < gridSize; g1++) {
+            for (int g2 = 0; g2 < gridSize; g2++, cell++) {
+                m_d->cellOffsets[cell] = m_d->indices.size();
+
+                if (!numPicked) continue;
+
+                const int cellCoords[3] = {g0, g1, g2};
+
+                for (int i = 0; i < m_d->numColors; i++) {
+                    double minDistance = 0.0;
+                    double maxDistance = 0.0;
+
+                    for (int ch = 0; ch < 3; ch++) {
+                        const double w = std::abs(weights[ch]);
+                        const double lo = w * (cellCoords[ch] << cellShift);
+                        const double hi = w * (((cellCoords[ch] + 1) << cellShift) - 1);
+                        const double x = w * colors[i][ch];
+
+                        const double outside = qMax(0.0, qMax(lo - x, x - hi));
+                        const double farthest = qMax(std::abs(x - lo), std::abs(x - hi));
+
+                        minDistance += outside * outside;
+                        maxDistance += farthest * farthest;
+                    }
+
+                    minDistances[i] = minDistance;
+                    maxDistances[i] = maxDistance;
+                }
+
+                /**
+                 * Every color of the cell has at least numPicked palette
+                 * colors not farther than the numPicked-th smallest of the
+                 * maximum distances, the colors lying farther than that
+                 * from the whole cell can never be picked. The threshold
+                 * is slightly relaxed to be safe from the rounding of the
+                 * float distances of the lookup.
+                 */
+                sortedDistances = maxDistances;
+                std::nth_element(sortedDistances.begin(),
+                                 sortedDistances.begin() + numPicked - 1,
+                                 sortedDistances.end());
+                const double threshold = sortedDistances[numPicked - 1] * (1.0 + 1e-5) + 1e-3;
+
+                for (int i = 0; i < m_d->numColors; i++) {
+                    if (minDistances[i] > threshold) continue;
+
+                    m_d->c0.append(weights[0] * colors[i][0]);
+                    m_d->c1.append(weights[1] * colors[i][1]);
+                    m_d->c2.append(weights[2] * colors[i][2]);
+                    m_d->indices.append(i);
+                }
+            }
+        }
+    }
+
+    m_d->cellOffsets[numCells] = m_d->indices.size();
+}
+
+KoPaletteMap::~KoPaletteMap()
+{
+}
+
+QSharedPointer<const KoPaletteMap> KoPaletteMap::cachedMap(const QVector<Color> &colors,
+                                                          const Weights &weights,
+                                                          int numNearest)
+{
+    QByteArray key(reinterpret_cast<const char*>(colors.constData()),
+                   colors.size() * int(sizeof(Color)));
+    key.append(reinterpret_cast<const char*>(weights.data()), int(sizeof(Weights)));
+    key.append(reinterpret_cast<const char*>(&numNearest), int(sizeof(numNearest)));
+
+    {
+        QMutexLocker l(&s_mapCache->lock);
+        QSharedPointer<const KoPaletteMap> *map = s_mapCache->maps.object(key);
+        if (map) return *map;
+    }
+
+    // the map is built without holding the lock, in the worst case
+    // two threads build the same map and one of them is dropped
+    QSharedPointer<const KoPaletteMap> map(new KoPaletteMap(colors, weights, numNearest));
+
+    {
+        QMutexLocker l(&s_mapCache->lock);
+        s_mapCache->maps.insert(key, new QSharedPointer<const KoPaletteMap>(map));
+    }
+
+    return map;
+}
+
+int KoPaletteMap::numColors() const
+{
+    return m_d->numColors;
+}
+
+int KoPaletteMap::numNearest() const
+{
+    return m_d->numNearest;
+}
+
+int KoPaletteMap::Private::findNearest(const quint16 *color, Match *matches, int numMatches) const
+{
+    const int cell = cellIndex(color);
+    const int begin = cellOffsets[cell];
+    const int end = cellOffsets[cell + 1];
+
+    const float x0 = weights[0] * color[0];
+    const float x1 = weights[1] * color[1];
+    const float x2 = weights[2] * color[2];
+
+    float bestDistances[2] = {std::numeric_limits<float>::max(),
+                              std::numeric_limits<float>::max()};
+    int bestIndices[2] = {-1, -1};
+
+    float distances[chunkSize];
+    const KoPaletteMapKernelBase *kernel = paletteMapKernel();
+
+    for (int chunk = begin; chunk < end; chunk += chunkSize) {
+        const int chunkLength = qMin(chunkSize, end - chunk);
+
+        kernel->squaredDistances(c0.constData() + chunk,
+                                 c1.constData() + chunk,
+                                 c2.constData() + chunk,
+                                 chunkLength, x0, x1, x2, distances);
+
+        // the candidates are sorted by the index, so the strict
+        // comparison prefers the first one of the equal colors
+        for (int i = 0; i < chunkLength; i++) {
+            const float d = distances[i];
+
+            if (d < bestDistances[0]) {
+                bestDistances[1] = bestDistances[0];
+                bestIndices[1] = bestIndices[0];
+                bestDistances[0] = d;
+                bestIndices[0] = indices[chunk + i];
+            } else if (numMatches > 1 && d < bestDistances[1]) {
+                bestDistances[1] = d;
+                bestIndices[1] = indices[chunk + i];
+            }
+        }
+    }
+
+    int numFound = 0;
+
+    for (int i = 0; i < numMatches && bestIndices[i] >= 0; i++) {
+        matches[i].index = bestIndices[i];
+        matches[i].distance = std::sqrt(bestDistances[i]);
+        numFound++;
+    }
+
+    return numFound;
+}
+
+int KoPaletteMap::nearest(const quint16 *color) const
+{
+    Match match;
+    m_d->findNearest(color, &match, 1);
+    return match.index;
+}
+
+int KoPaletteMap::nearestMatches(const quint16 *color, Match *matches) const
+{
+    return m_d->findNearest(color, matches, m_d->numNearest);
+}
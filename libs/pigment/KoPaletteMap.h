@@ -0,0 +1,86 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOPALETTEMAP_H
+#define KOPALETTEMAP_H
+
+#include <array>
+
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "kritapigment_export.h"
+
+/**
+ * Maps colors to the nearest colors of a palette.
+ *
+ * The colors are triplets of 16-bit channels (e.g. the color channels
+ * of Lab16 or RGB16), the distance is Euclidean with optional weights
+ * of the channels.
+ *
+ * The map keeps an inverse color map: the color cube is split into a
+ * 32x32x32 grid and every cell stores the palette colors which can be
+ * the nearest ones for some color inside the cell. A lookup checks only
+ * the candidates of the cell of the color, the distances to them are
+ * calculated with vector instructions.
+ *
+ * Building the grid costs much more than a lookup, so the filters share
+ * the maps through cachedMap().
+ */
+class KRITAPIGMENT_EXPORT KoPaletteMap
+{
+public:
+    using Color = std::array<quint16, 3>;
+    using Weights = std::array<float, 3>;
+
+    struct Match {
+        int index = -1; ///< index of the color in the palette
+        float distance = 0.0f; ///< weighted Euclidean distance to it
+    };
+
+    /**
+     * Creates a map of \p colors, which can find \p numNearest nearest
+     * colors at once (one or two, the latter is used for dithering). The channel differences are multiplied by
+     * \p weights before calculating the distance.
+     */
+    KoPaletteMap(const QVector<Color> &colors,
+                 const Weights &weights = {1.0f, 1.0f, 1.0f},
+                 int numNearest = 1);
+    ~KoPaletteMap();
+
+    /**
+     * Returns the map with the same parameters as the constructor, reusing
+     * the one created earlier for the same palette if it is still cached
+     */
+    static QSharedPointer<const KoPaletteMap> cachedMap(const QVector<Color> &colors,
+                                                        const Weights &weights = {1.0f, 1.0f, 1.0f},
+                                                        int numNearest = 1);
+
+    int numColors() const;
+    int numNearest() const;
+
+    /**
+     * \return the index of the color nearest to \p color or -1 if the
+     *         palette is empty. Of the equally distant colors the first
+     *         one in the palette is returned.
+     */
+    int nearest(const quint16 *color) const;
+
+    /**
+     * Writes up to numNearest() colors nearest to \p color into \p matches,
+     * sorted by the distance.
+     *
+     * \return the number of matches written
+     */
+    int nearestMatches(const quint16 *color, Match *matches) const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KOPALETTEMAP_H
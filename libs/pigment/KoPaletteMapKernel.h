@@ -0,0 +1,83 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOPALETTEMAPKERNEL_H
+#define KOPALETTEMAPKERNEL_H
+
+#include <type_traits>
+
+#include <KoMultiArchBuildSupport.h>
+
+#include "KoPaletteMapKernelBase.h"
+
+template<typename _impl, typename EnableDummyType = void>
+struct KoPaletteMapDistances
+{
+    static void calculate(const float *c0, const float *c1, const float *c2,
+                          int numColors,
+                          float x0, float x1, float x2,
+                          float *distances)
+    {
+        for (int i = 0; i < numColors; i++) {
+            const float d0 = c0[i] - x0;
+            const float d1 = c1[i] - x1;
+            const float d2 = c2[i] - x2;
+            distances[i] = d0 * d0 + d1 * d1 + d2 * d2;
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+template<typename _impl>
+struct KoPaletteMapDistances<_impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+{
+    using float_v = xsimd::batch<float, _impl>;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+    static void calculate(const float *c0, const float *c1, const float *c2,
+                          int numColors,
+                          float x0, float x1, float x2,
+                          float *distances)
+    {
+        const float_v vx0(x0);
+        const float_v vx1(x1);
+        const float_v vx2(x2);
+
+        int i = 0;
+
+        for (; i + vectorSize <= numColors; i += vectorSize) {
+            const float_v d0 = float_v::load_unaligned(c0 + i) - vx0;
+            const float_v d1 = float_v::load_unaligned(c1 + i) - vx1;
+            const float_v d2 = float_v::load_unaligned(c2 + i) - vx2;
+            (d0 * d0 + d1 * d1 + d2 * d2).store_unaligned(distances + i);
+        }
+
+        KoPaletteMapDistances<xsimd::generic>::calculate(c0 + i, c1 + i, c2 + i,
+                                                         numColors - i,
+                                                         x0, x1, x2,
+                                                         distances + i);
+    }
+};
+
+#endif // HAVE_XSIMD
+
+template<typename _impl>
+class KoPaletteMapKernel : public KoPaletteMapKernelBase
+{
+public:
+    void squaredDistances(const float *c0, const float *c1, const float *c2,
+                          int numColors,
+                          float x0, float x1, float x2,
+                          float *distances) const override
+    {
+        KoPaletteMapDistances<_impl>::calculate(c0, c1, c2, numColors, x0, x1, x2, distances);
+    }
+};
+
+#endif // KOPALETTEMAPKERNEL_H
@@ -0,0 +1,11 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoPaletteMapKernelBase.h"
+
+KoPaletteMapKernelBase::~KoPaletteMapKernelBase()
+{
+}
@@ -0,0 +1,33 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOPALETTEMAPKERNELBASE_H
+#define KOPALETTEMAPKERNELBASE_H
+
+#include "kritapigment_export.h"
+
+/**
+ * The inner loop of the nearest color search of KoPaletteMap. The
+ * candidate colors are stored as three separate arrays of coordinates,
+ * so the distances to several of them are calculated at once.
+ */
+class KRITAPIGMENT_EXPORT KoPaletteMapKernelBase
+{
+public:
+    virtual ~KoPaletteMapKernelBase();
+
+    /**
+     * Writes the squared distances from the point (\p x0, \p x1, \p x2)
+     * to \p numColors colors with the coordinates \p c0, \p c1 and \p c2
+     * into \p distances.
+     */
+    virtual void squaredDistances(const float *c0, const float *c1, const float *c2,
+                                  int numColors,
+                                  float x0, float x1, float x2,
+                                  float *distances) const = 0;
+};
+
+#endif // KOPALETTEMAPKERNELBASE_H
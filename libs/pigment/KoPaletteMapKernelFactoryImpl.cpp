@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoPaletteMapKernelFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoPaletteMapKernel.h"
+
+template<typename _impl>
+KoPaletteMapKernelBase *KoPaletteMapKernelFactoryImpl::create()
+{
+    return new KoPaletteMapKernel<_impl>();
+}
+
+template KoPaletteMapKernelBase *KoPaletteMapKernelFactoryImpl::create<xsimd::current_arch>();
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
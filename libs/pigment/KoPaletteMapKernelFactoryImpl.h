@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOPALETTEMAPKERNELFACTORYIMPL_H
+#define KOPALETTEMAPKERNELFACTORYIMPL_H
+
+#include <KoMultiArchBuildSupport.h>
+#include "kritapigment_export.h"
+
+class KoPaletteMapKernelBase;
+
+class KRITAPIGMENT_EXPORT KoPaletteMapKernelFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoPaletteMapKernelBase *create();
+};
+
+#endif // KOPALETTEMAPKERNELFACTORYIMPL_H
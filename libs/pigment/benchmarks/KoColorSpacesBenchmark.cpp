@@ -9,6 +9,7 @@
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoMixColorsOp.h>
 
 #define NB_PIXELS 1000000
 
@@ -134,4 +135,64 @@ void KoColorSpacesBenchmark::benchmarkSetAlpha2IndividualCall()
     END_BENCHMARK
 }
 
+void KoColorSpacesBenchmark::benchmarkMixColors_data()
+{
+    createRowsColumns();
+}
+
+void KoColorSpacesBenchmark::benchmarkMixColors()
+{
+    START_BENCHMARK
+    QVector<quint8> result(pixelSize);
+    const KoMixColorsOp *op = colorSpace->mixColorsOp();
+    QBENCHMARK {
+        op->mixColors(data, NB_PIXELS, result.data());
+    }
+    END_BENCHMARK
+}
+
+void KoColorSpacesBenchmark::benchmarkMixColorsWeighted_data()
+{
+    createRowsColumns();
+}
+
+void KoColorSpacesBenchmark::benchmarkMixColorsWeighted()
+{
+    START_BENCHMARK
+    QVector<quint8> result(pixelSize);
+    QVector<qint16> weights(NB_PIXELS);
+    for (int i = 0; i < NB_PIXELS; ++i) {
+        weights[i] = i % 256;
+    }
+    const KoMixColorsOp *op = colorSpace->mixColorsOp();
+    QBENCHMARK {
+        op->mixColors(data, weights.constData(), NB_PIXELS, result.data(), 255);
+    }
+    END_BENCHMARK
+}
+
+void KoColorSpacesBenchmark::benchmarkMixerAccumulate_data()
+{
+    createRowsColumns();
+}
+
+void KoColorSpacesBenchmark::benchmarkMixerAccumulate()
+{
+    START_BENCHMARK
+    // emulate color smudge sampling: many small rows of a dab
+    const int rowLength = 64;
+    QVector<quint8> result(pixelSize);
+    QVector<qint16> weights(rowLength, 255);
+    QScopedPointer<KoMixColorsOp::Mixer> mixer(colorSpace->mixColorsOp()->createMixer());
+    QBENCHMARK {
+        quint8* data_it = data;
+        for (int i = 0; i < NB_PIXELS / rowLength; ++i) {
+            mixer->accumulate(data_it, weights.constData(), 255, rowLength);
+            data_it += rowLength * pixelSize;
+        }
+        mixer->computeMixedColor(result.data());
+    }
+    END_BENCHMARK
+}
+
 SIMPLE_TEST_MAIN(KoColorSpacesBenchmark)
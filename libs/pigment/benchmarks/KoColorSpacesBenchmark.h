@@ -27,6 +27,12 @@ private Q_SLOTS:
     void benchmarkSetAlphaIndividualCall();
     void benchmarkSetAlpha2IndividualCall_data();
     void benchmarkSetAlpha2IndividualCall();
+    void benchmarkMixColors_data();
+    void benchmarkMixColors();
+    void benchmarkMixColorsWeighted_data();
+    void benchmarkMixColorsWeighted();
+    void benchmarkMixerAccumulate_data();
+    void benchmarkMixerAccumulate();
 };
 
 #endif
@@ -9,72 +9,84 @@
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard32(const KoColorSpace *cs)
 {
-    return createOptimizedClass<
+    return createCalibratedClass<
         KoOptimizedCompositeOpFactoryPerArch<
-            KoOptimizedCompositeOpAlphaDarkenHard32>>(cs);
+            KoOptimizedCompositeOpAlphaDarkenHard32>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamy32(const KoColorSpace *cs)
 {
-    return createOptimizedClass<
+    return createCalibratedClass<
         KoOptimizedCompositeOpFactoryPerArch<
-            KoOptimizedCompositeOpAlphaDarkenCreamy32>>(cs);
+            KoOptimizedCompositeOpAlphaDarkenCreamy32>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp32(const KoColorSpace *cs)
 {
-    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32> >(cs);
+    return createCalibratedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOp32(const KoColorSpace *cs)
 {
-    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopy32> >(cs);
+    return createCalibratedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopy32>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard128(const KoColorSpace *cs)
 {
-    return createOptimizedClass<
+    return createCalibratedClass<
         KoOptimizedCompositeOpFactoryPerArch<
-            KoOptimizedCompositeOpAlphaDarkenHard128>>(cs);
+            KoOptimizedCompositeOpAlphaDarkenHard128>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamy128(const KoColorSpace *cs)
 {
-    return createOptimizedClass<
+    return createCalibratedClass<
         KoOptimizedCompositeOpFactoryPerArch<
-            KoOptimizedCompositeOpAlphaDarkenCreamy128>>(cs);
+            KoOptimizedCompositeOpAlphaDarkenCreamy128>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp128(const KoColorSpace *cs)
 {
-    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128> >(cs);
+    return createCalibratedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOp128(const KoColorSpace *cs)
 {
-    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopy128> >(cs);
+    return createCalibratedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopy128>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHardU64(const KoColorSpace *cs)
 {
-    return createOptimizedClass<
+    return createCalibratedClass<
         KoOptimizedCompositeOpFactoryPerArch<
-            KoOptimizedCompositeOpAlphaDarkenHardU64>>(cs);
+            KoOptimizedCompositeOpAlphaDarkenHardU64>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyU64(const KoColorSpace *cs)
 {
-    return createOptimizedClass<
+    return createCalibratedClass<
         KoOptimizedCompositeOpFactoryPerArch<
-            KoOptimizedCompositeOpAlphaDarkenCreamyU64>>(cs);
+            KoOptimizedCompositeOpAlphaDarkenCreamyU64>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOpU64(const KoColorSpace *cs)
 {
-    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverU64> >(cs);
+    return createCalibratedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverU64>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
 
 KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOpU64(const KoColorSpace *cs)
 {
-    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyU64> >(cs);
+    return createCalibratedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyU64>>(
+        KisSupportedArchitectures::CompositeKernels, cs);
 }
@@ -0,0 +1,244 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <type_traits>
+
+#include <KoColorSpaceMaths.h>
+#include <KoID.h>
+#include <KoMultiArchBuildSupport.h>
+
+#include "KisDitherOp.h"
+#include "KisDitherMaths.h"
+
+/**
+ * Scalar row kernel of the dither op. All the channels of the pixel,
+ * including alpha, are processed in exactly the same way (the same way
+ * KisDitherOpImpl does), so the row is handled as a flat array of
+ * channel values. \p factors is expected to have a dither factor
+ * for every channel value of the row, repeated with period
+ * \p factorsPeriod.
+ */
+template<typename srcChannelsType, typename dstChannelsType, typename _impl, typename EnableDummyType = void>
+struct KisDitherRowKernel
+{
+    static void ditherRow(const srcChannelsType *src, dstChannelsType *dst, int numValues,
+                          const float *factors, int factorsPeriod, float scale)
+    {
+        int factorIndex = 0;
+
+        for (int i = 0; i < numValues; i++) {
+            float c = KoColorSpaceMaths<srcChannelsType, float>::scaleToA(src[i]);
+            c = KisDitherMaths::apply_dither(c, factors[factorIndex], scale);
+            dst[i] = KoColorSpaceMaths<float, dstChannelsType>::scaleToA(c);
+
+            if (++factorIndex >= factorsPeriod) {
+                factorIndex = 0;
+            }
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+template<typename srcChannelsType, typename dstChannelsType, typename _impl>
+struct KisDitherRowKernel<srcChannelsType, dstChannelsType, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+    static ALWAYS_INLINE float_v loadNormalized(const srcChannelsType *src)
+    {
+        if constexpr (std::is_same<srcChannelsType, float>::value) {
+            return float_v::load_unaligned(src);
+        } else {
+            // exactly the same division as in KoIntegerToFloat,
+            // so the result matches KoLuts bit-to-bit
+            return xsimd::batch_cast<float>(xsimd::load_and_extend<int_v>(src)) /
+                float_v(float(KoColorSpaceMathsTraits<srcChannelsType>::max));
+        }
+    }
+
+    static ALWAYS_INLINE void storeDenormalized(const float_v &value, dstChannelsType *dst)
+    {
+        static_assert(std::is_integral<dstChannelsType>::value,
+                      "KisDitherRowKernel supports only integer destination");
+
+        const float unit = float(KoColorSpaceMathsTraits<dstChannelsType>::max);
+
+        // the same rounding as in float2int(): the value is clamped,
+        // so the truncation of (v + 0.5) is correct
+        const float_v v = xsimd::clip(value * float_v(unit), float_v(0.0f), float_v(unit));
+        const int_v result = xsimd::batch_cast<int>(v + float_v(0.5f));
+
+        alignas(_impl::alignment()) std::array<int, int_v::size> buf;
+        result.store_aligned(buf.data());
+
+        for (size_t i = 0; i < int_v::size; i++) {
+            dst[i] = static_cast<dstChannelsType>(buf[i]);
+        }
+    }
+
+    static void ditherRow(const srcChannelsType *src, dstChannelsType *dst, int numValues,
+                          const float *factors, int factorsPeriod, float scale)
+    {
+        const float_v s(scale);
+
+        int factorIndex = 0;
+        int i = 0;
+
+        for (; i + vectorSize <= numValues; i += vectorSize) {
+            const float_v f = float_v::load_unaligned(factors + factorIndex);
+            const float_v c = loadNormalized(src + i);
+
+            storeDenormalized(c + (f - c) * s, dst + i);
+
+            factorIndex += vectorSize;
+            if (factorIndex >= factorsPeriod) {
+                factorIndex -= factorsPeriod;
+            }
+        }
+
+        for (; i < numValues; i++) {
+            float c = KoColorSpaceMaths<srcChannelsType, float>::scaleToA(src[i]);
+            c = KisDitherMaths::apply_dither(c, factors[factorIndex], scale);
+            dst[i] = KoColorSpaceMaths<float, dstChannelsType>::scaleToA(c);
+
+            if (++factorIndex >= factorsPeriod) {
+                factorIndex = 0;
+            }
+        }
+    }
+};
+
+#endif /* defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) */
+
+/**
+ * A per-arch implementation of the ordered dithering (Bayer and blue
+ * noise) into integer color depths. The result is the same as the one
+ * of KisDitherOpImpl, but the dither factors are precomputed once per
+ * row and the conversion is vectorized.
+ *
+ * The op does not depend on the color model, only on the channel types
+ * and the number of channels.
+ */
+template<typename srcChannelsType, typename dstChannelsType, DitherType dType, typename _impl>
+class KisOptimizedDitherOp : public KisDitherOp
+{
+    static_assert(dType == DITHER_BAYER || dType == DITHER_BLUE_NOISE,
+                  "KisOptimizedDitherOp supports only ordered dithering");
+
+    using Kernel = KisDitherRowKernel<srcChannelsType, dstChannelsType, _impl>;
+
+    /**
+     * Both, 8x8 Bayer and 64x64 blue noise patterns, are periodic
+     * with the period of 64 pixels
+     */
+    static constexpr int patternPeriod = 64;
+
+    /**
+     * The kernel reads the factors with vector loads, so the buffer
+     * should have some extra space for the loads that start at the
+     * end of the period
+     */
+    static constexpr int patternPadding = 64;
+
+public:
+    KisOptimizedDitherOp(const KoID &srcId, const KoID &dstId, int channelsNb)
+        : m_srcDepthId(srcId)
+        , m_dstDepthId(dstId)
+        , m_channelsNb(channelsNb)
+    {
+    }
+
+    void dither(const quint8 *src, quint8 *dst, int x, int y) const override
+    {
+        const srcChannelsType *nativeSrc = reinterpret_cast<const srcChannelsType *>(src);
+        dstChannelsType *nativeDst = reinterpret_cast<dstChannelsType *>(dst);
+
+        const float f = factor(x, y);
+
+        for (int i = 0; i < m_channelsNb; i++) {
+            float c = KoColorSpaceMaths<srcChannelsType, float>::scaleToA(nativeSrc[i]);
+            c = KisDitherMaths::apply_dither(c, f, scale());
+            nativeDst[i] = KoColorSpaceMaths<float, dstChannelsType>::scaleToA(c);
+        }
+    }
+
+    void dither(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int x, int y, int columns, int rows) const override
+    {
+        std::array<float, patternPeriod * MaxChannels + patternPadding> factors;
+
+        const int factorsPeriod = patternPeriod * m_channelsNb;
+        const int numValues = columns * m_channelsNb;
+        const int numFactors = qMin(numValues, factorsPeriod) + patternPadding;
+
+        for (int row = 0; row < rows; row++) {
+            fillFactors(factors.data(), numFactors, x, y + row);
+
+            Kernel::ditherRow(reinterpret_cast<const srcChannelsType *>(srcRowStart),
+                              reinterpret_cast<dstChannelsType *>(dstRowStart),
+                              numValues, factors.data(), factorsPeriod, scale());
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+
+    KoID sourceDepthId() const override
+    {
+        return m_srcDepthId;
+    }
+
+    KoID destinationDepthId() const override
+    {
+        return m_dstDepthId;
+    }
+
+    DitherType type() const override
+    {
+        return dType;
+    }
+
+private:
+    static constexpr int MaxChannels = 5;
+
+    static constexpr float scale()
+    {
+        return 1.f / static_cast<float>(1 << KoColorSpaceMathsTraits<dstChannelsType>::bits);
+    }
+
+    static inline float factor(int x, int y)
+    {
+        if constexpr (dType == DITHER_BAYER) {
+            return KisDitherMaths::dither_factor_bayer_8(x, y);
+        } else {
+            return KisDitherMaths::dither_factor_blue_noise_64(x, y);
+        }
+    }
+
+    void fillFactors(float *factors, int size, int x, int y) const
+    {
+        for (int i = 0, pixel = 0; i < size; pixel++) {
+            const float f = factor(x + pixel, y);
+
+            for (int ch = 0; ch < m_channelsNb && i < size; ch++, i++) {
+                factors[i] = f;
+            }
+        }
+    }
+
+private:
+    const KoID m_srcDepthId, m_dstDepthId;
+    const int m_channelsNb;
+};
@@ -0,0 +1,62 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOptimizedDitherOpFactory.h"
+
+#include <KoColorModelStandardIds.h>
+
+#include "KisOptimizedDitherOpFactoryImpl.h"
+
+namespace {
+
+template<typename srcChannelsType, typename dstChannelsType>
+KisDitherOp *createForType(const KoID &srcDepthId, const KoID &dstDepthId, int channelsNb, DitherType type)
+{
+    if (type == DITHER_BAYER) {
+        return createCalibratedClass<
+            KisOptimizedDitherOpFactoryImpl<srcChannelsType, dstChannelsType, DITHER_BAYER>>(
+                KisSupportedArchitectures::ConversionKernels, srcDepthId, dstDepthId, channelsNb);
+    } else if (type == DITHER_BLUE_NOISE) {
+        return createCalibratedClass<
+            KisOptimizedDitherOpFactoryImpl<srcChannelsType, dstChannelsType, DITHER_BLUE_NOISE>>(
+                KisSupportedArchitectures::ConversionKernels, srcDepthId, dstDepthId, channelsNb);
+    }
+
+    return nullptr;
+}
+
+template<typename srcChannelsType>
+KisDitherOp *createForSourceType(const KoID &srcDepthId, const KoID &dstDepthId, int channelsNb, DitherType type)
+{
+    if (dstDepthId == Integer8BitsColorDepthID) {
+        return createForType<srcChannelsType, quint8>(srcDepthId, dstDepthId, channelsNb, type);
+    } else if (dstDepthId == Integer16BitsColorDepthID) {
+        return createForType<srcChannelsType, quint16>(srcDepthId, dstDepthId, channelsNb, type);
+    }
+
+    return nullptr;
+}
+
+}
+
+KisDitherOp *KisOptimizedDitherOpFactory::create(const KoID &srcDepthId, const KoID &dstDepthId, int channelsNb, DitherType type)
+{
+    if (channelsNb < 1 || channelsNb > 5) {
+        return nullptr;
+    }
+
+    if (srcDepthId == Integer8BitsColorDepthID) {
+        return createForSourceType<quint8>(srcDepthId, dstDepthId, channelsNb, type);
+    } else if (srcDepthId == Integer16BitsColorDepthID) {
+        return createForSourceType<quint16>(srcDepthId, dstDepthId, channelsNb, type);
+    } else if (srcDepthId == Float32BitsColorDepthID) {
+        return createForSourceType<float>(srcDepthId, dstDepthId, channelsNb, type);
+    }
+
+    return nullptr;
+}
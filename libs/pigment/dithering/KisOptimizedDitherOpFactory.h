@@ -0,0 +1,29 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "kritapigment_export.h"
+
+#include "KisDitherOp.h"
+
+class KoID;
+
+/**
+ * Creates a per-arch optimized ordered dither op for the given channel
+ * depths. The optimized ops exist only for 8-bit, 16-bit integer and
+ * 32-bit float sources with integer destinations.
+ *
+ * \return the optimized op or nullptr if the combination is not supported,
+ *         in which case the caller should use KisDitherOpImpl
+ */
+class KRITAPIGMENT_EXPORT KisOptimizedDitherOpFactory
+{
+public:
+    static KisDitherOp *create(const KoID &srcDepthId, const KoID &dstDepthId, int channelsNb, DitherType type);
+};
@@ -0,0 +1,38 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOptimizedDitherOpFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisOptimizedDitherOp.h"
+
+template<typename srcChannelsType, typename dstChannelsType, DitherType dType>
+template<typename _impl>
+KisDitherOp *
+KisOptimizedDitherOpFactoryImpl<srcChannelsType, dstChannelsType, dType>::create(
+    const KoID &srcDepthId, const KoID &dstDepthId, int channelsNb)
+{
+    return new KisOptimizedDitherOp<srcChannelsType, dstChannelsType, dType, _impl>(
+        srcDepthId, dstDepthId, channelsNb);
+}
+
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<quint8,  quint8,  DITHER_BAYER>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<quint8,  quint16, DITHER_BAYER>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<quint16, quint8,  DITHER_BAYER>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<quint16, quint16, DITHER_BAYER>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<float,   quint8,  DITHER_BAYER>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<float,   quint16, DITHER_BAYER>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<quint8,  quint8,  DITHER_BLUE_NOISE>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<quint8,  quint16, DITHER_BLUE_NOISE>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<quint16, quint8,  DITHER_BLUE_NOISE>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<quint16, quint16, DITHER_BLUE_NOISE>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<float,   quint8,  DITHER_BLUE_NOISE>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+template KisDitherOp *KisOptimizedDitherOpFactoryImpl<float,   quint16, DITHER_BLUE_NOISE>::create<xsimd::current_arch>(const KoID &, const KoID &, int);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,22 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <KoMultiArchBuildSupport.h>
+
+#include "kritapigment_export.h"
+#include "KisDitherOp.h"
+
+template<typename srcChannelsType, typename dstChannelsType, DitherType dType>
+class KRITAPIGMENT_EXPORT KisOptimizedDitherOpFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisDitherOp *create(const KoID &srcDepthId, const KoID &dstDepthId, int channelsNb);
+};
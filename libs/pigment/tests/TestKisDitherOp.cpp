@@ -0,0 +1,131 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKisDitherOp.h"
+
+#include <QRandomGenerator>
+
+#include <simpletest.h>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceTraits.h>
+#include <KisDitherOpImpl.h>
+#include <dithering/KisOptimizedDitherOpFactory.h>
+
+namespace {
+
+template<typename srcChannelsType, typename dstChannelsType, DitherType dType>
+void testDitherOpImpl(const KoID &srcDepth, const KoID &dstDepth)
+{
+    using SrcTraits = KoColorSpaceTrait<srcChannelsType, 4, 3>;
+    using DstTraits = KoColorSpaceTrait<dstChannelsType, 4, 3>;
+
+    QScopedPointer<KisDitherOp> optimizedOp(KisOptimizedDitherOpFactory::create(srcDepth, dstDepth, 4, dType));
+    QVERIFY(!optimizedOp.isNull());
+
+    KisDitherOpImpl<SrcTraits, DstTraits, dType> scalarOp(srcDepth, dstDepth);
+
+    // the size of the rect is not aligned to the vector size and the
+    // offset is not aligned to the period of the dither pattern
+    const int columns = 133;
+    const int rows = 7;
+    const int x = 13;
+    const int y = 29;
+
+    QRandomGenerator rnd(42);
+
+    QVector<srcChannelsType> src(columns * rows * SrcTraits::channels_nb);
+    for (int i = 0; i < src.size(); i++) {
+        if (std::is_integral<srcChannelsType>::value) {
+            src[i] = rnd.bounded(int(KoColorSpaceMathsTraits<srcChannelsType>::unitValue) + 1);
+        } else {
+            src[i] = rnd.generateDouble() * 1.2 - 0.1;
+        }
+    }
+
+    QVector<dstChannelsType> expected(columns * rows * DstTraits::channels_nb);
+    QVector<dstChannelsType> result(columns * rows * DstTraits::channels_nb);
+
+    const int srcRowStride = columns * SrcTraits::pixelSize;
+    const int dstRowStride = columns * DstTraits::pixelSize;
+
+    scalarOp.dither(reinterpret_cast<const quint8*>(src.constData()), srcRowStride,
+                    reinterpret_cast<quint8*>(expected.data()), dstRowStride,
+                    x, y, columns, rows);
+
+    optimizedOp->dither(reinterpret_cast<const quint8*>(src.constData()), srcRowStride,
+                        reinterpret_cast<quint8*>(result.data()), dstRowStride,
+                        x, y, columns, rows);
+
+    QCOMPARE(result, expected);
+
+    // single pixel version
+    optimizedOp->dither(reinterpret_cast<const quint8*>(src.constData()),
+                        reinterpret_cast<quint8*>(result.data()), x, y);
+
+    QCOMPARE(result[0], expected[0]);
+    QCOMPARE(result[3], expected[3]);
+}
+
+template<DitherType dType>
+void testDitherOpForType(const KoID &srcDepth, const KoID &dstDepth)
+{
+    if (srcDepth == Integer8BitsColorDepthID) {
+        if (dstDepth == Integer8BitsColorDepthID) {
+            testDitherOpImpl<quint8, quint8, dType>(srcDepth, dstDepth);
+        } else {
+            testDitherOpImpl<quint8, quint16, dType>(srcDepth, dstDepth);
+        }
+    } else if (srcDepth == Integer16BitsColorDepthID) {
+        if (dstDepth == Integer8BitsColorDepthID) {
+            testDitherOpImpl<quint16, quint8, dType>(srcDepth, dstDepth);
+        } else {
+            testDitherOpImpl<quint16, quint16, dType>(srcDepth, dstDepth);
+        }
+    } else {
+        if (dstDepth == Integer8BitsColorDepthID) {
+            testDitherOpImpl<float, quint8, dType>(srcDepth, dstDepth);
+        } else {
+            testDitherOpImpl<float, quint16, dType>(srcDepth, dstDepth);
+        }
+    }
+}
+
+}
+
+void TestKisDitherOp::testOptimizedDitherOp_data()
+{
+    QTest::addColumn<KoID>("srcDepth");
+    QTest::addColumn<KoID>("dstDepth");
+    QTest::addColumn<int>("ditherType");
+
+    const QList<KoID> srcDepths = {Integer8BitsColorDepthID, Integer16BitsColorDepthID, Float32BitsColorDepthID};
+    const QList<KoID> dstDepths = {Integer8BitsColorDepthID, Integer16BitsColorDepthID};
+
+    Q_FOREACH (const KoID &srcDepth, srcDepths) {
+        Q_FOREACH (const KoID &dstDepth, dstDepths) {
+            QTest::addRow("%s-%s-bayer", srcDepth.id().toLatin1().data(), dstDepth.id().toLatin1().data())
+                << srcDepth << dstDepth << int(DITHER_BAYER);
+            QTest::addRow("%s-%s-blue-noise", srcDepth.id().toLatin1().data(), dstDepth.id().toLatin1().data())
+                << srcDepth << dstDepth << int(DITHER_BLUE_NOISE);
+        }
+    }
+}
+
+void TestKisDitherOp::testOptimizedDitherOp()
+{
+    QFETCH(KoID, srcDepth);
+    QFETCH(KoID, dstDepth);
+    QFETCH(int, ditherType);
+
+    if (ditherType == DITHER_BAYER) {
+        testDitherOpForType<DITHER_BAYER>(srcDepth, dstDepth);
+    } else {
+        testDitherOpForType<DITHER_BLUE_NOISE>(srcDepth, dstDepth);
+    }
+}
+
+SIMPLE_TEST_MAIN(TestKisDitherOp)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TEST_KIS_DITHER_OP_H
+#define TEST_KIS_DITHER_OP_H
+
+#include <QObject>
+
+class TestKisDitherOp : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testOptimizedDitherOp_data();
+    void testOptimizedDitherOp();
+};
+
+#endif // TEST_KIS_DITHER_OP_H
@@ -6,8 +6,10 @@
 
 #include "KoColorSpaceAbstract.h"
 #include "KoColorSpaceTraits.h"
+#include "KoOptimizedMixColorsOpFactory.h"
 
 #include <cfloat>
+#include <QRandomGenerator>
 
 #include <simpletest.h>
 
@@ -420,6 +422,116 @@ QBitArray makeChannelFlags(std::initializer_list<bool> flags)
     return result;
 }
 
+template <typename channels_type, int channels_nb, int alpha_pos>
+void testOptimizedMixColorsOpImpl(const KoID &depthId)
+{
+    using Trait = KoColorSpaceTrait<channels_type, channels_nb, alpha_pos>;
+
+    QScopedPointer<KoMixColorsOp> optimizedOp(KoOptimizedMixColorsOpFactory::create(depthId, channels_nb, alpha_pos));
+    QVERIFY(!optimizedOp.isNull());
+
+    KoMixColorsOpImpl<Trait> scalarOp;
+
+    // an odd number of pixels to cover both, vectorized and scalar, code paths
+    const int numPixels = 1031;
+
+    QRandomGenerator rnd(42);
+
+    QVector<channels_type> pixels(numPixels * channels_nb);
+    QVector<qint16> weights(numPixels);
+
+    for (int i = 0; i < pixels.size(); i++) {
+        if (std::is_integral<channels_type>::value) {
+            pixels[i] = rnd.bounded(int(KoColorSpaceMathsTraits<channels_type>::unitValue) + 1);
+        } else {
+            pixels[i] = rnd.generateDouble();
+        }
+    }
+
+    for (int i = 0; i < weights.size(); i++) {
+        weights[i] = rnd.bounded(256);
+    }
+
+    const quint8 *data = reinterpret_cast<const quint8*>(pixels.constData());
+
+    auto compareResults = [] (const channels_type *expected, const channels_type *result) {
+        for (int i = 0; i < channels_nb; i++) {
+            if (std::is_integral<channels_type>::value) {
+                QCOMPARE(result[i], expected[i]);
+            } else {
+                QVERIFY(qAbs(float(result[i]) - float(expected[i])) < 1e-4);
+            }
+        }
+    };
+
+    channels_type expected[channels_nb];
+    channels_type result[channels_nb];
+
+    scalarOp.mixColors(data, weights.constData(), numPixels, reinterpret_cast<quint8*>(expected), 255);
+    optimizedOp->mixColors(data, weights.constData(), numPixels, reinterpret_cast<quint8*>(result), 255);
+    compareResults(expected, result);
+
+    scalarOp.mixColors(data, numPixels, reinterpret_cast<quint8*>(expected));
+    optimizedOp->mixColors(data, numPixels, reinterpret_cast<quint8*>(result));
+    compareResults(expected, result);
+
+    QScopedPointer<KoMixColorsOp::Mixer> scalarMixer(scalarOp.createMixer());
+    QScopedPointer<KoMixColorsOp::Mixer> optimizedMixer(optimizedOp->createMixer());
+
+    const int rowLength = 37;
+    for (int start = 0; start + rowLength <= numPixels; start += rowLength) {
+        scalarMixer->accumulate(data + start * Trait::pixelSize, weights.constData() + start, 255, rowLength);
+        optimizedMixer->accumulate(data + start * Trait::pixelSize, weights.constData() + start, 255, rowLength);
+    }
+    scalarMixer->accumulateAverage(data, numPixels);
+    optimizedMixer->accumulateAverage(data, numPixels);
+
+    QCOMPARE(optimizedMixer->currentWeightsSum(), scalarMixer->currentWeightsSum());
+
+    scalarMixer->computeMixedColor(reinterpret_cast<quint8*>(expected));
+    optimizedMixer->computeMixedColor(reinterpret_cast<quint8*>(result));
+    compareResults(expected, result);
+}
+
+void TestKoColorSpaceAbstract::testOptimizedMixColorsOp_data()
+{
+    QTest::addColumn<KoID>("depthId");
+    QTest::addColumn<int>("numChannels");
+
+    QTest::newRow("rgba8") << Integer8BitsColorDepthID << 4;
+    QTest::newRow("rgba16") << Integer16BitsColorDepthID << 4;
+    QTest::newRow("rgbaf32") << Float32BitsColorDepthID << 4;
+    QTest::newRow("graya8") << Integer8BitsColorDepthID << 2;
+    QTest::newRow("graya16") << Integer16BitsColorDepthID << 2;
+    QTest::newRow("grayaf32") << Float32BitsColorDepthID << 2;
+}
+
+void TestKoColorSpaceAbstract::testOptimizedMixColorsOp()
+{
+    QFETCH(KoID, depthId);
+    QFETCH(int, numChannels);
+
+    if (depthId == Integer8BitsColorDepthID) {
+        if (numChannels == 4) {
+            testOptimizedMixColorsOpImpl<quint8, 4, 3>(depthId);
+        } else {
+            testOptimizedMixColorsOpImpl<quint8, 2, 1>(depthId);
+        }
+    } else if (depthId == Integer16BitsColorDepthID) {
+        if (numChannels == 4) {
+            testOptimizedMixColorsOpImpl<quint16, 4, 3>(depthId);
+        } else {
+            testOptimizedMixColorsOpImpl<quint16, 2, 1>(depthId);
+        }
+    } else {
+        if (numChannels == 4) {
+            testOptimizedMixColorsOpImpl<float, 4, 3>(depthId);
+        } else {
+            testOptimizedMixColorsOpImpl<float, 2, 1>(depthId);
+        }
+    }
+}
+
 void TestKoColorSpaceAbstract::testBitBltCrossColorSpaceWithChannelFlags_data()
 {
     QTest::addColumn<KoColor>("srcColor");
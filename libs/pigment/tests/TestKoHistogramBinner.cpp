@@ -0,0 +1,272 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKoHistogramBinner.h"
+
+#include <QRandomGenerator>
+
+#include <simpletest.h>
+
+#include <KoBasicHistogramProducers.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceMaths.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoHistogramBinnerBase.h>
+#include <KoHistogramBinnerFactory.h>
+
+namespace {
+
+// not aligned to the vector size to test the tail of the kernel,
+// and large enough to use the partial histograms
+const int numPixels = 4099;
+const int channelsNb = 4;
+
+template<typename channels_type>
+QVector<channels_type> generatePixels()
+{
+    QRandomGenerator rnd(42);
+    QVector<channels_type> pixels(numPixels * channelsNb);
+
+    for (int i = 0; i < pixels.size(); i++) {
+        if (std::is_same<channels_type, float>::value) {
+            // some values lie outside of the normalized range
+            pixels[i] = channels_type(rnd.generateDouble() * 1.5 - 0.25);
+        } else {
+            pixels[i] = channels_type(rnd.bounded(int(KoColorSpaceMathsTraits<channels_type>::unitValue) + 1));
+        }
+    }
+
+    // long runs of the same value
+    for (int i = 0; i < 500 * channelsNb; i++) {
+        pixels[i] = KoColorSpaceMathsTraits<channels_type>::halfValue;
+    }
+
+    return pixels;
+}
+
+template<typename channels_type>
+void testScaleToU8Impl(const KoID &depthId, int pixelStep, bool useSkipMask)
+{
+    QScopedPointer<KoHistogramBinnerBase> binner(KoHistogramBinnerFactory::create(depthId));
+    QVERIFY(!binner.isNull());
+
+    const QVector<channels_type> pixels = generatePixels<channels_type>();
+    const int numSamples = numPixels / pixelStep;
+
+    QVector<quint8> skipMask(numSamples);
+    for (int i = 0; i < numSamples; i++) {
+        skipMask[i] = (i % 3 == 1) ? 0 : 255;
+    }
+
+    std::vector<quint32> expected(channelsNb * 256, 0);
+    quint32 expectedCount = 0;
+
+    for (int i = 0; i < numSamples; i++) {
+        if (useSkipMask && !skipMask[i]) continue;
+
+        const channels_type *pixel = pixels.constData() + i * pixelStep * channelsNb;
+        for (int ch = 0; ch < channelsNb; ch++) {
+            expected[ch * 256 + KoColorSpaceMaths<channels_type, quint8>::scaleToA(pixel[ch])]++;
+        }
+        expectedCount++;
+    }
+
+    KoHistogramBinRange range;
+    range.bias = 0.5f;
+
+    std::vector<quint32> bins(channelsNb * 256, 0);
+
+    const quint32 count =
+        binner->addPixels(reinterpret_cast<const quint8*>(pixels.constData()),
+                          pixelStep * channelsNb * sizeof(channels_type),
+                          useSkipMask ? skipMask.constData() : nullptr,
+                          numSamples, channelsNb, range, bins.data(), nullptr, nullptr);
+
+    QCOMPARE(count, expectedCount);
+    QVERIFY(bins == expected);
+}
+
+template<typename channels_type>
+void testOutOfRangeImpl(const KoID &depthId)
+{
+    QScopedPointer<KoHistogramBinnerBase> binner(KoHistogramBinnerFactory::create(depthId));
+    QVERIFY(!binner.isNull());
+
+    const QVector<channels_type> pixels = generatePixels<channels_type>();
+
+    KoHistogramBinRange range;
+    range.from = 0.25f;
+    range.to = 0.75f;
+    range.factor = 255.0f / 0.5f;
+
+    std::vector<quint32> bins(channelsNb * 256, 0);
+    std::vector<quint32> outLeft(channelsNb, 0);
+    std::vector<quint32> outRight(channelsNb, 0);
+
+    const quint32 count =
+        binner->addPixels(reinterpret_cast<const quint8*>(pixels.constData()),
+                          channelsNb * sizeof(channels_type), nullptr,
+                          numPixels, channelsNb, range,
+                          bins.data(), outLeft.data(), outRight.data());
+
+    QCOMPARE(count, quint32(numPixels));
+
+    for (int ch = 0; ch < channelsNb; ch++) {
+        quint32 expectedLeft = 0;
+        quint32 expectedRight = 0;
+
+        for (int i = 0; i < numPixels; i++) {
+            const float value = KoColorSpaceMaths<channels_type, float>::scaleToA(pixels[i * channelsNb + ch]);
+            expectedLeft += value < range.from;
+            expectedRight += value > range.to;
+        }
+
+        QCOMPARE(outLeft[ch], expectedLeft);
+        QCOMPARE(outRight[ch], expectedRight);
+
+        quint32 binned = 0;
+        for (int bin = 0; bin < 256; bin++) {
+            binned += bins[ch * 256 + bin];
+        }
+
+        QCOMPARE(binned + expectedLeft + expectedRight, quint32(numPixels));
+
+        // the run of the half values falls into the middle of the view
+        QVERIFY(bins[ch * 256 + 127] + bins[ch * 256 + 128] >= 500);
+    }
+}
+
+void addDepthRows()
+{
+    QTest::addColumn<KoID>("depthId");
+
+    QTest::addRow("U8") << Integer8BitsColorDepthID;
+    QTest::addRow("U16") << Integer16BitsColorDepthID;
+    QTest::addRow("F32") << Float32BitsColorDepthID;
+}
+
+}
+
+void TestKoHistogramBinner::testScaleToU8_data()
+{
+    addDepthRows();
+}
+
+void TestKoHistogramBinner::testScaleToU8()
+{
+    QFETCH(KoID, depthId);
+
+    for (int pixelStep = 1; pixelStep <= 3; pixelStep++) {
+        for (int useSkipMask = 0; useSkipMask <= 1; useSkipMask++) {
+            if (depthId == Integer8BitsColorDepthID) {
+                testScaleToU8Impl<quint8>(depthId, pixelStep, useSkipMask);
+            } else if (depthId == Integer16BitsColorDepthID) {
+                testScaleToU8Impl<quint16>(depthId, pixelStep, useSkipMask);
+            } else {
+                testScaleToU8Impl<float>(depthId, pixelStep, useSkipMask);
+            }
+        }
+    }
+}
+
+void TestKoHistogramBinner::testOutOfRange_data()
+{
+    addDepthRows();
+}
+
+void TestKoHistogramBinner::testOutOfRange()
+{
+    QFETCH(KoID, depthId);
+
+    if (depthId == Integer8BitsColorDepthID) {
+        testOutOfRangeImpl<quint8>(depthId);
+    } else if (depthId == Integer16BitsColorDepthID) {
+        testOutOfRangeImpl<quint16>(depthId);
+    } else {
+        testOutOfRangeImpl<float>(depthId);
+    }
+}
+
+void TestKoHistogramBinner::testProducerNormalisedValues_data()
+{
+    QTest::addColumn<QString>("colorModelId");
+    QTest::addColumn<QString>("colorDepthId");
+
+    QTest::addRow("rgb-f32") << RGBAColorModelID.id() << Float32BitsColorDepthID.id();
+    QTest::addRow("cmyk-f32") << CMYKAColorModelID.id() << Float32BitsColorDepthID.id();
+    QTest::addRow("lab-f32") << LABAColorModelID.id() << Float32BitsColorDepthID.id();
+    QTest::addRow("rgb-u16") << RGBAColorModelID.id() << Integer16BitsColorDepthID.id();
+    QTest::addRow("cmyk-u16") << CMYKAColorModelID.id() << Integer16BitsColorDepthID.id();
+    QTest::addRow("lab-u16") << LABAColorModelID.id() << Integer16BitsColorDepthID.id();
+}
+
+void TestKoHistogramBinner::testProducerNormalisedValues()
+{
+    QFETCH(QString, colorModelId);
+    QFETCH(QString, colorDepthId);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace(colorModelId, colorDepthId, 0);
+    QVERIFY(cs);
+
+    QScopedPointer<KoBasicHistogramProducer> producer;
+    if (colorDepthId == Float32BitsColorDepthID.id()) {
+        producer.reset(new KoBasicF32HistogramProducer(KoID("test"), cs));
+    } else {
+        producer.reset(new KoBasicU16HistogramProducer(KoID("test"), cs));
+    }
+    producer->setSkipTransparent(false);
+
+    const int channelCount = cs->channelCount();
+    const int pixelSize = cs->pixelSize();
+
+    // the values are in the middle of the bins, so that the
+    // rounding of the storage doesn't move them into the neighbours
+    QRandomGenerator rnd(42);
+    QVector<quint8> pixels(numPixels * pixelSize);
+    QVector<float> values(channelCount);
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int ch = 0; ch < channelCount; ch++) {
+            values[ch] = (rnd.bounded(256) + 0.5f) / 256.0f;
+        }
+        cs->fromNormalisedChannelsValue(pixels.data() + i * pixelSize, values);
+    }
+
+    // the bins of the values of normalisedChannelsValue(), the
+    // same way as the producers computed them before the binner
+    std::vector<quint32> expected(channelCount * 256, 0);
+
+    for (int i = 0; i < numPixels; i++) {
+        cs->normalisedChannelsValue(pixels.constData() + i * pixelSize, values);
+        for (int ch = 0; ch < channelCount; ch++) {
+            expected[ch * 256 + int(values[ch] * 255.0f)]++;
+        }
+    }
+
+    producer->addRegionToBin(pixels.constData(), nullptr, numPixels, cs);
+
+    QCOMPARE(producer->count(), numPixels);
+
+    const QList<KoChannelInfo *> channels = cs->channels();
+
+    for (int ext = 0; ext < channelCount; ext++) {
+        const int ch = channels[ext]->pos() / channels[ext]->size();
+
+        QCOMPARE(producer->outOfViewLeft(ext), 0);
+        QCOMPARE(producer->outOfViewRight(ext), 0);
+
+        for (int bin = 0; bin < 256; bin++) {
+            if (quint32(producer->getBinAt(ext, bin)) != expected[ch * 256 + bin]) {
+                QFAIL(qPrintable(QString("channel %1, bin %2: expected %3, got %4")
+                                 .arg(ext).arg(bin)
+                                 .arg(expected[ch * 256 + bin])
+                                 .arg(producer->getBinAt(ext, bin))));
+            }
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(TestKoHistogramBinner)
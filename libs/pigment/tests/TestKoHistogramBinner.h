@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TEST_KO_HISTOGRAM_BINNER_H
+#define TEST_KO_HISTOGRAM_BINNER_H
+
+#include <QObject>
+
+class TestKoHistogramBinner : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testScaleToU8_data();
+    void testScaleToU8();
+    void testOutOfRange_data();
+    void testOutOfRange();
+    void testProducerNormalisedValues_data();
+    void testProducerNormalisedValues();
+};
+
+#endif // TEST_KO_HISTOGRAM_BINNER_H
@@ -0,0 +1,285 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKoLut3DColorTransformation.h"
+
+#include <cmath>
+
+#include <QRandomGenerator>
+
+#include <simpletest.h>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorProfile.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceMaths.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorTransformation.h>
+#include <KoLut3DApplicatorBase.h>
+#include <KoLut3DApplicatorFactory.h>
+#include <KoLut3DColorTransformation.h>
+
+namespace {
+
+/**
+ * A transformation between two RGBA-like pixel layouts. When \p smooth
+ * is false, it just converts the depth of the pixels, otherwise it
+ * applies a smooth non-linear function that mixes the channels.
+ */
+template<typename src_channels_type, typename dst_channels_type>
+class TestTransformation : public KoColorTransformation
+{
+public:
+    TestTransformation(bool smooth) : m_smooth(smooth) {}
+
+    void transform(const quint8 *srcU8, quint8 *dstU8, qint32 nPixels) const override
+    {
+        const src_channels_type *src = reinterpret_cast<const src_channels_type*>(srcU8);
+        dst_channels_type *dst = reinterpret_cast<dst_channels_type*>(dstU8);
+
+        for (int i = 0; i < nPixels; i++) {
+            const float r = KoColorSpaceMaths<src_channels_type, float>::scaleToA(src[0]);
+            const float g = KoColorSpaceMaths<src_channels_type, float>::scaleToA(src[1]);
+            const float b = KoColorSpaceMaths<src_channels_type, float>::scaleToA(src[2]);
+
+            float values[3] = {r, g, b};
+
+            if (m_smooth) {
+                values[0] = 0.7f * r + 0.3f * r * g;
+                values[1] = g * g;
+                values[2] = 0.5f * (b + r * r);
+            }
+
+            for (int ch = 0; ch < 3; ch++) {
+                dst[ch] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(values[ch]);
+            }
+            dst[3] = KoColorSpaceMaths<src_channels_type, dst_channels_type>::scaleToA(src[3]);
+
+            src += 4;
+            dst += 4;
+        }
+    }
+
+private:
+    bool m_smooth;
+};
+
+/**
+ * Encodes linear 16-bit data with a gamma 2.2 curve into 8-bit, the
+ * same way a conversion from a linear profile into sRGB does
+ */
+class EncodingTransformation : public KoColorTransformation
+{
+public:
+    void transform(const quint8 *srcU8, quint8 *dst, qint32 nPixels) const override
+    {
+        const quint16 *src = reinterpret_cast<const quint16*>(srcU8);
+
+        for (int i = 0; i < nPixels; i++) {
+            for (int ch = 0; ch < 3; ch++) {
+                const float value = KoColorSpaceMaths<quint16, float>::scaleToA(src[ch]);
+                dst[ch] = KoColorSpaceMaths<float, quint8>::scaleToA(std::pow(value, 1.0f / 2.2f));
+            }
+            dst[3] = KoColorSpaceMaths<quint16, quint8>::scaleToA(src[3]);
+
+            src += 4;
+            dst += 4;
+        }
+    }
+};
+
+template<typename src_channels_type, typename dst_channels_type>
+void testLutImpl(const KoID &srcDepth, const KoID &dstDepth, bool smooth)
+{
+    // not aligned to the vector size to test the tail of the kernel
+    const int numPixels = 1001;
+
+    TestTransformation<src_channels_type, dst_channels_type> transformation(smooth);
+
+    KoLut3DSP lut = KoLut3DColorTransformation::bakeLut(&transformation, srcDepth, dstDepth);
+    QVERIFY(lut);
+    QCOMPARE(lut->gridSize, int(KoLut3DColorTransformation::DefaultGridSize));
+
+    QScopedPointer<KoLut3DApplicatorBase> applicator(KoLut3DApplicatorFactory::create(srcDepth, dstDepth));
+    QVERIFY(!applicator.isNull());
+
+    QRandomGenerator rnd(42);
+
+    QVector<src_channels_type> src(numPixels * 4);
+    for (int i = 0; i < src.size(); i++) {
+        src[i] = rnd.bounded(int(KoColorSpaceMathsTraits<src_channels_type>::unitValue) + 1);
+    }
+
+    // the corners of the cube are the boundary cases of the interpolation
+    for (int i = 0; i < 8; i++) {
+        src[i * 4 + 0] = i & 0x1 ? KoColorSpaceMathsTraits<src_channels_type>::unitValue : 0;
+        src[i * 4 + 1] = i & 0x2 ? KoColorSpaceMathsTraits<src_channels_type>::unitValue : 0;
+        src[i * 4 + 2] = i & 0x4 ? KoColorSpaceMathsTraits<src_channels_type>::unitValue : 0;
+    }
+
+    QVector<dst_channels_type> expected(numPixels * 4);
+    QVector<dst_channels_type> result(numPixels * 4);
+
+    transformation.transform(reinterpret_cast<const quint8*>(src.constData()),
+                             reinterpret_cast<quint8*>(expected.data()), numPixels);
+
+    applicator->apply(reinterpret_cast<const quint8*>(src.constData()),
+                      reinterpret_cast<quint8*>(result.data()), numPixels, *lut);
+
+    if (!smooth && std::is_integral<dst_channels_type>::value) {
+        // linear function is interpolated exactly
+        QCOMPARE(result, expected);
+        return;
+    }
+
+    // the error of the interpolation of a quadratic function is
+    // proportional to the square of the grid step, plus rounding
+    const float tolerance = (smooth ? 0.001f : 0.00001f) +
+        (std::is_integral<dst_channels_type>::value ?
+             1.0f / float(KoColorSpaceMathsTraits<dst_channels_type>::unitValue) : 0.0f);
+
+    for (int i = 0; i < result.size(); i++) {
+        const float expectedValue = KoColorSpaceMaths<dst_channels_type, float>::scaleToA(expected[i]);
+        const float resultValue = KoColorSpaceMaths<dst_channels_type, float>::scaleToA(result[i]);
+
+        if (qAbs(expectedValue - resultValue) > tolerance) {
+            qDebug() << "pixel" << i / 4 << "channel" << i % 4
+                     << "expected" << expectedValue << "result" << resultValue;
+            QFAIL("LUT result differs from the original transformation");
+        }
+    }
+}
+
+template<typename src_channels_type>
+void testLutForSource(const KoID &srcDepth, const KoID &dstDepth, bool smooth)
+{
+    if (dstDepth == Integer8BitsColorDepthID) {
+        testLutImpl<src_channels_type, quint8>(srcDepth, dstDepth, smooth);
+    } else if (dstDepth == Integer16BitsColorDepthID) {
+        testLutImpl<src_channels_type, quint16>(srcDepth, dstDepth, smooth);
+    } else {
+        testLutImpl<src_channels_type, float>(srcDepth, dstDepth, smooth);
+    }
+}
+
+void testLut(const KoID &srcDepth, const KoID &dstDepth, bool smooth)
+{
+    if (srcDepth == Integer8BitsColorDepthID) {
+        testLutForSource<quint8>(srcDepth, dstDepth, smooth);
+    } else {
+        testLutForSource<quint16>(srcDepth, dstDepth, smooth);
+    }
+}
+
+void addDepthRows()
+{
+    QTest::addColumn<KoID>("srcDepth");
+    QTest::addColumn<KoID>("dstDepth");
+
+    const QList<KoID> srcDepths = {Integer8BitsColorDepthID, Integer16BitsColorDepthID};
+    const QList<KoID> dstDepths = {Integer8BitsColorDepthID, Integer16BitsColorDepthID, Float32BitsColorDepthID};
+
+    Q_FOREACH (const KoID &srcDepth, srcDepths) {
+        Q_FOREACH (const KoID &dstDepth, dstDepths) {
+            QTest::addRow("%s-%s", srcDepth.id().toLatin1().data(), dstDepth.id().toLatin1().data())
+                << srcDepth << dstDepth;
+        }
+    }
+}
+
+}
+
+void TestKoLut3DColorTransformation::testIdentity_data()
+{
+    addDepthRows();
+}
+
+void TestKoLut3DColorTransformation::testIdentity()
+{
+    QFETCH(KoID, srcDepth);
+    QFETCH(KoID, dstDepth);
+
+    testLut(srcDepth, dstDepth, false);
+}
+
+void TestKoLut3DColorTransformation::testSmoothTransformation_data()
+{
+    addDepthRows();
+}
+
+void TestKoLut3DColorTransformation::testSmoothTransformation()
+{
+    QFETCH(KoID, srcDepth);
+    QFETCH(KoID, dstDepth);
+
+    testLut(srcDepth, dstDepth, true);
+}
+
+void TestKoLut3DColorTransformation::testLinearSourceError()
+{
+    EncodingTransformation transformation;
+
+    KoLut3DSP lut = KoLut3DColorTransformation::bakeLut(&transformation,
+                                                        Integer16BitsColorDepthID,
+                                                        Integer8BitsColorDepthID);
+    QVERIFY(lut);
+
+    QScopedPointer<KoLut3DApplicatorBase> applicator(
+        KoLut3DApplicatorFactory::create(Integer16BitsColorDepthID, Integer8BitsColorDepthID));
+    QVERIFY(!applicator.isNull());
+
+    // gray ramp over all the 16-bit values
+    const int numPixels = 65536;
+
+    QVector<quint16> src(numPixels * 4);
+    for (int i = 0; i < numPixels; i++) {
+        src[i * 4 + 0] = src[i * 4 + 1] = src[i * 4 + 2] = i;
+        src[i * 4 + 3] = KoColorSpaceMathsTraits<quint16>::unitValue;
+    }
+
+    QVector<quint8> expected(numPixels * 4);
+    QVector<quint8> result(numPixels * 4);
+
+    transformation.transform(reinterpret_cast<const quint8*>(src.constData()), expected.data(), numPixels);
+    applicator->apply(reinterpret_cast<const quint8*>(src.constData()), result.data(), numPixels, *lut);
+
+    int maxError = 0;
+    for (int i = 0; i < result.size(); i++) {
+        maxError = qMax(maxError, qAbs(int(result[i]) - int(expected[i])));
+    }
+
+    /**
+     * The first cell of the grid covers 1/51 of the linear range,
+     * which is encoded into 43 of 255 output steps, so the linear
+     * interpolation over it misses the curve by 12 steps. It is far
+     * above the rounding error of the LUT, that is why canBake()
+     * rejects linear source profiles.
+     */
+    QVERIFY(maxError >= 11);
+    QVERIFY(maxError <= 13);
+}
+
+void TestKoLut3DColorTransformation::testCanBakeLinearProfile()
+{
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QVERIFY(KoLut3DColorTransformation::canBake(KoColorSpaceRegistry::instance()->rgb16(), dstCs));
+
+    const KoColorProfile *linearProfile =
+        KoColorSpaceRegistry::instance()->profileByName("sRGB-elle-V2-g10.icc");
+
+    if (!linearProfile) {
+        QSKIP("linear sRGB profile is not available");
+    }
+
+    const KoColorSpace *linearCs = KoColorSpaceRegistry::instance()->rgb16(linearProfile);
+    QVERIFY(linearCs);
+    QVERIFY(linearCs->profile()->isLinear());
+
+    QVERIFY(!KoLut3DColorTransformation::canBake(linearCs, dstCs));
+}
+
+SIMPLE_TEST_MAIN(TestKoLut3DColorTransformation)
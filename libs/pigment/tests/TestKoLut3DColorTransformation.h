@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TEST_KO_LUT3D_COLOR_TRANSFORMATION_H
+#define TEST_KO_LUT3D_COLOR_TRANSFORMATION_H
+
+#include <QObject>
+
+class TestKoLut3DColorTransformation : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testIdentity_data();
+    void testIdentity();
+    void testSmoothTransformation_data();
+    void testSmoothTransformation();
+    void testLinearSourceError();
+    void testCanBakeLinearProfile();
+};
+
+#endif // TEST_KO_LUT3D_COLOR_TRANSFORMATION_H
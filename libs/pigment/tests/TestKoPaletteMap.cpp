@@ -0,0 +1,130 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKoPaletteMap.h"
+
+#include <cmath>
+
+#include <QRandomGenerator>
+
+#include <simpletest.h>
+
+#include <KoPaletteMap.h>
+
+namespace {
+
+KoPaletteMap::Color randomColor(QRandomGenerator &rnd)
+{
+    return {quint16(rnd.bounded(65536)), quint16(rnd.bounded(65536)), quint16(rnd.bounded(65536))};
+}
+
+float distance(const KoPaletteMap::Color &a, const KoPaletteMap::Color &b,
+               const KoPaletteMap::Weights &weights)
+{
+    float sum = 0.0f;
+    for (int ch = 0; ch < 3; ch++) {
+        const float d = weights[ch] * a[ch] - weights[ch] * b[ch];
+        sum += d * d;
+    }
+    return std::sqrt(sum);
+}
+
+}
+
+void TestKoPaletteMap::testNearest_data()
+{
+    QTest::addColumn<int>("numColors");
+    QTest::addColumn<float>("weight");
+
+    QTest::newRow("1 color") << 1 << 1.0f;
+    QTest::newRow("16 colors") << 16 << 1.0f;
+    QTest::newRow("256 colors") << 256 << 1.0f;
+    QTest::newRow("256 colors, weighted") << 256 << 3.0f;
+}
+
+void TestKoPaletteMap::testNearest()
+{
+    QFETCH(int, numColors);
+    QFETCH(float, weight);
+
+    QRandomGenerator rnd(42);
+
+    QVector<KoPaletteMap::Color> colors;
+    for (int i = 0; i < numColors; i++) {
+        colors << randomColor(rnd);
+    }
+
+    const KoPaletteMap::Weights weights = {weight, 1.0f, 1.0f};
+    KoPaletteMap map(colors, weights, 2);
+
+    QCOMPARE(map.numColors(), numColors);
+    QCOMPARE(map.numNearest(), 2);
+
+    for (int i = 0; i < 10000; i++) {
+        const KoPaletteMap::Color color = randomColor(rnd);
+
+        QVector<float> distances;
+        for (const KoPaletteMap::Color &c : colors) {
+            distances << distance(color, c, weights);
+        }
+        std::sort(distances.begin(), distances.end());
+
+        KoPaletteMap::Match matches[2];
+        const int numMatches = map.nearestMatches(color.data(), matches);
+
+        QCOMPARE(numMatches, qMin(2, numColors));
+
+        for (int m = 0; m < numMatches; m++) {
+            // compare the distances, the equally distant colors may be swapped
+            QVERIFY(std::abs(matches[m].distance - distances[m]) <= 1e-3f * distances[m] + 1e-2f);
+            QVERIFY(std::abs(distance(color, colors[matches[m].index], weights) - distances[m]) <=
+                    1e-3f * distances[m] + 1e-2f);
+        }
+
+        QCOMPARE(map.nearest(color.data()), matches[0].index);
+    }
+}
+
+void TestKoPaletteMap::testCachedMap()
+{
+    QRandomGenerator rnd(42);
+
+    QVector<KoPaletteMap::Color> colors;
+    for (int i = 0; i < 8; i++) {
+        colors << randomColor(rnd);
+    }
+
+    QSharedPointer<const KoPaletteMap> map1 = KoPaletteMap::cachedMap(colors);
+    QSharedPointer<const KoPaletteMap> map2 = KoPaletteMap::cachedMap(colors);
+    QCOMPARE(map1, map2);
+
+    QSharedPointer<const KoPaletteMap> map3 = KoPaletteMap::cachedMap(colors, {1.0f, 1.0f, 1.0f}, 2);
+    QVERIFY(map1 != map3);
+
+    colors << randomColor(rnd);
+    QSharedPointer<const KoPaletteMap> map4 = KoPaletteMap::cachedMap(colors);
+    QVERIFY(map1 != map4);
+    QCOMPARE(map4->numColors(), 9);
+}
+
+void TestKoPaletteMap::testEmptyPalette()
+{
+    KoPaletteMap map(QVector<KoPaletteMap::Color>(), {1.0f, 1.0f, 1.0f}, 2);
+
+    QCOMPARE(map.numColors(), 0);
+
+    QRandomGenerator rnd(42);
+
+    for (int i = 0; i < 100; i++) {
+        const KoPaletteMap::Color color = randomColor(rnd);
+
+        KoPaletteMap::Match matches[2];
+        QCOMPARE(map.nearestMatches(color.data(), matches), 0);
+        QCOMPARE(map.nearest(color.data()), -1);
+    }
+}
+
+SIMPLE_TEST_MAIN(TestKoPaletteMap)
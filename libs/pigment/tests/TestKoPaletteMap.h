@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TEST_KO_PALETTE_MAP_H
+#define TEST_KO_PALETTE_MAP_H
+
+#include <QObject>
+
+class TestKoPaletteMap : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testNearest_data();
+    void testNearest();
+    void testCachedMap();
+    void testEmptyPalette();
+};
+
+#endif // TEST_KO_PALETTE_MAP_H
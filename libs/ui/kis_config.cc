@@ -80,6 +80,7 @@ void KisConfig::logImportantSettings() const
     KisUsageLogger::writeSysInfo(QString("  Use OpenGL Texture Buffer: %1").arg(useOpenGLTextureBuffer() ? "true" : "false"));
     KisUsageLogger::writeSysInfo(QString("  Disable Vector Optimizations: %1").arg(disableVectorOptimizations() ? "true" : "false"));
     KisUsageLogger::writeSysInfo(QString("  Disable AVX Optimizations: %1").arg(disableAVXOptimizations() ? "true" : "false"));
+    KisUsageLogger::writeSysInfo(QString("  Enable Vector Calibration: %1").arg(enableVectorCalibration() ? "true" : "false"));
     KisUsageLogger::writeSysInfo(QString("  Canvas State: %1").arg(canvasState()));
     KisUsageLogger::writeSysInfo(QString("  Autosave Interval: %1").arg(autoSaveInterval()));
     KisUsageLogger::writeSysInfo(QString("  Use Backup Files: %1").arg(backupFile() ? "true" : "false"));
@@ -2216,6 +2217,16 @@ bool KisConfig::disableAVXOptimizations(bool defaultValue) const
     return (defaultValue ? false : m_cfg.readEntry("disableAVXOptimizations", false));
 }
 
+void KisConfig::setEnableVectorCalibration(bool value)
+{
+    m_cfg.writeEntry("enableVectorCalibration", value);
+}
+
+bool KisConfig::enableVectorCalibration(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("enableVectorCalibration", false));
+}
+
 void KisConfig::setAnimationPlaybackBackend(int value)
 {
     m_cfg.writeEntry("animationPlaybackBackend", value);
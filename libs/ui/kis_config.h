@@ -595,6 +595,9 @@ public:
     void setDisableAVXOptimizations(bool value);
     bool disableAVXOptimizations(bool defaultValue = false) const;
 
+    void setEnableVectorCalibration(bool value);
+    bool enableVectorCalibration(bool defaultValue = false) const;
+
     void setAnimationPlaybackBackend(int value);
     int animationPlaybackBackend(bool defaultValue = false) const;
 
@@ -9,6 +9,7 @@
 
 
 #include <QHash>
+#include <QTimer>
 #include <KisSignalMapper.h>
 
 #include <QMessageBox>
@@ -33,6 +34,7 @@
 // krita/ui
 #include "KisViewManager.h"
 #include "kis_canvas2.h"
+#include "kis_coordinates_converter.h"
 #include <kis_bookmarked_configuration_manager.h>
 
 #include "kis_action.h"
@@ -62,6 +64,13 @@ struct KisFilterManager::Private {
 
     bool filterAllSelectedFrames = false;
 
+    /**
+     * When the preview is rendered on the level of detail plane,
+     * it is refined to the full resolution after the user stops
+     * changing the parameters for a while
+     */
+    QTimer refinePreviewTimer;
+
     KisSignalMapper actionsMapper;
 
     /*!
@@ -75,6 +84,10 @@ KisFilterManager::KisFilterManager(KisViewManager * view)
     : d(new Private)
 {
     d->view = view;
+
+    d->refinePreviewTimer.setSingleShot(true);
+    d->refinePreviewTimer.setInterval(500);
+    connect(&d->refinePreviewTimer, SIGNAL(timeout()), SLOT(slotRefinePreview()));
 }
 
 KisFilterManager::~KisFilterManager()
@@ -266,7 +279,12 @@ void KisFilterManager::showFilterDialog(const QString &filterId, KisFilterConfig
     }
 }
 
-void KisFilterManager::apply(KisFilterConfigurationSP _filterConfig)
+void KisFilterManager::apply(KisFilterConfigurationSP filterConfig)
+{
+    startFilterStroke(filterConfig, false);
+}
+
+void KisFilterManager::startFilterStroke(KisFilterConfigurationSP _filterConfig, bool refinePreview)
 {
     KisFilterConfigurationSP filterConfig = _filterConfig->cloneWithResourcesSnapshot();
 
@@ -301,9 +319,29 @@ void KisFilterManager::apply(KisFilterConfigurationSP _filterConfig)
                                                                     KisFilterConfigurationSP(filterConfig),
                                                                     resources,
                                                                     d->externalCancelUpdatesStorage.toWeakRef());
+    bool canRefinePreview = false;
+
     {
         KConfigGroup group( KSharedConfig::openConfig(), "filterdialog");
-        strategy->setForceLodModeIfPossible(group.readEntry("forceLodMode", true));
+        const bool forceLodMode = group.readEntry("forceLodMode", true);
+
+        if (refinePreview) {
+            strategy->setFullResolutionOnly(true);
+            strategy->setPriorityRect(
+                d->view->canvasBase()->coordinatesConverter()->widgetRectInImagePixels().toAlignedRect());
+        } else {
+            strategy->setForceLodModeIfPossible(forceLodMode);
+
+            const KisLodPreferences lodPreferences = image->lodPreferences();
+            const int levelOfDetail = lodPreferences.desiredLevelOfDetail();
+
+            canRefinePreview =
+                group.readEntry("progressivePreview", true) &&
+                levelOfDetail > 0 &&
+                (forceLodMode || lodPreferences.lodPreferred()) &&
+                filter->supportsLevelOfDetail(filterConfig, levelOfDetail) &&
+                d->view->activeNode()->supportsLodPainting();
+        }
     }
 
     d->currentStrokeId =
@@ -321,12 +359,33 @@ void KisFilterManager::apply(KisFilterConfigurationSP _filterConfig)
     }
 
     d->currentlyAppliedConfiguration = filterConfig;
+
+    if (canRefinePreview) {
+        d->refinePreviewTimer.start();
+    } else {
+        d->refinePreviewTimer.stop();
+    }
+}
+
+void KisFilterManager::slotRefinePreview()
+{
+    if (!d->currentStrokeId || !d->currentlyAppliedConfiguration) return;
+
+    // let the low resolution preview be shown first
+    if (!isIdle()) {
+        d->refinePreviewTimer.start();
+        return;
+    }
+
+    startFilterStroke(d->currentlyAppliedConfiguration, true);
 }
 
 void KisFilterManager::finish()
 {
     Q_ASSERT(d->currentStrokeId);
 
+    d->refinePreviewTimer.stop();
+
     if (d->filterAllSelectedFrames) {   // Apply filter to the other selected frames...
         KisImageSP image = d->view->image();
         KisPaintDeviceSP paintDevice = d->view->activeNode()->paintDevice();
@@ -362,6 +421,8 @@ void KisFilterManager::cancelRunningStroke()
 {
     Q_ASSERT(d->currentStrokeId);
 
+    d->refinePreviewTimer.stop();
+
     // we should to notify the stroke that it should do the updates itself.
     d->externalCancelUpdatesStorage->shouldIssueCancellationUpdates.ref();
     d->view->image()->cancelStroke(d->currentStrokeId);
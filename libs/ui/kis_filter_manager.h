@@ -60,6 +60,12 @@ private Q_SLOTS:
     //! Clean up after filter dialog has been accepted / rejected / closed
     void filterDialogHasFinished(int);
 
+    //! Replace the low resolution preview with the full resolution one
+    void slotRefinePreview();
+
+private:
+    void startFilterStroke(KisFilterConfigurationSP filterConfig, bool refinePreview);
+
 private:
     struct Private;
     QScopedPointer<Private> d;
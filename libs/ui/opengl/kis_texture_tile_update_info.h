@@ -16,6 +16,7 @@
 #include "kis_texture_tile_info_pool.h"
 #include <KoChannelInfo.h>
 #include <KoColorConversionTransformation.h>
+#include <KoLut3DColorTransformation.h>
 #include <KoColorModelStandardIds.h>
 #include <KoColorSpace.h>
 #include <kis_lod_transform.h>
@@ -223,6 +224,19 @@ public:
                                                                       KoColor gamutWarning,
                                                                       double adaptationState)
     {
+        /**
+         * Soft-proofing chains two ICC transformations, so it is much
+         * cheaper to evaluate a baked 3D LUT of it
+         */
+        KoColorConversionTransformation *transform =
+            KoLut3DColorTransformation::createProofingTransform(srcCS, dstCS, proofingSpace,
+                                                                renderingIntent, proofingIntent,
+                                                                conversionFlags, gamutWarning.data(),
+                                                                adaptationState);
+        if (transform) {
+            return transform;
+        }
+
         return srcCS->createProofingTransform(dstCS, proofingSpace, renderingIntent, proofingIntent, conversionFlags, gamutWarning.data(), adaptationState);
     }
 
@@ -36,6 +36,8 @@
 #include "KisAsynchronousStrokeUpdateHelper.h"
 #include "kis_canvas_resource_provider.h"
 #include <KisOptimizedBrushOutline.h>
+#include <KisStrokeRecording.h>
+#include "kis_image_config.h"
 
 #include <math.h>
 
@@ -103,6 +105,11 @@ struct KisToolFreehandHelper::Private
     KisStabilizedEventsSampler stabilizedSampler;
     KisStabilizerDelayedPaintHelper stabilizerDelayedPaintHelper;
 
+    // the raw tablet events of the current stroke, recorded
+    // only when KisImageConfig::strokeRecordingFile() is set
+    QString strokeRecordingFile;
+    KisStrokeRecording::Stroke recordedStroke;
+
     qreal effectiveSmoothnessDistance() const;
 };
 
@@ -275,6 +282,12 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
 
     m_d->previousPaintInformation = pi;
 
+    m_d->strokeRecordingFile = KisImageConfig(true).strokeRecordingFile();
+    m_d->recordedStroke.clear();
+    if (!m_d->strokeRecordingFile.isEmpty()) {
+        m_d->recordedStroke.append(KisStrokeRecording::eventFromPaintInformation(pi));
+    }
+
     m_d->resources = new KisResourcesSnapshot(image,
                                               currentNode,
                                               resourceManager,
@@ -445,6 +458,10 @@ void KisToolFreehandHelper::paintEvent(KoPointerEvent *event)
                                              elapsedStrokeTime());
     KisUpdateTimeMonitor::instance()->reportMouseMove(info.pos());
 
+    if (!m_d->strokeRecordingFile.isEmpty()) {
+        m_d->recordedStroke.append(KisStrokeRecording::eventFromPaintInformation(info));
+    }
+
     paint(info);
 }
 
@@ -647,6 +664,11 @@ void KisToolFreehandHelper::endPaint()
     m_d->strokesFacade->endStroke(m_d->strokeId);
     m_d->strokeId.clear();
     m_d->infoBuilder->reset();
+
+    if (!m_d->strokeRecordingFile.isEmpty()) {
+        KisStrokeRecording::appendStroke(m_d->strokeRecordingFile, m_d->recordedStroke);
+        m_d->recordedStroke.clear();
+    }
 }
 
 void KisToolFreehandHelper::cancelPaint()
@@ -676,6 +698,7 @@ void KisToolFreehandHelper::cancelPaint()
 
     m_d->strokesFacade->cancelStroke(m_d->strokeId);
     m_d->strokeId.clear();
+    m_d->recordedStroke.clear();
 
 }
 
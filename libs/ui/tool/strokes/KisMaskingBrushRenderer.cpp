@@ -6,13 +6,14 @@
 
 #include "KisMaskingBrushRenderer.h"
 
+#include <cstring>
+
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorModelStandardIds.h>
 #include <KoChannelInfo.h>
 #include <KoCompositeOpRegistry.h>
 
-#include "kis_painter.h"
 #include "kis_paint_device.h"
 #include "kis_random_accessor_ng.h"
 
@@ -73,38 +74,60 @@ void KisMaskingBrushRenderer::updateProjection(const QRect &rc)
 {
     if (rc.isEmpty()) return;
 
-    KisPainter::copyAreaOptimized(rc.topLeft(), m_strokeDevice, m_dstDevice, rc);
+    /**
+     * Copying the stroke into the destination and applying the mask
+     * is done in one pass: every chunk of the destination is copied
+     * and composited with the mask while it is still hot in the
+     * cache, instead of copying the whole rect first and walking
+     * over all its tiles once again.
+     */
 
+    KisRandomConstAccessorSP strokeIt = m_strokeDevice->createRandomConstAccessorNG();
     KisRandomAccessorSP dstIt = m_dstDevice->createRandomAccessorNG();
     KisRandomConstAccessorSP maskIt = m_maskDevice->createRandomConstAccessorNG();
 
+    const int pixelSize = m_dstDevice->pixelSize();
+
     qint32 dstY = rc.y();
     qint32 rowsRemaining = rc.height();
 
     while (rowsRemaining > 0) {
         qint32 dstX = rc.x();
 
+        const qint32 numContiguousStrokeRows = strokeIt->numContiguousRows(dstY);
         const qint32 numContiguousDstRows = dstIt->numContiguousRows(dstY);
         const qint32 numContiguousMaskRows = maskIt->numContiguousRows(dstY);
 
-        const qint32 rows = std::min({rowsRemaining, numContiguousDstRows, numContiguousMaskRows});
+        const qint32 rows = std::min({rowsRemaining, numContiguousStrokeRows, numContiguousDstRows, numContiguousMaskRows});
 
         qint32 columnsRemaining = rc.width();
 
         while (columnsRemaining > 0) {
 
+            const qint32 numContiguousStrokeColumns = strokeIt->numContiguousColumns(dstX);
             const qint32 numContiguousDstColumns = dstIt->numContiguousColumns(dstX);
             const qint32 numContiguousMaskColumns = maskIt->numContiguousColumns(dstX);
-            const qint32 columns = std::min({columnsRemaining, numContiguousDstColumns, numContiguousMaskColumns});
+            const qint32 columns = std::min({columnsRemaining, numContiguousStrokeColumns, numContiguousDstColumns, numContiguousMaskColumns});
 
+            const qint32 strokeRowStride = strokeIt->rowStride(dstX, dstY);
             const qint32 dstRowStride = dstIt->rowStride(dstX, dstY);
             const qint32 maskRowStride = maskIt->rowStride(dstX, dstY);
 
+            strokeIt->moveTo(dstX, dstY);
             dstIt->moveTo(dstX, dstY);
             maskIt->moveTo(dstX, dstY);
 
+            const quint8 *strokePtr = strokeIt->rawDataConst();
+            quint8 *dstPtr = dstIt->rawData();
+
+            for (qint32 row = 0; row < rows; row++) {
+                memcpy(dstPtr + row * dstRowStride,
+                       strokePtr + row * strokeRowStride,
+                       columns * pixelSize);
+            }
+
             m_compositeOp->composite(maskIt->rawDataConst(), maskRowStride,
-                                     dstIt->rawData(), dstRowStride,
+                                     dstPtr, dstRowStride,
                                      columns, rows);
 
             dstX += columns;
@@ -115,4 +138,3 @@ void KisMaskingBrushRenderer::updateProjection(const QRect &rc)
         rowsRemaining -= rows;
     }
 }
-
@@ -6,6 +6,10 @@
 
 #include "kis_filter_stroke_strategy.h"
 
+#include <algorithm>
+
+#include <QRegion>
+
 #include <filter/kis_filter.h>
 #include <filter/kis_filter_configuration.h>
 #include <krita_utils.h>
@@ -19,6 +23,7 @@
 #include "kis_image_config.h"
 #include "kis_image_animation_interface.h"
 #include "kis_painter.h"
+#include "kis_convolution_painter.h"
 #include "KisAnimAutoKey.h"
 #include <commands_new/KisDisableDirtyRequestsCommand.h>
 
@@ -40,7 +45,8 @@ struct KisFilterStrokeStrategy::Private {
         , updatesFacade(rhs.updatesFacade)
         , levelOfDetail(0)
         , cancelledUpdates(rhs.cancelledUpdates)
-
+        , priorityRect(rhs.priorityRect)
+        , fullResolutionOnly(rhs.fullResolutionOnly)
     {
         KIS_ASSERT_RECOVER_RETURN(!rhs.levelOfDetail);
     }
@@ -57,6 +63,16 @@ struct KisFilterStrokeStrategy::Private {
     ExternalCancelUpdatesStorageSP cancelledUpdates;
     QRect nextExternalUpdateRect;
     bool hasBeenLodCloned = false;
+
+    QRect priorityRect;
+    bool fullResolutionOnly = false;
+
+    /**
+     * The filter is applied to many patches of the image with the same
+     * kernel, so the kernel spectra of the FFTW convolution are cached
+     * until the stroke ends
+     */
+    QScopedPointer<KisConvolutionPainter::KernelSpectrumCacheScope> kernelSpectrumCacheScope;
 };
 
 struct SubTaskSharedData {
@@ -111,6 +127,8 @@ public:
     QRect filterDeviceBounds;
     QSharedPointer<KisTransaction> filterDeviceTransaction;
     QRect processRect;
+    QRect priorityRect;
+    bool priorityRectShown = false;
 
 private:
     KisImageSP m_image;
@@ -168,6 +186,9 @@ KisFilterStrokeStrategy::KisFilterStrokeStrategy(const KisFilterStrokeStrategy &
     , m_d(new Private(*rhs.m_d))
 {
     m_d->levelOfDetail = levelOfDetail;
+
+    KisLodTransform t(levelOfDetail);
+    m_d->priorityRect = t.map(m_d->priorityRect);
 }
 
 KisFilterStrokeStrategy::~KisFilterStrokeStrategy()
@@ -179,6 +200,8 @@ void KisFilterStrokeStrategy::initStrokeCallback()
 {
     KisStrokeStrategyUndoCommandBased::initStrokeCallback();
 
+    m_d->kernelSpectrumCacheScope.reset(new KisConvolutionPainter::KernelSpectrumCacheScope());
+
     qSwap(m_d->nextExternalUpdateRect, m_d->cancelledUpdates->updateRect);
     KisLodTransform t(m_d->levelOfDetail);
     m_d->nextExternalUpdateRect = t.map(m_d->nextExternalUpdateRect);
@@ -251,7 +274,43 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
                 QSize size = KritaUtils::optimalPatchSize();
                 QVector<QRect> patches = KritaUtils::splitRectIntoPatches(shared->processRect, size);
 
-                Q_FOREACH (const QRect &patch, patches) {
+                /**
+                 * The patches covering the priority rect go first, then
+                 * the priority rect is shown while the rest is filtered
+                 */
+                if (shared->shouldRedraw()) {
+                    shared->priorityRect = m_d->priorityRect & shared->processRect;
+                }
+
+                auto restOfPatches = patches.begin();
+
+                if (!shared->priorityRect.isEmpty()) {
+                    restOfPatches =
+                        std::stable_partition(patches.begin(), patches.end(),
+                                              [shared] (const QRect &patch) {
+                                                  return patch.intersects(shared->priorityRect);
+                                              });
+                }
+
+                for (auto it = patches.begin(); it != patches.end(); ++it) {
+                    if (it == restOfPatches && it != patches.begin()) {
+                        addJobSequential(processJobs, [this, shared](){
+                            QScopedPointer<KisTransaction> priorityTransaction(new KisTransaction(shared->targetDevice()));
+                            KisPainter::copyAreaOptimized(shared->priorityRect.topLeft(), shared->filterDevice, shared->targetDevice(), shared->priorityRect, shared->selection());
+                            runAndSaveCommand(toQShared(priorityTransaction->endAndTake()), KisStrokeJobData::BARRIER, KisStrokeJobData::EXCLUSIVE);
+
+                            QRect extraUpdateRect;
+                            qSwap(extraUpdateRect, m_d->nextExternalUpdateRect);
+
+                            shared->node()->setDirty(shared->priorityRect | extraUpdateRect);
+                            shared->priorityRectShown = true;
+
+                            m_d->nextExternalUpdateRect = shared->priorityRect;
+                        });
+                    }
+
+                    const QRect patch = *it;
+
                     if (!patch.isEmpty()) {
                         addJobConcurrent(processJobs, [patch, shared, progress](){
                             shared->filter()->processImpl(shared->filterDevice, patch,
@@ -294,7 +353,15 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
                 QRect extraUpdateRect;
                 qSwap(extraUpdateRect, m_d->nextExternalUpdateRect);
 
-                shared->node()->setDirty(shared->processRect | extraUpdateRect);
+                QRegion dirtyRegion(shared->processRect | extraUpdateRect);
+
+                if (shared->priorityRectShown) {
+                    dirtyRegion -= shared->priorityRect;
+                }
+
+                if (!dirtyRegion.isEmpty()) {
+                    shared->node()->setDirty(QVector<QRect>(dirtyRegion.begin(), dirtyRegion.end()));
+                }
 
                /**
                 * Save the last update to be able to restore the
@@ -328,6 +395,8 @@ void KisFilterStrokeStrategy::cancelStrokeCallback()
 {
     using namespace KritaUtils;
 
+    m_d->kernelSpectrumCacheScope.reset();
+
     const bool shouldIssueCancellationUpdates = m_d->cancelledUpdates->shouldIssueCancellationUpdates;
 
     QVector<KisStrokeJobData *> jobs;
@@ -366,10 +435,12 @@ void KisFilterStrokeStrategy::cancelStrokeCallback()
 void KisFilterStrokeStrategy::finishStrokeCallback()
 {
     KisStrokeStrategyUndoCommandBased::finishStrokeCallback();
+    m_d->kernelSpectrumCacheScope.reset();
 }
 
 KisStrokeStrategy* KisFilterStrokeStrategy::createLodClone(int levelOfDetail)
 {
+    if (m_d->fullResolutionOnly) return 0;
     if (!m_d->filter->supportsLevelOfDetail(m_d->filterConfig.data(), levelOfDetail)) return 0;
     if (!m_d->node->supportsLodPainting()) return 0;
 
@@ -377,3 +448,13 @@ KisStrokeStrategy* KisFilterStrokeStrategy::createLodClone(int levelOfDetail)
     m_d->hasBeenLodCloned = true;
     return clone;
 }
+
+void KisFilterStrokeStrategy::setPriorityRect(const QRect &rect)
+{
+    m_d->priorityRect = rect;
+}
+
+void KisFilterStrokeStrategy::setFullResolutionOnly(bool value)
+{
+    m_d->fullResolutionOnly = value;
+}
@@ -97,6 +97,20 @@ public:
 
     KisStrokeStrategy* createLodClone(int levelOfDetail) override;
 
+    /**
+     * The patches of the layer intersecting \p rect (in full resolution
+     * image coordinates) are filtered and shown on the canvas before
+     * the rest of the layer. Used when a low resolution preview is
+     * refined, so that the visible part of the canvas is updated first.
+     */
+    void setPriorityRect(const QRect &rect);
+
+    /**
+     * Forbids running the stroke on the level of detail plane even
+     * when the image prefers it
+     */
+    void setFullResolutionOnly(bool value);
+
 private:
     struct Private;
     Private* const m_d;
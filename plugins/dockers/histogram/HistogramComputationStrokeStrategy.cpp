@@ -6,11 +6,56 @@
  */
 #include "HistogramComputationStrokeStrategy.h"
 
+#include <algorithm>
+#include <limits>
+
+#include <QMutexLocker>
+
 #include "KoColorSpace.h"
+#include "KoHistogramBinnerBase.h"
+#include "KoHistogramBinnerFactory.h"
 
 #include "krita_utils.h"
 #include "kis_image.h"
-#include "kis_sequential_iterator.h"
+#include "kis_paint_device.h"
+
+namespace {
+
+void initiateVector(HistVector &vec, const KoColorSpace *colorSpace)
+{
+    vec.resize(colorSpace->channelCount());
+    for (auto &bin : vec) {
+        bin.assign(std::numeric_limits<quint8>::max() + 1, 0);
+    }
+}
+
+}
+
+void HistogramCache::addDirtyRect(const QRect &rect)
+{
+    QMutexLocker l(&mutex);
+
+    for (int i = 0; i < patches.size(); i++) {
+        if (patches[i].intersects(rect)) {
+            dirtyGeneration[i]++;
+        }
+    }
+}
+
+void HistogramCache::reset()
+{
+    QMutexLocker l(&mutex);
+
+    epoch++;
+    colorSpace = 0;
+    bounds = QRect();
+    nSkip = 0;
+    patches.clear();
+    dirtyGeneration.clear();
+    computedGeneration.clear();
+    patchBins.clear();
+    total.clear();
+}
 
 struct HistogramComputationStrokeStrategy::Private
 {
@@ -29,15 +74,25 @@ struct HistogramComputationStrokeStrategy::Private
     };
 
     KisImageSP image;
+    HistogramCacheSP cache;
+
+    int epoch {0};
+    const KoColorSpace *colorSpace {0};
+    int nSkip {1};
+    QScopedPointer<KoHistogramBinnerBase> binner;
+
+    QVector<int> dirtyPatches; // indexes of the patches in the cache
+    std::vector<quint64> generations; // dirty generations of the patches at the start
     std::vector<HistVector> results;
 };
 
 
-HistogramComputationStrokeStrategy::HistogramComputationStrokeStrategy(KisImageSP image)
+HistogramComputationStrokeStrategy::HistogramComputationStrokeStrategy(KisImageSP image, HistogramCacheSP cache)
     : KisIdleTaskStrokeStrategy(QLatin1String("ComputeHistogram"), kundo2_i18n("Update histogram"))
     , m_d(new Private)
 {
     m_d->image = image;
+    m_d->cache = cache;
 }
 
 HistogramComputationStrokeStrategy::~HistogramComputationStrokeStrategy()
@@ -48,15 +103,47 @@ void HistogramComputationStrokeStrategy::initStrokeCallback()
 {
     KisIdleTaskStrokeStrategy::initStrokeCallback();
 
+    const QRect imageBounds = m_d->image->bounds();
+    const int imageSize = imageBounds.width() * imageBounds.height();
+
+    m_d->colorSpace = m_d->image->projection()->colorSpace();
+    m_d->nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
+    m_d->binner.reset(KoHistogramBinnerFactory::create(m_d->colorSpace->colorDepthId()));
+
     QVector<KisStrokeJobData*> jobsData;
-    int i = 0;
-    QVector<QRect> tileRects = KritaUtils::splitRectIntoPatches(m_d->image->bounds(), KritaUtils::optimalPatchSize());
-    m_d->results.resize(tileRects.size());
 
-    Q_FOREACH (const QRect &tileRectangle, tileRects) {
-        jobsData << new HistogramComputationStrokeStrategy::Private::ProcessData(tileRectangle, i);
-        i++;
+    {
+        HistogramCache &cache = *m_d->cache;
+        QMutexLocker l(&cache.mutex);
+
+        if (cache.colorSpace != m_d->colorSpace ||
+            cache.bounds != imageBounds ||
+            cache.nSkip != m_d->nSkip) {
+
+            cache.epoch++;
+            cache.colorSpace = m_d->colorSpace;
+            cache.bounds = imageBounds;
+            cache.nSkip = m_d->nSkip;
+            cache.patches = KritaUtils::splitRectIntoPatches(imageBounds, KritaUtils::optimalPatchSize());
+            cache.dirtyGeneration.assign(cache.patches.size(), 1);
+            cache.computedGeneration.assign(cache.patches.size(), 0);
+            cache.patchBins.clear();
+            cache.patchBins.resize(cache.patches.size());
+            initiateVector(cache.total, m_d->colorSpace);
+        }
+
+        m_d->epoch = cache.epoch;
+
+        for (int i = 0; i < cache.patches.size(); i++) {
+            if (cache.dirtyGeneration[i] != cache.computedGeneration[i]) {
+                jobsData << new HistogramComputationStrokeStrategy::Private::ProcessData(cache.patches[i], m_d->dirtyPatches.size());
+                m_d->dirtyPatches << i;
+                m_d->generations.push_back(cache.dirtyGeneration[i]);
+            }
+        }
     }
+
+    m_d->results.resize(m_d->dirtyPatches.size());
     addMutatedJobs(jobsData);
 }
 
@@ -72,37 +159,49 @@ void HistogramComputationStrokeStrategy::doStrokeCallback(KisStrokeJobData *data
     QRect calculate = d_pd->rectToCalculate;
 
     KisPaintDeviceSP m_dev = m_d->image->projection();
-    QRect imageBounds = m_d->image->bounds();
 
-    const KoColorSpace *cs = m_dev->colorSpace();
-    quint32 channelCount = m_dev->channelCount();
-    quint32 pixelSize = m_dev->pixelSize();
+    const KoColorSpace *cs = m_d->colorSpace;
+    const int channelCount = cs->channelCount();
+    const int pixelSize = cs->pixelSize();
+    const int nSkip = m_d->nSkip;
 
-    int imageSize = imageBounds.width() * imageBounds.height();
-    int nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
+    HistVector &result = m_d->results[d_pd->jobId];
+    initiateVector(result, cs);
 
     if (calculate.isEmpty())
         return;
 
-    initiateVector(m_d->results[d_pd->jobId], cs);
+    const int numPixels = calculate.width() * calculate.height();
+    QVector<quint8> pixels(numPixels * pixelSize);
+    m_dev->readBytes(pixels.data(), calculate);
 
-    quint32 toSkip = nSkip;
+    // every nSkip-th pixel of the patch is taken, starting from
+    // the (nSkip - 1)-th one, the same as the sequential iterator did
+    const quint8 *firstPixel = pixels.constData() + (nSkip - 1) * pixelSize;
+    const int numSamples = numPixels / nSkip;
 
-    KisSequentialConstIterator it(m_dev, calculate);
+    if (m_d->binner) {
+        // the range maps the values exactly like KoColorSpace::scaleToU8()
+        KoHistogramBinRange range;
+        range.bias = 0.5f;
 
-    int numConseqPixels = it.nConseqPixels();
-    while (it.nextPixels(numConseqPixels)) {
+        std::vector<quint32> bins(channelCount * range.numBins, 0);
 
-        numConseqPixels = it.nConseqPixels();
-        const quint8* pixel = it.rawDataConst();
-        for (int k = 0; k < numConseqPixels; ++k) {
-            if (--toSkip == 0) {
-                for (int chan = 0; chan < (int)channelCount; ++chan) {
-                    m_d->results[d_pd->jobId][chan][cs->scaleToU8(pixel, chan)]++;
-                }
-                toSkip = nSkip;
+        m_d->binner->addPixels(firstPixel, nSkip * pixelSize, 0, numSamples, channelCount,
+                               range, bins.data(), 0, 0);
+
+        for (int chan = 0; chan < channelCount; ++chan) {
+            std::copy(bins.begin() + chan * range.numBins,
+                      bins.begin() + (chan + 1) * range.numBins,
+                      result[chan].begin());
+        }
+    } else {
+        const quint8 *pixel = firstPixel;
+        for (int k = 0; k < numSamples; ++k) {
+            for (int chan = 0; chan < channelCount; ++chan) {
+                result[chan][cs->scaleToU8(pixel, chan)]++;
             }
-            pixel += pixelSize;
+            pixel += nSkip * pixelSize;
         }
     }
 }
@@ -110,38 +209,53 @@ void HistogramComputationStrokeStrategy::doStrokeCallback(KisStrokeJobData *data
 void HistogramComputationStrokeStrategy::finishStrokeCallback()
 {
     HistogramData hisData;
-    hisData.colorSpace = m_d->image->projection()->colorSpace();
+    hisData.colorSpace = m_d->colorSpace;
 
-    if (m_d->results.size() == 1) {
-        hisData.bins = m_d->results[0];
-        emit computationResultReady(hisData);
-    } else {
+    bool cacheIsValid = false;
+
+    {
+        HistogramCache &cache = *m_d->cache;
+        QMutexLocker l(&cache.mutex);
 
-        quint32 channelCount = m_d->image->projection()->channelCount();
+        if (cache.epoch == m_d->epoch) {
+            cacheIsValid = true;
 
-        initiateVector(hisData.bins, hisData.colorSpace);
+            const int channelCount = cache.total.size();
 
-        for (int chan = 0; chan < (int)channelCount; chan++) {
-            int bsize = hisData.bins[chan].size();
+            for (int i = 0; i < m_d->dirtyPatches.size(); i++) {
+                const int patch = m_d->dirtyPatches[i];
+                HistVector &oldBins = cache.patchBins[patch];
+                const HistVector &newBins = m_d->results[i];
 
-            for (int bi = 0; bi < bsize; bi++) {
-                hisData.bins[chan][bi] = 0;
-                for (int i = 0; i < (int)m_d->results.size(); i++) {
-                    hisData.bins[chan][bi] += m_d->results[i][chan][bi];
+                for (int chan = 0; chan < channelCount; chan++) {
+                    std::vector<quint32> &total = cache.total[chan];
+                    const int bsize = total.size();
+
+                    if (!oldBins.empty()) {
+                        for (int bi = 0; bi < bsize; bi++) {
+                            total[bi] -= oldBins[chan][bi];
+                        }
+                    }
+
+                    for (int bi = 0; bi < bsize; bi++) {
+                        total[bi] += newBins[chan][bi];
+                    }
                 }
+
+                oldBins.swap(m_d->results[i]);
+
+                // if the patch has been updated while the stroke was
+                // running, it will stay dirty till the next run
+                cache.computedGeneration[patch] = m_d->generations[i];
             }
+
+            hisData.bins = cache.total;
         }
+    }
 
+    if (cacheIsValid) {
         emit computationResultReady(hisData);
     }
 
     KisIdleTaskStrokeStrategy::finishStrokeCallback();
 }
-
-void HistogramComputationStrokeStrategy::initiateVector(HistVector &vec, const KoColorSpace *colorSpace)
-{
-    vec.resize(colorSpace->channelCount());
-    for (auto &bin : vec) {
-        bin.resize(std::numeric_limits<quint8>::max() + 1);
-    }
-}
@@ -10,6 +10,11 @@
 #include <KisIdleTaskStrokeStrategy.h>
 #include <vector>
 
+#include <QMutex>
+#include <QRect>
+#include <QSharedPointer>
+#include <QVector>
+
 class KoColorSpace;
 
 
@@ -22,12 +27,64 @@ struct HistogramData
 };
 Q_DECLARE_METATYPE(HistogramData)
 
+/**
+ * The histogram of the image split into patches. The cache is shared
+ * between the docker and the computation strokes. The docker marks
+ * the patches touched by the updates of the image as dirty, and the
+ * stroke rebins only the dirty patches: their old contribution is
+ * subtracted from the total histogram and the new one is added.
+ *
+ * All the methods are thread-safe, addDirtyRect() is called directly
+ * from the threads updating the projection.
+ */
+class HistogramCache
+{
+public:
+    void addDirtyRect(const QRect &rect);
+
+    /**
+     * Drops all the bins, the next computation will process the
+     * whole image
+     */
+    void reset();
+
+private:
+    friend class HistogramComputationStrokeStrategy;
+
+    QMutex mutex;
+
+    /**
+     * Incremented on every reset, the stroke started before the reset
+     * doesn't write its results into the cache
+     */
+    int epoch {0};
+
+    const KoColorSpace *colorSpace {0};
+    QRect bounds;
+    int nSkip {0};
+
+    QVector<QRect> patches;
+
+    /**
+     * The patch needs rebinning if its dirtyGeneration differs from
+     * computedGeneration. Generations (instead of a flag) make the
+     * updates coming in while the stroke is running not get lost.
+     */
+    std::vector<quint64> dirtyGeneration;
+    std::vector<quint64> computedGeneration;
+
+    std::vector<HistVector> patchBins;
+    HistVector total;
+};
+
+using HistogramCacheSP = QSharedPointer<HistogramCache>;
+
 
 class HistogramComputationStrokeStrategy : public KisIdleTaskStrokeStrategy
 {
     Q_OBJECT
 public:
-    HistogramComputationStrokeStrategy(KisImageSP image);
+    HistogramComputationStrokeStrategy(KisImageSP image, HistogramCacheSP cache);
     ~HistogramComputationStrokeStrategy() override;
 
 private:
@@ -35,8 +92,6 @@ private:
     void doStrokeCallback(KisStrokeJobData *data) override;
     void finishStrokeCallback() override;
 
-    void initiateVector(HistVector &vec, const KoColorSpace* colorSpace);
-
 Q_SIGNALS:
     //Emitted when thumbnail is updated and overviewImage is fully generated.
     void computationResultReady(HistogramData data);
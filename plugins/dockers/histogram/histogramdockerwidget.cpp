@@ -18,11 +18,13 @@
 #include "KoChannelInfo.h"
 #include "KisViewManager.h"
 #include "kis_canvas2.h"
+#include "kis_image.h"
 
 
 
 HistogramDockerWidget::HistogramDockerWidget(QWidget *parent, const char *name, Qt::WindowFlags f)
     : KisWidgetWithIdleTask<QLabel>(parent, f)
+    , m_cache(new HistogramCache())
 {
     setObjectName(name);
     qRegisterMetaType<HistogramData>();
@@ -43,11 +45,25 @@ KisIdleTasksManager::TaskGuard HistogramDockerWidget::registerIdleTask(KisCanvas
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(canvas, KisIdleTasksManager::TaskGuard());
 
+    m_cache->reset();
+    disconnect(m_imageUpdatesConnection);
+
+    KisImageSP image = canvas->image();
+    if (image) {
+        // the updates come from the threads updating the projection,
+        // the cache is thread-safe, so it is notified directly
+        HistogramCacheSP cache = m_cache;
+        m_imageUpdatesConnection =
+            connect(image.data(), &KisImage::sigImageUpdated, this,
+                    [cache] (const QRect &rect) { cache->addDirtyRect(rect); },
+                    Qt::DirectConnection);
+    }
+
     return
         canvas->viewManager()->idleTasksManager()->
         addIdleTaskWithGuard([this](KisImageSP image) {
             HistogramComputationStrokeStrategy* strategy =
-                new HistogramComputationStrokeStrategy(image);
+                new HistogramComputationStrokeStrategy(image, m_cache);
 
             connect(strategy, SIGNAL(computationResultReady(HistogramData)), this, SLOT(receiveNewHistogram(HistogramData)));
 
@@ -59,6 +75,7 @@ void HistogramDockerWidget::clearCachedState()
 {
     m_colorSpace = 0;
     m_histogramData.clear();
+    m_cache->reset();
 }
 
 void HistogramDockerWidget::paintEvent(QPaintEvent *event)
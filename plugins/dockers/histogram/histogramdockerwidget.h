@@ -36,6 +36,8 @@ private:
 private:
     HistVector m_histogramData;
     const KoColorSpace* m_colorSpace {0};
+    HistogramCacheSP m_cache;
+    QMetaObject::Connection m_imageUpdatesConnection;
     bool m_smoothHistogram {false};
 };
 
@@ -241,4 +241,23 @@ KoColorTransformation* createPerChannelTransformationFromTransfers(const KoColor
     return KoCompositeColorTransformation::createOptimizedCompositeTransform(allTransforms);
 }
 
+bool isPerChannelTransformation(const KoColorSpace *cs, const QList<bool> &transferIsIdentity)
+{
+    const QVector<VirtualChannelInfo> virtualChannels = getVirtualChannels(cs, transferIsIdentity.size());
+
+    for (int i = 0; i < virtualChannels.size(); i++) {
+        const VirtualChannelInfo::Type type = virtualChannels[i].type();
+
+        if ((type == VirtualChannelInfo::HUE ||
+             type == VirtualChannelInfo::SATURATION ||
+             type == VirtualChannelInfo::LIGHTNESS) &&
+            !transferIsIdentity[i]) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
 }
@@ -45,6 +45,16 @@ KoColorTransformation* createPerChannelTransformationFromTransfers(const KoColor
                                                                    const QVector<QVector<quint16>> &transfers,
                                                                    const QList<bool> &transferIsIdentity);
 
+/**
+ * @brief Check if the transformation created by createPerChannelTransformationFromTransfers()
+ *        processes every channel separately, i.e. the hue, saturation and lightness transfers
+ *        have no effect
+ * @param cs a colorspace
+ * @param transferIsIdentity A collection of bools that indicate if the
+ *        corresponding transfer has no effect (maps the input to itself)
+ */
+bool isPerChannelTransformation(const KoColorSpace *cs, const QList<bool> &transferIsIdentity);
+
 }
 
 #endif
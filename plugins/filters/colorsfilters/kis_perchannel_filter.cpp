@@ -186,3 +186,17 @@ KoColorTransformation* KisPerChannelFilter::createTransformation(const KoColorSp
 
     return KisMultiChannelUtils::createPerChannelTransformationFromTransfers(cs, configBC->transfers(), isIdentityList);
 }
+
+bool KisPerChannelFilter::isPerChannelTransformation(const KoColorSpace *cs, const KisFilterConfigurationSP config) const
+{
+    const KisPerChannelFilterConfiguration* configBC =
+        dynamic_cast<const KisPerChannelFilterConfiguration*>(config.data());
+    if (!configBC) return false;
+
+    QList<bool> isIdentityList;
+    for (const KisCubicCurve &curve : configBC->curves()) {
+        isIdentityList.append(curve.isIdentity());
+    }
+
+    return KisMultiChannelUtils::isPerChannelTransformation(cs, isIdentityList);
+}
@@ -54,6 +54,16 @@ KoColorTransformation* KisFilterInvert::createTransformation(const KoColorSpace*
     return cs->createInvertTransformation();
 }
 
+bool KisFilterInvert::isPerChannelTransformation(const KoColorSpace *cs, const KisFilterConfigurationSP config) const
+{
+    Q_UNUSED(config);
+
+    // the integer color spaces invert every color channel separately,
+    // the others may be inverted via a conversion into RGB
+    return cs->colorDepthId() == Integer8BitsColorDepthID ||
+        cs->colorDepthId() == Integer16BitsColorDepthID;
+}
+
 bool KisFilterInvert::needsTransparentPixels(const KisFilterConfigurationSP config, const KoColorSpace *cs) const
 {
     Q_UNUSED(config);
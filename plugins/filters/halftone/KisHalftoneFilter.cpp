@@ -7,6 +7,8 @@
  */
 
 #include <QHash>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <kpluginfactory.h>
 #include <kis_filter_registry.h>
@@ -20,6 +22,7 @@
 #include <kis_processing_information.h>
 #include <kis_selection.h>
 #include <kis_painter.h>
+#include <tiles3/kis_tile_data_interface.h>
 #include <KoCompositeOpRegistry.h>
 #include <KoColorModelStandardIds.h>
 #include <KoColorSpaceRegistry.h>
@@ -139,32 +142,46 @@ QVector<quint8> KisHalftoneFilter::makeNoiseWeightLut(qreal hardness)
     return noiseWeightLut;
 }
 
-KisPaintDeviceSP KisHalftoneFilter::makeGeneratorPaintDevice(KisPaintDeviceSP prototype,
-                                                             const QString & prefix,
-                                                             const QRect &applyRect,
-                                                             const KisHalftoneFilterConfiguration *config,
-                                                             KoUpdater *progressUpdater) const
+KisHalftoneFilter::Screen KisHalftoneFilter::makeScreen(const QString &prefix,
+                                                        const KisHalftoneFilterConfiguration *config) const
 {
+    Screen screen;
+
     const QString generatorId = config->generatorId(prefix);
     if (generatorId.isEmpty()) {
-        return nullptr;
+        return screen;
     }
 
-    KisGeneratorSP generator  = KisGeneratorRegistry::instance()->get(generatorId);
-    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(generator, nullptr);
+    KisGeneratorSP generator = KisGeneratorRegistry::instance()->get(generatorId);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(generator, screen);
 
     KisFilterConfigurationSP generatorConfiguration = config->generatorConfiguration(prefix);
-    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(generatorConfiguration, nullptr);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(generatorConfiguration, screen);
+
+    // Make the hardness and the noise weight LUT
+    const qreal hardness = config->hardness(prefix) / 100.0;
+
+    screen.generator = generator;
+    screen.generatorConfiguration = generatorConfiguration;
+    screen.hardnessLut = makeHardnessLut(hardness);
+    screen.noiseWeightLut = makeNoiseWeightLut(hardness);
+    screen.invert = config->invert(prefix);
 
+    return screen;
+}
+
+KisPaintDeviceSP KisHalftoneFilter::makeGeneratorPaintDevice(KisPaintDeviceSP prototype,
+                                                             const Screen &screen,
+                                                             const QRect &rect) const
+{
     // Fill the generator device
     KisPaintDeviceSP generatorDevice = m_grayDevicesCache.getDevice(prototype, KoColorSpaceRegistry::instance()->graya8());
 
-    KisProcessingInformation(generatorDevice, applyRect.topLeft(), KisSelectionSP());
-    generator->generate(
-        KisProcessingInformation(generatorDevice, applyRect.topLeft(),KisSelectionSP()),
-        applyRect.size(),
-        generatorConfiguration,
-        progressUpdater
+    screen.generator->generate(
+        KisProcessingInformation(generatorDevice, rect.topLeft(), KisSelectionSP()),
+        rect.size(),
+        screen.generatorConfiguration,
+        nullptr
     );
 
     return generatorDevice;
@@ -186,6 +203,43 @@ bool KisHalftoneFilter::checkUpdaterInterruptedAndSetPercent(KoUpdater *progress
     return false;
 }
 
+void KisHalftoneFilter::processInStrips(KisPaintDeviceSP device,
+                                        const QRect &applyRect,
+                                        bool parallel,
+                                        KoUpdater *progressUpdater,
+                                        std::function<void(const QRect&)> processStrip) const
+{
+    // The generators are position-dependent only, so every strip can
+    // generate its own part of the screen. That way the temporary devices
+    // never grow larger than a strip, whatever the size of the image
+    const int tileSize = KisTileData::HEIGHT;
+    QVector<QRect> strips;
+    for (int top = applyRect.top(); top <= applyRect.bottom(); ) {
+        const int offset = (top - device->y()) % tileSize;
+        const int height = qMin(tileSize - (offset < 0 ? offset + tileSize : offset),
+                                applyRect.bottom() - top + 1);
+        strips.append(QRect(applyRect.x(), top, applyRect.width(), height));
+        top += height;
+    }
+
+    const int batchSize = parallel ? qMax(1, QThread::idealThreadCount()) : 1;
+
+    for (int i = 0; i < strips.size(); i += batchSize) {
+        if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 100 * i / strips.size())) {
+            return;
+        }
+
+        if (parallel) {
+            QVector<QRect> batch = strips.mid(i, batchSize);
+            QtConcurrent::blockingMap(batch, processStrip);
+        } else {
+            processStrip(strips[i]);
+        }
+    }
+
+    checkUpdaterInterruptedAndSetPercent(progressUpdater, 100);
+}
+
 void KisHalftoneFilter::processIntensity(KisPaintDeviceSP device,
                                          const QRect &applyRect,
                                          const KisHalftoneFilterConfiguration *config,
@@ -193,220 +247,129 @@ void KisHalftoneFilter::processIntensity(KisPaintDeviceSP device,
 {
     const QString prefix = "intensity_";
 
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 0)) {
+    const Screen screen = makeScreen(prefix, config);
+    if (!screen.generator) {
         return;
     }
-    
-    // Make the generator device
-    KisPaintDeviceSP generatorDevice = makeGeneratorPaintDevice(device, prefix, applyRect, config, nullptr);
-    if (!generatorDevice) {
-        return;
-    }
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 25)) {
-        return;
+
+    const KoColorSpace *colorSpace;
+    if (device->colorSpace()->profile()->isLinear()) {
+        colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    } else {
+        colorSpace = device->colorSpace();
     }
 
-    // Make the hardness and the noise weight LUT
-    const qreal hardness = config->hardness(prefix) / 100.0;
-    const QVector<quint8> hardnessLut = makeHardnessLut(hardness);
-    const QVector<quint8> noiseWeightLut = makeNoiseWeightLut(hardness);
+    KoColor foregroundColor = config->foregroundColor(prefix);
+    KoColor backgroundColor = config->backgroundColor(prefix);
+    const qreal foregroundOpacity = config->foregroundOpacity(prefix) / 100.0;
+    const qreal backgroundOpacity = config->backgroundOpacity(prefix) / 100.0;
+    foregroundColor.convertTo(colorSpace);
+    backgroundColor.convertTo(colorSpace);
+    foregroundColor.setOpacity(foregroundOpacity);
+    backgroundColor.setOpacity(backgroundOpacity);
 
-    // Fill the mask device
-    KisSelectionSP maskDevice = m_selectionsCache.getSelection();
+    auto processStrip = [&] (const QRect &rect) {
+        // Make the generator device
+        KisPaintDeviceSP generatorDevice = makeGeneratorPaintDevice(device, screen, rect);
 
-    {
-        const bool invert = config->invert(prefix);
+        // Fill the mask device
+        KisSelectionSP maskDevice = m_selectionsCache.getSelection();
 
-        KisSequentialIterator maskIterator(maskDevice->pixelSelection(), applyRect);
-        KisSequentialIterator dstIterator(device, applyRect);
-        KisSequentialIterator srcIterator(generatorDevice, applyRect);
+        {
+            KisSequentialIterator maskIterator(maskDevice->pixelSelection(), rect);
+            KisSequentialConstIterator dstIterator(device, rect);
+            KisSequentialConstIterator srcIterator(generatorDevice, rect);
 
-        if (!invert) {
             while (maskIterator.nextPixel() && dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dstGray = device->colorSpace()->intensity8(dstIterator.rawData());
-                int srcGray = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
+                int dstGray = device->colorSpace()->intensity8(dstIterator.rawDataConst());
+                int srcGray = srcIterator.rawDataConst()[0];
+                int srcAlpha = srcIterator.rawDataConst()[1];
 
                 // Combine pixels
-                int result = qBound(0, dstGray + (srcGray - 128) * noiseWeightLut[dstGray] * srcAlpha / 0xFE01, 255);
+                int result = qBound(0, dstGray + (srcGray - 128) * screen.noiseWeightLut[dstGray] * srcAlpha / 0xFE01, 255);
 
                 // Apply hardness
-                result = hardnessLut[result];
+                result = screen.hardnessLut[result];
 
-                *maskIterator.rawData() = 255 - result;
+                *maskIterator.rawData() = screen.invert ? result : 255 - result;
             }
-        } else {
-            while (maskIterator.nextPixel() && dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dstGray = device->colorSpace()->intensity8(dstIterator.rawData());
-                int srcGray = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
+        }
+        m_grayDevicesCache.putDevice(generatorDevice);
 
-                // Combine pixels
-                int result = qBound(0, dstGray + (srcGray - 128) * noiseWeightLut[dstGray] * srcAlpha / 0xFE01, 255);
+        // Make the halftone image
+        KisPaintDeviceSP halftoneDevice = m_genericDevicesCache.getDevice(device, colorSpace);
 
-                // Apply hardness
-                result = hardnessLut[result];
+        {
+            KisPaintDeviceSP foregroundDevice = m_genericDevicesCache.getDevice(device, colorSpace);
 
-                *maskIterator.rawData() = result;
-            }
-        }
-        m_grayDevicesCache.putDevice(generatorDevice);
-    }
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 50)) {
-        return;
-    }
+            foregroundDevice->fill(rect, foregroundColor);
+            halftoneDevice->fill(rect, backgroundColor);
 
-    // Make the halftone image
-    const KoColorSpace *colorSpace;
-    if (device->colorSpace()->profile()->isLinear()) {
-        colorSpace = KoColorSpaceRegistry::instance()->rgb8();
-    } else {
-        colorSpace = device->colorSpace();
-    }
-    KisPaintDeviceSP halftoneDevice = m_genericDevicesCache.getDevice(device, colorSpace);
-    
-    {
-        KisPaintDeviceSP foregroundDevice = m_genericDevicesCache.getDevice(device, colorSpace);
-        KoColor foregroundColor = config->foregroundColor(prefix);
-        KoColor backgroundColor = config->backgroundColor(prefix);
-        const qreal foregroundOpacity = config->foregroundOpacity(prefix) / 100.0;
-        const qreal backgroundOpacity = config->backgroundOpacity(prefix) / 100.0;
-        foregroundColor.convertTo(colorSpace);
-        backgroundColor.convertTo(colorSpace);
-        foregroundColor.setOpacity(foregroundOpacity);
-        backgroundColor.setOpacity(backgroundOpacity);
-
-        foregroundDevice->fill(applyRect, foregroundColor);
-        halftoneDevice->fill(applyRect, backgroundColor);
-
-        KisPainter painter(halftoneDevice, maskDevice);
-        painter.setCompositeOpId(COMPOSITE_OVER);
-        painter.bitBlt(applyRect.topLeft(), foregroundDevice, applyRect);
-
-        m_genericDevicesCache.putDevice(foregroundDevice);
-        m_selectionsCache.putSelection(maskDevice);
-    }
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 75)) {
-        return;
-    }
+            KisPainter painter(halftoneDevice, maskDevice);
+            painter.setCompositeOpId(COMPOSITE_OVER);
+            painter.bitBlt(rect.topLeft(), foregroundDevice, rect);
 
-    // Make the final image
-    {
-        KisPainter painter(halftoneDevice);
-        painter.setCompositeOpId(COMPOSITE_DESTINATION_IN);
-        painter.bitBlt(applyRect.topLeft(), device, applyRect);
-    }
-    {
-        KisPainter painter(device);
-        painter.setCompositeOpId(COMPOSITE_COPY);
-        painter.bitBlt(applyRect.topLeft(), halftoneDevice, applyRect);
-    }
-    m_genericDevicesCache.putDevice(halftoneDevice);
+            m_genericDevicesCache.putDevice(foregroundDevice);
+            m_selectionsCache.putSelection(maskDevice);
+        }
 
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 100)) {
-        return;
-    }
+        // Make the final image
+        {
+            KisPainter painter(halftoneDevice);
+            painter.setCompositeOpId(COMPOSITE_DESTINATION_IN);
+            painter.bitBlt(rect.topLeft(), device, rect);
+        }
+        {
+            KisPainter painter(device);
+            painter.setCompositeOpId(COMPOSITE_COPY);
+            painter.bitBlt(rect.topLeft(), halftoneDevice, rect);
+        }
+        m_genericDevicesCache.putDevice(halftoneDevice);
+    };
+
+    processInStrips(device, applyRect, screen.generator->supportsThreading(), progressUpdater, processStrip);
 }
 
 template <typename ChannelType>
 void KisHalftoneFilter::processChannel(KisPaintDeviceSP device,
                                        KisPaintDeviceSP generatorDevice,
-                                       const QRect &applyRect,
-                                       const KisHalftoneFilterConfiguration *config,
-                                       const QString & prefix,
-                                       KoChannelInfo * channelInfo) const
+                                       const QRect &rect,
+                                       const Screen &screen,
+                                       const KoChannelInfo *channelInfo,
+                                       const QVector<quint8> &linearGrayLut,
+                                       const QVector<quint8> &linearAlphaLut) const
 {
     const int channelPos = channelInfo->pos() / sizeof(ChannelType);
-    // Make the hardness and the noise weight LUT
-    const qreal hardness = config->hardness(prefix) / 100.0;
-    const QVector<quint8> hardnessLut = makeHardnessLut(hardness);
-    const QVector<quint8> noiseWeightLut = makeNoiseWeightLut(hardness);
+    const ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
+    const ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
+    const bool isLinear = !linearGrayLut.isEmpty();
 
     // Fill the device
-    const bool invert = config->invert(prefix);
-    KisSequentialIterator dstIterator(device, applyRect);
-    KisSequentialIterator srcIterator(generatorDevice, applyRect);
+    KisSequentialIterator dstIterator(device, rect);
+    KisSequentialConstIterator srcIterator(generatorDevice, rect);
 
     const KoColorSpace *colorSpace = device->colorSpace();
 
-    if (colorSpace->profile()->isLinear()) {
-        if (!invert) {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = 255 - device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-                KoColor c(QColor(src, src, src, srcAlpha), device->colorSpace());
-                src = device->colorSpace()->scaleToU8(c.data(), 0);
-                srcAlpha = device->colorSpace()->scaleToU8(c.data(), device->colorSpace()->alphaPos());
-
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-                // Apply hardness
-                result = hardnessLut[result];
-
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(255 - result, channelMin, channelMax));
-            }
-        } else {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-                KoColor c(QColor(src, src, src, srcAlpha), device->colorSpace());
-                src = device->colorSpace()->scaleToU8(c.data(), 0);
-                srcAlpha = device->colorSpace()->scaleToU8(c.data(), device->colorSpace()->alphaPos());
-
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-                // Apply hardness
-                result = hardnessLut[result];
-
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(result, channelMin, channelMax));
-            }
+    while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
+        int dst = colorSpace->scaleToU8(dstIterator.rawData(), channelPos);
+        if (!screen.invert) {
+            dst = 255 - dst;
+        }
+        int src = srcIterator.rawDataConst()[0];
+        int srcAlpha = srcIterator.rawDataConst()[1];
+        if (isLinear) {
+            src = linearGrayLut[src];
+            srcAlpha = linearAlphaLut[srcAlpha];
         }
-    } else {
-        if (!invert) {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = 255 - device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-                // Apply hardness
-                result = hardnessLut[result];
-
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(255 - result, channelMin, channelMax));
-            }
-        } else {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
 
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
+        // Combine pixels
+        int result = qBound(0, dst + (src - 128) * screen.noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
 
-                // Apply hardness
-                result = hardnessLut[result];
+        // Apply hardness
+        result = screen.hardnessLut[result];
 
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(result, channelMin, channelMax));
-            }
-        }
+        ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
+        dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(screen.invert ? result : 255 - result, channelMin, channelMax));
     }
 }
 
@@ -415,84 +378,91 @@ void KisHalftoneFilter::processChannels(KisPaintDeviceSP device,
                                         const KisHalftoneFilterConfiguration *config,
                                         KoUpdater *progressUpdater) const
 {
-    const QList<KoChannelInfo *> channels = device->colorSpace()->channels();
-    const int progressStep = 100 / (channels.count() * 2);
-
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 0)) {
-        return;
-    }
+    const KoColorSpace *colorSpace = device->colorSpace();
+    const QList<KoChannelInfo *> channels = colorSpace->channels();
 
-    // Make the generator devices
-    QVector<KisPaintDeviceSP> generatorDevices(channels.count());
+    // Look up the screens once, the strips share them
+    QVector<Screen> screens(channels.count());
+    bool hasScreens = false;
+    bool supportsThreading = true;
     for (int i = 0; i < channels.count(); ++i) {
         if (channels.at(i)->channelType() == KoChannelInfo::ALPHA) {
-            generatorDevices[i] = nullptr;
-        } else {
-            const QString prefix =
-                device->colorSpace()->colorModelId().id() + "_channel" + QString::number(i) + "_";
-            KisPaintDeviceSP generatorDevice = makeGeneratorPaintDevice(device, prefix, applyRect, config, nullptr);
-            if (generatorDevice) {
-                generatorDevices[i] = generatorDevice;
-            } else {
-                generatorDevices[i] = nullptr;
-            }
+            continue;
         }
-        if (checkUpdaterInterruptedAndSetPercent(progressUpdater, progressUpdater->progress() + progressStep)) {
-            return;
+        const QString prefix = colorSpace->colorModelId().id() + "_channel" + QString::number(i) + "_";
+        screens[i] = makeScreen(prefix, config);
+        if (screens[i].generator) {
+            hasScreens = true;
+            supportsThreading &= screens[i].generator->supportsThreading();
         }
     }
+    if (!hasScreens) {
+        return;
+    }
 
-    // process channels
-    for (int i = 0; i < channels.count(); ++i) {
-        if (!generatorDevices[i]) {
-            progressUpdater->setProgress(progressUpdater->progress() + progressStep);
-            continue;
+    // In linear color spaces the gray values of the screen are converted
+    // into the color space of the device. The conversion depends only on
+    // the value, so it is done once for all the possible values instead of
+    // once per pixel.
+    QVector<quint8> linearGrayLut;
+    QVector<quint8> linearAlphaLut;
+    if (colorSpace->profile()->isLinear()) {
+        linearGrayLut.resize(256);
+        linearAlphaLut.resize(256);
+        for (int i = 0; i < 256; ++i) {
+            const KoColor gray(QColor(i, i, i), colorSpace);
+            const KoColor alpha(QColor(0, 0, 0, i), colorSpace);
+            linearGrayLut[i] = colorSpace->scaleToU8(gray.data(), 0);
+            linearAlphaLut[i] = colorSpace->scaleToU8(alpha.data(), colorSpace->alphaPos());
         }
+    }
+
+    auto processStrip = [&] (const QRect &rect) {
+        for (int i = 0; i < channels.count(); ++i) {
+            const Screen &screen = screens[i];
+            if (!screen.generator) {
+                continue;
+            }
 
-        const QString prefix = device->colorSpace()->colorModelId().id() + "_channel" + QString::number(i) + "_";
-
-        switch (channels.at(i)->channelValueType()) {
-        case KoChannelInfo::UINT8: {
-            processChannel<quint8>(device, generatorDevices[i], applyRect, config, prefix, channels.at(i));
-            break;
-        } case KoChannelInfo::UINT16: {
-            processChannel<quint16>(device, generatorDevices[i], applyRect, config, prefix, channels.at(i));
-            break;
-        } case KoChannelInfo::UINT32: {
-            processChannel<quint32>(device, generatorDevices[i], applyRect, config, prefix, channels.at(i));
-            break;
-        } case KoChannelInfo::FLOAT16: {
+            KisPaintDeviceSP generatorDevice = makeGeneratorPaintDevice(device, screen, rect);
+
+            switch (channels.at(i)->channelValueType()) {
+            case KoChannelInfo::UINT8: {
+                processChannel<quint8>(device, generatorDevice, rect, screen, channels.at(i), linearGrayLut, linearAlphaLut);
+                break;
+            } case KoChannelInfo::UINT16: {
+                processChannel<quint16>(device, generatorDevice, rect, screen, channels.at(i), linearGrayLut, linearAlphaLut);
+                break;
+            } case KoChannelInfo::UINT32: {
+                processChannel<quint32>(device, generatorDevice, rect, screen, channels.at(i), linearGrayLut, linearAlphaLut);
+                break;
+            } case KoChannelInfo::FLOAT16: {
 #ifdef HAVE_OPENEXR
-            processChannel<half>(device, generatorDevices[i], applyRect, config, prefix, channels.at(i));
+                processChannel<half>(device, generatorDevice, rect, screen, channels.at(i), linearGrayLut, linearAlphaLut);
 #endif
-            break;
-        } case KoChannelInfo::FLOAT32: {
-            processChannel<float>(device, generatorDevices[i], applyRect, config, prefix, channels.at(i));
-            break;
-        } case KoChannelInfo::FLOAT64: {
-            processChannel<double>(device, generatorDevices[i], applyRect, config, prefix, channels.at(i));
-            break;
-        } case KoChannelInfo::INT8: {
-            processChannel<qint8>(device, generatorDevices[i], applyRect, config, prefix, channels.at(i));
-            break;
-        } case KoChannelInfo::INT16: {
-            processChannel<qint16>(device, generatorDevices[i], applyRect, config, prefix, channels.at(i));
-            break;
-        } default: {
-            break;
-        }
-        }
-
-        m_grayDevicesCache.putDevice(generatorDevices[i]);
+                break;
+            } case KoChannelInfo::FLOAT32: {
+                processChannel<float>(device, generatorDevice, rect, screen, channels.at(i), linearGrayLut, linearAlphaLut);
+                break;
+            } case KoChannelInfo::FLOAT64: {
+                processChannel<double>(device, generatorDevice, rect, screen, channels.at(i), linearGrayLut, linearAlphaLut);
+                break;
+            } case KoChannelInfo::INT8: {
+                processChannel<qint8>(device, generatorDevice, rect, screen, channels.at(i), linearGrayLut, linearAlphaLut);
+                break;
+            } case KoChannelInfo::INT16: {
+                processChannel<qint16>(device, generatorDevice, rect, screen, channels.at(i), linearGrayLut, linearAlphaLut);
+                break;
+            } default: {
+                break;
+            }
+            }
 
-        if (checkUpdaterInterruptedAndSetPercent(progressUpdater, progressUpdater->progress() + progressStep)) {
-            return;
+            m_grayDevicesCache.putDevice(generatorDevice);
         }
-    }
+    };
 
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 100)) {
-        return;
-    }
+    processInStrips(device, applyRect, supportsThreading, progressUpdater, processStrip);
 }
 
 void KisHalftoneFilter::processAlpha(KisPaintDeviceSP device,
@@ -500,65 +470,40 @@ void KisHalftoneFilter::processAlpha(KisPaintDeviceSP device,
                                      const KisHalftoneFilterConfiguration *config,
                                      KoUpdater *progressUpdater) const
 {
-    const QString prefix = "alpha_";
-    
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 0)) {
+    const Screen screen = makeScreen("alpha_", config);
+    if (!screen.generator) {
         return;
     }
 
-    // Make the generator device
-    KisPaintDeviceSP generatorDevice = makeGeneratorPaintDevice(device, prefix, applyRect, config, nullptr);
-    if (!generatorDevice) {
-        return;
-    }
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 50)) {
-        return;
-    }
+    const KoColorSpace *colorSpace = device->colorSpace();
 
-    // Make the hardness and the noise weight LUT
-    const qreal hardness = config->hardness(prefix) / 100.0;
-    const QVector<quint8> hardnessLut = makeHardnessLut(hardness);
-    const QVector<quint8> noiseWeightLut = makeNoiseWeightLut(hardness);
+    auto processStrip = [&] (const QRect &rect) {
+        KisPaintDeviceSP generatorDevice = makeGeneratorPaintDevice(device, screen, rect);
 
-    // Fill the device
-    const bool invert = config->invert(prefix);
-    KisSequentialIterator dstIterator(device, applyRect);
-    KisSequentialIterator srcIterator(generatorDevice, applyRect);
+        // Fill the device
+        KisSequentialIterator dstIterator(device, rect);
+        KisSequentialConstIterator srcIterator(generatorDevice, rect);
 
-    if (!invert) {
         while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = 255 - device->colorSpace()->opacityU8(dstIterator.rawData());
-            int src = srcIterator.rawData()[0];
-            int srcAlpha = srcIterator.rawData()[1];
-
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-            // Apply hardness
-            result = hardnessLut[result];
-
-            device->colorSpace()->setOpacity(dstIterator.rawData(), static_cast<quint8>(255 - result), 1);
-        }
-    } else {
-        while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = device->colorSpace()->opacityU8(dstIterator.rawData());
-            int src = srcIterator.rawData()[0];
-            int srcAlpha = srcIterator.rawData()[1];
+            int dst = colorSpace->opacityU8(dstIterator.rawData());
+            if (!screen.invert) {
+                dst = 255 - dst;
+            }
+            int src = srcIterator.rawDataConst()[0];
+            int srcAlpha = srcIterator.rawDataConst()[1];
 
             // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
+            int result = qBound(0, dst + (src - 128) * screen.noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
 
             // Apply hardness
-            result = hardnessLut[result];
+            result = screen.hardnessLut[result];
 
-            device->colorSpace()->setOpacity(dstIterator.rawData(), static_cast<quint8>(result), 1);
+            colorSpace->setOpacity(dstIterator.rawData(), static_cast<quint8>(screen.invert ? result : 255 - result), 1);
         }
-    }
-    m_grayDevicesCache.putDevice(generatorDevice);
+        m_grayDevicesCache.putDevice(generatorDevice);
+    };
 
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 100)) {
-        return;
-    }
+    processInStrips(device, applyRect, screen.generator->supportsThreading(), progressUpdater, processStrip);
 }
 
 void KisHalftoneFilter::processMask(KisPaintDeviceSP device,
@@ -566,63 +511,37 @@ void KisHalftoneFilter::processMask(KisPaintDeviceSP device,
                                     const KisHalftoneFilterConfiguration *config,
                                     KoUpdater *progressUpdater) const
 {
-    const QString prefix = "alpha_";
-    
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 0)) {
+    const Screen screen = makeScreen("alpha_", config);
+    if (!screen.generator) {
         return;
     }
 
-    // Make the generator device
-    KisPaintDeviceSP generatorDevice = makeGeneratorPaintDevice(device, prefix, applyRect, config, nullptr);
-    if (!generatorDevice) {
-        return;
-    }
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 50)) {
-        return;
-    }
-
-    // Make the hardness and the noise weight LUT
-    const qreal hardness = config->hardness(prefix) / 100.0;
-    const QVector<quint8> hardnessLut = makeHardnessLut(hardness);
-    const QVector<quint8> noiseWeightLut = makeNoiseWeightLut(hardness);
-
-    // Fill the device
-    const bool invert = config->invert(prefix);
-    KisSequentialIterator dstIterator(device, applyRect);
-    KisSequentialIterator srcIterator(generatorDevice, applyRect);
-
-    if (!invert) {
-        while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = 255 - *dstIterator.rawData();
-            int src = *srcIterator.rawData();
+    auto processStrip = [&] (const QRect &rect) {
+        KisPaintDeviceSP generatorDevice = makeGeneratorPaintDevice(device, screen, rect);
 
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] / 0xFF, 255);
-
-            // Apply hardness
-            result = hardnessLut[result];
+        // Fill the device
+        KisSequentialIterator dstIterator(device, rect);
+        KisSequentialConstIterator srcIterator(generatorDevice, rect);
 
-            *dstIterator.rawData() = static_cast<quint8>(255 - result);
-        }
-    } else {
         while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
             int dst = *dstIterator.rawData();
-            int src = *srcIterator.rawData();
+            if (!screen.invert) {
+                dst = 255 - dst;
+            }
+            int src = *srcIterator.rawDataConst();
 
             // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] / 0xFF, 255);
+            int result = qBound(0, dst + (src - 128) * screen.noiseWeightLut[dst] / 0xFF, 255);
 
             // Apply hardness
-            result = hardnessLut[result];
+            result = screen.hardnessLut[result];
 
-            *dstIterator.rawData() =  static_cast<quint8>(result);
+            *dstIterator.rawData() = static_cast<quint8>(screen.invert ? result : 255 - result);
         }
-    }
-    m_grayDevicesCache.putDevice(generatorDevice);
+        m_grayDevicesCache.putDevice(generatorDevice);
+    };
 
-    if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 100)) {
-        return;
-    }
+    processInStrips(device, applyRect, screen.generator->supportsThreading(), progressUpdater, processStrip);
 }
 
 KisFilterConfigurationSP KisHalftoneFilter::defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const
@@ -9,12 +9,15 @@
 #ifndef KIS_HALFTONE_FILTER_H
 #define KIS_HALFTONE_FILTER_H
 
+#include <functional>
+
 #include <QObject>
 #include <QVector>
 
 #include <filter/kis_filter.h>
 #include <kis_filter_configuration.h>
 #include <kis_cached_paint_device.h>
+#include <generator/kis_generator.h>
 
 #include "KisHalftoneFilterConfiguration.h"
 
@@ -51,6 +54,19 @@ private:
     mutable KisCachedPaintDevice m_grayDevicesCache;
     mutable KisCachedPaintDevice m_genericDevicesCache;
 
+    /**
+     * Everything needed to apply the screen of one prefix, looked up
+     * once per processImpl() call and shared by all the strips
+     */
+    struct Screen
+    {
+        KisGeneratorSP generator;
+        KisFilterConfigurationSP generatorConfiguration;
+        QVector<quint8> hardnessLut;
+        QVector<quint8> noiseWeightLut;
+        bool invert {false};
+    };
+
     static QVector<quint8> makeHardnessLut(qreal hardness);
     static QVector<quint8> makeNoiseWeightLut(qreal hardness);
     
@@ -64,13 +80,33 @@ private:
         return value * (new_max - new_min) / 255 + new_min;
     }
 
+    /**
+     * \return the screen of \p prefix or a screen with a null generator
+     *         if the prefix has no generator assigned
+     */
+    Screen makeScreen(const QString &prefix, const KisHalftoneFilterConfiguration *config) const;
+
+    /**
+     * Generates \p rect of the screen into a graya8 device taken from
+     * m_grayDevicesCache. The caller should return it to the cache.
+     */
     KisPaintDeviceSP makeGeneratorPaintDevice(KisPaintDeviceSP prototype,
-                                              const QString & prefix,
-                                              const QRect &applyRect,
-                                              const KisHalftoneFilterConfiguration *config,
-                                              KoUpdater *progressUpdater) const;
+                                              const Screen &screen,
+                                              const QRect &rect) const;
 
     bool checkUpdaterInterruptedAndSetPercent(KoUpdater *progressUpdater, int percent) const;
+
+    /**
+     * Splits \p applyRect into tile-aligned strips and calls \p processStrip
+     * for every one of them, in parallel if \p parallel is true. The strips
+     * are run in batches to be able to report the progress and to stop
+     * when the updater is interrupted.
+     */
+    void processInStrips(KisPaintDeviceSP device,
+                         const QRect &applyRect,
+                         bool parallel,
+                         KoUpdater *progressUpdater,
+                         std::function<void(const QRect&)> processStrip) const;
     
     void processIntensity(KisPaintDeviceSP device,
                           const QRect& applyRect,
@@ -79,10 +115,11 @@ private:
     template <typename ChannelType>
     void processChannel(KisPaintDeviceSP device,
                         KisPaintDeviceSP generatorDevice,
-                        const QRect &applyRect,
-                        const KisHalftoneFilterConfiguration *config,
-                        const QString & prefix,
-                        KoChannelInfo * channelInfo) const;
+                        const QRect &rect,
+                        const Screen &screen,
+                        const KoChannelInfo *channelInfo,
+                        const QVector<quint8> &linearGrayLut,
+                        const QVector<quint8> &linearAlphaLut) const;
     void processChannels(KisPaintDeviceSP device,
                          const QRect& applyRect,
                          const KisHalftoneFilterConfiguration *config,
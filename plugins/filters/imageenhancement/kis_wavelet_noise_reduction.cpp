@@ -8,8 +8,6 @@
 #include "kis_wavelet_noise_reduction.h"
 
 
-#include <cmath>
-
 #include <KoUpdater.h>
 
 #include <kis_layer.h>
@@ -80,34 +78,22 @@ void KisWaveletNoiseReduction::processImpl(KisPaintDeviceSP device,
         return;
     }
 
-    float* const fin = wav->coeffs + wav->depth * pow2(wav->size);
-    float* const begin = wav->coeffs + wav->depth;
-
-    const int size = fin - begin;
-    const int progressOffset = int(std::ceil(std::log2(size / 100)));
-    const int progressMask = (1 << progressOffset) - 1;
-    const int numProgressSteps = size >> progressOffset;
-    int pointsProcessed = 0;
-
-    progressUpdater->setRange(0, numProgressSteps);
-
-    for (float* it = begin; it < fin; it++) {
-        if (*it > threshold) {
-            *it -= threshold;
-        } else if (*it < -threshold) {
-            *it += threshold;
-        } else {
-            *it = 0.;
-        }
-
-        if (!(pointsProcessed & progressMask)) {
-            progressUpdater->setValue(pointsProcessed >> progressOffset);
-        }
-        pointsProcessed++;
+    if (progressUpdater) {
+        progressUpdater->setProgress(40);
+    }
+
+    mathToolbox.waveletSoftThreshold(wav, threshold);
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(60);
     }
 
     mathToolbox.fastWaveletUntransformation(device, applyRect, wav, buff);
 
+    if (progressUpdater) {
+        progressUpdater->setProgress(100);
+    }
+
     delete wav;
     delete buff;
 }
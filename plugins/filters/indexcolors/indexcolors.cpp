@@ -91,6 +91,16 @@ KisIndexColorTransformation::KisIndexColorTransformation(IndexColorPalette palet
 {
     m_palette = palette;
 
+    QVector<KoPaletteMap::Color> colors;
+    colors.reserve(m_palette.numColors());
+    Q_FOREACH (const LabColor &clr, m_palette.colors) {
+        colors.append({clr.L, clr.a, clr.b});
+    }
+    m_paletteMap = KoPaletteMap::cachedMap(colors,
+                                           {m_palette.similarityFactors.L,
+                                            m_palette.similarityFactors.a,
+                                            m_palette.similarityFactors.b});
+
     static const qreal max = KoColorSpaceMathsTraits<quint16>::max;
     if(alphaSteps > 0)
     {
@@ -106,28 +116,50 @@ KisIndexColorTransformation::KisIndexColorTransformation(IndexColorPalette palet
 
 void KisIndexColorTransformation::transform(const quint8* src, quint8* dst, qint32 nPixels) const
 {
+    // when every swatch of the generator is disabled, the palette
+    // is empty and there is nothing to map the pixels to
     if (m_palette.numColors() <= 0) {
         memcpy(dst, src, nPixels * m_colorSpace->pixelSize());
         return;
     }
 
-    union
-    {
-        quint16 laba[4];
-        LabColor lab;
-    } clr;
-    while (nPixels--)
+    // the pixels are converted to Lab in chunks to avoid the
+    // overhead of calling the conversion for every pixel
+    const int chunkSize = 256;
+    quint16 laba[chunkSize * 4];
+
+    while (nPixels > 0)
     {
-        m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(clr.laba), 1);
-        clr.lab = m_palette.getNearestIndex(clr.lab);
-        if(m_alphaStep)
+        const int chunk = qMin(nPixels, chunkSize);
+        m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(laba), chunk);
+
+        for (int i = 0; i < chunk; ++i)
         {
-            quint16 amod = clr.laba[3] % m_alphaStep;
-            clr.laba[3] = clr.laba[3] + (amod > m_alphaHalfStep ? m_alphaStep - amod : -amod);
+            quint16 *clr = laba + i * 4;
+            const int index = m_paletteMap->nearest(clr);
+
+            KIS_SAFE_ASSERT_RECOVER (index >= 0) {
+                clr[0] = 0;
+                clr[1] = 0;
+                clr[2] = 0;
+            } else {
+                const LabColor &nearest = m_palette.colors[index];
+                clr[0] = nearest.L;
+                clr[1] = nearest.a;
+                clr[2] = nearest.b;
+            }
+
+            if(m_alphaStep)
+            {
+                quint16 amod = clr[3] % m_alphaStep;
+                clr[3] = clr[3] + (amod > m_alphaHalfStep ? m_alphaStep - amod : -amod);
+            }
         }
-        m_colorSpace->fromLabA16(reinterpret_cast<quint8 *>(clr.laba), dst, 1);
-        src += m_psize;
-        dst += m_psize;
+
+        m_colorSpace->fromLabA16(reinterpret_cast<quint8 *>(laba), dst, chunk);
+        src += chunk * m_psize;
+        dst += chunk * m_psize;
+        nPixels -= chunk;
     }
 }
 
@@ -12,6 +12,7 @@
 #include "filter/kis_color_transformation_filter.h"
 #include "kis_config_widget.h"
 #include <KoColor.h>
+#include <KoPaletteMap.h>
 
 #include "indexcolorpalette.h"
 
@@ -46,6 +47,7 @@ private:
     const KoColorSpace* m_colorSpace;
     quint32 m_psize;
     IndexColorPalette m_palette;
+    QSharedPointer<const KoPaletteMap> m_paletteMap;
     quint16 m_alphaStep;
     quint16 m_alphaHalfStep;
 };
@@ -52,3 +52,21 @@ KoColorTransformation* KisLevelsFilter::createTransformation(const KoColorSpace*
     }
     return nullptr;
 }
+
+bool KisLevelsFilter::isPerChannelTransformation(const KoColorSpace* cs, const KisFilterConfigurationSP config) const
+{
+    const KisLevelsFilterConfiguration *config_ = dynamic_cast<const KisLevelsFilterConfiguration*>(config.data());
+    if (!config_) return false;
+
+    if (config_->useLightnessMode()) {
+        // the lightness is adjusted in Lab, which mixes the channels
+        return config_->lightnessLevelsCurve().isIdentity();
+    }
+
+    QList<bool> isIdentityList;
+    for (const KisLevelsCurve &levelsCurve : config_->levelsCurves()) {
+        isIdentityList.append(levelsCurve.isIdentity());
+    }
+
+    return KisMultiChannelUtils::isPerChannelTransformation(cs, isIdentityList);
+}
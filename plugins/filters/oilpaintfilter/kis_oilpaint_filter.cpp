@@ -19,6 +19,8 @@
 #include <QPoint>
 #include <QSpinBox>
 #include <QDateTime>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <klocalizedstring.h>
 #include <kis_debug.h>
@@ -28,7 +30,6 @@
 
 #include <KisDocument.h>
 #include <kis_image.h>
-#include <KisSequentialIteratorProgress.h>
 #include <kis_layer.h>
 #include <filter/kis_filter_registry.h>
 #include <kis_global.h>
@@ -37,6 +38,8 @@
 #include <filter/kis_filter_configuration.h>
 #include <kis_processing_information.h>
 #include <kis_paint_device.h>
+#include <kis_iterator_ng.h>
+#include <tiles3/kis_tile_data_interface.h>
 #include "widgets/kis_multi_integer_filter_widget.h"
 #include <KisGlobalResourcesInterface.h>
 
@@ -67,122 +70,287 @@ void KisOilPaintFilter::processImpl(KisPaintDeviceSP device,
 
 /* Function to apply the OilPaint effect.
  *
- * data             => The image data in RGBA mode.
- * w                => Width of image.
- * h                => Height of image.
  * BrushSize        => Brush size.
  * Smoothness       => Smooth value.
  *
- * Theory           => Using MostFrequentColor function we take the main color in
- *                     a matrix and simply write at the original position.
+ * Theory           => Every pixel takes the average color of the most frequent
+ *                     intensity in the (2 * BrushSize + 1)^2 square around it.
+ *
+ * The histograms of the squares are not recalculated for every pixel.
+ * The rect is split into tile-aligned vertical strips, which are processed
+ * in parallel from top to bottom. Every strip keeps the histograms of the
+ * columns of the square height, moving down a row updates each of them
+ * with one pixel. Moving right along the row updates the histogram of the
+ * square either with the histograms of the entering and the leaving columns
+ * (Perreault-Hebert) or, for small brushes, with the pixels of those
+ * columns directly, so the cost per pixel doesn't depend on the brush size.
  */
 
-void KisOilPaintFilter::OilPaint(const KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &applyRect,
-                                 int BrushSize, int Smoothness, KoUpdater* progressUpdater) const
+namespace {
+
+/**
+ * The pixels of the source converted into the form used by the histograms.
+ * The bin is -1 for the fully transparent pixels, they are not counted.
+ */
+struct OilPaintRow
 {
-    KisSequentialConstIteratorProgress it(src, applyRect, progressUpdater);
-    KisSequentialIterator dstIt(dst, applyRect);
+    QVector<int> bins;
+    QVector<qreal> opacities;
+    QVector<float> channels;
+};
 
-    while (it.nextPixel() && dstIt.nextPixel()) {
-        MostFrequentColor(src, dstIt.rawData(), applyRect, it.x(), it.y(), BrushSize, Smoothness);
+/**
+ * Counters and sums of the normalized channels per intensity bin
+ */
+struct OilPaintHistogram
+{
+    OilPaintHistogram(int numBins, int numChannels)
+        : counts(numBins, 0),
+          sums(numBins * numChannels, 0.0),
+          numChannels(numChannels)
+    {
     }
-}
 
-// This method has been ported from Pieter Z. Voloshyn's algorithm code in Digikam.
+    inline void addPixel(const OilPaintRow &row, int index, int sign) {
+        const int bin = row.bins[index];
+        if (bin < 0) return;
 
-/* Function to determine the most frequent color in a matrix
- *
- * Bits             => Bits array
- * Width            => Image width
- * Height           => Image height
- * X                => Position horizontal
- * Y                => Position vertical
- * Radius           => Is the radius of the matrix to be analyzed
- * Intensity        => Intensity to calculate
- *
- * Theory           => This function creates a matrix with the analyzed pixel in
- *                     the center of this matrix and find the most frequent color
- */
+        counts[bin] += sign;
 
-void KisOilPaintFilter::MostFrequentColor(KisPaintDeviceSP src, quint8* dst, const QRect& /*bounds*/, int X, int Y, int Radius, int Intensity) const
+        double *sum = sums.data() + bin * numChannels;
+        const float *channel = row.channels.constData() + index * numChannels;
+        for (int k = 0; k < numChannels; k++) {
+            sum[k] += sign * channel[k];
+        }
+    }
+
+    inline void addHistogram(const OilPaintHistogram &rhs, int sign) {
+        for (int i = 0; i < counts.size(); i++) {
+            counts[i] += sign * rhs.counts[i];
+        }
+        for (int i = 0; i < sums.size(); i++) {
+            sums[i] += sign * rhs.sums[i];
+        }
+    }
+
+    inline void clear() {
+        counts.fill(0);
+        sums.fill(0.0);
+    }
+
+    QVector<int> counts;
+    QVector<double> sums;
+    int numChannels;
+};
+
+QVector<QRect> splitIntoColumns(const QRect &rect, int origin, int stripWidth)
 {
-    uint I;
+    QVector<QRect> strips;
+
+    int left = rect.left();
+    while (left <= rect.right()) {
+        const int offset = (left - origin) % stripWidth;
+        const int width = qMin(stripWidth - (offset < 0 ? offset + stripWidth : offset),
+                               rect.right() - left + 1);
+        strips.append(QRect(left, rect.top(), width, rect.height()));
+        left += width;
+    }
 
-    double Scale = Intensity / 255.0;
+    return strips;
+}
 
-    // Alloc some arrays to be used
-    uchar *IntensityCount = new uchar[(Intensity + 1)];
+void readRow(KisPaintDeviceSP src, int x, int y, int width, int intensity, OilPaintRow &row)
+{
+    const KoColorSpace *cs = src->colorSpace();
+    const int numChannels = cs->channelCount();
+    const double scale = intensity / 255.0;
 
-    const KoColorSpace* cs = src->colorSpace();
+    QVector<float> channel(numChannels);
+    KisHLineConstIteratorSP it = src->createHLineConstIteratorNG(x, y, width);
 
-    QVector<float> channel(cs->channelCount());
-    QVector<float>* AverageChannels = new QVector<float>[(Intensity + 1)];
+    for (int i = 0; i < width; i++) {
+        const quint8 *pixel = it->oldRawData();
 
-    // Erase the array
-    memset(IntensityCount, 0, (Intensity + 1) * sizeof(uchar));
+        row.opacities[i] = cs->opacityF(pixel);
 
-    int startx = X - Radius;
-    int starty = Y - Radius;
-    int width = (2 * Radius) + 1;
-    int height = (2 * Radius) + 1;
+        // if the pixel is transparent, it's not going to provide any useful information
+        if (cs->opacityU8(pixel) == 0) {
+            row.bins[i] = -1;
+        } else {
+            row.bins[i] = int(cs->intensity8(pixel) * scale);
+            cs->normalisedChannelsValue(pixel, channel);
+            std::copy(channel.constBegin(), channel.constEnd(),
+                      row.channels.begin() + i * numChannels);
+        }
 
-    qreal middlePointAlpha = 1;
-    {
-        // if the current pixel is transparent, the result must be transparent, too.
-        KisSequentialConstIterator middlePointIt(src, QRect(X, Y, 1, 1));
-        middlePointIt.nextPixel();
-        middlePointAlpha = cs->opacityF(middlePointIt.oldRawData());
+        it->nextPixel();
     }
+}
 
+void processStrip(KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &strip,
+                  int radius, int intensity)
+{
+    const KoColorSpace *cs = src->colorSpace();
+    const int numChannels = cs->channelCount();
+    const int numBins = intensity + 1;
+    const int window = 2 * radius + 1;
+    const int numColumns = strip.width() + 2 * radius;
+    const int left = strip.left() - radius;
+
+    /**
+     * Adding and removing the column histograms costs the same for
+     * any radius, but for the small ones it is cheaper to add and
+     * remove the pixels of the columns themselves
+     */
+    const bool useColumnHistograms = 2 * window > numBins;
+
+    // the rows of the window and the one that has just left it
+    const int numRows = window + 1;
+    QVector<OilPaintRow> rows(numRows);
+    for (OilPaintRow &row : rows) {
+        row.bins.resize(numColumns);
+        row.opacities.resize(numColumns);
+        row.channels.resize(numColumns * numChannels);
+    }
+    auto rowAt = [&] (int y) -> OilPaintRow& {
+        return rows[(y - strip.top() + numRows) % numRows];
+    };
 
-    KisSequentialConstIterator srcIt(src, QRect(startx, starty, width, height));
-    while (middlePointAlpha > 0 && srcIt.nextPixel()) {
+    std::vector<OilPaintHistogram> columns;
+    if (useColumnHistograms) {
+        columns.assign(numColumns, OilPaintHistogram(numBins, numChannels));
+    }
+
+    OilPaintHistogram histogram(numBins, numChannels);
+    QVector<float> channel(numChannels);
 
-        cs->normalisedChannelsValue(srcIt.oldRawData(), channel);
+    for (int y = strip.top() - radius; y < strip.top() + radius; y++) {
+        OilPaintRow &row = rowAt(y);
+        readRow(src, left, y, numColumns, intensity, row);
 
-        if (cs->opacityU8(srcIt.oldRawData()) == 0) {
-            // if the pixel is transparent, it's not going to provide any useful information
-            continue;
+        if (useColumnHistograms) {
+            for (int c = 0; c < numColumns; c++) {
+                columns[c].addPixel(row, c, 1);
+            }
         }
+    }
 
-        I = (uint)(cs->intensity8(srcIt.oldRawData()) * Scale);
+    KisHLineIteratorSP dstIt = dst->createHLineIteratorNG(strip.left(), strip.top(), strip.width());
 
-        IntensityCount[I]++;
+    for (int y = strip.top(); y <= strip.bottom(); y++) {
+        OilPaintRow &enteringRow = rowAt(y + radius);
+        readRow(src, left, y + radius, numColumns, intensity, enteringRow);
 
-        if (IntensityCount[I] == 1) {
-            AverageChannels[I] = channel;
-        } else {
-            for (int i = 0; i < channel.size(); i++) {
-                AverageChannels[I][i] += channel[i];
+        if (useColumnHistograms) {
+            const OilPaintRow &leavingRow = rowAt(y - radius - 1);
+            const bool hasLeavingRow = y > strip.top();
+
+            for (int c = 0; c < numColumns; c++) {
+                columns[c].addPixel(enteringRow, c, 1);
+                if (hasLeavingRow) {
+                    columns[c].addPixel(leavingRow, c, -1);
+                }
             }
         }
-    }
 
-    I = 0;
-    int MaxInstance = 0;
+        const OilPaintRow &middleRow = rowAt(y);
+
+        for (int i = 0; i < strip.width(); i++) {
+            if (i == 0) {
+                histogram.clear();
+
+                for (int c = 0; c < window; c++) {
+                    if (useColumnHistograms) {
+                        histogram.addHistogram(columns[c], 1);
+                    } else {
+                        for (int r = y - radius; r <= y + radius; r++) {
+                            histogram.addPixel(rowAt(r), c, 1);
+                        }
+                    }
+                }
+            } else if (useColumnHistograms) {
+                histogram.addHistogram(columns[i + window - 1], 1);
+                histogram.addHistogram(columns[i - 1], -1);
+            } else {
+                for (int r = y - radius; r <= y + radius; r++) {
+                    const OilPaintRow &row = rowAt(r);
+                    histogram.addPixel(row, i + window - 1, 1);
+                    histogram.addPixel(row, i - 1, -1);
+                }
+            }
+
+            quint8 *dstPixel = dstIt->rawData();
+
+            // if the current pixel is transparent, the result must be transparent, too.
+            const qreal middlePointAlpha = middleRow.opacities[i + radius];
+
+            int I = 0;
+            int MaxInstance = 0;
+
+            if (middlePointAlpha > 0) {
+                for (int bin = 0; bin < numBins; bin++) {
+                    if (histogram.counts[bin] > MaxInstance) {
+                        I = bin;
+                        MaxInstance = histogram.counts[bin];
+                    }
+                }
+            }
+
+            if (MaxInstance != 0) {
+                const double *sum = histogram.sums.constData() + I * numChannels;
+                for (int k = 0; k < numChannels; k++) {
+                    channel[k] = sum[k] / MaxInstance;
+                }
+                cs->fromNormalisedChannelsValue(dstPixel, channel);
+                cs->setOpacity(dstPixel, OPACITY_OPAQUE_U8, middlePointAlpha);
+            } else {
+                memset(dstPixel, 0, cs->pixelSize());
+                cs->setOpacity(dstPixel, OPACITY_OPAQUE_U8, middlePointAlpha);
+            }
 
-    for (int i = 0 ; i <= Intensity ; ++i) {
-        if (IntensityCount[i] > MaxInstance) {
-            I = i;
-            MaxInstance = IntensityCount[i];
+            dstIt->nextPixel();
         }
+
+        dstIt->nextRow();
     }
+}
+
+}
+
+void KisOilPaintFilter::OilPaint(const KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &applyRect,
+                                 int BrushSize, int Smoothness, KoUpdater* progressUpdater) const
+{
+    /**
+     * When the filter works in place, the strips read a snapshot of
+     * the source to not see the pixels already written by the others.
+     * The tiles are shared with the source until they are changed.
+     */
+    KisPaintDeviceSP source = src == dst ? KisPaintDeviceSP(new KisPaintDevice(*src)) : src;
 
-    if (MaxInstance != 0) {
-        channel = AverageChannels[I];
-        for (int i = 0; i < channel.size(); i++) {
-            channel[i] /= MaxInstance;
+    const int tileSize = KisTileData::WIDTH;
+    const int stripWidth = tileSize * qMax(1, (4 * BrushSize + tileSize - 1) / tileSize);
+
+    QVector<QRect> strips = splitIntoColumns(applyRect, dst->x(), stripWidth);
+
+    // the strips are processed in batches to be able to report the progress
+    const int batchSize = qMax(1, QThread::idealThreadCount());
+
+    for (int i = 0; i < strips.size(); i += batchSize) {
+        if (progressUpdater) {
+            progressUpdater->setProgress(100 * i / strips.size());
         }
-        cs->fromNormalisedChannelsValue(dst, channel);
-        cs->setOpacity(dst, OPACITY_OPAQUE_U8, middlePointAlpha);
-    } else {
-        memset(dst, 0, cs->pixelSize());
-        cs->setOpacity(dst, OPACITY_OPAQUE_U8, middlePointAlpha);
-    }
 
+        QVector<QRect> batch = strips.mid(i, batchSize);
 
-    delete [] IntensityCount;        // free all the arrays
-    delete [] AverageChannels;
+        QtConcurrent::blockingMap(batch,
+            [&] (const QRect &strip) {
+                processStrip(source, dst, strip, BrushSize, Smoothness);
+            });
+    }
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(100);
+    }
 }
 
 QRect KisOilPaintFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int /*lod*/) const
@@ -202,7 +370,7 @@ QRect KisOilPaintFilter::changedRect(const QRect & rect, const KisFilterConfigur
 KisConfigWidget * KisOilPaintFilter::createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP, bool) const
 {
     vKisIntegerWidgetParam param;
-    param.push_back(KisIntegerWidgetParam(1, 5, 1, i18n("Brush size"), "brushSize"));
+    param.push_back(KisIntegerWidgetParam(1, 50, 1, i18n("Brush size"), "brushSize"));
     param.push_back(KisIntegerWidgetParam(10, 255, 30, i18nc("smooth out the painting strokes the filter creates", "Smooth"), "smooth"));
     KisMultiIntegerFilterWidget * w = new KisMultiIntegerFilterWidget(id().id(),  parent,  id().id(),  param);
     w->setConfiguration(defaultConfiguration(KisGlobalResourcesInterface::instance()));
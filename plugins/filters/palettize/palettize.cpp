@@ -8,6 +8,10 @@
 
 #include "palettize.h"
 
+#include <QSet>
+#include <QThread>
+#include <QtConcurrent>
+
 #include <kis_types.h>
 #include <kpluginfactory.h>
 #include <kis_config_widget.h>
@@ -15,7 +19,10 @@
 #include <kis_filter_configuration.h>
 #include <kis_filter_category_ids.h>
 #include <KoUpdater.h>
-#include <KisSequentialIteratorProgress.h>
+#include <KoPaletteMap.h>
+#include <KoColorConversionTransformation.h>
+#include <kis_iterator_ng.h>
+#include <tiles3/kis_tile_data_interface.h>
 #include <KisResourceItemChooser.h>
 #include <KoColorSet.h>
 #include <KoPattern.h>
@@ -243,17 +250,18 @@ void KisFilterPalettize::processImpl(KisPaintDeviceSP device, const QRect& apply
 
     const quint8 colorCount = ditherEnabled && colorMode == ColorMode::NearestColors ? 2 : 1;
 
-    using SearchColor = boost::geometry::model::point<quint16, 3, boost::geometry::cs::cartesian>;
-    struct ColorCandidate {
+    if (!palette) return;
+
+    struct PaletteEntry {
         KoColor color;
         quint16 index;
-        double distance;
     };
-    using SearchEntry = std::pair<SearchColor, ColorCandidate>;
-    boost::geometry::index::rtree<SearchEntry, boost::geometry::index::quadratic<16>> rtree;
+    QVector<KoPaletteMap::Color> searchColors;
+    QVector<PaletteEntry> entries;
 
-    if (palette) {
-        // Add palette colors to search tree
+    {
+        // Add palette colors to search map
+        QSet<quint64> addedColors;
         quint16 index = 0;
         for (int row = 0; row < palette->rowCount(); ++row) {
             for (int column = 0; column < palette->columnCount(); ++column) {
@@ -261,87 +269,143 @@ void KisFilterPalettize::processImpl(KisPaintDeviceSP device, const QRect& apply
                 if (swatch.isValid()) {
                     KoColor color = swatch.color().convertedTo(colorspace);
                     KoColor workColor = swatch.color().convertedTo(workColorspace);
-                    SearchColor searchColor;
-                    memcpy(&searchColor, workColor.data(), sizeof(SearchColor));
+                    KoPaletteMap::Color searchColor;
+                    memcpy(searchColor.data(), workColor.data(), sizeof(KoPaletteMap::Color));
                     // Don't add duplicates so won't dither between identical colors
-                    std::vector<SearchEntry> result;
-                    rtree.query(boost::geometry::index::contains(searchColor), std::back_inserter(result));
-                    if (result.empty()) rtree.insert(SearchEntry(searchColor, {color, index, 0.0}));
+                    const quint64 key = quint64(searchColor[0]) | quint64(searchColor[1]) << 16 | quint64(searchColor[2]) << 32;
+                    if (!addedColors.contains(key)) {
+                        addedColors.insert(key);
+                        searchColors.append(searchColor);
+                        entries.append({color, index});
+                    }
                 }
                 ++index;
             }
         }
+    }
 
-        KisDitherUtil ditherUtil;
-        if (ditherEnabled) ditherUtil.setConfiguration(*config, "dither/");
+    if (searchColors.isEmpty()) return;
 
-        KisDitherUtil alphaDitherUtil;
-        if (alphaMode == AlphaMode::Dither) alphaDitherUtil.setConfiguration(*config, "alphaDither/");
+    const QSharedPointer<const KoPaletteMap> paletteMap =
+        KoPaletteMap::cachedMap(searchColors, {1.0f, 1.0f, 1.0f}, colorCount);
 
-        KisSequentialIteratorProgress pixel(device, applyRect, progressUpdater);
-        while (pixel.nextPixel()) {
-            KoColor workColor(pixel.oldRawData(), colorspace);
-            workColor.convertTo(workColorspace);
+    KisDitherUtil ditherUtil;
+    if (ditherEnabled) ditherUtil.setConfiguration(*config, "dither/");
 
-            // Find dither threshold
-            double threshold = 0.5;
-            if (ditherEnabled) {
-                threshold = ditherUtil.threshold(QPoint(pixel.x(), pixel.y()));
+    KisDitherUtil alphaDitherUtil;
+    if (alphaMode == AlphaMode::Dither) alphaDitherUtil.setConfiguration(*config, "alphaDither/");
 
-                // Traditional per-channel ordered dithering
-                if (colorMode == ColorMode::PerChannelOffset) {
-                    QVector<float> normalized(int(workColorspace->channelCount()));
-                    workColorspace->normalisedChannelsValue(workColor.data(), normalized);
-                    for (int channel = 0; channel < int(workColorspace->channelCount()); ++channel) {
-                        normalized[channel] += (threshold - 0.5) * offsetScale;
-                    }
-                    workColorspace->fromNormalisedChannelsValue(workColor.data(), normalized);
-                }
-            }
+    const int pixelSize = colorspace->pixelSize();
+    const int workPixelSize = workColorspace->pixelSize();
 
-            // Get candidate colors and their distances
-            SearchColor searchColor;
-            memcpy(reinterpret_cast<quint8 *>(&searchColor), workColor.data(), sizeof(SearchColor));
-            std::vector<ColorCandidate> candidateColors;
-            candidateColors.reserve(size_t(colorCount));
-            double distanceSum = 0.0;
-            for (auto it = rtree.qbegin(boost::geometry::index::nearest(searchColor, colorCount)); it != rtree.qend() && candidateColors.size() < colorCount; ++it) {
-                ColorCandidate candidate = it->second;
-                candidate.distance = boost::geometry::distance(searchColor, it->first);
-                candidateColors.push_back(candidate);
-                distanceSum += candidate.distance;
-            }
+    auto processStrip = [&] (const QRect &strip) {
+        KisDitherUtil localDitherUtil = ditherUtil;
+        KisDitherUtil localAlphaDitherUtil = alphaDitherUtil;
 
-            // Select color candidate
-            quint16 selected;
-            if (ditherEnabled && colorMode == ColorMode::NearestColors) {
-                // Sort candidates by palette order for stable dither color ordering
-                const bool swap = candidateColors[0].index > candidateColors[1].index;
-                selected = swap ^ (candidateColors[swap].distance / distanceSum > threshold);
-            }
-            else {
-                selected = 0;
+        QVector<quint8> srcRow(strip.width() * pixelSize);
+        QVector<quint8> workRow(strip.width() * workPixelSize);
+        QVector<float> normalized(int(workColorspace->channelCount()));
+
+        KisHLineConstIteratorSP srcIt = device->createHLineConstIteratorNG(strip.x(), strip.y(), strip.width());
+        KisHLineIteratorSP dstIt = device->createHLineIteratorNG(strip.x(), strip.y(), strip.width());
+
+        for (int y = strip.top(); y <= strip.bottom(); ++y) {
+            // Convert the whole row into the search colorspace at once
+            for (int i = 0; i < strip.width(); ++i) {
+                memcpy(srcRow.data() + i * pixelSize, srcIt->oldRawData(), pixelSize);
+                srcIt->nextPixel();
             }
-            ColorCandidate &candidate = candidateColors[selected];
-
-            // Set alpha
-            const double oldAlpha = colorspace->opacityF(pixel.oldRawData());
-            double newAlpha = oldAlpha;
-            if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
-                if (alphaMode == AlphaMode::Clip) {
-                    newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
+            srcIt->nextRow();
+
+            colorspace->convertPixelsTo(srcRow.constData(), workRow.data(), workColorspace, strip.width(),
+                                        KoColorConversionTransformation::internalRenderingIntent(),
+                                        KoColorConversionTransformation::internalConversionFlags());
+
+            for (int i = 0; i < strip.width(); ++i) {
+                const QPoint pos(strip.x() + i, y);
+                quint8 *workColor = workRow.data() + i * workPixelSize;
+
+                // Find dither threshold
+                double threshold = 0.5;
+                if (ditherEnabled) {
+                    threshold = localDitherUtil.threshold(pos);
+
+                    // Traditional per-channel ordered dithering
+                    if (colorMode == ColorMode::PerChannelOffset) {
+                        workColorspace->normalisedChannelsValue(workColor, normalized);
+                        for (int channel = 0; channel < int(workColorspace->channelCount()); ++channel) {
+                            normalized[channel] += (threshold - 0.5) * offsetScale;
+                        }
+                        workColorspace->fromNormalisedChannelsValue(workColor, normalized);
+                    }
                 }
-                else if (alphaMode == AlphaMode::Index) {
-                    newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
+
+                // Get candidate colors and their distances
+                KoPaletteMap::Match candidates[2];
+                const int numCandidates =
+                    paletteMap->nearestMatches(reinterpret_cast<const quint16*>(workColor), candidates);
+
+                // Select color candidate
+                int selected = 0;
+                if (ditherEnabled && colorMode == ColorMode::NearestColors && numCandidates == 2) {
+                    // Sort candidates by palette order for stable dither color ordering
+                    const double distanceSum = candidates[0].distance + candidates[1].distance;
+                    const bool swap = entries[candidates[0].index].index > entries[candidates[1].index].index;
+                    selected = swap ^ (candidates[swap].distance / distanceSum > threshold);
                 }
-                else if (alphaMode == AlphaMode::Dither) {
-                    newAlpha = oldAlpha < alphaDitherUtil.threshold(QPoint(pixel.x(), pixel.y())) ? 0.0 : 1.0;
+                const PaletteEntry &candidate = entries[candidates[selected].index];
+
+                // Set alpha
+                const double oldAlpha = colorspace->opacityF(srcRow.constData() + i * pixelSize);
+                double newAlpha = oldAlpha;
+                if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
+                    if (alphaMode == AlphaMode::Clip) {
+                        newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
+                    }
+                    else if (alphaMode == AlphaMode::Index) {
+                        newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
+                    }
+                    else if (alphaMode == AlphaMode::Dither) {
+                        newAlpha = oldAlpha < localAlphaDitherUtil.threshold(pos) ? 0.0 : 1.0;
+                    }
                 }
+
+                // Copy color to pixel
+                quint8 *dst = dstIt->rawData();
+                memcpy(dst, candidate.color.data(), pixelSize);
+                colorspace->setOpacity(dst, newAlpha, 1);
+                dstIt->nextPixel();
             }
-            colorspace->setOpacity(candidate.color.data(), newAlpha, 1);
+            dstIt->nextRow();
+        }
+    };
 
-            // Copy color to pixel
-            memcpy(pixel.rawData(), candidate.color.data(), colorspace->pixelSize());
+    // The pixels don't depend on each other, so the rect is processed in
+    // tile-aligned strips in parallel. The strips are run in batches to be
+    // able to report the progress.
+    const int tileSize = KisTileData::HEIGHT;
+    QVector<QRect> strips;
+    for (int top = applyRect.top(); top <= applyRect.bottom(); ) {
+        const int offset = (top - device->y()) % tileSize;
+        const int height = qMin(tileSize - (offset < 0 ? offset + tileSize : offset),
+                                applyRect.bottom() - top + 1);
+        strips.append(QRect(applyRect.x(), top, applyRect.width(), height));
+        top += height;
+    }
+
+    const int batchSize = qMax(1, QThread::idealThreadCount());
+
+    for (int i = 0; i < strips.size(); i += batchSize) {
+        if (progressUpdater) {
+            progressUpdater->setProgress(100 * i / strips.size());
         }
+
+        QVector<QRect> batch = strips.mid(i, batchSize);
+        QtConcurrent::blockingMap(batch, processStrip);
+    }
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(100);
     }
 }
+
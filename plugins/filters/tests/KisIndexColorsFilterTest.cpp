@@ -0,0 +1,58 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisIndexColorsFilterTest.h"
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisGlobalResourcesInterface.h>
+
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include "kis_paint_device.h"
+#include <testutil.h>
+
+#include "../indexcolors/palettegeneratorconfig.h"
+
+#include <kistest.h>
+
+void KisIndexColorsFilterTest::testEmptyPalette()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rect(0, 0, 100, 100);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(rect, KoColor(QColor(200, 100, 50), cs));
+
+    KisPaintDeviceSP original = new KisPaintDevice(*dev);
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value("indexcolors");
+    QVERIFY(filter);
+
+    // untick every swatch of the generator, the palette becomes empty
+    PaletteGeneratorConfig palCfg;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            palCfg.colorsEnabled[i][j] = false;
+        }
+    }
+    QCOMPARE(palCfg.generate().numColors(), 0);
+
+    KisFilterConfigurationSP config = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    config->setProperty("paletteGen", palCfg.toByteArray());
+    config->createLocalResourcesSnapshot(KisGlobalResourcesInterface::instance());
+
+    filter->process(dev, rect, config);
+
+    // there is nothing to map the pixels to, so they are left untouched
+    QPoint errorPoint;
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, original, dev));
+}
+
+KISTEST_MAIN(KisIndexColorsFilterTest)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISINDEXCOLORSFILTERTEST_H
+#define KISINDEXCOLORSFILTERTEST_H
+
+#include <simpletest.h>
+
+class KisIndexColorsFilterTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEmptyPalette();
+};
+
+#endif // KISINDEXCOLORSFILTERTEST_H
@@ -0,0 +1,67 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOilPaintFilterBenchmark.h"
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisGlobalResourcesInterface.h>
+
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include "kis_iterator_ng.h"
+#include "kis_paint_device.h"
+
+#include <kistest.h>
+
+void KisOilPaintFilterBenchmark::benchmarkFilter_data()
+{
+    QTest::addColumn<int>("brushSize");
+    QTest::addColumn<int>("smooth");
+
+    QTest::newRow("r1-s30") << 1 << 30;
+    QTest::newRow("r5-s30") << 5 << 30;
+    QTest::newRow("r10-s30") << 10 << 30;
+    QTest::newRow("r25-s30") << 25 << 30;
+    QTest::newRow("r10-s255") << 10 << 255;
+}
+
+void KisOilPaintFilterBenchmark::benchmarkFilter()
+{
+    QFETCH(int, brushSize);
+    QFETCH(int, smooth);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rect(0, 0, 2000, 2000);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    KoColor color(cs);
+
+    srand(31524744);
+
+    KisSequentialIterator it(dev, rect);
+    while (it.nextPixel()) {
+        color.fromQColor(QColor(rand() % 255, rand() % 255, rand() % 255));
+        memcpy(it.rawData(), color.data(), cs->pixelSize());
+    }
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value("oilpaint");
+    QVERIFY(filter);
+
+    KisFilterConfigurationSP config = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    config->setProperty("brushSize", brushSize);
+    config->setProperty("smooth", smooth);
+    config->createLocalResourcesSnapshot(KisGlobalResourcesInterface::instance());
+
+    QBENCHMARK_ONCE {
+        filter->process(dev, rect, config);
+    }
+}
+
+KISTEST_MAIN(KisOilPaintFilterBenchmark)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOILPAINTFILTERBENCHMARK_H
+#define KISOILPAINTFILTERBENCHMARK_H
+
+#include <simpletest.h>
+
+class KisOilPaintFilterBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkFilter_data();
+    void benchmarkFilter();
+};
+
+#endif // KISOILPAINTFILTERBENCHMARK_H
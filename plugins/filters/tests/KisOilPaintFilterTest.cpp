@@ -0,0 +1,181 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOilPaintFilterTest.h"
+
+#include <QRandomGenerator>
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisGlobalResourcesInterface.h>
+
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include "kis_iterator_ng.h"
+#include "kis_random_accessor_ng.h"
+#include "kis_paint_device.h"
+
+#include <kistest.h>
+
+namespace {
+
+/**
+ * The per-pixel histogram of the original implementation of the
+ * filter, with int counters and double sums
+ */
+void referenceOilPaint(KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &rect,
+                       int radius, int intensity)
+{
+    const KoColorSpace *cs = src->colorSpace();
+    const int numChannels = cs->channelCount();
+    const int numBins = intensity + 1;
+    const double scale = intensity / 255.0;
+
+    QVector<int> counts(numBins);
+    QVector<double> sums(numBins * numChannels);
+    QVector<float> channel(numChannels);
+
+    KisRandomConstAccessorSP srcIt = src->createRandomConstAccessorNG();
+    KisSequentialIterator dstIt(dst, rect);
+
+    while (dstIt.nextPixel()) {
+        const int x = dstIt.x();
+        const int y = dstIt.y();
+
+        counts.fill(0);
+        sums.fill(0.0);
+
+        srcIt->moveTo(x, y);
+        const qreal middlePointAlpha = cs->opacityF(srcIt->rawDataConst());
+
+        if (middlePointAlpha > 0) {
+            for (int sy = y - radius; sy <= y + radius; sy++) {
+                for (int sx = x - radius; sx <= x + radius; sx++) {
+                    srcIt->moveTo(sx, sy);
+                    const quint8 *pixel = srcIt->rawDataConst();
+
+                    if (cs->opacityU8(pixel) == 0) continue;
+
+                    const int bin = int(cs->intensity8(pixel) * scale);
+                    cs->normalisedChannelsValue(pixel, channel);
+
+                    counts[bin]++;
+                    for (int k = 0; k < numChannels; k++) {
+                        sums[bin * numChannels + k] += channel[k];
+                    }
+                }
+            }
+        }
+
+        int I = 0;
+        int maxInstance = 0;
+
+        for (int bin = 0; bin < numBins; bin++) {
+            if (counts[bin] > maxInstance) {
+                I = bin;
+                maxInstance = counts[bin];
+            }
+        }
+
+        quint8 *dstPixel = dstIt.rawData();
+
+        if (maxInstance != 0) {
+            for (int k = 0; k < numChannels; k++) {
+                channel[k] = sums[I * numChannels + k] / maxInstance;
+            }
+            cs->fromNormalisedChannelsValue(dstPixel, channel);
+        } else {
+            memset(dstPixel, 0, cs->pixelSize());
+        }
+        cs->setOpacity(dstPixel, OPACITY_OPAQUE_U8, middlePointAlpha);
+    }
+}
+
+}
+
+void KisOilPaintFilterTest::testMatchesBruteForce_data()
+{
+    QTest::addColumn<int>("brushSize");
+    QTest::addColumn<int>("smooth");
+
+    // the filter switches to the column histograms when 2 * (2 * brushSize + 1) > smooth + 1
+    QTest::newRow("r1-s30-pixels") << 1 << 30;
+    QTest::newRow("r5-s30-pixels") << 5 << 30;
+    QTest::newRow("r5-s10-columns") << 5 << 10;
+    QTest::newRow("r8-s30-columns") << 8 << 30;
+    QTest::newRow("r12-s255-pixels") << 12 << 255;
+    QTest::newRow("r20-s40-columns") << 20 << 40;
+}
+
+void KisOilPaintFilterTest::testMatchesBruteForce()
+{
+    QFETCH(int, brushSize);
+    QFETCH(int, smooth);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    // not aligned to the tiles, so that the strips have different widths
+    const QRect rect(13, 7, 150, 130);
+    const QRect fillRect = rect.adjusted(-2 * brushSize, -2 * brushSize, 2 * brushSize, 2 * brushSize);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    /**
+     * Blocks of similar colors make some intensities frequent, the
+     * noise and the transparent pixels check the ties and the skipped
+     * pixels of the histograms
+     */
+    QRandomGenerator rnd(31524744);
+    KoColor color(cs);
+
+    KisSequentialIterator it(dev, fillRect);
+    while (it.nextPixel()) {
+        const int block = (it.x() / 8) * 31 + (it.y() / 8) * 17;
+        const int noise = rnd.bounded(24);
+        const int alpha = rnd.bounded(10) == 0 ? 0 : rnd.bounded(10) == 0 ? 128 : 255;
+
+        color.fromQColor(QColor((block * 7 + noise) % 256,
+                                (block * 13 + noise) % 256,
+                                (block * 3 + 2 * noise) % 256,
+                                alpha));
+        memcpy(it.rawData(), color.data(), cs->pixelSize());
+    }
+
+    KisPaintDeviceSP reference = new KisPaintDevice(*dev);
+    referenceOilPaint(dev, reference, rect, brushSize, smooth);
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value("oilpaint");
+    QVERIFY(filter);
+
+    KisFilterConfigurationSP config = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    config->setProperty("brushSize", brushSize);
+    config->setProperty("smooth", smooth);
+    config->createLocalResourcesSnapshot(KisGlobalResourcesInterface::instance());
+
+    filter->process(dev, rect, config);
+
+    KisSequentialConstIterator resultIt(dev, rect);
+    KisSequentialConstIterator referenceIt(reference, rect);
+
+    while (resultIt.nextPixel() && referenceIt.nextPixel()) {
+        const quint8 *result = resultIt.rawDataConst();
+        const quint8 *expected = referenceIt.rawDataConst();
+
+        // the sums are updated incrementally, so the averages may round differently
+        for (int ch = 0; ch < int(cs->pixelSize()); ch++) {
+            if (qAbs(int(result[ch]) - int(expected[ch])) > 1) {
+                qDebug() << "pixel" << resultIt.x() << resultIt.y() << "channel" << ch
+                         << "expected" << expected[ch] << "result" << result[ch];
+                QFAIL("oil paint result differs from the brute force reference");
+            }
+        }
+    }
+}
+
+KISTEST_MAIN(KisOilPaintFilterTest)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOILPAINTFILTERTEST_H
+#define KISOILPAINTFILTERTEST_H
+
+#include <simpletest.h>
+
+class KisOilPaintFilterTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testMatchesBruteForce_data();
+    void testMatchesBruteForce();
+};
+
+#endif // KISOILPAINTFILTERTEST_H
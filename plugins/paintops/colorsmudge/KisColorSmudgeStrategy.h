@@ -10,6 +10,8 @@
 #include <KisOptimizedByteArray.h>
 #include <kis_dab_cache.h>
 
+class KisRunnableStrokeJobData;
+
 class KisColorSmudgeStrategy
 {
 public:
@@ -35,6 +37,28 @@ public:
                                     qreal lightnessStrengthValue,
                                     qreal smudgeRadiusValue) = 0;
 
+    /**
+     * Asynchronous version of paintDab(). Instead of painting the dab
+     * right away, appends the jobs painting it to \p jobs.
+     *
+     * The mask prepared by the last call to updateMask() is detached
+     * from the strategy, so the next dabs can be prepared before the
+     * jobs are executed. The jobs of the consecutive dabs must be
+     * executed in the order they have been added, because every dab
+     * samples the result of the previous one.
+     *
+     * @return the rects that will be changed by the jobs
+     */
+    virtual QVector<QRect> paintDabAsynchronously(const QRect &srcRect, const QRect &dstRect,
+                                                  const KoColor &currentPaintColor,
+                                                  qreal opacity,
+                                                  qreal colorRateValue,
+                                                  qreal smudgeRateValue,
+                                                  qreal maxPossibleSmudgeRateValue,
+                                                  qreal lightnessStrengthValue,
+                                                  qreal smudgeRadiusValue,
+                                                  QVector<KisRunnableStrokeJobData*> &jobs) = 0;
+
     virtual const KoColorSpace* preciseColorSpace() const = 0;
 
 protected:
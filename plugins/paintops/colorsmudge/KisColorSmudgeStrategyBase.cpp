@@ -12,10 +12,30 @@
 #include "kis_paint_device.h"
 #include "KisColorSmudgeSampleUtils.h"
 
+namespace {
+
+/**
+ * The blending functions may be called for a strip of rows of the blend
+ * device, so the data should be addressed relative to the strip
+ */
+inline quint8* stripData(KisFixedPaintDeviceSP device, const QRect &rc)
+{
+    const QRect bounds = device->bounds();
+    return device->data() +
+        ((rc.y() - bounds.y()) * bounds.width() + rc.x() - bounds.x()) * device->pixelSize();
+}
+
+}
+
 /**********************************************************************************/
 /*                 DabColoringStrategyMask                                        */
 /**********************************************************************************/
 
+KisColorSmudgeStrategyBase::DabColoringStrategy *KisColorSmudgeStrategyBase::DabColoringStrategyMask::clone() const
+{
+    return new DabColoringStrategyMask(*this);
+}
+
 bool KisColorSmudgeStrategyBase::DabColoringStrategyMask::supportsFusedDullingBlending() const
 {
     return true;
@@ -32,10 +52,11 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyMask::blendInFusedBackground
     colorRateOp->composite(dullingFillColor.data(), 1, paintColor.data(), 1, 0, 0, 1, 1, colorRateOpacity);
 
     if (smearOp->id() == COMPOSITE_COPY && smudgeRateOpacity == OPACITY_OPAQUE_U8) {
-        dst->fill(dst->bounds(), dullingFillColor);
+        dst->fill(dstRect, dullingFillColor);
     } else {
-        src->readBytes(dst->data(), dstRect);
-        smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
+        quint8 *dstPtr = stripData(dst, dstRect);
+        src->readBytes(dstPtr, dstRect);
+        smearOp->composite(dstPtr, dstRect.width() * dst->pixelSize(),
                            dullingFillColor.data(), 0,
                            0, 0,
                            1, dstRect.width() * dstRect.height(),
@@ -51,7 +72,7 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyMask::blendInColorRate(const
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN(*paintColor.colorSpace() == *colorRateOp->colorSpace());
 
-    colorRateOp->composite(dstDevice->data(), dstRect.width() * dstDevice->pixelSize(),
+    colorRateOp->composite(stripData(dstDevice, dstRect), dstRect.width() * dstDevice->pixelSize(),
                            paintColor.data(), 0,
                            0, 0,
                            dstRect.height(), dstRect.width(),
@@ -62,6 +83,18 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyMask::blendInColorRate(const
 /*                 DabColoringStrategyStamp                                       */
 /**********************************************************************************/
 
+KisColorSmudgeStrategyBase::DabColoringStrategy *KisColorSmudgeStrategyBase::DabColoringStrategyStamp::clone() const
+{
+    DabColoringStrategyStamp *strategy = new DabColoringStrategyStamp();
+
+    // the stamp is owned by the dab cache and is overwritten by the next dab
+    if (m_origDab) {
+        strategy->m_origDab = new KisFixedPaintDevice(*m_origDab);
+    }
+
+    return strategy;
+}
+
 void KisColorSmudgeStrategyBase::DabColoringStrategyStamp::setStampDab(KisFixedPaintDeviceSP device)
 {
     m_origDab = device;
@@ -78,8 +111,12 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyStamp::blendInColorRate(cons
     // TODO: check correctness for composition source device (transparency masks)
     KIS_ASSERT_RECOVER_RETURN(*dstDevice->colorSpace() == *m_origDab->colorSpace());
 
-    colorRateOp->composite(dstDevice->data(), dstRect.width() * dstDevice->pixelSize(),
-                           m_origDab->data(), dstRect.width() * m_origDab->pixelSize(),
+    // the stamp has the same size as the blend device, but may have a different origin
+    const int rowOffset = dstRect.y() - dstDevice->bounds().y();
+    const quint8 *stampPtr = m_origDab->data() + rowOffset * dstRect.width() * m_origDab->pixelSize();
+
+    colorRateOp->composite(stripData(dstDevice, dstRect), dstRect.width() * dstDevice->pixelSize(),
+                           stampPtr, dstRect.width() * m_origDab->pixelSize(),
                            0, 0,
                            dstRect.height(), dstRect.width(),
                            colorRateOpacity);
@@ -187,95 +224,168 @@ KisColorSmudgeStrategyBase::blendBrush(const QVector<KisPainter *> dstPainters,
                                        qreal smudgeRateValue, qreal maxPossibleSmudgeRateValue, qreal colorRateValue,
                                        qreal smudgeRadiusValue)
 {
-    const quint8 colorRateOpacity = this->colorRateOpacity(opacity, smudgeRateValue, colorRateValue, maxPossibleSmudgeRateValue);
+    BlendBrushState state;
+    state.srcSampleDevice = srcSampleDevice;
+    state.maskDab = maskDab;
+    state.preserveMaskDab = preserveMaskDab;
+    state.srcRect = srcRect;
+    state.dstRect = dstRect;
+    state.currentPaintColor = currentPaintColor;
+    state.opacity = opacity;
+    state.smudgeRateValue = smudgeRateValue;
+    state.maxPossibleSmudgeRateValue = maxPossibleSmudgeRateValue;
+    state.colorRateValue = colorRateValue;
+    state.smudgeRadiusValue = smudgeRadiusValue;
+    state.coloringStrategy = &this->coloringStrategy();
+
+    prepareBlendBrush(&state);
+    blendBrushRows(state, dstRect);
+
+    const bool preserveDab = preserveMaskDab && dstPainters.size() > 1;
+
+    Q_FOREACH (KisPainter *dstPainter, dstPainters) {
+        bltBrushRows(dstPainter, state, dstRect);
+        dstPainter->renderMirrorMaskSafe(dstRect, m_blendDevice, maskDab, preserveDab);
+    }
+}
+
+void KisColorSmudgeStrategyBase::prepareBlendBrush(BlendBrushState *state)
+{
+    state->colorRateOpacity = this->colorRateOpacity(state->opacity, state->smudgeRateValue,
+                                                     state->colorRateValue, state->maxPossibleSmudgeRateValue);
+    state->dullingRateOpacity = this->dullingRateOpacity(state->opacity, state->smudgeRateValue);
+    state->smearRateOpacity = this->smearRateOpacity(state->opacity, state->smudgeRateValue);
+    state->finalOpacity = this->finalPainterOpacity(state->opacity, state->smudgeRateValue);
 
     if (m_useDullingMode) {
-        this->sampleDullingColor(srcRect,
-                                 smudgeRadiusValue,
-                                 srcSampleDevice, m_blendDevice,
-                                 maskDab, &m_preparedDullingColor);
+        this->sampleDullingColor(state->srcRect,
+                                 state->smudgeRadiusValue,
+                                 state->srcSampleDevice, m_blendDevice,
+                                 state->maskDab, &m_preparedDullingColor);
 
         KIS_SAFE_ASSERT_RECOVER(*m_preparedDullingColor.colorSpace() == *m_colorRateOp->colorSpace()) {
             m_preparedDullingColor.convertTo(m_colorRateOp->colorSpace());
         }
     }
 
-    m_blendDevice->setRect(dstRect);
-    m_blendDevice->lazyGrowBufferWithoutInitialization();
-
-    DabColoringStrategy &coloringStrategy = this->coloringStrategy();
+    state->preparedDullingColor = m_preparedDullingColor;
+    state->colorRateColor = state->currentPaintColor.convertedTo(m_preparedDullingColor.colorSpace());
 
-    const quint8 dullingRateOpacity = this->dullingRateOpacity(opacity, smudgeRateValue);
-
-    if (colorRateOpacity > 0 &&
+    state->useFusedDullingBlending =
+        state->colorRateOpacity > 0 &&
         m_useDullingMode &&
-        coloringStrategy.supportsFusedDullingBlending() &&
+        state->coloringStrategy->supportsFusedDullingBlending() &&
         ((m_smearOp->id() == COMPOSITE_OVER &&
           m_colorRateOp->id() == COMPOSITE_OVER) ||
          (m_smearOp->id() == COMPOSITE_COPY &&
-          dullingRateOpacity == OPACITY_OPAQUE_U8))) {
-
-        coloringStrategy.blendInFusedBackgroundAndColorRateWithDulling(m_blendDevice,
-                                                                       srcSampleDevice,
-                                                                       dstRect,
-                                                                       m_preparedDullingColor,
-                                                                       m_smearOp,
-                                                                       dullingRateOpacity,
-                                                                       currentPaintColor.convertedTo(
-                                                                               m_preparedDullingColor.colorSpace()),
-                                                                       m_colorRateOp,
-                                                                       colorRateOpacity);
+          state->dullingRateOpacity == OPACITY_OPAQUE_U8));
+
+    m_blendDevice->setRect(state->dstRect);
+    m_blendDevice->lazyGrowBufferWithoutInitialization();
+}
+
+void KisColorSmudgeStrategyBase::blendBrushRows(const BlendBrushState &state, const QRect &rc)
+{
+    if (state.useFusedDullingBlending) {
+        state.coloringStrategy->blendInFusedBackgroundAndColorRateWithDulling(m_blendDevice,
+                                                                             state.srcSampleDevice,
+                                                                             rc,
+                                                                             state.preparedDullingColor,
+                                                                             m_smearOp,
+                                                                             state.dullingRateOpacity,
+                                                                             state.colorRateColor,
+                                                                             m_colorRateOp,
+                                                                             state.colorRateOpacity);
 
     } else {
         if (!m_useDullingMode) {
-            const quint8 smudgeRateOpacity = this->smearRateOpacity(opacity, smudgeRateValue);
-            blendInBackgroundWithSmearing(m_blendDevice, srcSampleDevice,
-                                          srcRect, dstRect, smudgeRateOpacity);
+            const QRect srcRc = rc.translated(state.srcRect.topLeft() - state.dstRect.topLeft());
+            blendInBackgroundWithSmearing(m_blendDevice, state.srcSampleDevice,
+                                          srcRc, rc, state.smearRateOpacity);
         } else {
-            blendInBackgroundWithDulling(m_blendDevice, srcSampleDevice,
-                                         dstRect,
-                                         m_preparedDullingColor, dullingRateOpacity);
+            blendInBackgroundWithDulling(m_blendDevice, state.srcSampleDevice,
+                                         rc,
+                                         state.preparedDullingColor, state.dullingRateOpacity);
         }
 
-        if (colorRateOpacity > 0) {
-            coloringStrategy.blendInColorRate(
-                    currentPaintColor.convertedTo(m_preparedDullingColor.colorSpace()),
-                    m_colorRateOp,
-                    colorRateOpacity,
-                    m_blendDevice, dstRect);
+        if (state.colorRateOpacity > 0) {
+            state.coloringStrategy->blendInColorRate(state.colorRateColor,
+                                                     m_colorRateOp,
+                                                     state.colorRateOpacity,
+                                                     m_blendDevice, rc);
         }
     }
+}
 
-    const bool preserveDab = preserveMaskDab && dstPainters.size() > 1;
+void KisColorSmudgeStrategyBase::bltBrushRows(KisPainter *dstPainter, const BlendBrushState &state, const QRect &rc)
+{
+    const int rowOffset = rc.y() - state.dstRect.y();
+
+    dstPainter->setOpacity(state.finalOpacity);
+    dstPainter->bltFixedWithFixedSelection(rc.x(), rc.y(),
+                                           m_blendDevice, state.maskDab,
+                                           state.maskDab->bounds().x(), state.maskDab->bounds().y() + rowOffset,
+                                           m_blendDevice->bounds().x(), m_blendDevice->bounds().y() + rowOffset,
+                                           rc.width(), rc.height());
+}
 
-    Q_FOREACH (KisPainter *dstPainter, dstPainters) {
-        dstPainter->setOpacity(finalPainterOpacity(opacity, smudgeRateValue));
+void KisColorSmudgeStrategyBase::renderBrushMirrors(const QVector<KisPainter *> &dstPainters,
+                                                    const BlendBrushState &state)
+{
+    for (int i = 0; i < dstPainters.size(); i++) {
+        KisPainter *dstPainter = dstPainters[i];
 
-        dstPainter->bltFixedWithFixedSelection(dstRect.x(), dstRect.y(),
-                                               m_blendDevice, maskDab,
-                                               maskDab->bounds().x(), maskDab->bounds().y(),
-                                               m_blendDevice->bounds().x(), m_blendDevice->bounds().y(),
-                                               dstRect.width(), dstRect.height());
-        dstPainter->renderMirrorMaskSafe(dstRect, m_blendDevice, maskDab, preserveDab);
+        // all the painters except the last one need the original dab
+        const bool preserveDab = state.preserveMaskDab || i < dstPainters.size() - 1;
+
+        dstPainter->setOpacity(state.finalOpacity);
+        dstPainter->renderMirrorMaskSafe(state.dstRect, m_blendDevice, state.maskDab, preserveDab);
+    }
+}
+
+QVector<QRect> KisColorSmudgeStrategyBase::splitIntoStrips(const QRect &rc)
+{
+    // the height of the tiles of KisPaintDevice
+    const int tileSize = 64;
+
+    QVector<QRect> strips;
+
+    int y = rc.top();
+    while (y <= rc.bottom()) {
+        const int nextTileY = (y >= 0 ? y / tileSize + 1 : -((-y - 1) / tileSize)) * tileSize;
+        const int bottom = qMin(rc.bottom(), nextTileY - 1);
+
+        strips << QRect(rc.left(), y, rc.width(), bottom - y + 1);
+        y = bottom + 1;
     }
 
+    return strips;
+}
+
+void KisColorSmudgeStrategyBase::initializeStripPainter(KisPainter *stripPainter, KisPainter *painter)
+{
+    stripPainter->begin(painter->device(), painter->selection());
+    stripPainter->setCompositeOpId(painter->compositeOpId());
+    stripPainter->setChannelFlags(painter->channelFlags());
 }
 
 void KisColorSmudgeStrategyBase::blendInBackgroundWithSmearing(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src,
                                                                const QRect &srcRect, const QRect &dstRect,
                                                                const quint8 smudgeRateOpacity)
 {
+    quint8 *dstPtr = stripData(dst, dstRect);
+
     if (m_smearOp->id() == COMPOSITE_COPY && smudgeRateOpacity == OPACITY_OPAQUE_U8) {
-        src->readBytes(dst->data(), srcRect);
+        src->readBytes(dstPtr, srcRect);
     } else {
-        src->readBytes(dst->data(), dstRect);
+        src->readBytes(dstPtr, dstRect);
 
         KisFixedPaintDevice tempDevice(src->colorSpace(), m_memoryAllocator);
         tempDevice.setRect(srcRect);
         tempDevice.lazyGrowBufferWithoutInitialization();
 
         src->readBytes(tempDevice.data(), srcRect);
-        m_smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
+        m_smearOp->composite(dstPtr, dstRect.width() * dst->pixelSize(),
                              tempDevice.data(), dstRect.width() * tempDevice.pixelSize(), // stride should be random non-zero
                              0, 0,
                              1, dstRect.width() * dstRect.height(),
@@ -287,14 +397,13 @@ void KisColorSmudgeStrategyBase::blendInBackgroundWithDulling(KisFixedPaintDevic
                                                               const QRect &dstRect, const KoColor &preparedDullingColor,
                                                               const quint8 smudgeRateOpacity)
 {
-    Q_UNUSED(preparedDullingColor);
-
     if (m_smearOp->id() == COMPOSITE_COPY && smudgeRateOpacity == OPACITY_OPAQUE_U8) {
-        dst->fill(dst->bounds(), m_preparedDullingColor);
+        dst->fill(dstRect, preparedDullingColor);
     } else {
-        src->readBytes(dst->data(), dstRect);
-        m_smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
-                             m_preparedDullingColor.data(), 0,
+        quint8 *dstPtr = stripData(dst, dstRect);
+        src->readBytes(dstPtr, dstRect);
+        m_smearOp->composite(dstPtr, dstRect.width() * dst->pixelSize(),
+                             preparedDullingColor.data(), 0,
                              0, 0,
                              1, dstRect.width() * dstRect.height(),
                              smudgeRateOpacity);
@@ -21,6 +21,14 @@ public:
     struct DabColoringStrategy
     {
         virtual ~DabColoringStrategy() = default;
+
+        /**
+         * Creates a copy of the strategy that doesn't share any per-dab
+         * data with the original one, so that the copy could be used by
+         * the asynchronous jobs while the next dab is being prepared
+         */
+        virtual DabColoringStrategy* clone() const = 0;
+
         virtual bool supportsFusedDullingBlending() const = 0;
         virtual void blendInColorRate(const KoColor &paintColor, const KoCompositeOp *colorRateOp, quint8 colorRateOpacity,
                                       KisFixedPaintDeviceSP dstDevice, const QRect &dstRect) const = 0;
@@ -36,6 +44,8 @@ public:
 
     struct DabColoringStrategyMask : public DabColoringStrategy
     {
+        DabColoringStrategy* clone() const override;
+
         bool supportsFusedDullingBlending() const override;
 
         void blendInColorRate(const KoColor &paintColor, const KoCompositeOp *colorRateOp, quint8 colorRateOpacity,
@@ -54,6 +64,8 @@ public:
 
     struct DabColoringStrategyStamp : public DabColoringStrategy
     {
+        DabColoringStrategy* clone() const override;
+
         void setStampDab(KisFixedPaintDeviceSP device);
 
         void blendInColorRate(const KoColor &paintColor, const KoCompositeOp *colorRateOp, quint8 colorRateOpacity,
@@ -75,6 +87,54 @@ public:
         KisFixedPaintDeviceSP m_origDab;
     };
 
+    /**
+     * The state of blending of a single dab. The blending is split into
+     * stages, so that the rows of a big dab could be processed by
+     * concurrent stroke jobs:
+     *
+     * 1) prepareBlendBrush() samples the dulling color and prepares
+     *    the blend device (sequential)
+     * 2) blendBrushRows() blends the background and the paint color
+     *    into a strip of the blend device (concurrent)
+     * 3) bltBrushRows() writes a strip of the blend device into the
+     *    destination device (concurrent)
+     * 4) renderBrushMirrors() renders the mirrored copies of the dab
+     *    (sequential)
+     *
+     * Stage 3 writes into the device stage 2 reads from, so all the
+     * strips of stage 2 must be finished before stage 3 is started.
+     */
+    struct BlendBrushState
+    {
+        KisColorSmudgeSourceSP srcSampleDevice;
+        KisFixedPaintDeviceSP maskDab;
+        bool preserveMaskDab {true};
+        QRect srcRect;
+        QRect dstRect;
+        KoColor currentPaintColor;
+        qreal opacity {1.0};
+        qreal smudgeRateValue {1.0};
+        qreal maxPossibleSmudgeRateValue {1.0};
+        qreal colorRateValue {0.0};
+        qreal smudgeRadiusValue {0.0};
+
+        const DabColoringStrategy *coloringStrategy {nullptr};
+
+        /// keeps the coloring strategy of an asynchronous dab alive
+        QSharedPointer<DabColoringStrategy> detachedColoringStrategy;
+
+        // the fields below are filled by prepareBlendBrush()
+        KoColor preparedDullingColor;
+        KoColor colorRateColor;
+        quint8 colorRateOpacity {0};
+        quint8 dullingRateOpacity {0};
+        quint8 smearRateOpacity {0};
+        quint8 finalOpacity {OPACITY_OPAQUE_U8};
+        bool useFusedDullingBlending {false};
+    };
+
+    typedef QSharedPointer<BlendBrushState> BlendBrushStateSP;
+
 public:
 
     KisColorSmudgeStrategyBase(bool useDullingMode);
@@ -108,6 +168,27 @@ public:
                     const KoColor &currentPaintColor, qreal opacity, qreal smudgeRateValue,
                     qreal maxPossibleSmudgeRateValue, qreal colorRateValue, qreal smudgeRadiusValue);
 
+    void prepareBlendBrush(BlendBrushState *state);
+
+    void blendBrushRows(const BlendBrushState &state, const QRect &rc);
+
+    void bltBrushRows(KisPainter *dstPainter, const BlendBrushState &state, const QRect &rc);
+
+    void renderBrushMirrors(const QVector<KisPainter *> &dstPainters, const BlendBrushState &state);
+
+    /**
+     * Splits \p rc into strips of rows aligned to the tiles of the paint
+     * device, so that the concurrent jobs never write into the same tile
+     */
+    static QVector<QRect> splitIntoStrips(const QRect &rc);
+
+    /**
+     * KisPainter is not reentrant, so every concurrent job should write
+     * into the device with its own painter. Begins \p stripPainter on
+     * the device of \p painter and copies all its blending settings.
+     */
+    static void initializeStripPainter(KisPainter *stripPainter, KisPainter *painter);
+
     void blendInBackgroundWithSmearing(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src, const QRect &srcRect,
                                        const QRect &dstRect, const quint8 smudgeRateOpacity);
 
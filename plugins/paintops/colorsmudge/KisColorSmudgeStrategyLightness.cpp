@@ -4,6 +4,8 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <QRegion>
+
 #include <KoColorModelStandardIds.h>
 #include <KoCompositeOpRegistry.h>
 #include "KisColorSmudgeStrategyLightness.h"
@@ -17,6 +19,9 @@
 #include "kis_algebra_2d.h"
 #include <KoBgrColorSpaceTraits.h>
 
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+
 KisColorSmudgeStrategyLightness::KisColorSmudgeStrategyLightness(KisPainter *painter, bool smearAlpha,
                                                                  bool useDullingMode, KisPaintThicknessOptionData::ThicknessMode thicknessMode)
         : KisColorSmudgeStrategyBase(useDullingMode)
@@ -140,8 +145,6 @@ KisColorSmudgeStrategyLightness::paintDab(const QRect &srcRect, const QRect &dst
                                           qreal maxPossibleSmudgeRateValue, qreal paintThicknessValue,
                                           qreal smudgeRadiusValue)
 {
-    const int numPixels = dstRect.width() * dstRect.height();
-
     const QVector<QRect> mirroredRects = m_finalPainter.calculateAllMirroredRects(dstRect);
 
     QVector<QRect> readRects;
@@ -162,40 +165,164 @@ KisColorSmudgeStrategyLightness::paintDab(const QRect &srcRect, const QRect &dst
         smudgeRadiusValue);
 
 
+    m_heightmapPainter.setOpacity(heightmapOpacity(opacity, smudgeRateValue, paintThicknessValue));
+    m_heightmapPainter.bltFixed(dstRect.topLeft(), m_origDab, m_origDab->bounds());
+    m_heightmapPainter.renderMirrorMaskSafe(dstRect, m_origDab, m_shouldPreserveOriginalDab);
+
+    Q_FOREACH(const QRect& rc, mirroredRects) {
+        modulateLightness(rc);
+    }
+ 
+    m_layerOverlayDevice->writeRects(mirroredRects);
+
+    return mirroredRects;
+}
+
+QVector<QRect>
+KisColorSmudgeStrategyLightness::paintDabAsynchronously(const QRect &srcRect, const QRect &dstRect,
+                                                        const KoColor &currentPaintColor, qreal opacity,
+                                                        qreal colorRateValue, qreal smudgeRateValue,
+                                                        qreal maxPossibleSmudgeRateValue, qreal paintThicknessValue,
+                                                        qreal smudgeRadiusValue,
+                                                        QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    const QVector<QRect> mirroredRects = m_finalPainter.calculateAllMirroredRects(dstRect);
+
+    QVector<QRect> readRects;
+    readRects << mirroredRects;
+    readRects << srcRect;
+
+    BlendBrushStateSP state(new BlendBrushState());
+    state->srcSampleDevice = m_sourceWrapperDevice;
+
+    // both dabs are overwritten by the next call to updateMask(), so the
+    // jobs should have their own copies of them
+    state->maskDab = new KisFixedPaintDevice(*m_maskDab);
+    state->preserveMaskDab = false;
+    KisFixedPaintDeviceSP origDab = new KisFixedPaintDevice(*m_origDab);
+
+    state->srcRect = srcRect;
+    state->dstRect = dstRect;
+    state->currentPaintColor = currentPaintColor;
+    state->opacity = opacity;
+    state->smudgeRateValue = smudgeRateValue;
+    state->maxPossibleSmudgeRateValue = maxPossibleSmudgeRateValue;
+    state->colorRateValue = colorRateValue;
+    state->smudgeRadiusValue = smudgeRadiusValue;
+    state->detachedColoringStrategy.reset(m_coloringStrategy.clone());
+    state->coloringStrategy = state->detachedColoringStrategy.data();
+
+    const quint8 brushHeightmapOpacity = heightmapOpacity(opacity, smudgeRateValue, paintThicknessValue);
+
+    KritaUtils::addJobSequential(jobs,
+        [this, state, readRects] () {
+            m_sourceWrapperDevice->readRects(readRects);
+            prepareBlendBrush(state.data());
+        }
+    );
+
+    const QVector<QRect> strips = splitIntoStrips(dstRect);
+
+    Q_FOREACH (const QRect &rc, strips) {
+        KritaUtils::addJobConcurrent(jobs,
+            [this, state, rc] () {
+                blendBrushRows(*state, rc);
+            }
+        );
+    }
+
+    // the dab is sampled from the color device it is written into, so
+    // all the strips should be blended before any of them is written
+    KritaUtils::addJobSequential(jobs, nullptr);
+
+    Q_FOREACH (const QRect &rc, strips) {
+        KritaUtils::addJobConcurrent(jobs,
+            [this, state, origDab, brushHeightmapOpacity, rc] () {
+                KisPainter colorPainter;
+                initializeStripPainter(&colorPainter, &m_finalPainter);
+                bltBrushRows(&colorPainter, *state, rc);
+
+                const QRect origBounds = origDab->bounds();
+                const int rowOffset = rc.y() - state->dstRect.y();
+
+                KisPainter heightmapPainter;
+                initializeStripPainter(&heightmapPainter, &m_heightmapPainter);
+                heightmapPainter.setOpacity(brushHeightmapOpacity);
+                heightmapPainter.bltFixed(rc.topLeft(), origDab,
+                                          QRect(origBounds.x(), origBounds.y() + rowOffset,
+                                                rc.width(), rc.height()));
+            }
+        );
+    }
+
+    KritaUtils::addJobSequential(jobs,
+        [this, state, origDab, brushHeightmapOpacity] () {
+            renderBrushMirrors({&m_finalPainter}, *state);
+
+            m_heightmapPainter.setOpacity(brushHeightmapOpacity);
+            m_heightmapPainter.renderMirrorMaskSafe(state->dstRect, origDab, false);
+        }
+    );
+
+    /**
+     * The mirrored rects may overlap, so the strips of the projection
+     * are generated from their union to avoid writing the same tile
+     * from two jobs
+     */
+    QRegion modulatedRegion;
+    Q_FOREACH (const QRect &rc, mirroredRects) {
+        modulatedRegion += rc;
+    }
+
+    for (const QRect &rect : modulatedRegion) {
+        Q_FOREACH (const QRect &rc, splitIntoStrips(rect)) {
+            KritaUtils::addJobConcurrent(jobs,
+                [this, rc] () {
+                    modulateLightness(rc);
+                }
+            );
+        }
+    }
+
+    KritaUtils::addJobSequential(jobs,
+        [this, mirroredRects] () {
+            m_layerOverlayDevice->writeRects(mirroredRects);
+        }
+    );
+
+    return mirroredRects;
+}
+
+quint8 KisColorSmudgeStrategyLightness::heightmapOpacity(qreal opacity, qreal smudgeRateValue,
+                                                         qreal paintThicknessValue) const
+{
     const qreal overlaySmearRate = smudgeRateValue - 0.01; //adjust so minimum value is 0 instead of 1%
     const qreal overlayAdjustment =
         (m_thicknessMode == KisPaintThicknessOptionData::ThicknessMode::OVERWRITE) ?
         1.0 : KisAlgebra2D::lerp(overlaySmearRate, 1.0, paintThicknessValue);
-    const quint8 brushHeightmapOpacity = qRound(opacity * overlayAdjustment * 255.0);
-    m_heightmapPainter.setOpacity(brushHeightmapOpacity);
-    m_heightmapPainter.bltFixed(dstRect.topLeft(), m_origDab, m_origDab->bounds());
-    m_heightmapPainter.renderMirrorMaskSafe(dstRect, m_origDab, m_shouldPreserveOriginalDab);
-
+    return qRound(opacity * overlayAdjustment * 255.0);
+}
 
+void KisColorSmudgeStrategyLightness::modulateLightness(const QRect &rc)
+{
     KisFixedPaintDeviceSP tempColorDevice =
         new KisFixedPaintDevice(m_colorOnlyDevice->colorSpace(), m_memoryAllocator);
 
     KisFixedPaintDeviceSP tempHeightmapDevice =
         new KisFixedPaintDevice(m_heightmapDevice->colorSpace(), m_memoryAllocator);
 
-    Q_FOREACH(const QRect& rc, mirroredRects) {
-        tempColorDevice->setRect(rc);
-        tempColorDevice->lazyGrowBufferWithoutInitialization();
-
-        tempHeightmapDevice->setRect(rc);
-        tempHeightmapDevice->lazyGrowBufferWithoutInitialization();
-
-        m_colorOnlyDevice->readBytes(tempColorDevice->data(), rc);
-        m_heightmapDevice->readBytes(tempHeightmapDevice->data(), rc);
-        tempColorDevice->colorSpace()->
-            modulateLightnessByGrayBrush(tempColorDevice->data(),
-                reinterpret_cast<const QRgb*>(tempHeightmapDevice->data()),
-                1.0,
-                numPixels);
-        m_projectionDevice->writeBytes(tempColorDevice->data(), tempColorDevice->bounds());
-    }
- 
-    m_layerOverlayDevice->writeRects(mirroredRects);
+    tempColorDevice->setRect(rc);
+    tempColorDevice->lazyGrowBufferWithoutInitialization();
 
-    return mirroredRects;
+    tempHeightmapDevice->setRect(rc);
+    tempHeightmapDevice->lazyGrowBufferWithoutInitialization();
+
+    m_colorOnlyDevice->readBytes(tempColorDevice->data(), rc);
+    m_heightmapDevice->readBytes(tempHeightmapDevice->data(), rc);
+    tempColorDevice->colorSpace()->
+        modulateLightnessByGrayBrush(tempColorDevice->data(),
+            reinterpret_cast<const QRgb*>(tempHeightmapDevice->data()),
+            1.0,
+            rc.width() * rc.height());
+    m_projectionDevice->writeBytes(tempColorDevice->data(), tempColorDevice->bounds());
 }
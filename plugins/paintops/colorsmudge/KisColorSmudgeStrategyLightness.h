@@ -33,6 +33,16 @@ public:
     QVector<QRect> paintDab(const QRect &srcRect, const QRect &dstRect, const KoColor &currentPaintColor, qreal opacity,
                             qreal colorRateValue, qreal smudgeRateValue, qreal maxPossibleSmudgeRateValue,
                             qreal lightnessStrengthValue, qreal smudgeRadiusValue) override;
+
+    QVector<QRect> paintDabAsynchronously(const QRect &srcRect, const QRect &dstRect, const KoColor &currentPaintColor,
+                                          qreal opacity, qreal colorRateValue, qreal smudgeRateValue,
+                                          qreal maxPossibleSmudgeRateValue, qreal paintThicknessValue,
+                                          qreal smudgeRadiusValue, QVector<KisRunnableStrokeJobData*> &jobs) override;
+
+private:
+    quint8 heightmapOpacity(qreal opacity, qreal smudgeRateValue, qreal paintThicknessValue) const;
+    void modulateLightness(const QRect &rc);
+
 private:
     KisFixedPaintDeviceSP m_maskDab;
     KisFixedPaintDeviceSP m_origDab;
@@ -15,6 +15,9 @@
 
 #include "KisOverlayPaintDeviceWrapper.h"
 
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+
 KisColorSmudgeStrategyWithOverlay::KisColorSmudgeStrategyWithOverlay(KisPainter *painter, KisImageSP image,
                                                                      bool smearAlpha, bool useDullingMode,
                                                                      bool useOverlayMode)
@@ -83,15 +86,7 @@ QVector<QRect> KisColorSmudgeStrategyWithOverlay::paintDab(const QRect &srcRect,
     readRects << mirroredRects;
     readRects << srcRect;
 
-    m_sourceWrapperDevice->readRects(readRects);
-
-    if (m_imageOverlayDevice) {
-        /**
-         * If we have m_imageOverlayDevice set, then m_sourceWrapperOverlay points to it, not
-         * to the layer's overlay. Therefore, we should read from it as well.
-         */
-        m_layerOverlayDevice->readRects(readRects);
-    }
+    readSourceRects(readRects);
 
     blendBrush(finalPainters(),
                m_sourceWrapperDevice,
@@ -107,3 +102,114 @@ QVector<QRect> KisColorSmudgeStrategyWithOverlay::paintDab(const QRect &srcRect,
 
     return mirroredRects;
 }
+
+QVector<QRect> KisColorSmudgeStrategyWithOverlay::paintDabAsynchronously(const QRect &srcRect, const QRect &dstRect,
+                                                                         const KoColor &currentPaintColor, qreal opacity,
+                                                                         qreal colorRateValue, qreal smudgeRateValue,
+                                                                         qreal maxPossibleSmudgeRateValue,
+                                                                         qreal lightnessStrengthValue, qreal smudgeRadiusValue,
+                                                                         QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    Q_UNUSED(lightnessStrengthValue);
+
+    const QVector<QRect> mirroredRects = m_finalPainter.calculateAllMirroredRects(dstRect);
+
+    QVector<QRect> readRects;
+    readRects << mirroredRects;
+    readRects << srcRect;
+
+    BlendBrushStateSP state(new BlendBrushState());
+    state->srcSampleDevice = m_sourceWrapperDevice;
+
+    // the mask is reused by the next call to updateMask(), so the jobs
+    // should have their own copy of it
+    state->maskDab = new KisFixedPaintDevice(*m_maskDab);
+    state->preserveMaskDab = false;
+
+    state->srcRect = srcRect;
+    state->dstRect = dstRect;
+    state->currentPaintColor = currentPaintColor;
+    state->opacity = opacity;
+    state->smudgeRateValue = smudgeRateValue;
+    state->maxPossibleSmudgeRateValue = maxPossibleSmudgeRateValue;
+    state->colorRateValue = colorRateValue;
+    state->smudgeRadiusValue = smudgeRadiusValue;
+    state->detachedColoringStrategy.reset(coloringStrategy().clone());
+    state->coloringStrategy = state->detachedColoringStrategy.data();
+
+    const QVector<KisPainter*> dstPainters = finalPainters();
+    const QVector<QRect> strips = splitIntoStrips(dstRect);
+
+    if (strips.size() == 1) {
+        // the dab is too small to be split, the jobs would only add overhead
+        KritaUtils::addJobSequential(jobs,
+            [this, state, dstPainters, readRects, mirroredRects] () {
+                readSourceRects(readRects);
+                prepareBlendBrush(state.data());
+                blendBrushRows(*state, state->dstRect);
+
+                Q_FOREACH (KisPainter *dstPainter, dstPainters) {
+                    bltBrushRows(dstPainter, *state, state->dstRect);
+                }
+
+                renderBrushMirrors(dstPainters, *state);
+                m_layerOverlayDevice->writeRects(mirroredRects);
+            }
+        );
+
+        return mirroredRects;
+    }
+
+    KritaUtils::addJobSequential(jobs,
+        [this, state, readRects] () {
+            readSourceRects(readRects);
+            prepareBlendBrush(state.data());
+        }
+    );
+
+    Q_FOREACH (const QRect &rc, strips) {
+        KritaUtils::addJobConcurrent(jobs,
+            [this, state, rc] () {
+                blendBrushRows(*state, rc);
+            }
+        );
+    }
+
+    // the dab is sampled from the same device it is written into, so
+    // all the strips should be blended before any of them is written
+    KritaUtils::addJobSequential(jobs, nullptr);
+
+    Q_FOREACH (KisPainter *dstPainter, dstPainters) {
+        Q_FOREACH (const QRect &rc, strips) {
+            KritaUtils::addJobConcurrent(jobs,
+                [this, state, dstPainter, rc] () {
+                    KisPainter stripPainter;
+                    initializeStripPainter(&stripPainter, dstPainter);
+                    bltBrushRows(&stripPainter, *state, rc);
+                }
+            );
+        }
+    }
+
+    KritaUtils::addJobSequential(jobs,
+        [this, state, dstPainters, mirroredRects] () {
+            renderBrushMirrors(dstPainters, *state);
+            m_layerOverlayDevice->writeRects(mirroredRects);
+        }
+    );
+
+    return mirroredRects;
+}
+
+void KisColorSmudgeStrategyWithOverlay::readSourceRects(const QVector<QRect> &readRects)
+{
+    m_sourceWrapperDevice->readRects(readRects);
+
+    if (m_imageOverlayDevice) {
+        /**
+         * If we have m_imageOverlayDevice set, then m_sourceWrapperOverlay points to it, not
+         * to the layer's overlay. Therefore, we should read from it as well.
+         */
+        m_layerOverlayDevice->readRects(readRects);
+    }
+}
@@ -30,6 +30,14 @@ public:
                             qreal colorRateValue, qreal smudgeRateValue, qreal maxPossibleSmudgeRateValue,
                             qreal lightnessStrengthValue, qreal smudgeRadiusValue) override;
 
+    QVector<QRect> paintDabAsynchronously(const QRect &srcRect, const QRect &dstRect, const KoColor &currentPaintColor,
+                                          qreal opacity, qreal colorRateValue, qreal smudgeRateValue,
+                                          qreal maxPossibleSmudgeRateValue, qreal lightnessStrengthValue,
+                                          qreal smudgeRadiusValue, QVector<KisRunnableStrokeJobData*> &jobs) override;
+
+private:
+    void readSourceRects(const QVector<QRect> &readRects);
+
 protected:
     KisFixedPaintDeviceSP m_maskDab;
     bool m_shouldPreserveMaskDab = true;
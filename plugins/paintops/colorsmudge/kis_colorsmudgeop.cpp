@@ -6,6 +6,7 @@
 
 #include "kis_colorsmudgeop.h"
 
+#include <QElapsedTimer>
 #include <QRect>
 
 #include <KoColor.h>
@@ -16,8 +17,14 @@
 #include <kis_fixed_paint_device.h>
 #include <kis_lod_transform.h>
 #include <kis_spacing_information.h>
+#include <kis_paint_device.h>
+#include <kis_default_bounds_base.h>
+#include <kis_pointer_utils.h>
 #include "kis_paintop_plugin_utils.h"
 
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+
 #include "KisInterstrokeData.h"
 #include "KisInterstrokeDataFactory.h"
 
@@ -111,6 +118,17 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
     }
 
     m_strategy->initializePainting();
+
+    /**
+     * The jobs painting the dabs are executed only if the stroke calls
+     * doAsynchronousUpdate(). In wrap-around mode the strips of a dab may
+     * overlap in the wrapped space, so the dabs are painted right away.
+     */
+    m_useAsynchronousPainting =
+        settings->needsAsynchronousUpdates() &&
+        painter->runnableStrokeJobsInterface() &&
+        !painter->device()->defaultBounds()->wrapAroundMode();
+
     m_paintColor = painter->paintColor().convertedTo(m_strategy->preciseColorSpace());
 
     m_hsvOptions.append(KisHSVOption::createHueOption(settings.data()));
@@ -130,6 +148,9 @@ KisColorSmudgeOp::~KisColorSmudgeOp()
 {
     qDeleteAll(m_hsvOptions);
     delete m_hsvTransform;
+
+    // the stroke has been cancelled before the dabs were painted
+    qDeleteAll(m_pendingJobs);
 }
 
 KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
@@ -213,20 +234,77 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
         m_hsvTransform->transform(paintColor.data(), paintColor.data(), 1);
     }
 
-    const QVector<QRect> dirtyRects =
-            m_strategy->paintDab(srcDabRect, m_dstDabRect,
-                                 paintColor,
-                                 fpOpacity, colorRate,
-                                 smudgeRate,
-                                 maxSmudgeRate,
-                                 paintThickness,
-                                 smudgeRadiusPortion);
-
-    painter()->addDirtyRects(dirtyRects);
+    if (m_useAsynchronousPainting) {
+        m_pendingDirtyRects +=
+            m_strategy->paintDabAsynchronously(srcDabRect, m_dstDabRect,
+                                               paintColor,
+                                               fpOpacity, colorRate,
+                                               smudgeRate,
+                                               maxSmudgeRate,
+                                               paintThickness,
+                                               smudgeRadiusPortion,
+                                               m_pendingJobs);
+    } else {
+        const QVector<QRect> dirtyRects =
+                m_strategy->paintDab(srcDabRect, m_dstDabRect,
+                                     paintColor,
+                                     fpOpacity, colorRate,
+                                     smudgeRate,
+                                     maxSmudgeRate,
+                                     paintThickness,
+                                     smudgeRadiusPortion);
+
+        painter()->addDirtyRects(dirtyRects);
+    }
 
     return spacingInfo;
 }
 
+struct KisColorSmudgeOp::UpdateSharedState
+{
+    KisPainter *painter = 0;
+    QVector<QRect> dirtyRects;
+    QElapsedTimer renderingTimer;
+};
+
+std::pair<int, bool> KisColorSmudgeOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    if (m_pendingJobs.isEmpty()) {
+        return std::make_pair(m_currentUpdatePeriod, false);
+    }
+
+    /**
+     * Every dab samples the result of the previous one, so the next batch
+     * of the dabs can be started only after the previous one is finished
+     */
+    if (m_updateSharedState) {
+        return std::make_pair(m_currentUpdatePeriod, true);
+    }
+
+    m_updateSharedState = toQShared(new UpdateSharedState());
+    UpdateSharedStateSP state = m_updateSharedState;
+
+    state->painter = painter();
+    state->dirtyRects.swap(m_pendingDirtyRects);
+    state->renderingTimer.start();
+
+    jobs.append(m_pendingJobs);
+    m_pendingJobs.clear();
+
+    KritaUtils::addJobSequential(jobs,
+        [state, this] () {
+            state->painter->addDirtyRects(state->dirtyRects);
+
+            const int renderingTime = state->renderingTimer.elapsed();
+            m_currentUpdatePeriod = qBound(m_minUpdatePeriod, int(1.5 * renderingTime), m_maxUpdatePeriod);
+
+            m_updateSharedState.clear();
+        }
+    );
+
+    return std::make_pair(m_currentUpdatePeriod, false);
+}
+
 KisSpacingInformation KisColorSmudgeOp::updateSpacingImpl(const KisPaintInformation &info) const
 {
     const qreal scale = m_sizeOption.apply(info) * KisLodTransform::lodToScale(painter()->device());
@@ -37,6 +37,7 @@ class KoColorSpace;
 class KisInterstrokeDataFactory;
 
 class KisColorSmudgeStrategy;
+class KisRunnableStrokeJobData;
 
 class KisColorSmudgeOp: public KisBrushBasedPaintOp
 {
@@ -46,12 +47,18 @@ public:
 
     static KisInterstrokeDataFactory* createInterstrokeDataFactory(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
 protected:
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
 
     KisSpacingInformation updateSpacingImpl(const KisPaintInformation &info) const override;
     KisTimingInformation updateTimingImpl(const KisPaintInformation &info) const override;
 
+private:
+    struct UpdateSharedState;
+    typedef QSharedPointer<UpdateSharedState> UpdateSharedStateSP;
+
 private:
     bool                      m_firstRun;
 
@@ -79,6 +86,19 @@ private:
 
     KoColorTransformation *m_hsvTransform {0};
     QScopedPointer<KisColorSmudgeStrategy> m_strategy;
+
+    /**
+     * In asynchronous mode paintAt() only prepares the dabs and the jobs
+     * painting them are passed to the stroke in doAsynchronousUpdate()
+     */
+    bool m_useAsynchronousPainting {false};
+    QVector<KisRunnableStrokeJobData*> m_pendingJobs;
+    QVector<QRect> m_pendingDirtyRects;
+    UpdateSharedStateSP m_updateSharedState;
+
+    int m_currentUpdatePeriod {20};
+    const int m_minUpdatePeriod {10};
+    const int m_maxUpdatePeriod {100};
 };
 
 #endif // _KIS_COLORSMUDGEOP_H_
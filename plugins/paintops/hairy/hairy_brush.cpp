@@ -25,6 +25,136 @@
 #include <ctime>
 
 
+namespace {
+
+/**
+ * Paints the ink drops into the dab. The painter doesn't depend on the
+ * state of the brush, so it can be used in a worker thread.
+ */
+struct InkPainter
+{
+    InkPainter(KisPaintDeviceSP dab)
+        : accessor(dab->createRandomAccessorNG()),
+          cs(dab->colorSpace()),
+          compositeOp(cs->compositeOp(COMPOSITE_OVER)),
+          pixelSize(cs->pixelSize())
+    {
+    }
+
+    /// paints single bristle
+    inline void addBristleInk(const QPointF &pos, const KoColor &color, bool antialias, bool useCompositing)
+    {
+        if (antialias) {
+            if (useCompositing) {
+                paintParticle(pos, color);
+            } else {
+                paintParticle(pos, color, 1.0);
+            }
+        }
+        else {
+            int ix = qRound(pos.x());
+            int iy = qRound(pos.y());
+            if (useCompositing) {
+                plotPixel(ix, iy, color);
+            }
+            else {
+                darkenPixel(ix, iy, color);
+            }
+        }
+    }
+
+    /// paint wu particle by copying the color and setup just the opacity, weight is complementary to opacity of the color
+    void paintParticle(QPointF pos, const KoColor& color, qreal weight)
+    {
+        // opacity top left, right, bottom left, right
+        quint8 opacity = color.opacityU8();
+        opacity *= weight;
+
+        int ipx = int (pos.x());
+        int ipy = int (pos.y());
+        qreal fx = qAbs(pos.x() - ipx);
+        qreal fy = qAbs(pos.y() - ipy);
+
+        quint8 btl = qRound((1.0 - fx) * (1.0 - fy) * opacity);
+        quint8 btr = qRound((fx)  * (1.0 - fy) * opacity);
+        quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
+        quint8 bbr = qRound((fx)  * (fy)  * opacity);
+
+        accessor->moveTo(ipx  , ipy);
+        btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+        memcpy(accessor->rawData(), color.data(), pixelSize);
+        cs->setOpacity(accessor->rawData(), btl, 1);
+
+        accessor->moveTo(ipx + 1, ipy);
+        btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+        memcpy(accessor->rawData(), color.data(), pixelSize);
+        cs->setOpacity(accessor->rawData(), btr, 1);
+
+        accessor->moveTo(ipx, ipy + 1);
+        bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+        memcpy(accessor->rawData(), color.data(), pixelSize);
+        cs->setOpacity(accessor->rawData(), bbl, 1);
+
+        accessor->moveTo(ipx + 1, ipy + 1);
+        bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+        memcpy(accessor->rawData(), color.data(), pixelSize);
+        cs->setOpacity(accessor->rawData(), bbr, 1);
+    }
+
+    /// paint wu particle using composite operation
+    void paintParticle(QPointF pos, const KoColor& color)
+    {
+        // opacity top left, right, bottom left, right
+        KoColor particleColor(color);
+        quint8 opacity = color.opacityU8();
+
+        int ipx = int (pos.x());
+        int ipy = int (pos.y());
+        qreal fx = qAbs(pos.x() - ipx);
+        qreal fy = qAbs(pos.y() - ipy);
+
+        quint8 btl = qRound((1.0 - fx) * (1.0 - fy) * opacity);
+        quint8 btr = qRound((fx)  * (1.0 - fy) * opacity);
+        quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
+        quint8 bbr = qRound((fx)  * (fy)  * opacity);
+
+        particleColor.setOpacity(btl);
+        plotPixel(ipx  , ipy, particleColor);
+
+        particleColor.setOpacity(btr);
+        plotPixel(ipx + 1  , ipy, particleColor);
+
+        particleColor.setOpacity(bbl);
+        plotPixel(ipx  , ipy + 1, particleColor);
+
+        particleColor.setOpacity(bbr);
+        plotPixel(ipx + 1 , ipy + 1, particleColor);
+    }
+
+    /// composite single pixel to dab
+    inline void plotPixel(int wx, int wy, const KoColor &color)
+    {
+        accessor->moveTo(wx, wy);
+        compositeOp->composite(accessor->rawData(), pixelSize, color.data() , pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
+    }
+
+    /// check the opacity of dab pixel and if the opacity is less than color, it will copy color to dab
+    inline void darkenPixel(int wx, int wy, const KoColor &color)
+    {
+        accessor->moveTo(wx, wy);
+        if (cs->opacityU8(accessor->rawData()) < color.opacityU8()) {
+            memcpy(accessor->rawData(), color.data(), pixelSize);
+        }
+    }
+
+    KisRandomAccessorSP accessor;
+    const KoColorSpace *cs;
+    const KoCompositeOp *compositeOp;
+    const quint32 pixelSize;
+};
+
+}
+
 HairyBrush::HairyBrush()
 {
     m_counter = 0;
@@ -42,13 +172,12 @@ HairyBrush::~HairyBrush()
 }
 
 
-void HairyBrush::initAndCache()
+void HairyBrush::initAndCache(const KoColorSpace *cs)
 {
-    m_compositeOp = m_dab->colorSpace()->compositeOp(COMPOSITE_OVER);
-    m_pixelSize = m_dab->colorSpace()->pixelSize();
+    m_pixelSize = cs->pixelSize();
 
     if (m_properties->useSaturation) {
-        m_transfo = m_dab->colorSpace()->createColorTransformation("hsv_adjustment", m_params);
+        m_transfo = cs->createColorTransformation("hsv_adjustment", m_params);
         if (m_transfo) {
             m_saturationId = m_transfo->parameterId("s");
         }
@@ -94,6 +223,21 @@ void HairyBrush::fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density)
 
 
 void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const KisPaintInformation &pi1, const KisPaintInformation &pi2, qreal scale, qreal rotation)
+{
+    paintInk(dab, computeInk(dab->colorSpace(), layer, pi1, pi2, scale, rotation),
+             m_properties->antialias, m_properties->useCompositing);
+}
+
+void HairyBrush::paintInk(KisPaintDeviceSP dab, const QVector<InkDrop> &ink, bool antialias, bool useCompositing)
+{
+    InkPainter painter(dab);
+
+    Q_FOREACH (const InkDrop &drop, ink) {
+        painter.addBristleInk(drop.pos, drop.color, antialias, useCompositing);
+    }
+}
+
+QVector<HairyBrush::InkDrop> HairyBrush::computeInk(const KoColorSpace *cs, KisPaintDeviceSP layer, const KisPaintInformation &pi1, const KisPaintInformation &pi2, qreal scale, qreal rotation)
 {
     m_counter++;
 
@@ -121,15 +265,13 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     qreal pressure = mousePressure * (pi2.pressure() * 2);
 
     Bristle *bristle = 0;
-    KoColor bristleColor(dab->colorSpace());
-
-    m_dabAccessor = dab->createRandomAccessorNG();
+    KoColor bristleColor(cs);
 
-    m_dab = dab;
+    QVector<InkDrop> ink;
 
     // initialization block
     if (firstStroke()) {
-        initAndCache();
+        initAndCache(cs);
     }
 
     /*If this is first time the brush touches the canvas and
@@ -137,7 +279,7 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     if (m_properties->inkDepletionEnabled &&
             firstStroke() && m_properties->useSoakInk) {
         if (layer) {
-            colorifyBristles(layer, pi1.pos());
+            colorifyBristles(cs, layer, pi1.pos());
         }
         else {
             dbgKrita << "Can't soak the ink from the layer";
@@ -225,14 +367,14 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
                 }
             }
 
-            addBristleInk(bristle, bristlePath.at(i), bristleColor);
+            ink.append({bristlePath.at(i), bristleColor});
             bristle->setInkAmount(1.0 - inkDepletion);
             bristle->upIncrement();
         }
 
     }
-    m_dab = nullptr;
-    m_dabAccessor = nullptr;
+
+    return ink;
 }
 
 
@@ -293,111 +435,6 @@ void HairyBrush::opacityDepletion(Bristle* bristle, KoColor& bristleColor, qreal
     bristleColor.setOpacity(opacity);
 }
 
-inline void HairyBrush::addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color)
-{
-    Q_UNUSED(bristle);
-    if (m_properties->antialias) {
-        if (m_properties->useCompositing) {
-            paintParticle(pos, color);
-        } else {
-            paintParticle(pos, color, 1.0);
-        }
-    }
-    else {
-        int ix = qRound(pos.x());
-        int iy = qRound(pos.y());
-        if (m_properties->useCompositing) {
-            plotPixel(ix, iy, color);
-        }
-        else {
-            darkenPixel(ix, iy, color);
-        }
-    }
-}
-
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
-{
-    // opacity top left, right, bottom left, right
-    quint8 opacity = color.opacityU8();
-    opacity *= weight;
-
-    int ipx = int (pos.x());
-    int ipy = int (pos.y());
-    qreal fx = qAbs(pos.x() - ipx);
-    qreal fy = qAbs(pos.y() - ipy);
-
-    quint8 btl = qRound((1.0 - fx) * (1.0 - fy) * opacity);
-    quint8 btr = qRound((fx)  * (1.0 - fy) * opacity);
-    quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
-    quint8 bbr = qRound((fx)  * (fy)  * opacity);
-
-    const KoColorSpace * cs = m_dab->colorSpace();
-
-    m_dabAccessor->moveTo(ipx  , ipy);
-    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy);
-    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btr, 1);
-
-    m_dabAccessor->moveTo(ipx, ipy + 1);
-    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy + 1);
-    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbr, 1);
-}
-
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
-{
-    // opacity top left, right, bottom left, right
-    memcpy(m_color.data(), color.data(), m_pixelSize);
-    quint8 opacity = color.opacityU8();
-
-    int ipx = int (pos.x());
-    int ipy = int (pos.y());
-    qreal fx = qAbs(pos.x() - ipx);
-    qreal fy = qAbs(pos.y() - ipy);
-
-    quint8 btl = qRound((1.0 - fx) * (1.0 - fy) * opacity);
-    quint8 btr = qRound((fx)  * (1.0 - fy) * opacity);
-    quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
-    quint8 bbr = qRound((fx)  * (fy)  * opacity);
-
-    m_color.setOpacity(btl);
-    plotPixel(ipx  , ipy, m_color);
-
-    m_color.setOpacity(btr);
-    plotPixel(ipx + 1  , ipy, m_color);
-
-    m_color.setOpacity(bbl);
-    plotPixel(ipx  , ipy + 1, m_color);
-
-    m_color.setOpacity(bbr);
-    plotPixel(ipx + 1 , ipy + 1, m_color);
-}
-
-
-inline void HairyBrush::plotPixel(int wx, int wy, const KoColor &color)
-{
-    m_dabAccessor->moveTo(wx, wy);
-    m_compositeOp->composite(m_dabAccessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
-}
-
-inline void HairyBrush::darkenPixel(int wx, int wy, const KoColor &color)
-{
-    m_dabAccessor->moveTo(wx, wy);
-    if (m_dab->colorSpace()->opacityU8(m_dabAccessor->rawData()) < color.opacityU8()) {
-        memcpy(m_dabAccessor->rawData(), color.data(), m_pixelSize);
-    }
-}
-
 double HairyBrush::computeMousePressure(double distance)
 {
     static const double scale = 20.0;
@@ -415,9 +452,9 @@ double HairyBrush::computeMousePressure(double distance)
 }
 
 
-void HairyBrush::colorifyBristles(KisPaintDeviceSP source, QPointF point)
+void HairyBrush::colorifyBristles(const KoColorSpace *cs, KisPaintDeviceSP source, QPointF point)
 {
-    KoColor bristleColor(m_dab->colorSpace());
+    KoColor bristleColor(cs);
     KisCrossDeviceColorSamplerInt colorSampler(source, bristleColor);
 
     Bristle *b = 0;
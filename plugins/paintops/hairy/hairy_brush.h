@@ -20,8 +20,6 @@
 #include <brushengine/kis_paint_information.h>
 #include <kis_random_accessor_ng.h>
 
-class KoCompositeOp;
-
 
 class KisHairyProperties
 {
@@ -57,11 +55,28 @@ public:
 class HairyBrush
 {
 
+public:
+    /// a drop of ink left by a bristle on the dab
+    struct InkDrop {
+        QPointF pos;
+        KoColor color;
+    };
+
 public:
     HairyBrush();
     ~HairyBrush();
 
     void paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const KisPaintInformation &pi1, const KisPaintInformation &pi2, qreal scale, qreal rotation);
+
+    /**
+     * Moves the bristles from \p pi1 to \p pi2 and returns the ink they
+     * leave on the way. The ink is painted with paintInk().
+     */
+    QVector<InkDrop> computeInk(const KoColorSpace *cs, KisPaintDeviceSP layer, const KisPaintInformation &pi1, const KisPaintInformation &pi2, qreal scale, qreal rotation);
+
+    /// paints the ink into \p dab, doesn't depend on the state of the brush
+    static void paintInk(KisPaintDeviceSP dab, const QVector<InkDrop> &ink, bool antialias, bool useCompositing);
+
     /// set ink color for the whole bristle shape
     void setInkColor(const KoColor &color) {
         m_color = color;
@@ -74,18 +89,8 @@ public:
     void fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density);
 
 private:
-    /// paints single bristle
-    void addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color);
-    /// composite single pixel to dab
-    void plotPixel(int wx, int wy, const KoColor &color);
-    /// check the opacity of dab pixel and if the opacity is less than color, it will copy color to dab
-    void darkenPixel(int wx, int wy, const KoColor &color);
-    /// paint wu particle by copying the color and setup just the opacity, weight is complementary to opacity of the color
-    void paintParticle(QPointF pos, const KoColor& color, qreal weight);
-    /// paint wu particle using composite operation
-    void paintParticle(QPointF pos, const KoColor& color);
     /// similar to sample input color in spray
-    void colorifyBristles(KisPaintDeviceSP source, QPointF point);
+    void colorifyBristles(const KoColorSpace *cs, KisPaintDeviceSP source, QPointF point);
 
     void repositionBristles(double angle, double slope);
     /// compute mouse pressure according distance
@@ -98,7 +103,7 @@ private:
     /// fetch actual ink status according depletion curve
     qreal fetchInkDepletion(Bristle * bristle, int inkDepletionSize);
 
-    void initAndCache();
+    void initAndCache(const KoColorSpace *cs);
 
 private:
     const KisHairyProperties * m_properties {nullptr};
@@ -109,10 +114,6 @@ private:
     // used for interpolation the path of bristles
     Trajectory m_trajectory;
     QHash<QString, QVariant> m_params;
-    // temporary device
-    KisPaintDeviceSP m_dab;
-    KisRandomAccessorSP m_dabAccessor;
-    const KoCompositeOp * m_compositeOp {nullptr};
     quint32 m_pixelSize {0};
 
     int m_counter {0};
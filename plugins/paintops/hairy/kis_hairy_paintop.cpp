@@ -24,6 +24,7 @@
 #include <kis_fixed_paint_device.h>
 #include <kis_lod_transform.h>
 #include <kis_spacing_information.h>
+#include <KisAsyncDabRenderingQueue.h>
 #include <KoResourceLoadResult.h>
 
 
@@ -64,6 +65,23 @@ KisHairyPaintOp::KisHairyPaintOp(const KisPaintOpSettingsSP settings, KisPainter
 
     loadSettings();
     m_brush.setProperties(&m_properties);
+
+    if (settings->needsAsynchronousUpdates() &&
+        KisAsyncDabRenderingQueue::canRenderAsynchronously(painter)) {
+
+        m_asyncQueue.reset(new KisAsyncDabRenderingQueue(painter, source()));
+    }
+}
+
+KisHairyPaintOp::~KisHairyPaintOp()
+{
+}
+
+std::pair<int, bool> KisHairyPaintOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    return m_asyncQueue ?
+        m_asyncQueue->doAsynchronousUpdate(jobs) :
+        KisPaintOp::doAsynchronousUpdate(jobs);
 }
 
 QList<KoResourceLoadResult> KisHairyPaintOp::prepareLinkedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface)
@@ -118,13 +136,6 @@ void KisHairyPaintOp::paintLine(const KisPaintInformation &pi1, const KisPaintIn
     Q_UNUSED(currentDistance);
     if (!painter()) return;
 
-    if (!m_dab) {
-        m_dab = source()->createCompositionSourceDevice();
-    }
-    else {
-        m_dab->clear();
-    }
-
     /**
      * Even though we don't use spacing in hairy brush, we should still
      * initialize its distance information to ensure drawing angle and
@@ -147,12 +158,34 @@ void KisHairyPaintOp::paintLine(const KisPaintInformation &pi1, const KisPaintIn
     // during initialization), so we should just skip the distance info
     // update
 
-    m_brush.paintLine(m_dab, m_dev, pi1, pi, scale * m_hairyBristleOption.scaleFactor, mirrorFlip ? -rotation : rotation);
+    if (m_asyncQueue) {
+        const QVector<HairyBrush::InkDrop> ink =
+            m_brush.computeInk(source()->compositionSourceColorSpace(), m_dev, pi1, pi,
+                               scale * m_hairyBristleOption.scaleFactor, mirrorFlip ? -rotation : rotation);
+
+        const bool antialias = m_properties.antialias;
+        const bool useCompositing = m_properties.useCompositing;
+
+        m_asyncQueue->addDab(
+            [ink, antialias, useCompositing] (KisPaintDeviceSP dab) {
+                HairyBrush::paintInk(dab, ink, antialias, useCompositing);
+            });
+    } else {
+        if (!m_dab) {
+            m_dab = source()->createCompositionSourceDevice();
+        }
+        else {
+            m_dab->clear();
+        }
+
+        m_brush.paintLine(m_dab, m_dev, pi1, pi, scale * m_hairyBristleOption.scaleFactor, mirrorFlip ? -rotation : rotation);
+
+        //QRect rc = m_dab->exactBounds();
+        QRect rc = m_dab->extent();
+        painter()->bitBlt(rc.topLeft(), m_dab, rc);
+        painter()->renderMirrorMask(rc, m_dab);
+    }
 
-    //QRect rc = m_dab->exactBounds();
-    QRect rc = m_dab->extent();
-    painter()->bitBlt(rc.topLeft(), m_dab, rc);
-    painter()->renderMirrorMask(rc, m_dab);
     painter()->setOpacity(origOpacity);
 
     // we don't use spacing in hairy brush, but history is
@@ -8,6 +8,8 @@
 #ifndef KIS_HAIRYPAINTOP_H_
 #define KIS_HAIRYPAINTOP_H_
 
+#include <QScopedPointer>
+
 #include <klocalizedstring.h>
 #include <brushengine/kis_paintop.h>
 #include <brushengine/kis_paintop_factory.h>
@@ -24,15 +26,19 @@
 class KisPainter;
 class KisBrushBasedPaintOpSettings;
 class KisResourcesInterface;
+class KisAsyncDabRenderingQueue;
 
 class KisHairyPaintOp : public KisPaintOp
 {
 
 public:
     KisHairyPaintOp(const KisPaintOpSettingsSP settings, KisPainter *painter, KisNodeSP node, KisImageSP image);
+    ~KisHairyPaintOp() override;
 
     void paintLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2, KisDistanceInformation *currentDistance) override;
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
     static QList<KoResourceLoadResult> prepareLinkedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 protected:
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
@@ -51,6 +57,12 @@ private:
     KisSizeOption m_sizeOption;
     KisRotationOption m_rotationOption;
 
+    /**
+     * In asynchronous mode the bristles are moved in paintLine(), but
+     * their ink is painted in the stroke jobs
+     */
+    QScopedPointer<KisAsyncDabRenderingQueue> m_asyncQueue;
+
     void loadSettings();
 };
 
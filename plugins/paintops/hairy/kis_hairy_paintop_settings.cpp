@@ -28,3 +28,8 @@ bool KisHairyPaintOpSettings::hasPatternSettings() const
 {
     return false;
 }
+
+bool KisHairyPaintOpSettings::needsAsynchronousUpdates() const
+{
+    return true;
+}
@@ -24,6 +24,7 @@ public:
     using KisBrushBasedPaintOpSettings::brushOutline;
     KisOptimizedBrushOutline brushOutline(const KisPaintInformation &info, const OutlineMode &mode, qreal alignForZoom) override;
     bool hasPatternSettings() const override;
+    bool needsAsynchronousUpdates() const override;
 
 };
 
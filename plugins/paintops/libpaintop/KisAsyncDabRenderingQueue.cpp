@@ -0,0 +1,262 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAsyncDabRenderingQueue.h"
+
+#include <atomic>
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QRect>
+#include <QSharedPointer>
+
+#include <kis_painter.h>
+#include <kis_paint_device.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_default_bounds_base.h>
+#include <kis_image_config.h>
+#include <kis_pointer_utils.h>
+#include <KisRenderedDab.h>
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+#include <KisRunnableStrokeJobsInterface.h>
+#include <tool/strokes/FreehandStrokeRunnableJobDataWithUpdate.h>
+
+#include "kis_paintop_utils.h"
+
+namespace {
+
+struct DabJob
+{
+    KisAsyncDabRenderingQueue::RenderFunction func;
+    KisPaintDeviceSP device;
+
+    KisRenderedDab dab;
+    std::atomic<bool> isReady {false};
+};
+
+typedef QSharedPointer<DabJob> DabJobSP;
+
+struct UpdateSharedState
+{
+    KisPainter *painter = nullptr;
+    QList<KisRenderedDab> dabsQueue;
+    QVector<QRect> allDirtyRects;
+    QElapsedTimer renderingTimer;
+};
+
+typedef QSharedPointer<UpdateSharedState> UpdateSharedStateSP;
+
+void addMirroringJobs(Qt::Orientation direction,
+                      QVector<QRect> &rects,
+                      UpdateSharedStateSP state,
+                      QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    KritaUtils::addJobSequential(jobs, nullptr);
+
+    // every dab owns its device, so there is nothing to deduplicate
+    for (KisRenderedDab &dab : state->dabsQueue) {
+        KritaUtils::addJobConcurrent(jobs,
+            [state, &dab, direction] () {
+                state->painter->mirrorDab(direction, &dab);
+            }
+        );
+    }
+
+    KritaUtils::addJobSequential(jobs, nullptr);
+
+    for (QRect &rc : rects) {
+        state->painter->mirrorRect(direction, &rc);
+
+        KritaUtils::addJobConcurrent(jobs,
+            [rc, state] () {
+                state->painter->bltFixed(rc, state->dabsQueue);
+            }
+        );
+    }
+
+    state->allDirtyRects.append(rects);
+}
+
+}
+
+struct KisAsyncDabRenderingQueue::Private
+{
+    Private(KisPainter *_painter, KisPaintDeviceSP _sourceDevice)
+        : painter(_painter),
+          sourceDevice(_sourceDevice),
+          idealNumRects(KisImageConfig(true).maxNumberOfThreads())
+    {
+    }
+
+    KisPainter *painter;
+    KisPaintDeviceSP sourceDevice;
+
+    QList<DabJobSP> jobs;
+    UpdateSharedStateSP updateSharedState;
+    qreal averageOpacity = 0.0;
+
+    const int idealNumRects;
+    int currentUpdatePeriod {20};
+    const int minUpdatePeriod {10};
+    const int maxUpdatePeriod {100};
+};
+
+KisAsyncDabRenderingQueue::KisAsyncDabRenderingQueue(KisPainter *painter, KisPaintDeviceSP sourceDevice)
+    : m_d(new Private(painter, sourceDevice))
+{
+}
+
+KisAsyncDabRenderingQueue::~KisAsyncDabRenderingQueue()
+{
+}
+
+bool KisAsyncDabRenderingQueue::canRenderAsynchronously(KisPainter *painter)
+{
+    /**
+     * In wrap-around mode the patches composited in parallel may overlap
+     * in the wrapped space, so the dabs should be painted synchronously.
+     */
+    return painter && painter->device() &&
+        painter->runnableStrokeJobsInterface() &&
+        !painter->device()->defaultBounds()->wrapAroundMode();
+}
+
+void KisAsyncDabRenderingQueue::addDab(RenderFunction func)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_d->painter->runnableStrokeJobsInterface());
+
+    DabJobSP job(new DabJob());
+    job->func = func;
+    job->device = m_d->sourceDevice->createCompositionSourceDevice();
+    job->dab.opacity = qreal(m_d->painter->opacity()) / OPACITY_OPAQUE_U8;
+    job->dab.flow = qreal(m_d->painter->flow()) / OPACITY_OPAQUE_U8;
+
+    m_d->jobs.append(job);
+
+    m_d->painter->runnableStrokeJobsInterface()->addRunnableJob(
+        new FreehandStrokeRunnableJobDataWithUpdate(
+            [job] () {
+                job->func(job->device);
+
+                const QRect rc = job->device->extent();
+
+                if (!rc.isEmpty()) {
+                    KisFixedPaintDeviceSP dabDevice = new KisFixedPaintDevice(job->device->colorSpace());
+                    dabDevice->setRect(rc);
+                    dabDevice->lazyGrowBufferWithoutInitialization();
+                    job->device->readBytes(dabDevice->data(), rc);
+
+                    job->dab.device = dabDevice;
+                    job->dab.offset = rc.topLeft();
+                }
+
+                // release the tiles and the data captured by the function
+                job->func = RenderFunction();
+                job->device = nullptr;
+
+                job->isReady.store(true, std::memory_order_release);
+            },
+            KisStrokeJobData::CONCURRENT));
+}
+
+std::pair<int, bool> KisAsyncDabRenderingQueue::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    if (m_d->updateSharedState) {
+        return std::make_pair(m_d->currentUpdatePeriod, !m_d->jobs.isEmpty());
+    }
+
+    QList<KisRenderedDab> dabs;
+
+    // the dabs are composited strictly in the order they were added
+    while (!m_d->jobs.isEmpty() &&
+           m_d->jobs.first()->isReady.load(std::memory_order_acquire)) {
+
+        DabJobSP job = m_d->jobs.takeFirst();
+        if (!job->dab.device) continue;
+
+        m_d->averageOpacity = KisPainter::blendAverageOpacity(job->dab.opacity, m_d->averageOpacity);
+        job->dab.averageOpacity = m_d->averageOpacity;
+
+        dabs.append(job->dab);
+    }
+
+    const bool someDabsAreStillInQueue = !m_d->jobs.isEmpty();
+
+    if (dabs.isEmpty()) {
+        return std::make_pair(someDabsAreStillInQueue ? m_d->minUpdatePeriod : m_d->currentUpdatePeriod,
+                              someDabsAreStillInQueue);
+    }
+
+    m_d->updateSharedState = toQShared(new UpdateSharedState());
+    UpdateSharedStateSP state = m_d->updateSharedState;
+
+    state->painter = m_d->painter;
+    state->dabsQueue = dabs;
+
+    QVector<QRect> rects;
+    int diameter = 0;
+
+    Q_FOREACH (const KisRenderedDab &dab, state->dabsQueue) {
+        const QRect rc = dab.realBounds();
+        rects.append(rc);
+        diameter += qMax(rc.width(), rc.height());
+    }
+    diameter /= state->dabsQueue.size();
+
+    /**
+     * The spacing of these engines is not related to the size of the
+     * dab, so just let the patches be about the size of a dab.
+     */
+    rects = KisPaintOpUtils::splitDabsIntoRects(rects, m_d->idealNumRects, diameter, 1.0);
+    state->allDirtyRects = rects;
+
+    state->renderingTimer.start();
+
+    Q_FOREACH (const QRect &rc, rects) {
+        KritaUtils::addJobConcurrent(jobs,
+            [rc, state] () {
+                state->painter->bltFixed(rc, state->dabsQueue);
+            }
+        );
+    }
+
+    // see a comment in KisBrushOp::doAsynchronousUpdate()
+    if (state->painter->hasHorizontalMirroring()) {
+        addMirroringJobs(Qt::Horizontal, rects, state, jobs);
+    }
+
+    if (state->painter->hasVerticalMirroring()) {
+        addMirroringJobs(Qt::Vertical, rects, state, jobs);
+    }
+
+    if (state->painter->hasHorizontalMirroring() && state->painter->hasVerticalMirroring()) {
+        addMirroringJobs(Qt::Horizontal, rects, state, jobs);
+    }
+
+    KritaUtils::addJobSequential(jobs,
+        [state, this, someDabsAreStillInQueue] () {
+            Q_FOREACH (const QRect &rc, state->allDirtyRects) {
+                state->painter->addDirtyRect(rc);
+            }
+
+            state->painter->setAverageOpacity(state->dabsQueue.last().averageOpacity);
+
+            const int updateRenderingTime = state->renderingTimer.elapsed();
+
+            m_d->currentUpdatePeriod =
+                someDabsAreStillInQueue ? m_d->minUpdatePeriod :
+                qBound(m_d->minUpdatePeriod, int(1.5 * updateRenderingTime), m_d->maxUpdatePeriod);
+
+            // release all the dab devices
+            state->dabsQueue.clear();
+
+            m_d->updateSharedState.clear();
+        }
+    );
+
+    return std::make_pair(m_d->currentUpdatePeriod, someDabsAreStillInQueue);
+}
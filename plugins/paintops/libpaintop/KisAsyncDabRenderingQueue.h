@@ -0,0 +1,77 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers <kimageshop@kde.org>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISASYNCDABRENDERINGQUEUE_H
+#define KISASYNCDABRENDERINGQUEUE_H
+
+#include <functional>
+#include <utility>
+
+#include <QScopedPointer>
+#include <QVector>
+
+#include "kis_types.h"
+#include "kritapaintop_export.h"
+
+class KisPainter;
+class KisRunnableStrokeJobData;
+
+/**
+ * A generic version of the asynchronous dab rendering used by the
+ * brush engine (KisDabRenderingQueue) for the paintops that render
+ * their dabs into a KisPaintDevice (spray, hairy, sketch, particle).
+ *
+ * The paintop does all the sequential work (random numbers, physics,
+ * bristles' state) in paintAt()/paintLine() and passes a function
+ * rendering the prepared primitives into addDab(). The function is
+ * executed in a concurrent stroke job into a separate composition source
+ * device, so several dabs are rendered at the same time. The rendered
+ * dabs are composited onto the painter's device in doAsynchronousUpdate()
+ * in the order they were added, split into non-overlapping patches
+ * processed in parallel, the same way KisBrushOp does.
+ *
+ * All the methods should be called from the stroke's thread only.
+ */
+class PAINTOP_EXPORT KisAsyncDabRenderingQueue
+{
+public:
+    /**
+     * Renders the dab into the passed device. The function is called in a
+     * worker thread concurrently with the other dabs and with the paintop,
+     * so it should capture everything it needs by value and should not
+     * touch the state of the paintop.
+     */
+    typedef std::function<void(KisPaintDeviceSP)> RenderFunction;
+
+    KisAsyncDabRenderingQueue(KisPainter *painter, KisPaintDeviceSP sourceDevice);
+    ~KisAsyncDabRenderingQueue();
+
+    /**
+     * @return true if the dabs of \p painter can be rendered
+     *         asynchronously, that is the painter is owned by a stroke
+     *         supporting runnable jobs and the device is not in
+     *         wrap-around mode
+     */
+    static bool canRenderAsynchronously(KisPainter *painter);
+
+    /**
+     * Starts rendering of a dab by \p func. The dab will be composited with
+     * the current opacity and flow of the painter.
+     */
+    void addDab(RenderFunction func);
+
+    /**
+     * Composites the dabs rendered so far and returns the same values as
+     * KisPaintOp::doAsynchronousUpdate()
+     */
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISASYNCDABRENDERINGQUEUE_H
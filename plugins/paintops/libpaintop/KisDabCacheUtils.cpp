@@ -13,6 +13,7 @@
 
 #include <KisSharpnessOption.h>
 #include <kis_texture_option.h>
+#include <KisTransformedTipCache.h>
 
 #include <kundo2command.h>
 
@@ -47,6 +48,7 @@ void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources,
     KIS_SAFE_ASSERT_RECOVER_RETURN(*dab);
     const KoColorSpace *cs = (*dab)->colorSpace();
 
+    KisTransformedTipCache::ExactTipsGuard exactTipsGuard(di.exactTips);
 
     if (forceNormalizedRGBAImageStamp || resources->brush->brushApplication() == IMAGESTAMP) {
         *dab = resources->brush->paintDevice(cs, di.shape, di.info,
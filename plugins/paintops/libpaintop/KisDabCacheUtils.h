@@ -92,6 +92,12 @@ struct PAINTOP_EXPORT DabGenerationInfo
     qreal softnessFactor = 1.0;
     qreal lightnessStrength = 1.0;
 
+    /**
+     * The highest precision level, the transformed tips of the
+     * brush should not be quantized
+     */
+    bool exactTips = false;
+
     bool needsPostprocessing = false;
 };
 
@@ -107,6 +107,14 @@ QRect KisTextureMaskInfo::maskBounds() const {
     return m_maskBounds;
 }
 
+const quint8* KisTextureMaskInfo::maskData() const {
+    return m_maskData.constData();
+}
+
+int KisTextureMaskInfo::maskDataPixelSize() const {
+    return m_maskDataPixelSize;
+}
+
 bool KisTextureMaskInfo::fillProperties(const KisPropertiesConfiguration *setting, KisResourcesInterfaceSP resourcesInterface)
 {
     KisTextureOptionData data;
@@ -240,6 +248,22 @@ void KisTextureMaskInfo::recalculateMask()
         m_mask->convertFromQImage(mask, 0);
     }
     m_maskBounds = QRect(0, 0, width, height);
+
+    const KoColorSpace *dataColorSpace =
+        m_preserveAlpha ?
+            KoColorSpaceRegistry::instance()->rgb8() :
+            KoColorSpaceRegistry::instance()->alpha8();
+
+    KisPaintDeviceSP dataDevice = m_mask;
+
+    if (dataDevice->colorSpace() != dataColorSpace) {
+        dataDevice = new KisPaintDevice(*m_mask);
+        dataDevice->convertTo(dataColorSpace);
+    }
+
+    m_maskDataPixelSize = dataColorSpace->pixelSize();
+    m_maskData.resize(width * height * m_maskDataPixelSize);
+    dataDevice->readBytes(m_maskData.data(), m_maskBounds);
 }
 
 bool KisTextureMaskInfo::hasAlpha() {
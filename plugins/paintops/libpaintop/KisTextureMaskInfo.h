@@ -11,6 +11,7 @@
 #include <kis_paint_device.h>
 #include <QSharedPointer>
 #include <QMutex>
+#include <QVector>
 
 
 #include <boost/operators.hpp>
@@ -42,6 +43,21 @@ public:
 
     QRect maskBounds() const;
 
+    /**
+     * The mask converted into the color space the texture option
+     * consumes it in (rgb8 if the alpha is preserved, alpha8
+     * otherwise) and stored in a plain buffer with the row stride
+     * of maskBounds().width() pixels. The dabs read the pattern
+     * directly from this buffer instead of tiling it into a
+     * temporary paint device.
+     */
+    const quint8* maskData() const;
+
+    /**
+     * The size of a pixel in maskData()
+     */
+    int maskDataPixelSize() const;
+
     bool fillProperties(const KisPropertiesConfiguration *setting, KisResourcesInterfaceSP resourcesInterface);
 
     void recalculateMask();
@@ -66,6 +82,8 @@ private:
 
     KisPaintDeviceSP m_mask;
     QRect m_maskBounds;
+    QVector<quint8> m_maskData;
+    int m_maskDataPixelSize = 1;
 
 };
 
@@ -37,6 +37,8 @@ static const PrecisionValues precisionLevels[] = {
     {       eps,    0, eps,  eps, eps, eps}
 };
 
+static const int highestPrecisionLevel = sizeof(precisionLevels) / sizeof(precisionLevels[0]) - 1;
+
 struct KisDabCacheBase::SavedDabParameters {
     KoColor color;
     qreal angle;
@@ -271,11 +273,13 @@ void KisDabCacheBase::fetchDabGenerationInfo(bool hasDabInCache,
                                                     di->lightnessStrength,
                                                     di->mirrorProperties);
 
-    int precisionLevel = 4;
+    int precisionLevel = highestPrecisionLevel;
     if (m_d->precisionOption) {
         const int effectiveDabSize = qMin(newParams.width, newParams.height);
         precisionLevel = m_d->precisionOption->effectivePrecisionLevel(effectiveDabSize) - 1;
     }
+
+    di->exactTips = precisionLevel >= highestPrecisionLevel;
     *shouldUseCache = hasDabInCache && supportsCaching && di->solidColorFill &&
             newParams.compare(m_d->lastSavedDabParameters, precisionLevel);
 
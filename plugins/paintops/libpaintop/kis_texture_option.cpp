@@ -26,20 +26,57 @@
 #include <KoResource.h>
 #include <KoResourceServerProvider.h>
 #include <kis_paint_device.h>
-#include <kis_fill_painter.h>
 #include <kis_painter.h>
 #include <kis_iterator_ng.h>
 #include <kis_fixed_paint_device.h>
 #include "KoMixColorsOp.h"
 #include <strokes/KisMaskingBrushCompositeOpBase.h>
 #include <strokes/KisMaskingBrushCompositeOpFactory.h>
-#include <kis_random_accessor_ng.h>
 #include <KoCompositeOpRegistry.h>
 
 #include <KoCanvasResourcesIds.h>
 #include <KoCanvasResourcesInterface.h>
 #include <KoResourceLoadResult.h>
 
+namespace {
+
+int toPatternLocal(int value, int size)
+{
+    return value >= 0 ? value % size : size - (-value - 1) % size - 1;
+}
+
+/**
+ * Splits \p rect of the infinitely tiled pattern of \p patternSize
+ * into the chunks that don't cross the borders of the pattern, the
+ * same way KisFillPainter::fillRect() tiles a pattern device, and
+ * passes them to \p func(srcX, srcY, dabX, dabY, columns, rows),
+ * where (dabX, dabY) is the position of the chunk relative to
+ * the top-left corner of \p rect.
+ */
+template <typename Func>
+void forEachPatternChunk(const QRect &rect, const QSize &patternSize, Func func)
+{
+    int dabY = 0;
+    while (dabY < rect.height()) {
+        const int srcY = toPatternLocal(rect.y() + dabY, patternSize.height());
+        const int rows = qMin(patternSize.height() - srcY, rect.height() - dabY);
+
+        int dabX = 0;
+        while (dabX < rect.width()) {
+            const int srcX = toPatternLocal(rect.x() + dabX, patternSize.width());
+            const int columns = qMin(patternSize.width() - srcX, rect.width() - dabX);
+
+            func(srcX, srcY, dabX, dabY, columns, rows);
+
+            dabX += columns;
+        }
+
+        dabY += rows;
+    }
+}
+
+}
+
 /**********************************************************************/
 /*       KisTextureOption                                             */
 /**********************************************************************/
@@ -79,7 +116,22 @@ void KisTextureOption::fillProperties(const KisPropertiesConfiguration *setting,
         m_texturingMode = KisTextureOptionData::SUBTRACT;
     }
 
-    const bool preserveAlpha = m_texturingMode == KisTextureOptionData::LIGHTNESS || m_texturingMode == KisTextureOptionData::GRADIENT;
+    if (m_texturingMode == KisTextureOptionData::GRADIENT && canvasResourcesInterface) {
+        KoAbstractGradientSP gradient = canvasResourcesInterface->resource(KoCanvasResource::CurrentGradient).value<KoAbstractGradientSP>()->cloneAndBakeVariableColors(canvasResourcesInterface);
+        if (gradient) {
+            m_gradient = gradient;
+            m_cachedGradient.setGradient(gradient, 256);
+        }
+    }
+
+    /**
+     * The mask data is prepared for the mode that is actually going to
+     * be applied: without a gradient the gradient mode goes through the
+     * alpha path of apply(), which needs the alpha8 data
+     */
+    const bool preserveAlpha =
+        m_texturingMode == KisTextureOptionData::LIGHTNESS ||
+        (m_texturingMode == KisTextureOptionData::GRADIENT && m_gradient);
 
     m_maskInfo = toQShared(new KisTextureMaskInfo(m_levelOfDetail, preserveAlpha));
     if (!m_maskInfo->fillProperties(setting, resourcesInterface)) {
@@ -93,14 +145,6 @@ void KisTextureOption::fillProperties(const KisPropertiesConfiguration *setting,
     m_enabled = data.isEnabled;
     m_offsetX = data.offsetX;
     m_offsetY = data.offsetY;
-
-    if (m_texturingMode == KisTextureOptionData::GRADIENT && canvasResourcesInterface) {
-        KoAbstractGradientSP gradient = canvasResourcesInterface->resource(KoCanvasResource::CurrentGradient).value<KoAbstractGradientSP>()->cloneAndBakeVariableColors(canvasResourcesInterface);
-        if (gradient) {
-            m_gradient = gradient;
-            m_cachedGradient.setGradient(gradient, 256);
-        }
-    }
 }
 
 QList<KoResourceLoadResult> KisTextureOption::prepareEmbeddedResources(const KisPropertiesConfigurationSP setting, KisResourcesInterfaceSP resourcesInterface)
@@ -158,33 +202,35 @@ void KisTextureOption::applyLightness(KisFixedPaintDeviceSP dab, const QPoint& o
     if (!m_enabled) return;
     if (!m_maskInfo->isValid()) return;
 
-    KisPaintDeviceSP mask = m_maskInfo->mask();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_maskInfo->maskDataPixelSize() == 4);
 
     const QRect rect = dab->bounds();
     const QRect maskBounds = m_maskInfo->maskBounds();
 
-    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->rgb8(), m_cachedPaintDevice);
-    KisPaintDeviceSP fillMaskDevice = g.device();
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
     const QRect maskPatchRect = QRect(x, y, rect.width(), rect.height());
 
-    KisFillPainter fillMaskPainter(fillMaskDevice);
-    fillMaskPainter.setCompositeOpId(COMPOSITE_COPY);
-    fillMaskPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
-    fillMaskPainter.end();
-
     qreal pressure = m_strengthOption.apply(info);
-    quint8* dabData = dab->data();
 
-    KisSequentialConstIterator it(fillMaskDevice, QRect(x, y, rect.width(), rect.height()));
-    while (it.nextPixel()) {
-        const QRgb *maskQRgb = reinterpret_cast<const QRgb*>(it.oldRawData());
-        dab->colorSpace()->fillGrayBrushWithColorAndLightnessWithStrength(dabData, maskQRgb, dabData, pressure, 1);
-        dabData += dab->pixelSize();
-    }
+    const KoColorSpace *dabColorSpace = dab->colorSpace();
+    const int dabPixelSize = dab->pixelSize();
+    const QRgb *maskData = reinterpret_cast<const QRgb*>(m_maskInfo->maskData());
+
+    forEachPatternChunk(maskPatchRect, maskBounds.size(),
+        [&] (int srcX, int srcY, int dabX, int dabY, int columns, int rows) {
+            for (int row = 0; row < rows; row++) {
+                const QRgb *maskQRgb = maskData + (srcY + row) * maskBounds.width() + srcX;
+                quint8 *dabData = dab->data() + ((dabY + row) * rect.width() + dabX) * dabPixelSize;
+
+                for (int col = 0; col < columns; col++) {
+                    dabColorSpace->fillGrayBrushWithColorAndLightnessWithStrength(dabData, maskQRgb, dabData, pressure, 1);
+                    dabData += dabPixelSize;
+                    maskQRgb++;
+                }
+            }
+        });
 }
 
 void KisTextureOption::applyGradient(KisFixedPaintDeviceSP dab, const QPoint& offset, const KisPaintInformation& info) {
@@ -192,26 +238,17 @@ void KisTextureOption::applyGradient(KisFixedPaintDeviceSP dab, const QPoint& of
     if (!m_maskInfo->isValid()) return;
 
     KIS_SAFE_ASSERT_RECOVER_RETURN(m_gradient && m_gradient->valid());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_maskInfo->maskDataPixelSize() == 4);
 
-    KisPaintDeviceSP mask = m_maskInfo->mask();
     const QRect maskBounds = m_maskInfo->maskBounds();
     QRect rect = dab->bounds();
 
-    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->rgb8(), m_cachedPaintDevice);
-    KisPaintDeviceSP fillDevice = g.device();
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
     const QRect maskPatchRect = QRect(x, y, rect.width(), rect.height());
 
-    KisFillPainter fillPainter(fillDevice);
-    fillPainter.setCompositeOpId(COMPOSITE_COPY);
-    fillPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
-    fillPainter.end();
-
     qreal pressure = m_strengthOption.apply(info);
-    quint8* dabData = dab->data();
 
     //for gradient textures...
     KoMixColorsOp* colorMix = dab->colorSpace()->mixColorsOp();
@@ -221,26 +258,31 @@ void KisTextureOption::applyGradient(KisFixedPaintDeviceSP dab, const QPoint& of
     quint8* colors[2];
     m_cachedGradient.setColorSpace(dab->colorSpace()); //Change colorspace here so we don't have to convert each pixel drawn
 
-    KisHLineIteratorSP iter = fillDevice->createHLineIteratorNG(x, y, rect.width());
-    for (int row = 0; row < rect.height(); ++row) {
-        for (int col = 0; col < rect.width(); ++col) {
-
-            const QRgb* maskQRgb = reinterpret_cast<const QRgb*>(iter->oldRawData());
-            qreal gradientvalue = qreal(qGray(*maskQRgb))/255.0;//qreal(*iter->oldRawData()) / 255.0;
-            KoColor paintcolor;
-            paintcolor.setColor(m_cachedGradient.cachedAt(gradientvalue), dab->colorSpace());
-            qreal paintOpacity = paintcolor.opacityF() * (qreal(qAlpha(*maskQRgb)) / 255.0);
-            paintcolor.setOpacity(qMin(paintOpacity, dab->colorSpace()->opacityF(dabData)));
-            colors[0] = paintcolor.data();
-            KoColor dabColor(dabData, dab->colorSpace());
-            colors[1] = dabColor.data();
-            colorMix->mixColors(colors, colorWeights, 2, dabData);
-
-            iter->nextPixel();
-            dabData += dab->pixelSize();
-        }
-        iter->nextRow();
-    }
+    const int dabPixelSize = dab->pixelSize();
+    const QRgb *maskData = reinterpret_cast<const QRgb*>(m_maskInfo->maskData());
+
+    forEachPatternChunk(maskPatchRect, maskBounds.size(),
+        [&] (int srcX, int srcY, int dabX, int dabY, int columns, int rows) {
+            for (int row = 0; row < rows; row++) {
+                const QRgb *maskQRgb = maskData + (srcY + row) * maskBounds.width() + srcX;
+                quint8 *dabData = dab->data() + ((dabY + row) * rect.width() + dabX) * dabPixelSize;
+
+                for (int col = 0; col < columns; col++) {
+                    qreal gradientvalue = qreal(qGray(*maskQRgb))/255.0;
+                    KoColor paintcolor;
+                    paintcolor.setColor(m_cachedGradient.cachedAt(gradientvalue), dab->colorSpace());
+                    qreal paintOpacity = paintcolor.opacityF() * (qreal(qAlpha(*maskQRgb)) / 255.0);
+                    paintcolor.setOpacity(qMin(paintOpacity, dab->colorSpace()->opacityF(dabData)));
+                    colors[0] = paintcolor.data();
+                    KoColor dabColor(dabData, dab->colorSpace());
+                    colors[1] = dabColor.data();
+                    colorMix->mixColors(colors, colorWeights, 2, dabData);
+
+                    dabData += dabPixelSize;
+                    maskQRgb++;
+                }
+            }
+        });
 }
 
 void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, const KisPaintInformation & info)
@@ -258,22 +300,13 @@ void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, co
     }
 
     QRect rect = dab->bounds();
-    KisPaintDeviceSP mask = m_maskInfo->mask();
     const QRect maskBounds = m_maskInfo->maskBounds();
 
-    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->alpha8(), m_cachedPaintDevice);
-    KisPaintDeviceSP maskPatch = g.device();
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
     const QRect maskPatchRect = QRect(x, y, rect.width(), rect.height());
 
-    KisFillPainter fillPainter(maskPatch);
-    fillPainter.setCompositeOpId(COMPOSITE_COPY);
-    fillPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
-    fillPainter.end();
-
     // Compute final strength
     qreal strength = m_strengthOption.apply(info);
 
@@ -319,45 +352,17 @@ void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, co
                         compositeOpId, alphaChannelType, dab->pixelSize(),
                         alphaChannelOffset, strength, m_useSoftTexturing));
 
-    // Apply the mask to the dab
-    {
-        quint8 *dabIt = nullptr;
-        KisRandomConstAccessorSP maskPatchIt = maskPatch->createRandomConstAccessorNG();
-
-        qint32 dabY = dab->bounds().y();
-        qint32 maskPatchY = maskPatchRect.y();
-        qint32 rowsRemaining = dab->bounds().height();
-        const qint32 dabRowStride = dab->bounds().width() * dab->pixelSize();
-
-        while (rowsRemaining > 0) {
-            qint32 dabX = dab->bounds().x();
-            qint32 maskPatchX = maskPatchRect.x();
-            const qint32 numContiguousMaskPatchRows = maskPatchIt->numContiguousRows(maskPatchY);
-            const qint32 rows = std::min(rowsRemaining, numContiguousMaskPatchRows);
-            qint32 columnsRemaining = dab->bounds().width();
-
-            while (columnsRemaining > 0) {
-                const qint32 numContiguousMaskPatchColumns = maskPatchIt->numContiguousColumns(maskPatchX);
-                const qint32 columns = std::min(columnsRemaining, numContiguousMaskPatchColumns);
-
-                const qint32 maskPatchRowStride = maskPatchIt->rowStride(maskPatchX, maskPatchY);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_maskInfo->maskDataPixelSize() == 1);
 
-                dabIt = dab->data() + (dabY * dab->bounds().width() + dabX) * dab->pixelSize();
-                maskPatchIt->moveTo(maskPatchX, maskPatchY);
+    // Apply the mask to the dab directly from the pre-converted
+    // pattern, one chunk per every crossed border of the pattern
+    const quint8 *maskData = m_maskInfo->maskData();
+    const qint32 dabRowStride = rect.width() * dab->pixelSize();
 
-                compositeOp->composite(maskPatchIt->rawDataConst(), maskPatchRowStride,
-                                       dabIt, dabRowStride,
-                                       columns, rows);
-
-                dabX += columns;
-                maskPatchX += columns;
-                columnsRemaining -= columns;
-
-            }
-
-            dabY += rows;
-            maskPatchY += rows;
-            rowsRemaining -= rows;
-        }
-    }
+    forEachPatternChunk(maskPatchRect, maskBounds.size(),
+        [&] (int srcX, int srcY, int dabX, int dabY, int columns, int rows) {
+            compositeOp->composite(maskData + srcY * maskBounds.width() + srcX, maskBounds.width(),
+                                   dab->data() + dabY * dabRowStride + dabX * dab->pixelSize(), dabRowStride,
+                                   columns, rows);
+        });
 }
@@ -19,6 +19,7 @@
 #include <qmath.h>
 #include <KoCompositeOpRegistry.h>
 #include <KoMixColorsOp.h>
+#include <KisRegion.h>
 
 using namespace std;
 
@@ -57,13 +58,56 @@ KisMyPaintSurface::KisMyPaintSurface(KisPainter *painter, KisPaintDeviceSP paint
     // devices for mask information
     static const KoColorSpace *maskCs = KoColorSpaceRegistry::instance()->alpha8();
     m_maskDevice = KisFixedPaintDeviceSP(new KisFixedPaintDevice(maskCs));
+
+    const QBitArray channelFlags = painter->channelFlags();
+    m_canPaintDirectly =
+        !painter->selection() &&
+        !painter->hasMirroring() &&
+        (channelFlags.isEmpty() || channelFlags.count(true) == channelFlags.size());
 }
 
 KisMyPaintSurface::~KisMyPaintSurface()
 {
+    endDabBatch();
     mypaint_surface_unref(m_surface);
 }
 
+void KisMyPaintSurface::beginDabBatch()
+{
+    m_isBatching = true;
+}
+
+void KisMyPaintSurface::endDabBatch()
+{
+    m_isBatching = false;
+
+    if (!m_pendingDirtyRegion.isEmpty()) {
+        const QVector<QRect> rects = KisRegion::fromQRegion(m_pendingDirtyRegion).rects();
+        m_pendingDirtyRegion = QRegion();
+
+        m_precisePainterWrapper.writeRects(rects);
+        painter()->addDirtyRects(rects);
+    }
+}
+
+void KisMyPaintSurface::flushDirtyRects(const QVector<QRect> &rects)
+{
+    if (m_isBatching) {
+        /**
+         * The dabs of a batch overlap a lot, so we write back only
+         * the union of them. The union is exact (not aligned to any
+         * grid), because the overlay is guaranteed to be read only
+         * in the areas of the dabs themselves.
+         */
+        Q_FOREACH (const QRect &rc, rects) {
+            m_pendingDirtyRegion += rc;
+        }
+    } else {
+        m_precisePainterWrapper.writeRects(rects);
+        painter()->addDirtyRects(rects);
+    }
+}
+
 int KisMyPaintSurface::draw_dab(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
                                 float color_b, float opaque, float hardness, float color_a,
                                 float aspect_ratio, float angle, float lock_alpha, float colorize) {
@@ -151,58 +195,38 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
     const QPointF center = QPointF(x, y);
 
     KisAlgebra2D::OuterCircle outer(center, radius);
-    m_precisePainterWrapper.readRects(m_tempPainter->calculateAllMirroredRects(dabRectAligned));
-    m_tempPainter->copyAreaOptimized(dabRectAligned.topLeft(), m_tempPainter->device(), m_dab, dabRectAligned);
-    KisSequentialIterator it(m_dab, dabRectAligned);
-
-    quint8 maskUnitValue = KoColorSpaceMathsTraits<quint8>::unitValue; // because it's alpha8
-
-    float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
-    float minValue = KoColorSpaceMathsTraits<channelType>::min;
-    bool eraser = painter()->compositeOpId() == COMPOSITE_ERASE;
-
-
-    m_maskDevice->setRect(dabRectAligned);
-    m_maskDevice->lazyGrowBufferWithoutInitialization();
-
-
-    // Dmitry says that going with the pointer should be in the same order
-    // as using the sequential iterator
-    quint8* maskPointer = m_maskDevice->data();
-
-
-    while(it.nextPixel()) {
-
-        // first initialize to 0;
-        *maskPointer = 0;
 
-        QPoint pt(it.x(), it.y());
+    const float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
+    const float minValue = KoColorSpaceMathsTraits<channelType>::min;
+    const bool eraser = painter()->compositeOpId() == COMPOSITE_ERASE;
 
-        if(outer.fadeSq(pt) > 1.0f) {
-            maskPointer++;
-            continue;
+    /**
+     * Blends the dab into a single pixel in place. Returns false if
+     * the pixel is not covered by the dab, in which case the pixel
+     * is left untouched.
+     */
+    auto blendPixel = [&] (int xp, int yp, quint8 *rawData) {
+        if (outer.fadeSq(QPoint(xp, yp)) > 1.0f) {
+            return false;
         }
 
         float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
 
         if (radius < 3.0) {
-            rr = calculate_rr_antialiased (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
+            rr = calculate_rr_antialiased (xp, yp, x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
         }
         else {
-            rr = calculate_rr (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2);
+            rr = calculate_rr (xp, yp, x, y, aspect_ratio, sn, cs, one_over_radius2);
         }
 
         base_alpha = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
-
-        m_tempPainter->selection();
         alpha = base_alpha * normal_mode;
 
-        // set alpha to mask
-        if (alpha > minValue) {
-            *maskPointer = (quint8)(maskUnitValue);
+        if (!(alpha > minValue)) {
+            return false;
         }
 
-        channelType* nativeArray = reinterpret_cast<channelType*>(it.rawData());
+        channelType* nativeArray = reinterpret_cast<channelType*>(rawData);
 
         b = nativeArray[0]/unitValue;
         g = nativeArray[1]/unitValue;
@@ -263,15 +287,47 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
         nativeArray[2] = KoColorSpaceMaths<float, channelType>::scaleToA(r);
         nativeArray[3] = KoColorSpaceMaths<float, channelType>::scaleToA(a);
 
-        maskPointer++;
+        return true;
+    };
+
+    if (m_canPaintDirectly) {
+        /**
+         * The overlay is already in the precise color space of the dab,
+         * so we can blend the dab right into its tiles, skipping the
+         * pixels that are not covered by the dab.
+         */
+        m_precisePainterWrapper.readRect(dabRectAligned);
+
+        KisSequentialIterator it(m_precisePainterWrapper.overlay(), dabRectAligned);
+        while (it.nextPixel()) {
+            blendPixel(it.x(), it.y(), it.rawData());
+        }
+
+        flushDirtyRects({dabRectAligned});
+        return 1;
     }
 
+    m_precisePainterWrapper.readRects(m_tempPainter->calculateAllMirroredRects(dabRectAligned));
+    m_tempPainter->copyAreaOptimized(dabRectAligned.topLeft(), m_tempPainter->device(), m_dab, dabRectAligned);
+    KisSequentialIterator it(m_dab, dabRectAligned);
+
+    quint8 maskUnitValue = KoColorSpaceMathsTraits<quint8>::unitValue; // because it's alpha8
+
+    m_maskDevice->setRect(dabRectAligned);
+    m_maskDevice->lazyGrowBufferWithoutInitialization();
+
+    // Dmitry says that going with the pointer should be in the same order
+    // as using the sequential iterator
+    quint8* maskPointer = m_maskDevice->data();
+
+    while(it.nextPixel()) {
+        *maskPointer = blendPixel(it.x(), it.y(), it.rawData()) ? maskUnitValue : 0;
+        maskPointer++;
+    }
 
     m_tempPainter->bitBltWithFixedSelection(dabRectAligned.x(), dabRectAligned.y(), m_dab, m_maskDevice, dabRectAligned.x(), dabRectAligned.y(), dabRectAligned.x(), dabRectAligned.y(), dabRectAligned.width(), dabRectAligned.height());
     m_tempPainter->renderMirrorMask(dabRectAligned, m_dab, dabRectAligned.x(), dabRectAligned.y(), m_maskDevice);
-    const QVector<QRect> dirtyRects = m_tempPainter->takeDirtyRegion();
-    m_precisePainterWrapper.writeRects(dirtyRects);
-    painter()->addDirtyRects(dirtyRects);
+    flushDirtyRects(m_tempPainter->takeDirtyRegion());
     return 1;
 }
 
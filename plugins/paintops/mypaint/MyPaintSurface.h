@@ -8,6 +8,7 @@
 #define KIS_MYPAINT_SURFACE_H
 
 #include <QObject>
+#include <QRegion>
 
 #include <kis_paint_device.h>
 #include <kis_fixed_paint_device.h>
@@ -76,6 +77,19 @@ public:
 
     MyPaintSurface* surface();
 
+    /**
+     * Starts a batch of dabs. While the batch is active, the dabs are
+     * painted only on the overlay of the painter's device and the
+     * result is written back into the device with a single pass in
+     * endDabBatch(). Outside of a batch every dab is written back
+     * immediately.
+     */
+    void beginDabBatch();
+    void endDabBatch();
+
+private:
+    void flushDirtyRects(const QVector<QRect> &rects);
+
 private:
     KisPainter *m_painter;
     KisPaintDeviceSP m_imageDevice;
@@ -88,6 +102,16 @@ private:
     KisFixedPaintDeviceSP m_blendDevice;
     KisFixedPaintDeviceSP m_maskDevice;
 
+    /**
+     * When there is no selection, mirroring or locked channels, the
+     * dabs are painted right into the tiles of the overlay, without
+     * copying them into a temporary device and blitting them back.
+     */
+    bool m_canPaintDirectly {false};
+
+    bool m_isBatching {false};
+    QRegion m_pendingDirtyRegion;
+
 };
 
 #endif // KIS_MYPAINT_SURFACE_H
@@ -17,6 +17,8 @@
 #include <kis_paint_information.h>
 #include <kis_random_accessor_ng.h>
 #include <KisGlobalResourcesInterface.h>
+#include <kis_selection.h>
+#include <kis_pixel_selection.h>
 
 #include "kis_mypaintop_test.h"
 #include "MyPaintPaintOp.h"
@@ -79,6 +81,66 @@ void KisMyPaintOpTest::testGetColor() {
     QVERIFY(qFuzzyCompare((float)qRound(a), 1.0L));
 }
 
+namespace {
+void drawTestDabs(KisMyPaintSurface *surface)
+{
+    for (int i = 0; i < 8; i++) {
+        surface->draw_dab(surface->surface(), 150 + 20 * i, 250, 50, 0, 0, 1, 0.5, 0.8, 1, 1, 90, 0, 0);
+    }
+}
+}
+
+void KisMyPaintOpTest::testBatchedDabs() {
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisPaintDeviceSP referenceDevice = new KisPaintDevice(cs);
+    KisPaintDeviceSP batchedDevice = new KisPaintDevice(cs);
+    KisPaintDeviceSP selectedDevice = new KisPaintDevice(cs);
+
+    {
+        KisPainter painter(referenceDevice);
+        QScopedPointer<KisMyPaintSurface> surface(new KisMyPaintSurface(&painter, referenceDevice));
+        drawTestDabs(surface.data());
+    }
+
+    {
+        KisPainter painter(batchedDevice);
+        QScopedPointer<KisMyPaintSurface> surface(new KisMyPaintSurface(&painter, batchedDevice));
+
+        surface->beginDabBatch();
+        drawTestDabs(surface.data());
+
+        // nothing is written into the device until the batch is finished
+        QVERIFY(batchedDevice->exactBounds().isEmpty());
+
+        surface->endDabBatch();
+    }
+
+    {
+        // a selection disables painting right into the overlay
+        KisSelectionSP selection = new KisSelection();
+        selection->pixelSelection()->select(QRect(0, 0, 500, 500));
+
+        KisPainter painter(selectedDevice);
+        painter.setSelection(selection);
+        QScopedPointer<KisMyPaintSurface> surface(new KisMyPaintSurface(&painter, selectedDevice));
+
+        surface->beginDabBatch();
+        drawTestDabs(surface.data());
+        surface->endDabBatch();
+    }
+
+    const QRect rc = referenceDevice->exactBounds();
+    QVERIFY(!rc.isEmpty());
+
+    const QImage referenceImage = referenceDevice->convertToQImage(0, rc);
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint, referenceImage, batchedDevice->convertToQImage(0, rc)));
+    QVERIFY(TestUtil::compareQImages(errpoint, referenceImage, selectedDevice->convertToQImage(0, rc)));
+}
+
 void KisMyPaintOpTest::testLoading() {
 
     QScopedPointer<KisMyPaintPaintOpPreset> brush (new KisMyPaintPaintOpPreset(QString(FILES_DATA_DIR) + QDir::separator() + "basic.myb"));
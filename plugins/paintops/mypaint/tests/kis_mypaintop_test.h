@@ -23,6 +23,7 @@ public:
 private Q_SLOTS:
     void testDab();
     void testGetColor();
+    void testBatchedDabs();
     void testLoading();
 };
 
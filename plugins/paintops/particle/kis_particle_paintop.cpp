@@ -11,6 +11,7 @@
 
 #include "kis_vec.h"
 
+#include <KoColor.h>
 #include <KoCompositeOp.h>
 
 #include <kis_image.h>
@@ -24,6 +25,7 @@
 #include <kis_paintop_plugin_utils.h>
 #include <brushengine/kis_paintop.h>
 #include <brushengine/kis_paint_information.h>
+#include <KisAsyncDabRenderingQueue.h>
 
 #include "KisParticleOpOptionData.h"
 
@@ -43,12 +45,25 @@ KisParticlePaintOp::KisParticlePaintOp(const KisPaintOpSettingsSP settings, KisP
     m_particleBrush.initParticles();
 
     m_airbrushData.read(settings.data());
+
+    if (settings->needsAsynchronousUpdates() &&
+        KisAsyncDabRenderingQueue::canRenderAsynchronously(painter)) {
+
+        m_asyncQueue.reset(new KisAsyncDabRenderingQueue(painter, source()));
+    }
 }
 
 KisParticlePaintOp::~KisParticlePaintOp()
 {
 }
 
+std::pair<int, bool> KisParticlePaintOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    return m_asyncQueue ?
+        m_asyncQueue->doAsynchronousUpdate(jobs) :
+        KisPaintOp::doAsynchronousUpdate(jobs);
+}
+
 KisSpacingInformation KisParticlePaintOp::paintAt(const KisPaintInformation& info)
 {
     doPaintLine(info, info);
@@ -83,6 +98,25 @@ void KisParticlePaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPa
 {
     if (!painter()) return;
 
+    if (m_asyncQueue) {
+        if (m_first) {
+            m_particleBrush.setInitialPosition(pi1.pos());
+            m_first = false;
+        }
+
+        const QVector<QPointF> positions =
+            m_particleBrush.simulate(pi2.pos(), m_particleBrush.simulationBounds(source()));
+        const KoColor color = painter()->paintColor();
+        const qreal weight = m_particleOpData.particleWeight;
+
+        m_asyncQueue->addDab(
+            [positions, color, weight] (KisPaintDeviceSP dab) {
+                ParticleBrush::paintParticles(dab, color, positions, weight);
+            });
+
+        return;
+    }
+
     if (!m_dab) {
         m_dab = source()->createCompositionSourceDevice();
     }
@@ -7,6 +7,8 @@
 #ifndef KIS_PARTICLE_PAINTOP_H_
 #define KIS_PARTICLE_PAINTOP_H_
 
+#include <QScopedPointer>
+
 #include <brushengine/kis_paintop.h>
 #include <kis_types.h>
 #include <KisAirbrushOptionData.h>
@@ -15,6 +17,8 @@
 #include "kis_particle_paintop_settings.h"
 #include "particle_brush.h"
 
+class KisAsyncDabRenderingQueue;
+
 class KisPainter;
 class KisPaintInformation;
 
@@ -28,6 +32,8 @@ public:
 
     void paintLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2, KisDistanceInformation *currentDistance) override;
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
 protected:
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
 
@@ -45,6 +51,12 @@ private:
     KisAirbrushOptionData m_airbrushData;
     KisRateOption m_rateOption;
     bool m_first;
+
+    /**
+     * In asynchronous mode the physics of the particles is calculated in
+     * paintLine(), but the particles are painted in the stroke jobs
+     */
+    QScopedPointer<KisAsyncDabRenderingQueue> m_asyncQueue;
 };
 
 #endif // KIS_PARTICLE_PAINTOP_H_
@@ -21,6 +21,8 @@ public:
 
     bool paintIncremental() override;
 
+    bool needsAsynchronousUpdates() const override;
+
     QList<KisUniformPaintOpPropertySP> uniformProperties(KisPaintOpSettingsSP settings, QPointer<KisPaintOpPresetUpdateProxy> updateProxy) override;
 
 private:
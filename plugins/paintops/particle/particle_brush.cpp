@@ -81,15 +81,25 @@ void ParticleBrush::paintParticle(KisRandomAccessorSP accWrite, const KoColorSpa
 
 void ParticleBrush::draw(KisPaintDeviceSP dab, const KoColor& color, const QPointF &pos)
 {
-    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
-    const KoColorSpace * cs = dab->colorSpace();
+    paintParticles(dab, color, simulate(pos, simulationBounds(dab)), m_properties->particleWeight);
+}
 
+QRect ParticleBrush::simulationBounds(KisPaintDeviceSP dab) const
+{
     QRect boundingRect;
 
     if (m_properties->particleScaleX < 0 || m_properties->particleScaleY < 0 || m_properties->particleGravity < 0) {
         boundingRect = dab->defaultBounds()->bounds();
     }
 
+    return boundingRect;
+}
+
+QVector<QPointF> ParticleBrush::simulate(const QPointF &pos, const QRect &boundingRect)
+{
+    QVector<QPointF> positions;
+    positions.reserve(m_properties->particleIterations * m_properties->particleCount);
+
     for (int i = 0; i < m_properties->particleIterations; i++) {
         for (int j = 0; j < m_properties->particleCount; j++) {
             /*
@@ -140,11 +150,23 @@ void ParticleBrush::draw(KisPaintDeviceSP dab, const KoColor& color, const QPoin
             bool inside = boundingRect.contains(m_particlePos[j].toPoint());
 
             if (boundingRect.isEmpty() || (inside && !nearInfinity)) {
-                paintParticle(accessor, cs, m_particlePos[j], color, m_properties->particleWeight, true);
+                positions.append(m_particlePos[j]);
             }
 
         }//for j
     }//for i
+
+    return positions;
+}
+
+void ParticleBrush::paintParticles(KisPaintDeviceSP dab, const KoColor& color, const QVector<QPointF> &positions, qreal weight)
+{
+    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
+    const KoColorSpace * cs = dab->colorSpace();
+
+    Q_FOREACH (const QPointF &pos, positions) {
+        paintParticle(accessor, cs, pos, color, weight, true);
+    }
 }
 
 
@@ -39,6 +39,19 @@ public:
     void initParticles();
     void draw(KisPaintDeviceSP dab, const KoColor& color, const QPointF &pos);
 
+    /**
+     * Moves the particles towards \p pos and returns the positions the
+     * particles should be painted at. The particles outside \p boundingRect
+     * are skipped, unless the rect is empty.
+     */
+    QVector<QPointF> simulate(const QPointF &pos, const QRect &boundingRect);
+
+    /// paints the particles returned by simulate(), doesn't depend on the state of the brush
+    static void paintParticles(KisPaintDeviceSP dab, const KoColor& color, const QVector<QPointF> &positions, qreal weight);
+
+    /// the rect the particles are limited to if their movement is unstable
+    QRect simulationBounds(KisPaintDeviceSP dab) const;
+
     void setInitialPosition(const QPointF &pos);
     void setProperties(KisParticleOpOptionData * properties) {
         m_properties = properties;
@@ -47,7 +60,7 @@ public:
 private:
     /// paints wu particle, similar to spray version but you can turn on respecting opacity of the tool and add weight to opacity
     /// also the particle respects opacity in the destination pixel buffer
-    void paintParticle(KisRandomAccessorSP writeAccessor, const KoColorSpace *cs,const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity);
+    static void paintParticle(KisRandomAccessorSP writeAccessor, const KoColorSpace *cs,const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity);
 
     QVector<QPointF> m_particlePos;
     QVector<QPointF> m_particleNextPos;
@@ -28,6 +28,7 @@
 
 #include <kis_dab_cache.h>
 #include "kis_lod_transform.h"
+#include <KisAsyncDabRenderingQueue.h>
 #include <KoResourceLoadResult.h>
 
 
@@ -71,39 +72,62 @@ KisSketchPaintOp::KisSketchPaintOp(const KisPaintOpSettingsSP settings, KisPaint
     m_brush = m_brushOption.brush();
     m_dabCache = new KisDabCache(m_brush);
 
-    m_painter = 0;
     m_count = 0;
+
+    if (settings->needsAsynchronousUpdates() &&
+        KisAsyncDabRenderingQueue::canRenderAsynchronously(painter)) {
+
+        m_asyncQueue.reset(new KisAsyncDabRenderingQueue(painter, source()));
+    }
 }
 
 KisSketchPaintOp::~KisSketchPaintOp()
 {
-    delete m_painter;
     delete m_dabCache;
 }
 
+std::pair<int, bool> KisSketchPaintOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    return m_asyncQueue ?
+        m_asyncQueue->doAsynchronousUpdate(jobs) :
+        KisPaintOp::doAsynchronousUpdate(jobs);
+}
+
 QList<KoResourceLoadResult> KisSketchPaintOp::prepareLinkedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface)
 {
     KisBrushOptionProperties brushOption;
     return brushOption.prepareLinkedResources(settings, resourcesInterface);
 }
 
-void KisSketchPaintOp::drawConnection(const QPointF& start, const QPointF& end, double lineWidth)
+void KisSketchPaintOp::addConnection(QVector<Connection> &connections, const QPointF &start, const QPointF &end, qreal lineWidth) const
 {
-    //Both drawWuLine() and the drawDDALine produce nicer 1px lines than the drawLine()
-    if (m_sketchProperties.antiAliasing) {
-        if (lineWidth == 1.0) {
-            m_painter->drawWuLine(start, end);
-        }
-        else {
-            m_painter->drawLine(start, end, lineWidth, true);
-        }
-    }
-    else {
-        if (lineWidth == 1.0) {
-            m_painter->drawDDALine(start, end);
+    connections.append({start, end, lineWidth, m_lineColor, m_lineOpacity});
+}
+
+void KisSketchPaintOp::drawConnections(KisPaintDeviceSP dab, const QVector<Connection> &connections, bool antiAliasing)
+{
+    KisPainter painter(dab);
+
+    Q_FOREACH (const Connection &connection, connections) {
+        painter.setPaintColor(connection.color);
+        painter.setOpacity(connection.opacity);
+
+        //Both drawWuLine() and the drawDDALine produce nicer 1px lines than the drawLine()
+        if (antiAliasing) {
+            if (connection.lineWidth == 1.0) {
+                painter.drawWuLine(connection.start, connection.end);
+            }
+            else {
+                painter.drawLine(connection.start, connection.end, connection.lineWidth, true);
+            }
         }
         else {
-            m_painter->drawLine(start, end, lineWidth, false);
+            if (connection.lineWidth == 1.0) {
+                painter.drawDDALine(connection.start, connection.end);
+            }
+            else {
+                painter.drawLine(connection.start, connection.end, connection.lineWidth, false);
+            }
         }
     }
 }
@@ -111,7 +135,7 @@ void KisSketchPaintOp::drawConnection(const QPointF& start, const QPointF& end,
 void KisSketchPaintOp::updateBrushMask(const KisPaintInformation& info, qreal scale, qreal rotation)
 {
     QRect dstRect;
-    m_maskDab = m_dabCache->fetchDab(m_dab->colorSpace(),
+    m_maskDab = m_dabCache->fetchDab(source()->compositionSourceColorSpace(),
                                      painter()->paintColor(),
                                      info.pos(),
                                      KisDabShape(scale, 1.0, rotation),
@@ -139,13 +163,8 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
 {
     if (!m_brush || !painter()) return;
 
-    if (!m_dab) {
-        m_dab = source()->createCompositionSourceDevice();
-        m_painter = new KisPainter(m_dab);
-        m_painter->setPaintColor(painter()->paintColor());
-    }
-    else {
-        m_dab->clear();
+    if (m_count == 0) {
+        m_lineColor = painter()->paintColor();
     }
 
     QPointF prevMouse = pi1.pos();
@@ -163,9 +182,11 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
     const double rotation = m_rotationOption.apply(pi2);
     const double currentProbability = m_densityOption.apply(pi2) * m_sketchProperties.probability;
 
+    QVector<Connection> connections;
+
     // shaded: does not draw this line, chrome does, fur does
     if (m_sketchProperties.makeConnection) {
-        drawConnection(prevMouse, mousePosition, currentLineWidth);
+        addConnection(connections, prevMouse, mousePosition, currentLineWidth);
     }
 
 
@@ -198,7 +219,7 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
 
     QColor painterColor = painter()->paintColor().toQColor();
     QColor randomColor;
-    KoColor color(m_dab->colorSpace());
+    KoColor color(source()->compositionSourceColorSpace());
 
     int w = m_maskDab->bounds().width();
     quint8 opacityU8 = 0;
@@ -267,7 +288,7 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
                                     r2 * painterColor.greenF(),
                                     r3 * painterColor.blueF());
                 color.fromQColor(randomColor);
-                m_painter->setPaintColor(color);
+                m_lineColor = color;
             }
 
             // distance based opacity
@@ -280,13 +301,13 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
                 opacity *= randomSource->generateNormalized();
             }
 
-            m_painter->setOpacity(opacity);
+            m_lineOpacity = opacity;
 
             if (m_sketchProperties.magnetify) {
-                drawConnection(mousePosition + offsetPt, m_points.at(i) - offsetPt, currentLineWidth);
+                addConnection(connections, mousePosition + offsetPt, m_points.at(i) - offsetPt, currentLineWidth);
             }
             else {
-                drawConnection(mousePosition + offsetPt, mousePosition - offsetPt, currentLineWidth);
+                addConnection(connections, mousePosition + offsetPt, mousePosition - offsetPt, currentLineWidth);
             }
 
 
@@ -296,11 +317,30 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
 
     m_count++;
 
-    QRect rc = m_dab->extent();
     quint8 origOpacity = m_opacityOption.apply(painter(), pi2);
 
-    painter()->bitBlt(rc.x(), rc.y(), m_dab, rc.x(), rc.y(), rc.width(), rc.height());
-    painter()->renderMirrorMask(rc, m_dab);
+    if (m_asyncQueue) {
+        const bool antiAliasing = m_sketchProperties.antiAliasing;
+
+        m_asyncQueue->addDab(
+            [connections, antiAliasing] (KisPaintDeviceSP dab) {
+                drawConnections(dab, connections, antiAliasing);
+            });
+    } else {
+        if (!m_dab) {
+            m_dab = source()->createCompositionSourceDevice();
+        }
+        else {
+            m_dab->clear();
+        }
+
+        drawConnections(m_dab, connections, m_sketchProperties.antiAliasing);
+
+        QRect rc = m_dab->extent();
+        painter()->bitBlt(rc.x(), rc.y(), m_dab, rc.x(), rc.y(), rc.width(), rc.height());
+        painter()->renderMirrorMask(rc, m_dab);
+    }
+
     painter()->setOpacity(origOpacity);
 }
 
@@ -7,6 +7,10 @@
 #ifndef KIS_SKETCH_PAINTOP_H_
 #define KIS_SKETCH_PAINTOP_H_
 
+#include <QScopedPointer>
+
+#include <KoColor.h>
+
 #include <brushengine/kis_paintop.h>
 #include <kis_types.h>
 
@@ -22,6 +26,7 @@
 #include "KisAirbrushOptionData.h"
 
 class KisDabCache;
+class KisAsyncDabRenderingQueue;
 
 
 class KisSketchPaintOp : public KisPaintOp
@@ -34,6 +39,8 @@ public:
 
     void paintLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2, KisDistanceInformation *currentDistance) override;
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
     static QList<KoResourceLoadResult> prepareLinkedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 
 protected:
@@ -43,6 +50,16 @@ protected:
 
     KisTimingInformation updateTimingImpl(const KisPaintInformation &info) const override;
 
+private:
+    /// a line generated by the sketch algorithm
+    struct Connection {
+        QPointF start;
+        QPointF end;
+        qreal lineWidth;
+        KoColor color;
+        quint8 opacity;
+    };
+
 private:
     // pixel buffer
     KisPaintDeviceSP m_dab;
@@ -69,12 +86,22 @@ private:
 
     QVector<QPointF> m_points;
     int m_count {0};
-    KisPainter * m_painter {nullptr};
     KisBrushSP m_brush;
     KisDabCache *m_dabCache {nullptr};
 
+    // the color and opacity of the lines persist between the calls to doPaintLine()
+    KoColor m_lineColor;
+    quint8 m_lineOpacity {OPACITY_OPAQUE_U8};
+
+    /**
+     * In asynchronous mode the lines are generated in doPaintLine(), but
+     * drawn in the stroke jobs
+     */
+    QScopedPointer<KisAsyncDabRenderingQueue> m_asyncQueue;
+
 private:
-    void drawConnection(const QPointF &start, const QPointF &end, double lineWidth);
+    void addConnection(QVector<Connection> &connections, const QPointF &start, const QPointF &end, qreal lineWidth) const;
+    static void drawConnections(KisPaintDeviceSP dab, const QVector<Connection> &connections, bool antiAliasing);
     void updateBrushMask(const KisPaintInformation& info, qreal scale, qreal rotation);
     void doPaintLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2);
 };
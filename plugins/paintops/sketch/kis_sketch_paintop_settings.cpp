@@ -22,6 +22,11 @@ bool KisSketchPaintOpSettings::paintIncremental()
     return data.paintingMode == enumPaintingMode::BUILDUP;
 }
 
+bool KisSketchPaintOpSettings::needsAsynchronousUpdates() const
+{
+    return true;
+}
+
 KisOptimizedBrushOutline KisSketchPaintOpSettings::brushOutline(const KisPaintInformation &info, const OutlineMode &mode, qreal alignForZoom)
 {
     bool isSimpleMode = getBool("Sketch/simpleMode");
@@ -24,6 +24,8 @@ public:
 
     bool paintIncremental() override;
 
+    bool needsAsynchronousUpdates() const override;
+
     bool hasPatternSettings() const override;
 };
 
@@ -22,6 +22,7 @@
 #include <kis_lod_transform.h>
 #include <kis_paintop_plugin_utils.h>
 #include <KoResourceLoadResult.h>
+#include <KisAsyncDabRenderingQueue.h>
 
 
 KisSprayPaintOp::KisSprayPaintOp(const KisPaintOpSettingsSP settings, KisPainter *painter, KisNodeSP node, KisImageSP image)
@@ -71,6 +72,15 @@ KisSprayPaintOp::KisSprayPaintOp(const KisPaintOpSettingsSP settings, KisPainter
         m_ySpacing = m_xSpacing = 1.0;
     }
     m_spacing = m_xSpacing;
+
+    if (m_isPresetValid &&
+        m_sprayBrush.usesSimpleShapes() &&
+        !m_colorProperties.sampleInputColor &&
+        settings->needsAsynchronousUpdates() &&
+        KisAsyncDabRenderingQueue::canRenderAsynchronously(painter)) {
+
+        m_asyncQueue.reset(new KisAsyncDabRenderingQueue(painter, source()));
+    }
 }
 
 KisSprayPaintOp::~KisSprayPaintOp()
@@ -83,19 +93,19 @@ QList<KoResourceLoadResult> KisSprayPaintOp::prepareLinkedResources(const KisPai
     return brushOption.prepareLinkedResources(settings, resourcesInterface);
 }
 
+std::pair<int, bool> KisSprayPaintOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    return m_asyncQueue ?
+        m_asyncQueue->doAsynchronousUpdate(jobs) :
+        KisPaintOp::doAsynchronousUpdate(jobs);
+}
+
 KisSpacingInformation KisSprayPaintOp::paintAt(const KisPaintInformation& info)
 {
     if (!painter() || !m_isPresetValid) {
         return KisSpacingInformation(m_spacing);
     }
 
-    if (!m_dab) {
-        m_dab = source()->createCompositionSourceDevice();
-    }
-    else {
-        m_dab->clear();
-    }
-
     qreal rotation = m_rotationOption.apply(info);
     quint8 origOpacity = m_opacityOption.apply(painter(), info);
     // Spray Brush is capable of working with zero scale,
@@ -103,6 +113,31 @@ KisSpacingInformation KisSprayPaintOp::paintAt(const KisPaintInformation& info)
     const qreal scale = m_sizeOption.apply(info);
     const qreal lodScale = KisLodTransform::lodToScale(painter()->device());
 
+    if (m_asyncQueue) {
+        const QVector<SprayBrush::Particle> particles =
+            m_sprayBrush.generateParticles(m_node->paintDevice(),
+                                           info,
+                                           rotation,
+                                           scale, lodScale,
+                                           painter()->paintColor(),
+                                           painter()->backgroundColor());
+        const QSize maskSize = m_sprayBrush.particleMaskSize();
+
+        m_asyncQueue->addDab(
+            [particles, maskSize] (KisPaintDeviceSP dab) {
+                SprayBrush::paintParticles(dab, particles, maskSize);
+            });
+
+        painter()->setOpacity(origOpacity);
+        return computeSpacing(info, lodScale);
+    }
+
+    if (!m_dab) {
+        m_dab = source()->createCompositionSourceDevice();
+    }
+    else {
+        m_dab->clear();
+    }
 
     m_sprayBrush.paint(m_dab,
                        m_node->paintDevice(),
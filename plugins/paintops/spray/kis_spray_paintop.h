@@ -7,6 +7,8 @@
 #ifndef KIS_SPRAY_PAINTOP_H_
 #define KIS_SPRAY_PAINTOP_H_
 
+#include <QScopedPointer>
+
 #include <brushengine/kis_paintop.h>
 #include <kis_types.h>
 
@@ -22,6 +24,7 @@
 
 
 class KisPainter;
+class KisAsyncDabRenderingQueue;
 
 
 class KisSprayPaintOp : public KisPaintOp
@@ -34,6 +37,8 @@ public:
 
     static QList<KoResourceLoadResult> prepareLinkedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
 protected:
 
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
@@ -63,6 +68,13 @@ private:
     KisOpacityOption m_opacityOption;
     KisRateOption m_rateOption;
     KisNodeSP m_node;
+
+    /**
+     * In asynchronous mode the particles are generated in paintAt(), but
+     * painted in the stroke jobs. Only the simple shapes not sampling the
+     * color of the layer can be painted this way.
+     */
+    QScopedPointer<KisAsyncDabRenderingQueue> m_asyncQueue;
 };
 
 #endif // KIS_SPRAY_PAINTOP_H_
@@ -66,6 +66,11 @@ bool KisSprayPaintOpSettings::paintIncremental()
     return data.paintingMode == enumPaintingMode::BUILDUP;
 }
 
+bool KisSprayPaintOpSettings::needsAsynchronousUpdates() const
+{
+    return true;
+}
+
 
 KisOptimizedBrushOutline KisSprayPaintOpSettings::brushOutline(const KisPaintInformation &info, const OutlineMode &mode, qreal alignForZoom)
 {
@@ -21,6 +21,7 @@
 
 #include <kis_random_accessor_ng.h>
 #include <kis_random_sub_accessor.h>
+#include <kis_assert.h>
 
 #include <kis_paint_device.h>
 
@@ -89,16 +90,56 @@ qreal SprayBrush::rotationAngle(KisRandomSourceSP randomSource)
     return rotation;
 }
 
+bool SprayBrush::usesSimpleShapes() const
+{
+    return m_shapeProperties->enabled &&
+        m_shapeProperties->shape >= 0 && m_shapeProperties->shape <= 3;
+}
+
+QSize SprayBrush::particleMaskSize() const
+{
+    return m_shapeProperties->effectiveSize(m_sprayOpOptionData->diameter, m_sprayOpOptionData->scale);
+}
+
 void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                        const KisPaintInformation& info,
                        qreal rotation, qreal scale,
                        qreal additionalScale,
                        const KoColor &color, const KoColor &bgColor)
+{
+    if (usesSimpleShapes()) {
+        paintParticles(dab,
+                       generateParticles(source, info, rotation, scale, additionalScale, color, bgColor),
+                       particleMaskSize());
+    } else {
+        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, nullptr);
+    }
+}
+
+QVector<SprayBrush::Particle> SprayBrush::generateParticles(KisPaintDeviceSP source,
+                                                            const KisPaintInformation& info,
+                                                            qreal rotation, qreal scale,
+                                                            qreal additionalScale,
+                                                            const KoColor &color, const KoColor &bgColor)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(usesSimpleShapes());
+
+    QVector<Particle> particles;
+    paintImpl(nullptr, source, info, rotation, scale, additionalScale, color, bgColor, &particles);
+    return particles;
+}
+
+void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
+                           const KisPaintInformation& info,
+                           qreal rotation, qreal scale,
+                           qreal additionalScale,
+                           const KoColor &color, const KoColor &bgColor,
+                           QVector<Particle> *particles)
 {
     if (m_sprayOpOption->data.angularDistributionType == KisSprayOpOptionData::ParticleDistribution_Uniform) {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, m_sprayOpOption->m_uniformDistribution);
+        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, particles, m_sprayOpOption->m_uniformDistribution);
     } else {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, m_sprayOpOption->m_angularCurveBasedDistribution);
+        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, particles, m_sprayOpOption->m_angularCurveBasedDistribution);
     }
 }
 
@@ -109,30 +150,31 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                            qreal additionalScale,
                            const KoColor &color,
                            const KoColor &bgColor,
+                           QVector<Particle> *particles,
                            const AngularDistribution &angularDistribution)
 {
     if (m_sprayOpOption->data.radialDistributionType == KisSprayOpOptionData::ParticleDistribution_Uniform) {
         if (m_sprayOpOption->data.radialDistributionCenterBiased) {
             paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                      angularDistribution, m_sprayOpOption->m_uniformDistribution);
+                      particles, angularDistribution, m_sprayOpOption->m_uniformDistribution);
         } else {
             paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                      angularDistribution, m_sprayOpOption->m_uniformDistributionPolarDistance);
+                      particles, angularDistribution, m_sprayOpOption->m_uniformDistributionPolarDistance);
         }
     } else if (m_sprayOpOption->data.radialDistributionType == KisSprayOpOptionData::ParticleDistribution_Gaussian) {
         if (m_sprayOpOption->data.radialDistributionCenterBiased) {
             paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                      angularDistribution, m_sprayOpOption->m_normalDistribution);
+                      particles, angularDistribution, m_sprayOpOption->m_normalDistribution);
         } else {
             paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                      angularDistribution, m_sprayOpOption->m_normalDistributionPolarDistance);
+                      particles, angularDistribution, m_sprayOpOption->m_normalDistributionPolarDistance);
         }
     } else if (m_sprayOpOption->data.radialDistributionType == KisSprayOpOptionData::ParticleDistribution_ClusterBased) {
         paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                  angularDistribution, m_sprayOpOption->m_clusterBasedDistributionPolarDistance);
+                  particles, angularDistribution, m_sprayOpOption->m_clusterBasedDistributionPolarDistance);
     } else {
         paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                  angularDistribution, m_sprayOpOption->m_radialCurveBasedDistributionPolarDistance);
+                  particles, angularDistribution, m_sprayOpOption->m_radialCurveBasedDistributionPolarDistance);
     }
 }
 
@@ -143,6 +185,7 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                            qreal additionalScale,
                            const KoColor &color,
                            const KoColor &bgColor,
+                           QVector<Particle> *particles,
                            const AngularDistribution &angularDistribution,
                            const RadialDistribution &radialDistribution)
 {
@@ -154,29 +197,40 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
     const QSize effectiveSize = m_shapeProperties->effectiveSize(m_sprayOpOptionData->diameter, m_sprayOpOptionData->scale);
 
-    // initializing painter
-    if (!m_painter) {
-        m_painter = new KisPainter(dab);
-        m_painter->setFillStyle(KisPainter::FillStyleForegroundColor);
-        m_painter->setMaskImageSize(effectiveSize.width(), effectiveSize.height());
-        m_dabPixelSize = dab->colorSpace()->pixelSize();
+    /**
+     * When generating the particles there is no dab, but the
+     * color of the particles is always in the color space of the dab
+     */
+    KIS_SAFE_ASSERT_RECOVER_RETURN(dab || particles);
+    const KoColorSpace *colorSpace = dab ? dab->colorSpace() : color.colorSpace();
+
+    if (!m_initialized) {
+        m_initialized = true;
+
         if (m_colorProperties->useRandomHSV) {
-            m_transfo = dab->colorSpace()->createColorTransformation("hsv_adjustment", QHash<QString, QVariant>());
+            m_transfo = colorSpace->createColorTransformation("hsv_adjustment", QHash<QString, QVariant>());
         }
 
         m_brushQImage = m_shapeProperties->image;
         if (!m_brushQImage.isNull()) {
             m_brushQImage = m_brushQImage.scaled(effectiveSize);
         }
-        m_imageDevice = new KisPaintDevice(dab->colorSpace());
+    }
+
+    // initializing painter, the image and brush particles are painted directly
+    if (!particles && !m_painter) {
+        m_painter = new KisPainter(dab);
+        m_painter->setFillStyle(KisPainter::FillStyleForegroundColor);
+        m_painter->setMaskImageSize(effectiveSize.width(), effectiveSize.height());
+        m_painter->setOpacity(m_particleOpacity);
+        m_imageDevice = new KisPaintDevice(colorSpace);
     }
 
 
     qreal x = info.pos().x();
     qreal y = info.pos().y();
-    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
 
-    Q_ASSERT(color.colorSpace()->pixelSize() == dab->pixelSize());
+    Q_ASSERT(!dab || color.colorSpace()->pixelSize() == dab->pixelSize());
     m_inkColor = color;
     KisCrossDeviceColorSampler colorSampler(source, m_inkColor);
 
@@ -210,8 +264,12 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
     bool shouldColor = true;
     if (m_colorProperties->fillBackground) {
-        m_painter->setPaintColor(bgColor);
-        paintCircle(m_painter, x, y, m_radius);
+        if (particles) {
+            particles->append({Particle::Circle, QPointF(x, y), 2.0 * m_radius, 2.0 * m_radius, 0.0, bgColor, m_particleOpacity});
+        } else {
+            m_painter->setPaintColor(bgColor);
+            paintCircle(m_painter, x, y, m_radius);
+        }
     }
 
     QTransform m;
@@ -264,7 +322,7 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
             // mix the color with background color
             if (m_colorProperties->mixBgColor) {
-                KoMixColorsOp * mixOp = dab->colorSpace()->mixColorsOp();
+                KoMixColorsOp * mixOp = colorSpace->mixColorsOp();
 
                 const quint8 *colors[2];
                 colors[0] = m_inkColor.data();
@@ -292,14 +350,21 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             if (m_colorProperties->useRandomOpacity) {
                 quint8 alpha = qRound(randomSource->generateNormalized() * OPACITY_OPAQUE_U8);
                 m_inkColor.setOpacity(alpha);
-                m_painter->setOpacity(alpha);
+
+                // the opacity is kept by the following particles and dabs
+                m_particleOpacity = alpha;
+                if (m_painter) {
+                    m_painter->setOpacity(alpha);
+                }
             }
 
             if (!m_colorProperties->colorPerParticle) {
                 shouldColor = false;
             }
 
-            m_painter->setPaintColor(m_inkColor);
+            if (!particles) {
+                m_painter->setPaintColor(m_inkColor);
+            }
         }
 
         qreal jitteredWidth = qMax(1.0 * additionalScale, effectiveSize.width() * particleScale * additionalScale);
@@ -311,30 +376,27 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             case 0:
             {
                 if (effectiveSize.width() == effectiveSize.height()){
-                    paintCircle(m_painter, nx + x, ny + y, jitteredWidth * 0.5);
+                    particles->append({Particle::Circle, QPointF(nx + x, ny + y), jitteredWidth, jitteredWidth, 0.0, m_inkColor, m_particleOpacity});
                 }
                 else {
-                    paintEllipse(m_painter, nx + x, ny + y, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ);
+                    particles->append({Particle::Ellipse, QPointF(nx + x, ny + y), jitteredWidth, jitteredHeight, rotationZ, m_inkColor, m_particleOpacity});
                 }
                 break;
             }
             // rectangle
             case 1:
             {
-                paintRectangle(m_painter, nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                particles->append({Particle::Rectangle, QPointF(nx + x, ny + y), qreal(qRound(jitteredWidth)), qreal(qRound(jitteredHeight)), rotationZ, m_inkColor, m_particleOpacity});
                 break;
             }
             // wu-particle
             case 2: {
-                paintParticle(accessor, m_inkColor, nx + x, ny + y);
+                particles->append({Particle::WuParticle, QPointF(nx + x, ny + y), 1.0, 1.0, 0.0, m_inkColor, m_particleOpacity});
                 break;
             }
             // pixel
             case 3: {
-                ix = qRound(nx + x);
-                iy = qRound(ny + y);
-                accessor->moveTo(ix, iy);
-                memcpy(accessor->rawData(), m_inkColor.data(), m_dabPixelSize);
+                particles->append({Particle::Pixel, QPointF(nx + x, ny + y), 1.0, 1.0, 0.0, m_inkColor, m_particleOpacity});
                 break;
             }
             case 4: {
@@ -416,7 +478,46 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
 
 
-void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry)
+void SprayBrush::paintParticles(KisPaintDeviceSP dab, const QVector<Particle> &particles, const QSize &maskSize)
+{
+    KisPainter painter(dab);
+    painter.setFillStyle(KisPainter::FillStyleForegroundColor);
+    painter.setMaskImageSize(maskSize.width(), maskSize.height());
+
+    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
+    const quint32 pixelSize = dab->pixelSize();
+
+    Q_FOREACH (const Particle &particle, particles) {
+        switch (particle.shape) {
+        case Particle::Circle:
+            painter.setPaintColor(particle.color);
+            painter.setOpacity(particle.opacity);
+            paintCircle(&painter, particle.pos.x(), particle.pos.y(), particle.width * 0.5);
+            break;
+        case Particle::Ellipse:
+            painter.setPaintColor(particle.color);
+            painter.setOpacity(particle.opacity);
+            paintEllipse(&painter, particle.pos.x(), particle.pos.y(),
+                         particle.width * 0.5, particle.height * 0.5, particle.rotation);
+            break;
+        case Particle::Rectangle:
+            painter.setPaintColor(particle.color);
+            painter.setOpacity(particle.opacity);
+            paintRectangle(&painter, particle.pos.x(), particle.pos.y(),
+                           particle.width, particle.height, particle.rotation);
+            break;
+        case Particle::WuParticle:
+            paintParticle(accessor, particle.color, particle.pos.x(), particle.pos.y(), pixelSize);
+            break;
+        case Particle::Pixel:
+            accessor->moveTo(qRound(particle.pos.x()), qRound(particle.pos.y()));
+            memcpy(accessor->rawData(), particle.color.data(), pixelSize);
+            break;
+        }
+    }
+}
+
+void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry, quint32 pixelSize)
 {
     // opacity top left, right, bottom left, right
     KoColor pcolor(color);
@@ -438,19 +539,19 @@ void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor
 
     pcolor.setOpacity(btl);
     writeAccessor->moveTo(ipx  , ipy);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+    memcpy(writeAccessor->rawData(), pcolor.data(), pixelSize);
 
     pcolor.setOpacity(btr);
     writeAccessor->moveTo(ipx + 1, ipy);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+    memcpy(writeAccessor->rawData(), pcolor.data(), pixelSize);
 
     pcolor.setOpacity(bbl);
     writeAccessor->moveTo(ipx, ipy + 1);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+    memcpy(writeAccessor->rawData(), pcolor.data(), pixelSize);
 
     pcolor.setOpacity(bbr);
     writeAccessor->moveTo(ipx + 1, ipy + 1);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+    memcpy(writeAccessor->rawData(), pcolor.data(), pixelSize);
 }
 
 void SprayBrush::paintCircle(KisPainter* painter, qreal x, qreal y, qreal radius)
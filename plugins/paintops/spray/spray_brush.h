@@ -24,6 +24,7 @@
 
 
 #include <QImage>
+#include <QVector>
 #include <kis_brush.h>
 
 class KisPaintInformation;
@@ -31,6 +32,30 @@ class KisPaintInformation;
 class SprayBrush
 {
 
+public:
+    /**
+     * A simple particle generated by generateParticles(). The particles
+     * don't depend on the state of the brush and can be painted by
+     * paintParticles() in any thread.
+     */
+    struct Particle {
+        enum Shape {
+            Circle,
+            Ellipse,
+            Rectangle,
+            WuParticle,
+            Pixel
+        };
+
+        Shape shape;
+        QPointF pos;
+        qreal width;
+        qreal height;
+        qreal rotation;
+        KoColor color;
+        quint8 opacity;
+    };
+
 public:
     SprayBrush();
     ~SprayBrush();
@@ -51,12 +76,46 @@ public:
 
     void setFixedDab(KisFixedPaintDeviceSP dab);
 
+    /**
+     * @return true if the particles are simple shapes (ellipses, rectangles,
+     *         pixels), that is the dab can be generated by generateParticles()
+     *         and painted by paintParticles() later
+     */
+    bool usesSimpleShapes() const;
+
+    /**
+     * Generates the particles of the dab at \p info. The random sequence and
+     * the state of the brush are updated the same way as in paint(), so
+     * the result is the same as the one of paint().
+     *
+     * Can be used only if usesSimpleShapes() returns true.
+     */
+    QVector<Particle> generateParticles(KisPaintDeviceSP source,
+                                        const KisPaintInformation& info,
+                                        qreal rotation,
+                                        qreal scale,
+                                        qreal additionalScale,
+                                        const KoColor &color,
+                                        const KoColor &bgColor);
+
+    /// the size of the mask image used for painting of the particle shapes
+    QSize particleMaskSize() const;
+
+    /**
+     * Paints \p particles into \p dab. The method is reentrant and
+     * doesn't touch the state of the brush.
+     */
+    static void paintParticles(KisPaintDeviceSP dab,
+                               const QVector<Particle> &particles,
+                               const QSize &maskSize);
+
 private:
     int m_dabSeqNo {0};
     KoColor m_inkColor;
     qreal m_radius {1.0};
     quint32 m_particlesCount {1};
-    quint8 m_dabPixelSize {1};
+    quint8 m_particleOpacity {OPACITY_OPAQUE_U8};
+    bool m_initialized {false};
 
     KisPainter * m_painter {nullptr};
     KisPaintDeviceSP m_imageDevice;
@@ -75,6 +134,20 @@ private:
     KisFixedPaintDeviceSP m_fixedDab;
 
 private:
+    /**
+     * Paints the dab into \p dab. If \p particles is not null, the simple
+     * shapes are not painted but appended to \p particles instead and
+     * \p dab may be null.
+     */
+    void paintImpl(KisPaintDeviceSP dab,
+                   KisPaintDeviceSP source,
+                   const KisPaintInformation& info,
+                   qreal rotation,
+                   qreal scale,
+                   qreal additionalScale,
+                   const KoColor &color,
+                   const KoColor &bgColor,
+                   QVector<Particle> *particles);
     template <typename AngularDistribution>
     void paintImpl(KisPaintDeviceSP dab,
                    KisPaintDeviceSP source,
@@ -84,6 +157,7 @@ private:
                    qreal additionalScale,
                    const KoColor &color,
                    const KoColor &bgColor,
+                   QVector<Particle> *particles,
                    const AngularDistribution &angularDistribution);
     template <typename AngularDistribution, typename RadialDistribution>
     void paintImpl(KisPaintDeviceSP dab,
@@ -94,15 +168,16 @@ private:
                    qreal additionalScale,
                    const KoColor &color,
                    const KoColor &bgColor,
+                   QVector<Particle> *particles,
                    const AngularDistribution &angularDistribution,
                    const RadialDistribution &radialDistribution);
     /// rotation in radians according the settings (gauss distribution, uniform distribution or fixed angle)
     qreal rotationAngle(KisRandomSourceSP randomSource);
     /// Paints Wu Particle
-    void paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry);
-    void paintCircle(KisPainter * painter, qreal x, qreal y, qreal radius);
-    void paintEllipse(KisPainter * painter, qreal x, qreal y, qreal a, qreal b, qreal angle);
-    void paintRectangle(KisPainter * painter, qreal x, qreal y, qreal width, qreal height, qreal angle);
+    static void paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry, quint32 pixelSize);
+    static void paintCircle(KisPainter * painter, qreal x, qreal y, qreal radius);
+    static void paintEllipse(KisPainter * painter, qreal x, qreal y, qreal a, qreal b, qreal angle);
+    static void paintRectangle(KisPainter * painter, qreal x, qreal y, qreal width, qreal height, qreal angle);
 
     void paintOutline(KisPaintDeviceSP dev, const KoColor& painterColor, qreal posX, qreal posY, qreal radius);
 